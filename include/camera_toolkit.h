@@ -9,8 +9,26 @@
 #include "camera_toolkit/capture.h"
 #include "camera_toolkit/common.h"
 #include "camera_toolkit/config.h"
+#include "camera_toolkit/config_file.h"
+#include "camera_toolkit/congestion_control.h"
 #include "camera_toolkit/convert.h"
 #include "camera_toolkit/encoder.h"
+#include "camera_toolkit/file_writer.h"
+#include "camera_toolkit/frame.h"
+#include "camera_toolkit/latency.h"
+#include "camera_toolkit/logger.h"
+#include "camera_toolkit/metrics.h"
 #include "camera_toolkit/network.h"
+#include "camera_toolkit/osd.h"
+#include "camera_toolkit/overlay.h"
+#include "camera_toolkit/packet_pool.h"
+#include "camera_toolkit/pacer.h"
+#include "camera_toolkit/pre_event_buffer.h"
+#include "camera_toolkit/privacy_mask.h"
+#include "camera_toolkit/recorder.h"
 #include "camera_toolkit/rtp_packer.h"
-#include "camera_toolkit/timestamp.h"
\ No newline at end of file
+#include "camera_toolkit/stream_server.h"
+#include "camera_toolkit/task_scheduler.h"
+#include "camera_toolkit/timestamp.h"
+#include "camera_toolkit/trace.h"
+#include "camera_toolkit/ts_muxer.h"
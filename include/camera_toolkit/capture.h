@@ -64,6 +64,18 @@ class Capture : public NonCopyable {
    */
   Buffer getData();
 
+  /**
+   * @brief 获取最近一帧的采集时间戳
+   * @return 驱动记录的采集时刻换算为墙上时间(CLOCK_REALTIME微秒)，尚未采集时返回0
+   */
+  int64_t getLastTimestamp() const;
+
+  /**
+   * @brief 获取驱动丢帧数
+   * @return 按V4L2帧序号跳变累计的丢帧数(应用取帧不及时、驱动缓冲区耗尽时发生)
+   */
+  uint64_t getDroppedFrames() const;
+
   /**
    * @brief 查询亮度控制范围
    * @return 支持时返回ControlRange，否则返回nullopt
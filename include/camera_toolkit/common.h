@@ -33,7 +33,8 @@ enum class PictureType {
  */
 enum class NetworkType {
   UDP = 0, /**< UDP协议 */
-  TCP      /**< TCP协议 */
+  TCP,     /**< TCP协议 */
+  UNIX     /**< Unix域套接字(本地传递帧缓冲区描述符) */
 };
 
 /**
@@ -42,6 +43,7 @@ enum class NetworkType {
 enum class PixelFormat : uint32_t {
   YUYV = 0x56595559,   /**< V4L2_PIX_FMT_YUYV */
   YUV420 = 0x32315559, /**< V4L2_PIX_FMT_YUV420 */
+  NV12 = 0x3231564E,   /**< V4L2_PIX_FMT_NV12 */
   RGB565 = 0x50424752, /**< V4L2_PIX_FMT_RGB565 */
   RGB24 = 0x33424752   /**< V4L2_PIX_FMT_RGB24 */
 };
@@ -0,0 +1,99 @@
+/**
+ * @file config_file.h
+ * @brief INI格式配置文件解析定义
+ *
+ * 配置文件由若干节组成，节头形如[global]或[stream front]，节内每行一个
+ * key = value。以#或;开头的行为注释；值两端的空白被去掉，需要保留空白或
+ * 以#开头时用双引号括起。同一节内的键可以重复(如多个遮挡区域)，按出现顺序保留
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 配置项
+ */
+struct ConfigEntry {
+  std::string key;   /**< 键 */
+  std::string value; /**< 值(已去掉两端空白和引号) */
+  int line = 0;      /**< 所在行号(从1开始) */
+};
+
+/**
+ * @brief 配置节
+ */
+struct ConfigSection {
+  std::string type;                 /**< 节类型，如[stream front]中的stream */
+  std::string name;                 /**< 节名，如[stream front]中的front，可为空 */
+  int line = 0;                     /**< 节头所在行号 */
+  std::vector<ConfigEntry> entries; /**< 按出现顺序的配置项 */
+
+  /**
+   * @brief 查找键最后一次出现的配置项
+   * @param key 键
+   * @return 配置项，不存在返回nullptr
+   */
+  const ConfigEntry* find(const std::string& key) const;
+};
+
+/**
+ * @class ConfigFile
+ * @brief INI格式配置文件
+ */
+class ConfigFile {
+ public:
+  /**
+   * @brief 解析配置文本
+   * @param text 配置文本
+   * @param origin 来源名称，用于错误消息中的"来源:行号"
+   * @return 配置文件
+   * @throws CameraToolkitException 语法错误、节外的配置项或重复的节时抛出
+   */
+  static ConfigFile parse(const std::string& text, const std::string& origin = "<config>");
+
+  /**
+   * @brief 读取并解析配置文件
+   * @param path 文件路径
+   * @return 配置文件
+   * @throws CameraToolkitException 文件无法读取或解析失败时抛出
+   */
+  static ConfigFile load(const std::string& path);
+
+  /**
+   * @brief 获取所有节
+   * @return 按出现顺序的节
+   */
+  const std::vector<ConfigSection>& getSections() const;
+
+  /**
+   * @brief 获取指定类型的节
+   * @param type 节类型
+   * @return 按出现顺序的节指针，在ConfigFile生命周期内有效
+   */
+  std::vector<const ConfigSection*> getSections(const std::string& type) const;
+
+  /**
+   * @brief 获取来源名称
+   * @return 来源名称(文件路径)
+   */
+  const std::string& getOrigin() const;
+
+  /**
+   * @brief 生成带位置的错误消息
+   * @param line 行号
+   * @param message 错误描述
+   * @return "来源:行号: 错误描述"
+   */
+  std::string describe(int line, const std::string& message) const;
+
+ private:
+  std::string origin_;                  /**< 来源名称 */
+  std::vector<ConfigSection> sections_; /**< 所有节 */
+};
+
+}  // namespace camera_toolkit
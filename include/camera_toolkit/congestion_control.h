@@ -0,0 +1,128 @@
+/**
+ * @file congestion_control.h
+ * @brief 拥塞控制类定义
+ *
+ * 基于延迟梯度(GCC风格)和丢包率估计可用带宽，驱动编码码率和发送速率
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 拥塞控制配置参数结构体
+ */
+struct CongestionControlParams {
+  int startBitrate = 1000; /**< 初始码率(kbps) */
+  int minBitrate = 100;    /**< 最小码率(kbps) */
+  int maxBitrate = 8000;   /**< 最大码率(kbps) */
+};
+
+/**
+ * @brief 带宽使用状态枚举
+ */
+enum class BandwidthUsage {
+  Normal = 0, /**< 正常 */
+  Underusing, /**< 链路未充分利用(排队延迟在下降) */
+  Overusing   /**< 链路过载(排队延迟在增长) */
+};
+
+/**
+ * @brief RTCP接收者报告块
+ */
+struct ReceiverReport {
+  uint32_t ssrc = 0;             /**< 被报告的源SSRC */
+  uint8_t fractionLost = 0;      /**< 上个报告间隔内的丢包比例(x/256) */
+  int32_t cumulativeLost = 0;    /**< 累计丢包数 */
+  uint32_t highestSequence = 0;  /**< 扩展最高序列号 */
+  uint32_t jitter = 0;           /**< 到达间隔抖动(RTP时间戳单位) */
+  uint32_t lastSenderReport = 0; /**< LSR */
+  uint32_t delaySinceLastSr = 0; /**< DLSR(1/65536秒) */
+};
+
+/**
+ * @brief 传输层逐包反馈(transport-wide feedback)
+ */
+struct PacketFeedback {
+  uint16_t sequence = 0;     /**< 传输层序列号 */
+  int64_t sendTimeUs = 0;    /**< 发送时刻(发送端时钟，微秒) */
+  int64_t arrivalTimeUs = 0; /**< 到达时刻(接收端时钟，微秒)，小于0表示丢失 */
+  int size = 0;              /**< 包大小(字节) */
+};
+
+/**
+ * @class CongestionController
+ * @brief 拥塞控制类
+ *
+ * 延迟控制器对包组间的到达延迟变化做趋势线拟合，配合自适应阈值检测过载，
+ * 按AIMD调整码率；丢包控制器依据接收者报告中的丢包率调整码率。
+ * 目标码率取两者较小值并限制在[minBitrate, maxBitrate]内
+ *
+ * @note 反馈接口应在同一线程调用，getTargetBitrate()可在任意线程调用
+ */
+class CongestionController : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 拥塞控制参数
+   */
+  explicit CongestionController(const CongestionControlParams& params);
+
+  /**
+   * @brief 析构函数
+   */
+  ~CongestionController();
+
+  /**
+   * @brief 处理RTCP接收者报告
+   * @param report 报告块
+   * @param nowUs 当前时刻(微秒)
+   */
+  void onReceiverReport(const ReceiverReport& report, int64_t nowUs);
+
+  /**
+   * @brief 处理传输层逐包反馈
+   * @param feedback 按序列号排序的逐包反馈
+   * @param nowUs 当前时刻(微秒)
+   */
+  void onTransportFeedback(const std::vector<PacketFeedback>& feedback, int64_t nowUs);
+
+  /**
+   * @brief 获取目标码率
+   * @return 目标码率(kbps)
+   */
+  int getTargetBitrate() const;
+
+  /**
+   * @brief 获取延迟检测器的带宽使用状态
+   * @return 带宽使用状态
+   */
+  BandwidthUsage getUsage() const;
+
+  /**
+   * @brief 获取拥塞控制参数
+   * @return 拥塞控制参数引用
+   */
+  const CongestionControlParams& getParams() const;
+
+  /**
+   * @brief 从RTCP复合包中解析报告指定源的接收者报告块
+   * @param data RTCP数据
+   * @param size 数据大小(字节)
+   * @param ssrc 本端发送的RTP流的SSRC，报告其他源(如同一端口上的其他流)的块被忽略
+   * @param report 输出报告块
+   * @return 找到该源的SR/RR报告块返回true
+   */
+  static bool parseReceiverReport(const void* data, int size, uint32_t ssrc, ReceiverReport* report);
+
+ private:
+  class Impl;                   /**< 前向声明实现类 */
+  std::unique_ptr<Impl> pImpl_; /**< PIMPL指针 */
+};
+
+}  // namespace camera_toolkit
@@ -6,9 +6,12 @@
  */
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "common.h"
+#include "frame.h"
+#include "task_scheduler.h"
 
 namespace camera_toolkit {
 
@@ -22,13 +25,24 @@ struct ConvertParams {
   int outWidth = 640;                               /**< 输出图像宽度 */
   int outHeight = 480;                              /**< 输出图像高度 */
   PixelFormat outPixelFormat = PixelFormat::YUV420; /**< 输出像素格式 */
+  int sliceHeight = 0;                              /**< 分条转换的输入行数(0=整帧一次转换) */
+  TaskScheduler* scheduler = nullptr;               /**< 共享调度器，非空且不缩放时并行转换，须比Convert存活更久 */
 };
 
+/**
+ * @brief 行回调类型
+ *
+ * 参数依次为输出帧视图、本次新输出的首行和末行(不含)。分条转换时除最后一次外行号均为偶数，
+ * 对应的色度行已经写完，回调可以直接在这些仍在缓存中的行上绘制叠加内容
+ */
+using RowCallback = std::function<void(const FrameView& frame, int firstRow, int lastRow)>;
+
 /**
  * @class Convert
  * @brief 图像格式转换类
  *
- * 使用FFmpeg的swscale进行不同像素格式和分辨率之间的转换
+ * 使用FFmpeg的swscale进行不同像素格式和分辨率之间的转换。指定调度器且输入输出尺寸相同时，
+ * 整帧被切成若干水平带，各带用自己的swscale上下文在调度器上并行转换(行回调融合的分条转换仍顺序执行)
  */
 class Convert : public NonCopyable {
  public:
@@ -52,6 +66,13 @@ class Convert : public NonCopyable {
    */
   Buffer convert(const Buffer& input);
 
+  /**
+   * @brief 设置行回调
+   * @param callback 每输出一批行后调用，传空函数取消。sliceHeight为0时每帧整帧调用一次
+   * @note 回调在convert()内同步执行，时间戳、OSD、叠加层可借此与转换融合为一趟
+   */
+  void setRowCallback(RowCallback callback);
+
   /**
    * @brief 获取转换参数
    * @return 转换参数引用
@@ -25,6 +25,7 @@ struct EncoderParams {
   int bitrate = 1000;            /**< 码率(kbps)，0表示不进行码率控制 */
   int gop = 12;                  /**< GOP大小 */
   bool chromaInterleave = false; /**< 色度是否交织 */
+  int threads = 0;               /**< 编码线程数，0表示按CPU核数自动选择；多路编码共用一台机器时应分摊核数 */
 };
 
 /**
@@ -33,6 +34,8 @@ struct EncoderParams {
 struct EncodedFrame {
   Buffer buffer;                        /**< 编码数据 */
   PictureType type = PictureType::None; /**< 帧类型 */
+  int64_t ptsUs = 0;                    /**< 显示时间戳(微秒，首帧为0，按帧率递增) */
+  int64_t dtsUs = 0;                    /**< 解码时间戳(微秒，有B帧时小于ptsUs) */
 
   /**
    * @brief 检查帧是否为空
@@ -0,0 +1,106 @@
+/**
+ * @file file_writer.h
+ * @brief 异步文件写入类定义
+ *
+ * 数据先复制到对齐的大缓冲区，写满后交给后台线程整块写盘，
+ * 调用线程不做磁盘I/O，慢速磁盘不会阻塞帧处理
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 异步文件写入配置参数结构体
+ */
+struct FileWriterParams {
+  std::string path;            /**< 文件路径(已存在时截断) */
+  size_t bufferSize = 4 << 20; /**< 单个缓冲区大小(字节，向上取整到4096) */
+  int bufferCount = 2;         /**< 缓冲区数量(至少2个：一个填充，其余排队写盘) */
+  bool directIO = false;       /**< 使用O_DIRECT绕过页缓存，文件系统不支持时退回普通写入 */
+  int64_t preallocate = 0;     /**< 用fallocate预分配的字节数，0表示不预分配 */
+  bool dropWhenFull = false;   /**< 缓冲区全部排队时丢弃数据而非等待 */
+};
+
+/**
+ * @brief 异步文件写入统计
+ */
+struct FileWriterStats {
+  uint64_t bytesWritten = 0; /**< 已写入文件的字节数 */
+  uint64_t writes = 0;       /**< 写盘系统调用次数 */
+  uint64_t dropped = 0;      /**< 缓冲区满被丢弃的write()调用次数 */
+  uint64_t stalls = 0;       /**< 缓冲区满时调用线程等待的次数 */
+  uint64_t errors = 0;       /**< 写盘失败次数 */
+  int queuedBuffers = 0;     /**< 当前排队等待写盘的缓冲区数 */
+  int maxQueuedBuffers = 0;  /**< 排队缓冲区数的历史最大值 */
+  size_t queuedBytes = 0;    /**< 当前排队等待写盘的字节数(不含正在填充的缓冲区) */
+  bool directIO = false;     /**< 实际是否使用O_DIRECT */
+};
+
+/**
+ * @class AsyncFileWriter
+ * @brief 异步文件写入类
+ *
+ * 多次小写入(如RTP包)合并在同一缓冲区中，写盘总是以缓冲区为单位
+ * 按4096字节对齐进行。write()只能由一个线程调用
+ */
+class AsyncFileWriter : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数，打开文件并启动写盘线程
+   * @param params 配置参数
+   * @throws CameraToolkitException 文件打开失败时抛出
+   */
+  explicit AsyncFileWriter(const FileWriterParams& params);
+
+  /**
+   * @brief 析构函数，写出剩余数据并关闭文件
+   */
+  ~AsyncFileWriter();
+
+  /**
+   * @brief 追加数据
+   * @param data 数据指针
+   * @param size 数据大小(字节)
+   * @return 成功返回true；dropWhenFull且缓冲区不足时丢弃整块数据并返回false
+   */
+  bool write(const void* data, size_t size);
+
+  /**
+   * @brief 把已追加的数据全部写入文件并等待完成
+   */
+  void flush();
+
+  /**
+   * @brief 切换到新文件，之后追加的数据写入新文件
+   * @param path 新文件路径(已存在时截断)
+   *
+   * @note 不等待写盘：已追加的数据仍写入原文件，写盘线程按顺序关闭原文件并打开新文件，
+   *       缓冲区和线程继续复用。新文件打开失败时记录错误，其数据被丢弃直到下一次切换
+   */
+  void reopen(const std::string& path);
+
+  /**
+   * @brief 获取写入统计
+   * @return 统计信息
+   */
+  FileWriterStats getStats() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const FileWriterParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
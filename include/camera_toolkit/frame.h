@@ -0,0 +1,67 @@
+/**
+ * @file frame.h
+ * @brief 视频帧视图定义
+ *
+ * 描述一帧图像各平面的位置和行跨度，叠加类按视图绘制，可直接作用于带填充或对齐的帧
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 视频帧视图(不持有数据)
+ *
+ * YUV420: planes = {Y, U, V}；NV12: planes = {Y, UV}；打包格式只使用planes[0]
+ */
+struct FrameView {
+  uint8_t* planes[3] = {};                  /**< 各平面起始地址 */
+  int strides[3] = {};                      /**< 各平面行跨度(字节) */
+  int width = 0;                            /**< 图像宽度(像素) */
+  int height = 0;                           /**< 图像高度(像素) */
+  PixelFormat format = PixelFormat::YUV420; /**< 像素格式 */
+
+  /**
+   * @brief 由连续存放、无行填充的帧构造视图
+   * @param data 帧数据
+   * @param width 图像宽度
+   * @param height 图像高度
+   * @param format 像素格式
+   * @return 帧视图
+   */
+  static FrameView contiguous(uint8_t* data, int width, int height, PixelFormat format = PixelFormat::YUV420) {
+    FrameView view;
+    view.width = width;
+    view.height = height;
+    view.format = format;
+    const int chromaWidth = (width + 1) / 2;
+    const int chromaHeight = (height + 1) / 2;
+    view.planes[0] = data;
+    switch (format) {
+      case PixelFormat::YUV420:
+        view.strides[0] = width;
+        view.strides[1] = view.strides[2] = chromaWidth;
+        view.planes[1] = data + static_cast<size_t>(width) * height;
+        view.planes[2] = view.planes[1] + static_cast<size_t>(chromaWidth) * chromaHeight;
+        break;
+      case PixelFormat::NV12:
+        view.strides[0] = width;
+        view.strides[1] = chromaWidth * 2;
+        view.planes[1] = data + static_cast<size_t>(width) * height;
+        break;
+      case PixelFormat::RGB24:
+        view.strides[0] = width * 3;
+        break;
+      default:
+        view.strides[0] = width * 2;
+        break;
+    }
+    return view;
+  }
+};
+
+}  // namespace camera_toolkit
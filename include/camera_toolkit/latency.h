@@ -0,0 +1,199 @@
+/**
+ * @file latency.h
+ * @brief 逐帧时延跟踪类定义
+ *
+ * 记录每帧在采集、转换、叠加、编码、打包、发送各阶段的时刻，按阶段和端到端汇总为对数线性直方图
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 跟踪阶段枚举，按流水线顺序排列
+ */
+enum class TraceStage {
+  Dequeue = 0,  /**< 从采集队列取出 */
+  Convert,      /**< 格式转换完成 */
+  Overlay,      /**< 遮挡和叠加绘制完成 */
+  EncodeSubmit, /**< 提交编码 */
+  EncodeReturn, /**< 编码返回 */
+  FirstPacket,  /**< 首个RTP包打包完成 */
+  LastPacket,   /**< 最后一个RTP包打包完成 */
+  Sent          /**< 最后一个包发出(定时发送时取计划发送时刻) */
+};
+
+constexpr int TRACE_STAGE_COUNT = static_cast<int>(TraceStage::Sent) + 1; /**< 跟踪阶段数 */
+
+/**
+ * @brief 单帧跟踪记录
+ */
+struct FrameTrace {
+  int64_t stamps[TRACE_STAGE_COUNT] = {}; /**< 各阶段时刻(CLOCK_MONOTONIC纳秒)，0表示未经过该阶段 */
+
+  /**
+   * @brief 以当前CLOCK_MONOTONIC时刻标记阶段
+   * @param stage 阶段
+   */
+  void mark(TraceStage stage);
+
+  /**
+   * @brief 以指定时刻标记阶段
+   * @param stage 阶段
+   * @param timeNs 时刻(CLOCK_MONOTONIC纳秒)
+   */
+  void mark(TraceStage stage, int64_t timeNs) { stamps[static_cast<int>(stage)] = timeNs; }
+
+  /**
+   * @brief 判断是否经过了某个阶段
+   * @param stage 阶段
+   * @return 是否已标记
+   */
+  bool has(TraceStage stage) const { return stamps[static_cast<int>(stage)] != 0; }
+
+  /**
+   * @brief 清除所有标记，供下一帧复用
+   */
+  void clear() { *this = FrameTrace(); }
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief 对数线性时延直方图
+ *
+ * 每个2的幂区间再等分为64个桶(HDR直方图的做法)，相对误差不超过1/64，
+ * 覆盖1纳秒到约18分钟；记录一个值只需一次前导零计数和一次加法
+ */
+class LatencyHistogram {
+ public:
+  /**
+   * @brief 构造函数
+   */
+  LatencyHistogram();
+
+  /**
+   * @brief 记录一个值
+   * @param valueNs 时延(纳秒)，负值按0记录，超出量程按最大值记录
+   */
+  void record(int64_t valueNs);
+
+  /**
+   * @brief 合并另一个直方图
+   * @param other 直方图
+   */
+  void merge(const LatencyHistogram& other);
+
+  /**
+   * @brief 清空所有记录
+   */
+  void reset();
+
+  /**
+   * @brief 获取记录数
+   * @return 记录数
+   */
+  uint64_t getCount() const { return count_; }
+
+  /**
+   * @brief 获取最小值
+   * @return 最小值(纳秒)，无记录时为0
+   */
+  int64_t getMin() const { return count_ ? min_ : 0; }
+
+  /**
+   * @brief 获取最大值
+   * @return 最大值(纳秒)
+   */
+  int64_t getMax() const { return max_; }
+
+  /**
+   * @brief 获取平均值
+   * @return 平均值(纳秒)，无记录时为0
+   */
+  double getMean() const;
+
+  /**
+   * @brief 获取百分位数
+   * @param percentile 百分位(0-100)
+   * @return 该百分位所在桶内的最大可能值(纳秒，不超过实际最大值)，无记录时为0
+   */
+  int64_t getPercentile(double percentile) const;
+
+ private:
+  std::vector<uint64_t> buckets_; /**< 桶计数 */
+  uint64_t count_ = 0;            /**< 记录数 */
+  int64_t min_ = 0;               /**< 最小值 */
+  int64_t max_ = 0;               /**< 最大值 */
+  double sum_ = 0;                /**< 总和(用于平均值) */
+};
+
+/**
+ * @class LatencyTracer
+ * @brief 逐帧时延汇总类
+ *
+ * 每个阶段的直方图记录从上一个已标记阶段到该阶段的间隔，端到端直方图记录从首个到最后一个已标记阶段的间隔，
+ * 未经过的阶段(如未启用打包)直接跳过
+ *
+ * @note 非线程安全，record()与读取接口应在同一线程调用
+ */
+class LatencyTracer : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   */
+  LatencyTracer();
+
+  /**
+   * @brief 析构函数
+   */
+  ~LatencyTracer();
+
+  /**
+   * @brief 汇总一帧的跟踪记录
+   * @param trace 跟踪记录
+   */
+  void record(const FrameTrace& trace);
+
+  /**
+   * @brief 获取阶段直方图
+   * @param stage 阶段(Dequeue阶段没有前驱，其直方图始终为空)
+   * @return 直方图引用
+   */
+  const LatencyHistogram& getStage(TraceStage stage) const;
+
+  /**
+   * @brief 获取端到端直方图
+   * @return 直方图引用
+   */
+  const LatencyHistogram& getEndToEnd() const;
+
+  /**
+   * @brief 生成文本报表(微秒)，每个有记录的阶段一行
+   * @return 报表文本
+   */
+  std::string report() const;
+
+  /**
+   * @brief 清空所有直方图
+   */
+  void reset();
+
+  /**
+   * @brief 获取阶段名称
+   * @param stage 阶段
+   * @return 阶段名称
+   */
+  static const char* stageName(TraceStage stage);
+
+ private:
+  class Impl;                   /**< 前向声明实现类 */
+  std::unique_ptr<Impl> pImpl_; /**< PIMPL指针 */
+};
+
+}  // namespace camera_toolkit
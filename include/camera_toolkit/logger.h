@@ -0,0 +1,77 @@
+/**
+ * @file logger.h
+ * @brief 异步日志接口定义
+ *
+ * 日志消息写入无锁环形缓冲区，由后台线程统一输出，记录日志的线程从不阻塞在终端或文件I/O上
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace camera_toolkit {
+
+/**
+ * @brief 日志级别枚举
+ */
+enum class LogLevel {
+  Debug = 0, /**< 调试信息 */
+  Info,      /**< 组件生命周期事件 */
+  Warn,      /**< 非致命异常路径 */
+  Error,     /**< 操作失败 */
+  Off        /**< 关闭日志 */
+};
+
+/**
+ * @brief 日志统计信息结构体
+ */
+struct LogStats {
+  uint64_t written = 0;    /**< 已输出的消息数 */
+  uint64_t dropped = 0;    /**< 缓冲区满被丢弃的消息数 */
+  uint64_t suppressed = 0; /**< 重复消息被限流的次数 */
+};
+
+/**
+ * @brief 日志输出回调类型，在后台线程中按入队顺序调用
+ */
+using LogSink = std::function<void(LogLevel level, const char* message)>;
+
+/**
+ * @brief 记录一条日志
+ * @param level 日志级别
+ * @param message 日志消息，超过缓冲槽长度的部分被截断
+ * @note 不加锁、不做系统调用：低于运行时级别的消息直接返回，相同消息每秒最多输出5条，
+ *       缓冲区满时丢弃并计数。进程退出后转为同步输出
+ */
+void logMessage(LogLevel level, const char* message);
+
+/**
+ * @brief 设置运行时日志级别
+ * @param level 低于此级别的消息被忽略(编译期级别CK_LOG_LEVEL之下的库内日志已在编译时去除)
+ */
+void setLogLevel(LogLevel level);
+
+/**
+ * @brief 获取运行时日志级别
+ * @return 日志级别
+ */
+LogLevel getLogLevel();
+
+/**
+ * @brief 设置日志输出回调
+ * @param sink 输出回调，传空函数恢复默认输出(Debug/Info到stdout，Warn/Error到stderr)
+ */
+void setLogSink(LogSink sink);
+
+/**
+ * @brief 等待调用前入队的日志全部输出
+ */
+void flushLog();
+
+/**
+ * @brief 获取日志统计信息
+ * @return 日志统计信息
+ */
+LogStats getLogStats();
+
+}  // namespace camera_toolkit
@@ -0,0 +1,181 @@
+/**
+ * @file metrics.h
+ * @brief 运行指标与Prometheus HTTP端点定义
+ *
+ * 流水线线程只对注册好的计数器/仪表做原子更新，MetricsServer在自己的线程中
+ * 读取这些原子值并以Prometheus文本格式响应抓取请求，不与流水线线程同步
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @class Counter
+ * @brief 单调递增计数器
+ */
+class Counter : public NonCopyable {
+ public:
+  /**
+   * @brief 增加计数
+   * @param value 增量
+   */
+  void add(uint64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
+
+  /**
+   * @brief 获取计数
+   * @return 计数
+   */
+  uint64_t get() const { return value_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<uint64_t> value_{0}; /**< 计数 */
+};
+
+/**
+ * @class Gauge
+ * @brief 可任意设置的仪表值
+ */
+class Gauge : public NonCopyable {
+ public:
+  /**
+   * @brief 设置值
+   * @param value 值
+   */
+  void set(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits_.store(bits, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 获取值
+   * @return 值
+   */
+  double get() const {
+    const uint64_t bits = bits_.load(std::memory_order_relaxed);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+ private:
+  std::atomic<uint64_t> bits_{0}; /**< double的位模式 */
+};
+
+/**
+ * @brief 指标标签(名称, 值)列表，同名指标以不同标签区分多个时间序列(如每路流一个)
+ */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * @class MetricsRegistry
+ * @brief 指标注册表
+ *
+ * 指标在启动时注册，返回的引用在注册表生命周期内有效；更新指标不加锁。
+ * 同名不同标签的指标属于同一族，输出时共用一组HELP/TYPE
+ */
+class MetricsRegistry : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   */
+  MetricsRegistry();
+
+  /**
+   * @brief 析构函数
+   */
+  ~MetricsRegistry();
+
+  /**
+   * @brief 注册计数器
+   * @param name 指标名(须符合[a-zA-Z_:][a-zA-Z0-9_:]*，计数器惯例以_total结尾)
+   * @param help 说明文字
+   * @param scale 输出时的换算系数(如以纳秒计数、以秒输出时为1e-9)
+   * @param labels 标签，为空时不带标签
+   * @return 计数器引用
+   * @throws CameraToolkitException 名称或标签名非法、名称和标签均重复、与同名指标类型不同时抛出
+   */
+  Counter& counter(const std::string& name, const std::string& help, double scale = 1.0,
+                   const MetricLabels& labels = {});
+
+  /**
+   * @brief 注册仪表
+   * @param name 指标名
+   * @param help 说明文字
+   * @param labels 标签，为空时不带标签
+   * @return 仪表引用
+   * @throws CameraToolkitException 名称或标签名非法、名称和标签均重复、与同名指标类型不同时抛出
+   */
+  Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels = {});
+
+  /**
+   * @brief 按Prometheus文本格式(0.0.4)输出所有指标
+   * @return 文本
+   */
+  std::string render() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+/**
+ * @brief 指标HTTP端点配置参数结构体
+ */
+struct MetricsServerParams {
+  std::string address = "127.0.0.1"; /**< 监听地址(IPv4)，0.0.0.0监听所有接口 */
+  int port = 9100;                   /**< 监听端口，0表示由系统分配 */
+  int maxConnections = 16;           /**< 同时保持的最大连接数，超出时直接关闭新连接 */
+  int idleTimeoutMs = 5000;          /**< 连接未完成请求的超时时间(毫秒) */
+};
+
+/**
+ * @class MetricsServer
+ * @brief Prometheus指标HTTP端点
+ *
+ * 单线程epoll事件循环，GET /metrics返回注册表的文本格式输出，
+ * 其他路径返回404。每个请求响应后关闭连接
+ */
+class MetricsServer : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数，绑定端口并启动服务线程
+   * @param params 配置参数
+   * @param registry 指标注册表(须比MetricsServer存活更久)
+   * @throws NetworkException 地址非法或绑定失败时抛出
+   */
+  MetricsServer(const MetricsServerParams& params, const MetricsRegistry& registry);
+
+  /**
+   * @brief 析构函数，停止服务线程并关闭所有连接
+   */
+  ~MetricsServer();
+
+  /**
+   * @brief 获取实际监听的端口
+   * @return 端口
+   */
+  int getPort() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const MetricsServerParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
@@ -2,7 +2,7 @@
  * @file network.h
  * @brief 网络通信类定义
  *
- * 通过UDP或TCP连接发送和接收数据
+ * 通过UDP、TCP或Unix域套接字发送和接收数据
  */
 #pragma once
 
@@ -17,9 +17,68 @@ namespace camera_toolkit {
  * @brief 网络配置参数结构体
  */
 struct NetworkParams {
-  NetworkType type = NetworkType::UDP; /**< 协议类型(UDP或TCP) */
+  NetworkType type = NetworkType::UDP; /**< 协议类型(UDP、TCP或UNIX) */
   std::string serverIP;                /**< 服务器IP地址 */
   int serverPort = 0;                  /**< 服务器端口 */
+  std::string socketPath;              /**< Unix域套接字路径(仅UNIX类型) */
+  bool txTime = false;                 /**< 启用SO_TXTIME内核定时发送(仅UDP，需fq qdisc，不支持etf) */
+  int receiveTimeoutMs = 0;            /**< receive()超时(毫秒)，0表示一直阻塞 */
+  int batchSize = 32;                  /**< receiveBatch()/sendBatch()单次最多处理的包数，0表示不分配批量数组 */
+  int batchBufferSize = 2048;          /**< 批量接收缓冲池中每个包的缓冲区大小(字节) */
+  bool rxTimestamp = false;            /**< 启用SO_TIMESTAMPNS内核接收时间戳 */
+  int sendBufferSize = 0;              /**< SO_SNDBUF(字节)，0表示使用系统默认值 */
+  int receiveBufferSize = 0;           /**< SO_RCVBUF(字节)，0表示使用系统默认值 */
+  int tos = -1;                        /**< IP_TOS字节(DSCP左移2位，如EF为0xB8)，-1表示不设置(仅UDP/TCP) */
+  int priority = -1;                   /**< SO_PRIORITY(0-6，更高需CAP_NET_ADMIN)，-1表示不设置 */
+};
+
+/**
+ * @brief 网络发送统计
+ *
+ * 发送耗时直方图按2的幂分桶：第0桶为小于1微秒，第i桶为[2^(i-1), 2^i)微秒，
+ * 最后一桶包含所有更长的耗时
+ */
+struct NetworkStats {
+  static constexpr int LATENCY_BUCKETS = 16; /**< 发送耗时直方图桶数 */
+
+  uint64_t packetsSent = 0;                   /**< 成功发送的包数 */
+  uint64_t bytesSent = 0;                     /**< 成功发送的字节数 */
+  uint64_t shortSends = 0;                    /**< 只发送了部分数据的次数 */
+  uint64_t wouldBlock = 0;                    /**< 因EAGAIN/EWOULDBLOCK失败的次数(发送缓冲区满) */
+  uint64_t errors = 0;                        /**< 其他发送错误次数 */
+  uint64_t sendLatency[LATENCY_BUCKETS] = {}; /**< 发送系统调用耗时直方图 */
+  int queuedBytes = 0;                        /**< 发送队列中尚未发出/确认的字节数(SIOCOUTQ) */
+  int sendBufferSize = 0;                     /**< 实际生效的SO_SNDBUF(字节) */
+  int receiveBufferSize = 0;                  /**< 实际生效的SO_RCVBUF(字节) */
+};
+
+/**
+ * @brief 批量接收的单个包
+ *
+ * data指向Network内部的接收缓冲池，在下一次receiveBatch()调用前有效
+ */
+struct ReceivedPacket {
+  const uint8_t* data = nullptr; /**< 包数据 */
+  int size = 0;                  /**< 包大小(字节) */
+  bool truncated = false;        /**< 包超出batchBufferSize被截断 */
+  int64_t timestampNs = 0;       /**< 内核接收时间戳(CLOCK_REALTIME纳秒)，未启用rxTimestamp时为0 */
+};
+
+/**
+ * @brief 帧描述符元数据结构体
+ *
+ * 与帧缓冲区文件描述符(memfd/DMABUF)一起通过UNIX传输发送，
+ * 接收方据此映射并解析帧数据，无需复制像素
+ */
+struct FrameDescriptor {
+  uint64_t sequence = 0;                         /**< 帧序号 */
+  int64_t timestampUs = 0;                       /**< 采集时间戳(微秒) */
+  uint32_t width = 0;                            /**< 图像宽度 */
+  uint32_t height = 0;                           /**< 图像高度 */
+  PixelFormat pixelFormat = PixelFormat::YUV420; /**< 像素格式 */
+  uint32_t stride = 0;                           /**< 行跨度(字节) */
+  uint32_t offset = 0;                           /**< 帧数据在缓冲区中的偏移(字节) */
+  uint32_t size = 0;                             /**< 帧数据大小(字节) */
 };
 
 /**
@@ -27,6 +86,7 @@ struct NetworkParams {
  * @brief 网络通信类
  *
  * 通过UDP或TCP连接发送和接收数据
+ * UNIX类型使用SOCK_SEQPACKET套接字，可通过SCM_RIGHTS传递帧缓冲区描述符
  */
 class Network : public NonCopyable {
  public:
@@ -57,6 +117,17 @@ class Network : public NonCopyable {
    */
   int send(const Buffer& buffer);
 
+  /**
+   * @brief 批量发送数据
+   * @param buffers 每个包一个缓冲区(UDP时每个为一个数据报)
+   * @param count 包数
+   * @return 发送的包数，第一个包就失败时返回-1(errno为错误码)
+   *
+   * @note 使用sendmmsg每次系统调用最多发送batchSize个包，batchSize为0时逐个发送。
+   *       批量发送不带发送时刻，即使启用了txTime也立即发出，需要平滑发送时逐个调用sendAt()
+   */
+  int sendBatch(const Buffer* buffers, int count);
+
   /**
    * @brief 接收数据
    * @param data 接收缓冲区
@@ -65,12 +136,86 @@ class Network : public NonCopyable {
    */
   int receive(void* data, int size);
 
+  /**
+   * @brief 批量接收数据
+   * @param packets 输出包信息数组
+   * @param max packets数组容量，实际上限为batchSize
+   * @return 接收的包数，错误返回-1
+   *
+   * @note 使用recvmmsg一次系统调用接收多个包：阻塞等待第一个包(受receiveTimeoutMs约束)，
+   *       之后只取走已到达的包，不再等待。接收缓冲池在第一次调用时分配
+   */
+  int receiveBatch(ReceivedPacket* packets, int max);
+
+  /**
+   * @brief 在指定时刻发送数据
+   * @param data 要发送的数据缓冲区
+   * @param size 数据大小(字节)
+   * @param txTimeNs 发送时刻(CLOCK_MONOTONIC纳秒)，通常由Pacer计算
+   * @return 发送的字节数，错误返回-1
+   *
+   * @note 启用txTime且出接口挂载fq qdisc时由内核定时发送，调用立即返回；
+   *       否则在用户态睡眠到发送时刻后再发送
+   */
+  int sendAt(const void* data, int size, int64_t txTimeNs);
+
+  /**
+   * @brief 在指定时刻发送缓冲区
+   * @param buffer 要发送的Buffer
+   * @param txTimeNs 发送时刻(CLOCK_MONOTONIC纳秒)
+   * @return 发送的字节数，错误返回-1
+   */
+  int sendAt(const Buffer& buffer, int64_t txTimeNs);
+
+  /**
+   * @brief 检查是否由内核负责发送定时
+   * @return SO_TXTIME内核定时生效返回true，回退到用户态定时返回false
+   */
+  bool isKernelPacing() const;
+
+  /**
+   * @brief 发送文件描述符及附带的元数据(仅UNIX类型)
+   * @param fd 要传递的文件描述符(如memfd或DMABUF)
+   * @param meta 元数据缓冲区(如FrameDescriptor)
+   * @param size 元数据大小(字节)
+   * @return 发送的元数据字节数，错误返回-1
+   * @throws NetworkException 非UNIX类型时抛出
+   *
+   * @note 内核为接收方复制描述符，发送方仍需自行关闭fd
+   */
+  int sendFd(int fd, const void* meta, int size);
+
+  /**
+   * @brief 接收文件描述符及附带的元数据(仅UNIX类型)
+   * @param meta 元数据接收缓冲区
+   * @param size 最大接收字节数
+   * @param fd 输出收到的文件描述符，消息未携带描述符时为-1
+   * @return 接收的元数据字节数，错误返回-1
+   * @throws NetworkException 非UNIX类型时抛出
+   *
+   * @note 收到的描述符由调用方负责关闭
+   */
+  int receiveFd(void* meta, int size, int* fd);
+
   /**
    * @brief 检查连接是否有效
-   * @return 已连接返回true
+   * @return 已连接返回true，发送时遇到EPIPE/ECONNRESET/ENOTCONN后返回false
    */
   bool isConnected() const;
 
+  /**
+   * @brief 获取发送统计
+   * @return 统计快照，queuedBytes和缓冲区大小为调用时从内核读取的值
+   *
+   * @note 可在任意线程调用
+   */
+  NetworkStats getStats() const;
+
+  /**
+   * @brief 清零发送计数器和耗时直方图
+   */
+  void resetStats();
+
   /**
    * @brief 获取网络参数
    * @return 网络参数引用
@@ -0,0 +1,126 @@
+/**
+ * @file osd.h
+ * @brief 屏幕叠加(OSD)类定义
+ *
+ * 在视频帧上按模板绘制多个文字区域，字段值来自采集/编码流水线的统计
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "frame.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief OSD文字区域
+ *
+ * 模板支持的字段: {time} 时间戳, {fps} 帧率, {kbps} 码率, {camera} 相机名称；
+ * 未知字段按原文输出，"\n"(字面两个字符)换行
+ */
+struct OsdRegion {
+  std::string format = "{time}"; /**< 文字模板 */
+  int x = 10;                    /**< 锚点X坐标，位于右半边时右对齐 */
+  int y = 10;                    /**< 最后一行的Y坐标，多行时向上展开 */
+  int factor = 0;                /**< 文字大小，按(factor + 1)倍缩放 */
+};
+
+/**
+ * @brief OSD配置参数结构体
+ */
+struct OsdParams {
+  int videoWidth = 640;           /**< 视频帧宽度 */
+  int videoHeight = 480;          /**< 视频帧高度 */
+  std::string cameraName;         /**< 相机名称({camera}字段) */
+  bool milliseconds = false;      /**< {time}字段附带".mmm"毫秒 */
+  std::vector<OsdRegion> regions; /**< 文字区域列表 */
+};
+
+/**
+ * @brief OSD动态字段统计值
+ */
+struct OsdStats {
+  double fps = 0.0; /**< 帧率({fps}字段) */
+  int kbps = 0;     /**< 码率({kbps}字段) */
+};
+
+/**
+ * @class Osd
+ * @brief 多区域OSD合成类
+ *
+ * 每个区域缓存预渲染的文字条带，只在字段值变化时重绘变化的字符；
+ * 每帧对所有区域覆盖的行做一次自上而下的合成
+ *
+ * @note 非线程安全，update()与draw()应在同一线程调用
+ */
+class Osd : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params OSD参数
+   */
+  explicit Osd(const OsdParams& params);
+
+  /**
+   * @brief 析构函数
+   */
+  ~Osd();
+
+  /**
+   * @brief 更新动态字段统计值
+   * @param stats 统计值
+   */
+  void update(const OsdStats& stats);
+
+  /**
+   * @brief 在图像上绘制所有区域，{time}取当前系统时间
+   * @param image 图像数据指针(YUV的Y平面)
+   */
+  void draw(uint8_t* image);
+
+  /**
+   * @brief 在图像上绘制所有区域
+   * @param image 图像数据指针(YUV的Y平面)
+   * @param timeUs {time}字段的墙上时间(CLOCK_REALTIME微秒)，通常为Capture::getLastTimestamp()
+   */
+  void draw(uint8_t* image, int64_t timeUs);
+
+  /**
+   * @brief 在帧上绘制所有区域，{time}取当前系统时间
+   * @param frame 帧视图(使用Y平面及其行跨度)
+   */
+  void draw(const FrameView& frame);
+
+  /**
+   * @brief 在帧上绘制所有区域
+   * @param frame 帧视图(使用Y平面及其行跨度)
+   * @param timeUs {time}字段的墙上时间(CLOCK_REALTIME微秒)
+   */
+  void draw(const FrameView& frame, int64_t timeUs);
+
+  /**
+   * @brief 只在帧的[firstRow, lastRow)行内绘制所有区域
+   * @param frame 帧视图(使用Y平面及其行跨度)
+   * @param timeUs {time}字段的墙上时间(CLOCK_REALTIME微秒)
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   * @note 字段和布局在每次调用时增量更新，同一帧分条调用的结果与整帧调用一致
+   */
+  void draw(const FrameView& frame, int64_t timeUs, int firstRow, int lastRow);
+
+  /**
+   * @brief 获取OSD参数
+   * @return OSD参数引用
+   */
+  const OsdParams& getParams() const;
+
+ private:
+  class Impl;                   /**< 前向声明实现类 */
+  std::unique_ptr<Impl> pImpl_; /**< PIMPL指针 */
+};
+
+}  // namespace camera_toolkit
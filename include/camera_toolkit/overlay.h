@@ -0,0 +1,143 @@
+/**
+ * @file overlay.h
+ * @brief 彩色叠加层类定义
+ *
+ * 在YUV420/NV12视频帧上按Alpha混合彩色文字和位图(台标等)，同时更新亮度和下采样的色度平面
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "common.h"
+#include "frame.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 叠加层颜色(RGB)
+ */
+struct OverlayColor {
+  uint8_t r = 255; /**< 红 */
+  uint8_t g = 255; /**< 绿 */
+  uint8_t b = 255; /**< 蓝 */
+};
+
+/**
+ * @brief 叠加层配置参数结构体
+ */
+struct OverlayParams {
+  int videoWidth = 640;                          /**< 视频帧宽度 */
+  int videoHeight = 480;                         /**< 视频帧高度 */
+  PixelFormat pixelFormat = PixelFormat::YUV420; /**< 视频帧像素格式(YUV420或NV12) */
+};
+
+/**
+ * @class Overlay
+ * @brief 彩色叠加层类
+ *
+ * 位图和文字在加载时转换为BT.601 YUV并预乘Alpha，色度按2x2块对预乘值求平均，
+ * 每帧只需对每个平面逐行做一次定点SIMD混合: dst = premul + dst * (255 - alpha) / 255
+ *
+ * @note 非线程安全，所有接口应在同一线程调用
+ */
+class Overlay : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 叠加层参数
+   * @throws CameraToolkitException 像素格式不是YUV420/NV12或尺寸无效时抛出
+   */
+  explicit Overlay(const OverlayParams& params);
+
+  /**
+   * @brief 析构函数
+   */
+  ~Overlay();
+
+  /**
+   * @brief 添加RGBA位图层
+   * @param rgba RGBA像素数据(非预乘)
+   * @param width 位图宽度
+   * @param height 位图高度
+   * @param stride 位图行跨度(字节)
+   * @param x 左上角X坐标(可超出帧边缘，超出部分裁剪)
+   * @param y 左上角Y坐标
+   * @param alpha 整体不透明度，与逐像素Alpha相乘
+   * @return 图层ID
+   * @throws CameraToolkitException 参数无效时抛出
+   */
+  int addImage(const uint8_t* rgba, int width, int height, int stride, int x, int y, uint8_t alpha = 255);
+
+  /**
+   * @brief 添加彩色文字层
+   * @param text 文字(使用\\n作为换行符)
+   * @param x 左上角X坐标
+   * @param y 左上角Y坐标
+   * @param factor 文字大小，按(factor + 1)倍缩放
+   * @param color 文字颜色
+   * @param outline 描边颜色
+   * @param alpha 不透明度
+   * @return 图层ID
+   */
+  int addText(const char* text, int x, int y, int factor, const OverlayColor& color, const OverlayColor& outline,
+              uint8_t alpha = 255);
+
+  /**
+   * @brief 更新文字层内容
+   * @param id 文字层ID
+   * @param text 新文字，与当前文字相同时不做任何工作
+   * @throws CameraToolkitException ID无效或不是文字层时抛出
+   */
+  void setText(int id, const char* text);
+
+  /**
+   * @brief 移动图层
+   * @param id 图层ID
+   * @param x 左上角X坐标
+   * @param y 左上角Y坐标
+   * @throws CameraToolkitException ID无效时抛出
+   */
+  void setPosition(int id, int x, int y);
+
+  /**
+   * @brief 删除图层
+   * @param id 图层ID，无效ID忽略
+   */
+  void remove(int id);
+
+  /**
+   * @brief 按添加顺序把所有图层合成到图像上
+   * @param image 图像数据指针(连续存放的YUV420或NV12帧)
+   */
+  void draw(uint8_t* image);
+
+  /**
+   * @brief 按添加顺序把所有图层合成到帧上
+   * @param frame 帧视图，格式须与参数一致，各平面按各自行跨度访问
+   * @throws CameraToolkitException 帧格式与参数不一致时抛出
+   */
+  void draw(const FrameView& frame);
+
+  /**
+   * @brief 只在帧的[firstRow, lastRow)亮度行内合成所有图层
+   * @param frame 帧视图，格式须与参数一致
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   * @throws CameraToolkitException 帧格式与参数不一致时抛出
+   * @note 色度行r随亮度行2r合成，按相邻行范围分条调用时每个样本只混合一次，结果与整帧调用一致
+   */
+  void draw(const FrameView& frame, int firstRow, int lastRow);
+
+  /**
+   * @brief 获取叠加层参数
+   * @return 叠加层参数引用
+   */
+  const OverlayParams& getParams() const;
+
+ private:
+  class Impl;                   /**< 前向声明实现类 */
+  std::unique_ptr<Impl> pImpl_; /**< PIMPL指针 */
+};
+
+}  // namespace camera_toolkit
@@ -0,0 +1,89 @@
+/**
+ * @file pacer.h
+ * @brief 发送节奏控制类定义
+ *
+ * 根据码率和帧时序为每个RTP包计算发送时刻，配合Network::sendAt()平滑发送
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 发送节奏控制参数结构体
+ */
+struct PacerParams {
+  int bitrate = 1000;        /**< 媒体码率(kbps) */
+  double pacingFactor = 2.5; /**< 发送速率相对媒体码率的倍数 */
+  int fps = 15;              /**< 帧率，单帧发送窗口不超过一个帧间隔 */
+};
+
+/**
+ * @class Pacer
+ * @brief 发送节奏控制类
+ *
+ * 以 bitrate * pacingFactor 的速率为每个包分配发送时刻(漏桶)，
+ * 单帧的包在一个帧间隔内发完，空闲期不累积突发额度
+ */
+class Pacer : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 节奏控制参数
+   */
+  explicit Pacer(const PacerParams& params);
+
+  /**
+   * @brief 析构函数
+   */
+  ~Pacer();
+
+  /**
+   * @brief 标记新帧开始
+   * @param frameTimeNs 帧就绪时刻(CLOCK_MONOTONIC纳秒)
+   */
+  void onFrame(int64_t frameTimeNs);
+
+  /**
+   * @brief 计算下一个包的发送时刻
+   * @param bytes 包大小(字节)
+   * @param nowNs 当前时刻(CLOCK_MONOTONIC纳秒)
+   * @return 发送时刻(CLOCK_MONOTONIC纳秒)
+   */
+  int64_t next(int bytes, int64_t nowNs);
+
+  /**
+   * @brief 以当前CLOCK_MONOTONIC时刻计算下一个包的发送时刻
+   * @param bytes 包大小(字节)
+   * @return 发送时刻(CLOCK_MONOTONIC纳秒)
+   */
+  int64_t next(int bytes);
+
+  /**
+   * @brief 设置媒体码率
+   * @param bitrate 新码率(kbps)
+   */
+  void setBitrate(int bitrate);
+
+  /**
+   * @brief 获取当前发送速率
+   * @return 发送速率(kbps)
+   */
+  int getPacingRate() const;
+
+  /**
+   * @brief 获取节奏控制参数
+   * @return 节奏控制参数引用
+   */
+  const PacerParams& getParams() const;
+
+ private:
+  class Impl;                   /**< 前向声明实现类 */
+  std::unique_ptr<Impl> pImpl_; /**< PIMPL指针 */
+};
+
+}  // namespace camera_toolkit
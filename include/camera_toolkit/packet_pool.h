@@ -0,0 +1,186 @@
+/**
+ * @file packet_pool.h
+ * @brief 编码包内存池定义
+ *
+ * 编码后的访问单元复制到一块预先分配的环形内存中，以引用计数的Packet句柄传递，
+ * 总内存固定为池容量，不随码率和帧数增长
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "common.h"
+#include "encoder.h"
+
+namespace camera_toolkit {
+
+struct PacketSlot;
+
+/**
+ * @class Packet
+ * @brief 池中编码包的引用计数句柄
+ *
+ * 复制句柄只增加引用计数，最后一个句柄析构时内存归还内存池。
+ * 句柄可以在线程间传递，包数据写入后只读
+ */
+class Packet {
+ public:
+  /** @brief 构造空句柄 */
+  Packet() = default;
+
+  /**
+   * @brief 复制构造，增加引用计数
+   * @param other 另一个句柄
+   */
+  Packet(const Packet& other);
+
+  /**
+   * @brief 移动构造
+   * @param other 另一个句柄，之后为空
+   */
+  Packet(Packet&& other) noexcept;
+
+  /**
+   * @brief 复制赋值
+   * @param other 另一个句柄
+   * @return 自身引用
+   */
+  Packet& operator=(const Packet& other);
+
+  /**
+   * @brief 移动赋值
+   * @param other 另一个句柄，之后为空
+   * @return 自身引用
+   */
+  Packet& operator=(Packet&& other) noexcept;
+
+  /**
+   * @brief 析构函数，释放引用
+   */
+  ~Packet();
+
+  /**
+   * @brief 检查句柄是否为空
+   * @return 为空返回true
+   */
+  bool empty() const { return slot_ == nullptr; }
+
+  /**
+   * @brief 获取包数据
+   * @return 数据指针
+   */
+  const uint8_t* data() const;
+
+  /**
+   * @brief 获取包大小
+   * @return 字节数
+   */
+  size_t size() const;
+
+  /**
+   * @brief 获取显示时间戳
+   * @return 微秒
+   */
+  int64_t ptsUs() const;
+
+  /**
+   * @brief 获取解码时间戳
+   * @return 微秒
+   */
+  int64_t dtsUs() const;
+
+  /**
+   * @brief 是否为IDR帧
+   * @return 是返回true
+   */
+  bool keyframe() const;
+
+  /**
+   * @brief 以EncodedFrame形式引用包数据(不复制)，在句柄存活期间有效
+   * @return 编码帧
+   */
+  EncodedFrame frame() const;
+
+  /**
+   * @brief 释放引用，句柄变为空
+   */
+  void reset();
+
+ private:
+  friend class PacketPool;
+
+  /**
+   * @brief 构造函数(由PacketPool调用)
+   * @param slot 已持有一个引用的槽位
+   */
+  explicit Packet(PacketSlot* slot) : slot_(slot) {}
+
+  PacketSlot* slot_ = nullptr; /**< 池中槽位 */
+};
+
+/**
+ * @brief 内存池统计
+ */
+struct PacketPoolStats {
+  size_t capacity = 0;      /**< 池容量(字节) */
+  size_t used = 0;          /**< 已占用字节数(含槽位头和回绕空隙) */
+  size_t livePackets = 0;   /**< 仍被引用的包数 */
+  uint64_t allocations = 0; /**< 成功分配次数 */
+  uint64_t failures = 0;    /**< 空间不足导致的分配失败次数 */
+};
+
+/**
+ * @class PacketPool
+ * @brief 编码包内存池
+ *
+ * 按先进先出顺序从环形内存中分配，包释放后只有当它成为最早的槽位时空间才被回收，
+ * 因此长时间持有旧包会阻止新分配。allocate()应由一个线程调用，句柄可在任意线程释放。
+ * 内存池必须在所有Packet句柄释放之后才能销毁
+ */
+class PacketPool : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数，一次性分配全部内存
+   * @param capacity 容量(字节)
+   * @throws CameraToolkitException 内存分配失败时抛出
+   */
+  explicit PacketPool(size_t capacity);
+
+  /**
+   * @brief 析构函数
+   */
+  ~PacketPool();
+
+  /**
+   * @brief 分配一个包并复制数据
+   * @param data 数据
+   * @param size 数据大小
+   * @param ptsUs 显示时间戳(微秒)
+   * @param dtsUs 解码时间戳(微秒)
+   * @param keyframe 是否为IDR帧
+   * @return 包句柄，空间不足时返回空句柄
+   */
+  Packet allocate(const void* data, size_t size, int64_t ptsUs, int64_t dtsUs, bool keyframe);
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  PacketPoolStats getStats() const;
+
+  /**
+   * @brief 获取容量
+   * @return 字节数
+   */
+  size_t capacity() const;
+
+ private:
+  friend struct PacketSlot;
+
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
@@ -0,0 +1,115 @@
+/**
+ * @file pre_event_buffer.h
+ * @brief 事件前录像缓冲类定义
+ *
+ * 在内存中保留最近若干秒的编码帧，事件触发时把缓冲内容连同之后的实时帧
+ * 交给录像等输出，得到包含事件发生前画面的录像
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "common.h"
+#include "encoder.h"
+#include "packet_pool.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 事件前录像缓冲配置参数结构体
+ */
+struct PreEventBufferParams {
+  size_t poolBytes = 16 << 20; /**< 包内存池容量(字节)，即单路缓冲的内存上限 */
+  int64_t durationMs = 10000;  /**< 保留时长(毫秒)，淘汰整个GOP后仍不少于该时长 */
+  int maxFrames = 1024;        /**< 最多保留的帧数 */
+};
+
+/**
+ * @brief 事件前录像缓冲统计
+ */
+struct PreEventBufferStats {
+  int frames = 0;           /**< 当前缓冲的帧数 */
+  int gops = 0;             /**< 当前缓冲的GOP数 */
+  size_t bytes = 0;         /**< 当前缓冲的编码数据字节数 */
+  int64_t durationUs = 0;   /**< 当前缓冲覆盖的时长(首帧到末帧的解码时间差) */
+  uint64_t pushed = 0;      /**< 已缓冲的帧数 */
+  uint64_t dropped = 0;     /**< 内存池或帧数已满而丢弃的帧数(含等待下一个IDR期间的帧) */
+  uint64_t evictedGops = 0; /**< 被淘汰的GOP数 */
+  uint64_t dumped = 0;      /**< 已交给输出的帧数 */
+  uint64_t lost = 0;        /**< 输出过慢、送出前已被淘汰的帧数 */
+  PacketPoolStats pool;     /**< 内存池统计 */
+};
+
+/**
+ * @class PreEventBuffer
+ * @brief 事件前录像缓冲类
+ *
+ * 缓冲总是从IDR帧开始，并按整个GOP淘汰。输出由后台线程进行：startDump()之后
+ * 先送出缓冲中的帧，然后持续送出新写入的帧，直到stopDump()。push()只复制数据到
+ * 内存池，不等待输出
+ */
+class PreEventBuffer : public NonCopyable {
+ public:
+  /**
+   * @brief 帧输出回调，在后台线程中调用，帧数据只在回调期间有效
+   */
+  using Sink = std::function<void(const EncodedFrame&)>;
+
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   * @throws CameraToolkitException 内存池分配失败时抛出
+   */
+  explicit PreEventBuffer(const PreEventBufferParams& params);
+
+  /**
+   * @brief 析构函数，停止输出
+   */
+  ~PreEventBuffer();
+
+  /**
+   * @brief 写入一个编码帧(只含SPS/PPS的头信息单独保存，输出时放在最前面)
+   * @param frame 编码帧(Annex-B格式，使用buffer、ptsUs、dtsUs)
+   * @return 已缓冲返回true，被跳过或丢弃返回false
+   */
+  bool push(const EncodedFrame& frame);
+
+  /**
+   * @brief 开始输出，从缓冲中最早的、尚未输出过的GOP开始
+   * @param sink 帧输出回调
+   * @throws CameraToolkitException 已在输出时抛出
+   */
+  void startDump(Sink sink);
+
+  /**
+   * @brief 停止输出，等待调用前写入的帧全部送出
+   */
+  void stopDump();
+
+  /**
+   * @brief 是否正在输出
+   * @return 是返回true
+   */
+  bool isDumping() const;
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  PreEventBufferStats getStats() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const PreEventBufferParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
@@ -0,0 +1,119 @@
+/**
+ * @file privacy_mask.h
+ * @brief 隐私遮挡类定义
+ *
+ * 在编码前对视频帧中的多边形或矩形区域做纯色填充或马赛克处理
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "common.h"
+#include "frame.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 遮挡方式枚举
+ */
+enum class MaskMode {
+  Fill = 0, /**< 纯色填充 */
+  Pixelate  /**< 马赛克(按块取平均) */
+};
+
+/**
+ * @brief 多边形顶点(亮度像素坐标)
+ */
+struct MaskPoint {
+  int x = 0; /**< X坐标 */
+  int y = 0; /**< Y坐标 */
+};
+
+/**
+ * @brief 遮挡区域
+ *
+ * 像素中心落在多边形内部(奇偶规则)的像素被遮挡；区域可部分超出帧
+ */
+struct MaskRegion {
+  std::vector<MaskPoint> polygon; /**< 多边形顶点，至少3个 */
+
+  /**
+   * @brief 构造矩形区域
+   * @param x 左上角X坐标
+   * @param y 左上角Y坐标
+   * @param width 宽度
+   * @param height 高度
+   * @return 遮挡区域
+   */
+  static MaskRegion rectangle(int x, int y, int width, int height) {
+    MaskRegion region;
+    region.polygon = {{x, y}, {x + width, y}, {x + width, y + height}, {x, y + height}};
+    return region;
+  }
+};
+
+/**
+ * @brief 隐私遮挡配置参数结构体
+ */
+struct PrivacyMaskParams {
+  int videoWidth = 640;                          /**< 视频帧宽度 */
+  int videoHeight = 480;                         /**< 视频帧高度 */
+  PixelFormat pixelFormat = PixelFormat::YUV420; /**< 视频帧像素格式(YUV420或NV12) */
+  MaskMode mode = MaskMode::Fill;                /**< 遮挡方式 */
+  uint8_t fillY = 16;                            /**< 填充亮度(默认黑色) */
+  uint8_t fillU = 128;                           /**< 填充色度U */
+  uint8_t fillV = 128;                           /**< 填充色度V */
+  int blockSize = 16;                            /**< 马赛克块大小(亮度像素，偶数) */
+  std::vector<MaskRegion> regions;               /**< 遮挡区域列表 */
+};
+
+/**
+ * @class PrivacyMask
+ * @brief 隐私遮挡类
+ *
+ * 区域在构造时光栅化为逐行的像素区间列表(亮度和色度各一份，色度覆盖所有接触遮挡像素的样本)，
+ * 每帧只遍历区间：纯色填充按行memset，马赛克对与区间相交的块用SIMD求和后回填平均值
+ *
+ * @note 非线程安全，同一实例不应在多个线程中同时使用
+ */
+class PrivacyMask : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 隐私遮挡参数
+   * @throws CameraToolkitException 像素格式、尺寸、块大小或区域无效时抛出
+   */
+  explicit PrivacyMask(const PrivacyMaskParams& params);
+
+  /**
+   * @brief 析构函数
+   */
+  ~PrivacyMask();
+
+  /**
+   * @brief 对连续存放的帧应用遮挡
+   * @param image 图像数据指针
+   */
+  void apply(uint8_t* image);
+
+  /**
+   * @brief 对帧应用遮挡
+   * @param frame 帧视图，格式须与参数一致
+   * @throws CameraToolkitException 帧格式与参数不一致时抛出
+   */
+  void apply(const FrameView& frame);
+
+  /**
+   * @brief 获取隐私遮挡参数
+   * @return 隐私遮挡参数引用
+   */
+  const PrivacyMaskParams& getParams() const;
+
+ private:
+  class Impl;                   /**< 前向声明实现类 */
+  std::unique_ptr<Impl> pImpl_; /**< PIMPL指针 */
+};
+
+}  // namespace camera_toolkit
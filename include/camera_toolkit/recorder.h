@@ -0,0 +1,103 @@
+/**
+ * @file recorder.h
+ * @brief 分段fMP4录像类定义
+ *
+ * 把编码后的H264访问单元封装为分段(fragmented) MP4，每个文件以IDR帧开始，
+ * 按时长或大小在IDR帧处切换到新文件，并为每个文件写一个记录片段位置的索引
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common.h"
+#include "encoder.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 录像配置参数结构体
+ */
+struct RecorderParams {
+  std::string directory = ".";       /**< 输出目录 */
+  std::string prefix = "record";     /**< 文件名前缀，文件名为<prefix>-<序号>.mp4 */
+  int width = 640;                   /**< 视频宽度 */
+  int height = 480;                  /**< 视频高度 */
+  int fps = 15;                      /**< 帧率(只用于推算最后一帧的时长) */
+  int64_t segmentDurationMs = 60000; /**< 单个文件的目标时长(毫秒)，0表示不按时长切换 */
+  int64_t segmentBytes = 0;          /**< 单个文件的目标大小(字节)，0表示不按大小切换 */
+  int fragmentDurationMs = 1000;     /**< 片段(moof+mdat)的最大时长(毫秒)，IDR帧总是开始新片段 */
+  bool directIO = false;             /**< 使用O_DIRECT写入 */
+};
+
+/**
+ * @brief 录像统计
+ */
+struct RecorderStats {
+  uint64_t segments = 0;  /**< 已打开的文件数 */
+  uint64_t fragments = 0; /**< 已写出的片段数 */
+  uint64_t frames = 0;    /**< 已写入的帧数 */
+  uint64_t bytes = 0;     /**< 已写入的字节数 */
+  uint64_t skipped = 0;   /**< 第一个IDR帧之前被跳过的帧数 */
+};
+
+/**
+ * @class Recorder
+ * @brief 分段fMP4录像类
+ *
+ * 输入为Annex-B格式的访问单元，SPS/PPS从IDR帧(或单独的头信息)中提取写入avcC，
+ * 帧数据转换为长度前缀格式。片段缓冲区复用，稳定运行时不按帧分配内存，
+ * 文件通过AsyncFileWriter顺序写入，分段切换时复用同一个写入器，由其写盘线程关闭旧文件，调用线程不等待磁盘
+ */
+class Recorder : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   */
+  explicit Recorder(const RecorderParams& params);
+
+  /**
+   * @brief 析构函数，写出缓冲的片段并关闭当前文件
+   */
+  ~Recorder();
+
+  /**
+   * @brief 写入一个访问单元
+   * @param frame 编码帧(使用buffer、ptsUs、dtsUs)
+   * @throws CameraToolkitException 打开第一个文件(或close()之后的新文件)失败时抛出；
+   *         分段切换时新文件打开失败只记录错误并计入写入器统计
+   */
+  void write(const EncodedFrame& frame);
+
+  /**
+   * @brief 写出缓冲的片段并关闭当前文件，之后的写入从下一个IDR帧开始新文件
+   * @note 等待数据全部写盘后返回
+   */
+  void close();
+
+  /**
+   * @brief 获取当前文件路径
+   * @return 路径，没有打开的文件时为空
+   */
+  std::string getSegmentPath() const;
+
+  /**
+   * @brief 获取录像统计
+   * @return 统计信息
+   */
+  RecorderStats getStats() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const RecorderParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
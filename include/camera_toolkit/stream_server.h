@@ -0,0 +1,104 @@
+/**
+ * @file stream_server.h
+ * @brief HTTP低延迟直播服务类定义
+ *
+ * 把编码后的H264访问单元封装为每帧一个片段的fMP4(CMAF chunk)，通过HTTP
+ * 分块传输(chunked transfer encoding)持续推送，浏览器可用MSE直接播放
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "common.h"
+#include "encoder.h"
+#include "packet_pool.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 直播服务配置参数结构体
+ */
+struct StreamServerParams {
+  std::string address = "0.0.0.0"; /**< 监听地址(IPv4) */
+  int port = 8080;                 /**< 监听端口，0表示由系统分配 */
+  std::string path = "/live.mp4";  /**< 流的请求路径，其他路径返回404 */
+  int width = 640;                 /**< 视频宽度 */
+  int height = 480;                /**< 视频高度 */
+  int fps = 15;                    /**< 帧率(只用于推算首帧时长) */
+  int maxViewers = 256;            /**< 同时连接的最大观看者数，超出时直接关闭新连接 */
+  size_t poolBytes = 8 << 20;      /**< 片段内存池容量(字节)，所有观看者共享 */
+  size_t maxQueueBytes = 1 << 20;  /**< 单个观看者允许积压的字节数，超出时丢弃到下一个IDR帧 */
+  int sendBufferSize = 0;          /**< 每个连接的SO_SNDBUF(字节)，限制内核中的积压，0表示系统默认 */
+  int idleTimeoutMs = 5000;        /**< 连接未完成请求或发送停滞的超时时间(毫秒) */
+};
+
+/**
+ * @brief 直播服务统计
+ */
+struct StreamServerStats {
+  int viewers = 0;        /**< 当前观看者数(正在接收流的连接) */
+  uint64_t accepted = 0;  /**< 已接受的连接数 */
+  uint64_t frames = 0;    /**< 已封装的帧数 */
+  uint64_t bytesSent = 0; /**< 已发送的字节数 */
+  uint64_t dropped = 0;   /**< 内存池已满而未能封装的帧数 */
+  uint64_t overflows = 0; /**< 观看者积压超限被跳到下一个IDR帧的次数 */
+  PacketPoolStats pool;   /**< 片段内存池统计 */
+};
+
+/**
+ * @class StreamServer
+ * @brief HTTP低延迟直播服务类
+ *
+ * 每帧只封装和复制一次：片段连同分块传输的长度行写入引用计数的PacketPool，
+ * 各观看者的发送队列只持有包的引用，由单线程epoll事件循环用sendmsg聚合发送。
+ * 新观看者先收到初始化段和当前GOP，从IDR帧开始播放
+ */
+class StreamServer : public NonCopyable {
+ public:
+  /**
+   * @brief 构造函数，绑定端口并启动服务线程
+   * @param params 配置参数
+   * @throws CameraToolkitException 参数无效或内存池分配失败时抛出
+   * @throws NetworkException 地址非法或绑定失败时抛出
+   */
+  explicit StreamServer(const StreamServerParams& params);
+
+  /**
+   * @brief 析构函数，停止服务线程并关闭所有连接
+   */
+  ~StreamServer();
+
+  /**
+   * @brief 写入一个编码帧(可在任意单个线程中调用，不等待网络发送)
+   * @param frame 编码帧(Annex-B格式，使用buffer、ptsUs、dtsUs)；只含SPS/PPS的头信息
+   *              用于生成初始化段
+   */
+  void write(const EncodedFrame& frame);
+
+  /**
+   * @brief 获取实际监听的端口
+   * @return 端口
+   */
+  int getPort() const;
+
+  /**
+   * @brief 获取统计(可在任意线程调用)
+   * @return 统计信息
+   */
+  StreamServerStats getStats() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const StreamServerParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
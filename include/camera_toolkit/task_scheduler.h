@@ -0,0 +1,153 @@
+/**
+ * @file task_scheduler.h
+ * @brief 工作窃取任务调度器定义
+ *
+ * 所有流、所有流水线阶段共用一组工作线程：每个线程有自己的按优先级分开的任务队列，
+ * 空闲线程从其他线程的队列窃取任务，线程数固定为核数，多路流并行时不会超额订阅
+ */
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "common.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief 任务优先级，工作线程总是先取更高优先级的任务
+ */
+enum class TaskPriority {
+  High = 0,   /**< 采集路径上的实时工作，如当前帧的转换分条 */
+  Normal = 1, /**< 编码路径上的工作 */
+  Low = 2,    /**< 可以延后的后台工作，如快照 */
+};
+
+/**
+ * @brief 调度器配置参数结构体
+ */
+struct TaskSchedulerParams {
+  int threads = 0;         /**< 工作线程数，0表示CPU核数 */
+  bool pinThreads = false; /**< 把第i个工作线程绑定到第firstCore+i号核 */
+  int firstCore = 0;       /**< 绑定的起始核号 */
+};
+
+/**
+ * @brief 调度器统计
+ */
+struct TaskSchedulerStats {
+  uint64_t submitted = 0; /**< 已提交的任务数 */
+  uint64_t executed = 0;  /**< 已执行完的任务数(包括抛出异常的) */
+  uint64_t stolen = 0;    /**< 从其他线程队列取得的任务数 */
+  uint64_t failed = 0;    /**< 抛出异常的任务数 */
+};
+
+/**
+ * @class TaskGroup
+ * @brief 任务组，用于等待一批任务全部完成
+ *
+ * 组须比其中的任务存活更久，通常在栈上创建并在作用域结束前调用TaskScheduler::wait()
+ */
+class TaskGroup : public NonCopyable {
+ public:
+  /**
+   * @brief 检查组内任务是否全部完成
+   * @return 全部完成返回true
+   */
+  bool done() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_ == 0;
+  }
+
+ private:
+  friend class TaskScheduler;
+
+  mutable std::mutex mutex_; /**< 保护以下成员 */
+  int pending_ = 0;          /**< 未完成的任务数 */
+  int queued_ = 0;           /**< 仍在队列中、等待方可以帮忙执行的任务数 */
+  std::exception_ptr error_; /**< 第一个任务异常，由wait()重新抛出 */
+};
+
+/**
+ * @class TaskScheduler
+ * @brief 工作窃取任务调度器
+ *
+ * 工作线程提交的任务进入自己的队列，其他线程提交的任务轮流分配到各线程的队列。
+ * 取任务时按优先级从高到低，先查本线程队列再窃取其他线程的队列，同一优先级内先提交的先执行。
+ * 等待任务组的线程在等待期间帮忙执行该组仍在队列中的任务(不执行其他组的任务，避免被无关的
+ * 低优先级任务拖住)，任务内部可以嵌套提交并等待子任务
+ */
+class TaskScheduler : public NonCopyable {
+ public:
+  using Task = std::function<void()>; /**< 任务类型 */
+
+  /**
+   * @brief 构造函数，启动工作线程
+   * @param params 配置参数
+   * @throws CameraToolkitException 线程数为负时抛出
+   */
+  explicit TaskScheduler(const TaskSchedulerParams& params = TaskSchedulerParams());
+
+  /**
+   * @brief 析构函数，执行完已提交的任务后停止工作线程
+   */
+  ~TaskScheduler();
+
+  /**
+   * @brief 提交任务(可在任意线程调用)
+   * @param task 任务，抛出的异常被记录并计入failed
+   * @param priority 优先级
+   */
+  void submit(Task task, TaskPriority priority = TaskPriority::Normal);
+
+  /**
+   * @brief 提交属于任务组的任务
+   * @param group 任务组
+   * @param task 任务，抛出的异常由wait()重新抛出
+   * @param priority 优先级
+   */
+  void submit(TaskGroup& group, Task task, TaskPriority priority = TaskPriority::Normal);
+
+  /**
+   * @brief 等待任务组完成，等待期间执行该组仍在队列中的任务
+   * @param group 任务组
+   * @throws 组内第一个任务抛出的异常(所有任务完成后才抛出)
+   */
+  void wait(TaskGroup& group);
+
+  /**
+   * @brief 并行执行body(0)到body(count-1)并等待全部完成
+   * @param count 次数
+   * @param body 循环体，各次调用可能在不同线程中并发执行
+   * @param priority 优先级
+   * @throws 第一个抛出的异常(所有调用完成后才抛出)
+   */
+  void parallelFor(int count, const std::function<void(int)>& body, TaskPriority priority = TaskPriority::Normal);
+
+  /**
+   * @brief 获取工作线程数
+   * @return 工作线程数
+   */
+  int getThreadCount() const;
+
+  /**
+   * @brief 获取统计(可在任意线程调用)
+   * @return 统计信息
+   */
+  TaskSchedulerStats getStats() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const TaskSchedulerParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "common.h"
+#include "frame.h"
 
 namespace camera_toolkit {
 
@@ -17,10 +18,11 @@ namespace camera_toolkit {
  * @brief 时间戳绘制配置参数结构体
  */
 struct TimestampParams {
-  int startX = 10;      /**< 距左边缘的距离(像素) */
-  int startY = 10;      /**< 距上边缘的距离(像素) */
-  int videoWidth = 640; /**< 视频帧宽度 */
-  int factor = 0;       /**< 文字大小(0=小, 1=大) */
+  int startX = 10;           /**< 距左边缘的距离(像素) */
+  int startY = 10;           /**< 距上边缘的距离(像素) */
+  int videoWidth = 640;      /**< 视频帧宽度 */
+  int factor = 0;            /**< 文字大小，按(factor + 1)倍缩放(0=小, 1=大, 可继续增大) */
+  bool milliseconds = false; /**< 时间戳附带".mmm"毫秒字段 */
 };
 
 /**
@@ -46,17 +48,56 @@ class Timestamp : public NonCopyable {
    * @brief 在图像上绘制时间戳
    * @param image 图像数据指针(YUV的Y平面)
    *
-   * @note 时间戳格式: "YYYY-MM-DD HH:MM:SS (TZ)"
+   * @note 时间戳格式: "YYYY-MM-DD HH:MM:SS[.mmm] (TZ)"，取当前系统时间
    */
   void draw(uint8_t* image);
 
+  /**
+   * @brief 在图像上绘制指定时刻的时间戳
+   * @param image 图像数据指针(YUV的Y平面)
+   * @param timeUs 墙上时间(CLOCK_REALTIME微秒)，通常为Capture::getLastTimestamp()
+   *
+   * @note 时区信息每个UTC分钟查询一次，其余字段按变化增量更新，不进入glibc时区锁
+   */
+  void draw(uint8_t* image, int64_t timeUs);
+
   /**
    * @brief 在图像上绘制自定义文字
-   * @param image 图像数据指针
+   * @param image 图像数据指针(行跨度为videoWidth，高度未知，只裁剪顶边)
    * @param text 要绘制的文字
    */
   void drawText(uint8_t* image, const char* text);
 
+  /**
+   * @brief 在帧上绘制时间戳，取当前系统时间
+   * @param frame 帧视图(使用Y平面及其行跨度)，超出帧高度的行被裁剪
+   */
+  void draw(const FrameView& frame);
+
+  /**
+   * @brief 在帧上绘制指定时刻的时间戳
+   * @param frame 帧视图
+   * @param timeUs 墙上时间(CLOCK_REALTIME微秒)
+   */
+  void draw(const FrameView& frame, int64_t timeUs);
+
+  /**
+   * @brief 只在帧的[firstRow, lastRow)行内绘制指定时刻的时间戳
+   * @param frame 帧视图
+   * @param timeUs 墙上时间(CLOCK_REALTIME微秒)
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   * @note 用于在转换器逐条输出时趁热绘制，同一帧分条调用的结果与整帧调用一致
+   */
+  void draw(const FrameView& frame, int64_t timeUs, int firstRow, int lastRow);
+
+  /**
+   * @brief 在帧上绘制自定义文字
+   * @param frame 帧视图
+   * @param text 要绘制的文字
+   */
+  void drawText(const FrameView& frame, const char* text);
+
   /**
    * @brief 获取时间戳参数
    * @return 时间戳参数引用
@@ -0,0 +1,120 @@
+/**
+ * @file trace.h
+ * @brief 流水线时间线跟踪接口定义
+ *
+ * 各模块在关键路径上记录带起止时刻的作用域事件，导出为Chrome trace JSON，
+ * 可在chrome://tracing或Perfetto UI中按线程查看时间线
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace camera_toolkit {
+
+/**
+ * @brief 跟踪统计信息结构体
+ */
+struct TraceStats {
+  uint64_t events = 0;  /**< 已记录的事件数 */
+  uint64_t dropped = 0; /**< 线程缓冲区满被丢弃的事件数 */
+};
+
+/**
+ * @brief 开始一次跟踪会话，清空上一次会话的事件
+ * @param eventsPerThread 每个线程的事件缓冲区容量
+ */
+void startTracing(size_t eventsPerThread = 65536);
+
+/**
+ * @brief 停止记录事件，已记录的事件保留到下一次startTracing()
+ */
+void stopTracing();
+
+/**
+ * @brief 获取跟踪统计信息
+ * @return 跟踪统计信息
+ */
+TraceStats getTraceStats();
+
+/**
+ * @brief 把当前会话的事件导出为Chrome trace JSON
+ * @return JSON文本
+ * @note 应在停止跟踪后调用，跟踪进行中导出时只包含已完成的事件
+ */
+std::string getTraceJson();
+
+/**
+ * @brief 把当前会话的事件写入Chrome trace JSON文件
+ * @param path 文件路径
+ * @throws CameraToolkitException 文件写入失败时抛出
+ */
+void saveTrace(const std::string& path);
+
+namespace detail {
+
+extern std::atomic<bool> tracingActive; /**< 跟踪开关，未开启时作用域事件只做一次原子读 */
+
+/**
+ * @brief 获取CLOCK_MONOTONIC时刻
+ * @return 纳秒
+ */
+int64_t traceNowNs();
+
+/**
+ * @brief 把一个完整事件写入当前线程的缓冲区(无锁，每个线程独占自己的缓冲区)
+ * @param name 事件名(须为静态字符串)
+ * @param startNs 开始时刻
+ * @param endNs 结束时刻
+ */
+void recordTraceEvent(const char* name, int64_t startNs, int64_t endNs);
+
+}  // namespace detail
+
+/**
+ * @class TraceScope
+ * @brief 作用域跟踪事件
+ *
+ * 构造时记录开始时刻，析构时把完整事件写入当前线程的缓冲区。
+ * 跟踪未开启时构造和析构各只有一次原子读和分支
+ */
+class TraceScope {
+ public:
+  /**
+   * @brief 构造函数
+   * @param name 事件名(须为静态字符串，导出时才读取)
+   */
+  explicit TraceScope(const char* name) : name_(name) {
+    if (detail::tracingActive.load(std::memory_order_relaxed)) startNs_ = detail::traceNowNs();
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~TraceScope() {
+    if (startNs_ != 0) detail::recordTraceEvent(name_, startNs_, detail::traceNowNs());
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* name_;    /**< 事件名 */
+  int64_t startNs_ = 0; /**< 开始时刻，0表示未记录 */
+};
+
+}  // namespace camera_toolkit
+
+#define CK_TRACE_CONCAT_INNER(a, b) a##b
+#define CK_TRACE_CONCAT(a, b) CK_TRACE_CONCAT_INNER(a, b)
+
+/**
+ * @brief 在当前作用域记录一个跟踪事件；定义CK_DISABLE_TRACING时在编译期去除
+ */
+#ifdef CK_DISABLE_TRACING
+#define CK_TRACE_SCOPE(name) ((void)0)
+#else
+#define CK_TRACE_SCOPE(name) ::camera_toolkit::TraceScope CK_TRACE_CONCAT(ckTraceScope, __LINE__)(name)
+#endif
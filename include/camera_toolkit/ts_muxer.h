@@ -0,0 +1,98 @@
+/**
+ * @file ts_muxer.h
+ * @brief MPEG-TS封装类定义
+ *
+ * 把编码后的H264访问单元封装为MPEG-TS(单节目、单视频流)，生成PAT/PMT、PES和PCR，
+ * 按数据报大小成组输出，适合UDP组播或写入文件
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "common.h"
+#include "encoder.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief MPEG-TS封装配置参数结构体
+ */
+struct TsMuxerParams {
+  int videoPid = 0x100;       /**< 视频流PID(同时作为PCR PID) */
+  int pmtPid = 0x1000;        /**< PMT的PID */
+  int programNumber = 1;      /**< 节目号 */
+  int transportStreamId = 1;  /**< 传输流ID */
+  int packetsPerDatagram = 7; /**< 每个数据报的TS包数，7 x 188 = 1316字节不超过以太网MTU */
+  int maxDatagrams = 128;     /**< 输出缓冲区可容纳的数据报数，帧更大时分多次交给输出 */
+  int tableIntervalMs = 100;  /**< PAT/PMT重复间隔(毫秒)，IDR帧前总是插入 */
+  int pcrIntervalMs = 40;     /**< PCR最大间隔(毫秒) */
+  int muxDelayMs = 100;       /**< PTS/DTS相对PCR的提前量(毫秒)，即接收端缓冲时间 */
+};
+
+/**
+ * @brief MPEG-TS封装统计
+ */
+struct TsMuxerStats {
+  uint64_t frames = 0;    /**< 已封装的帧数 */
+  uint64_t packets = 0;   /**< 已生成的TS包数 */
+  uint64_t datagrams = 0; /**< 已输出的数据报数 */
+  uint64_t batches = 0;   /**< 调用输出回调的次数 */
+  uint64_t pcrs = 0;      /**< 插入的PCR数 */
+  uint64_t tables = 0;    /**< 插入PAT/PMT的次数 */
+};
+
+/**
+ * @class TsMuxer
+ * @brief MPEG-TS封装类
+ *
+ * 输出缓冲区在构造时一次性分配，封装过程不分配内存。每帧封装完成后，
+ * 连同最后一个不满的数据报一起交给输出回调，不把帧的尾部留到下一帧，
+ * 因此每帧通常只需一次批量发送(sendmmsg)或一次文件写入
+ */
+class TsMuxer : public NonCopyable {
+ public:
+  /**
+   * @brief 输出回调：datagrams为count个数据报，在内存中连续存放，只在回调期间有效
+   */
+  using Sink = std::function<void(const Buffer* datagrams, int count)>;
+
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   * @param sink 输出回调
+   * @throws CameraToolkitException 参数无效时抛出
+   */
+  TsMuxer(const TsMuxerParams& params, Sink sink);
+
+  /**
+   * @brief 析构函数
+   */
+  ~TsMuxer();
+
+  /**
+   * @brief 封装一个访问单元并输出
+   * @param frame 编码帧(Annex-B格式，使用buffer、ptsUs、dtsUs)；只含SPS/PPS的头信息
+   *              暂存并放在下一帧的PES中
+   */
+  void write(const EncodedFrame& frame);
+
+  /**
+   * @brief 获取封装统计
+   * @return 统计信息
+   */
+  TsMuxerStats getStats() const;
+
+  /**
+   * @brief 获取当前配置参数
+   * @return 配置参数引用
+   */
+  const TsMuxerParams& getParams() const;
+
+ private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl_;
+};
+
+}  // namespace camera_toolkit
@@ -0,0 +1,123 @@
+/**
+ * @file alpha_blend.cpp
+ * @brief 定点预乘Alpha混合实现
+ */
+#include "alpha_blend.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace camera_toolkit {
+
+namespace {
+
+/**
+ * @brief 合成一行像素的标量实现
+ */
+void alphaBlendRowScalar(uint8_t* dst, const uint8_t* inv, const uint8_t* premul, int n) {
+  for (int x = 0; x < n; x++) {
+    dst[x] = static_cast<uint8_t>(premul[x] + div255(static_cast<uint32_t>(dst[x]) * inv[x]));
+  }
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief 对16位乘积做 round(t / 255)
+ */
+inline __m128i div255Epi16(__m128i t) {
+  t = _mm_add_epi16(t, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/**
+ * @brief 合成一行像素(SSE2，每次16像素)
+ */
+void alphaBlendRowSse2(uint8_t* dst, const uint8_t* inv, const uint8_t* premul, int n) {
+  const __m128i zero = _mm_setzero_si128();
+  int x = 0;
+  for (; x + 16 <= n; x += 16) {
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(inv + x));
+    __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(premul + x));
+    __m128i lo = div255Epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(a, zero)));
+    __m128i hi = div255Epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(a, zero)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_adds_epu8(_mm_packus_epi16(lo, hi), p));
+  }
+  alphaBlendRowScalar(dst + x, inv + x, premul + x, n - x);
+}
+
+/**
+ * @brief 对16位乘积做 round(t / 255)(AVX2)
+ */
+__attribute__((target("avx2"))) inline __m256i div255Epi16Avx2(__m256i t) {
+  t = _mm256_add_epi16(t, _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+/**
+ * @brief 合成一行像素(AVX2，每次32像素)
+ *
+ * unpack与packus都在128位通道内进行，两者配对使用时像素顺序保持不变
+ */
+__attribute__((target("avx2"))) void alphaBlendRowAvx2(uint8_t* dst, const uint8_t* inv, const uint8_t* premul,
+                                                       int n) {
+  const __m256i zero = _mm256_setzero_si256();
+  int x = 0;
+  for (; x + 32 <= n; x += 32) {
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + x));
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inv + x));
+    __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(premul + x));
+    __m256i lo = div255Epi16Avx2(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(a, zero)));
+    __m256i hi = div255Epi16Avx2(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(a, zero)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), p));
+  }
+  alphaBlendRowSse2(dst + x, inv + x, premul + x, n - x);
+}
+#elif defined(__ARM_NEON)
+/**
+ * @brief 合成一行像素(NEON，每次16像素)
+ *
+ * vraddhn(t, vrshr(t, 8)) 即 (t + ((t + 128) >> 8) + 128) >> 8，与标量除法一致
+ */
+void alphaBlendRowNeon(uint8_t* dst, const uint8_t* inv, const uint8_t* premul, int n) {
+  int x = 0;
+  for (; x + 16 <= n; x += 16) {
+    uint8x16_t d = vld1q_u8(dst + x);
+    uint8x16_t a = vld1q_u8(inv + x);
+    uint16x8_t lo = vmull_u8(vget_low_u8(d), vget_low_u8(a));
+    uint16x8_t hi = vmull_u8(vget_high_u8(d), vget_high_u8(a));
+    uint8x16_t q = vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)), vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+    vst1q_u8(dst + x, vqaddq_u8(q, vld1q_u8(premul + x)));
+  }
+  alphaBlendRowScalar(dst + x, inv + x, premul + x, n - x);
+}
+#endif
+
+using AlphaBlendRowFn = void (*)(uint8_t*, const uint8_t*, const uint8_t*, int); /**< 行合成函数类型 */
+
+/**
+ * @brief 按CPU特性选择行合成实现
+ * @return 行合成函数
+ */
+AlphaBlendRowFn selectAlphaBlendRow() {
+#if defined(__SSE2__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") ? alphaBlendRowAvx2 : alphaBlendRowSse2;
+#elif defined(__ARM_NEON)
+  return alphaBlendRowNeon;
+#else
+  return alphaBlendRowScalar;
+#endif
+}
+
+}  // anonymous namespace
+
+void alphaBlendRow(uint8_t* dst, const uint8_t* inv, const uint8_t* premul, int n) {
+  static const AlphaBlendRowFn impl = selectAlphaBlendRow();
+  impl(dst, inv, premul, n);
+}
+
+}  // namespace camera_toolkit
@@ -0,0 +1,35 @@
+/**
+ * @file alpha_blend.h
+ * @brief 定点预乘Alpha混合
+ *
+ * 仅供库内部源文件使用，不对外暴露。
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace camera_toolkit {
+
+/**
+ * @brief 按预乘Alpha合成一行像素: dst = premul + dst * inv / 255
+ * @param dst 目标像素
+ * @param inv 反Alpha(255 - alpha)
+ * @param premul 预乘后的颜色(color * alpha / 255)
+ * @param n 像素数
+ *
+ * @note 除以255采用精确舍入的移位形式，结果与浮点四舍五入一致且不会溢出；
+ *       按CPU特性选择AVX2/SSE2/NEON实现
+ */
+void alphaBlendRow(uint8_t* dst, const uint8_t* inv, const uint8_t* premul, int n);
+
+/**
+ * @brief 计算 round(value / 255)
+ * @param value 被除数(0 - 65025)
+ * @return 商
+ */
+inline uint8_t div255(uint32_t value) {
+  value += 128;
+  return static_cast<uint8_t>((value + (value >> 8)) >> 8);
+}
+
+}  // namespace camera_toolkit
@@ -11,17 +11,26 @@
 #include <sys/time.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <csignal>
+#include <cstdio>
 #include <cstring>
-#include <fstream>
+#include <ctime>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log.h"
 
 namespace {
 
-std::unique_ptr<std::ofstream> outFile; /**< 输出文件 */
-volatile sig_atomic_t quit = 0;         /**< 退出标志 */
-bool debug = false;                     /**< 调试模式标志 */
+volatile sig_atomic_t quit = 0;   /**< 退出标志 */
+std::atomic<int> eventRequest{0}; /**< 事件录像请求：最低位0为SIGUSR1开始、1为SIGUSR2停止，其余位为请求序号 */
+bool debug = false;               /**< 调试模式标志 */
 
 /**
  * @brief 信号处理函数
@@ -29,6 +38,15 @@ bool debug = false;                     /**< 调试模式标志 */
  */
 void signalHandler(int /*sig*/) { quit = 1; }
 
+/**
+ * @brief 事件录像信号处理函数，递增请求序号，每路流各自记录已处理的序号
+ * @param sig SIGUSR1或SIGUSR2
+ */
+void eventHandler(int sig) {
+  const int sequence = (eventRequest.load() >> 1) + 1;
+  eventRequest.store(sequence << 1 | (sig == SIGUSR2 ? 1 : 0));
+}
+
 /**
  * @brief 显示使用帮助
  */
@@ -44,7 +62,13 @@ void displayUsage() {
             << "    7: capture + convert + encode + pack\n"
             << "    15: capture + convert + encode + pack + network\n"
             << "-i video device (\"/dev/video0\")\n"
-            << "-o dump to file (no dump)\n"
+            << "-o dump to file, written by a background thread (no dump)\n"
+            << "-D write the dump file with O_DIRECT (off)\n"
+            << "-R record fragmented MP4 segments into directory, rotated every minute on a keyframe (off)\n"
+            << "-X pack as MPEG-TS instead of RTP, 7 TS packets per datagram, sent with sendmmsg (off, ignores -k)\n"
+            << "-E with -R, record only on events: keep N seconds before the event in memory, start on SIGUSR1,\n"
+            << "   stop on SIGUSR2 (off)\n"
+            << "-H serve fragmented MP4 over HTTP on [address:]port at /live.mp4 for browsers (off)\n"
             << "-a IP address of stream server (none)\n"
             << "-p port of stream server (none)\n"
             << "-c capture pixel format 0:YUYV, 1:YUV420 (YUYV)\n"
@@ -53,7 +77,24 @@ void displayUsage() {
             << "-r bitrate kbps (1000)\n"
             << "-f fps (15)\n"
             << "-t chroma interleaved (0)\n"
-            << "-g size of group of pictures (12)\n";
+            << "-g size of group of pictures (12)\n"
+            << "-j encoder threads, 0 for one per core (0; with -C the cores are divided among the streams)\n"
+            << "-k paced transmission via kernel SO_TXTIME, needs fq on the egress interface (off)\n"
+            << "-b adaptive bitrate from RTCP receiver reports, -r is the ceiling (off)\n"
+            << "-m milliseconds in timestamp overlay (off)\n"
+            << "-n camera name for the {camera} OSD field (none)\n"
+            << "-O OSD region template, fields {time} {fps} {kbps} {camera}; repeat for up to\n"
+            << "   4 regions placed top-left, top-right, bottom-left, bottom-right (timestamp only)\n"
+            << "-M privacy mask rectangle \"x,y,w,h\", repeatable (none)\n"
+            << "-P pixelate privacy masks instead of filling them black (off)\n"
+            << "-F draw timestamp/OSD during conversion, 16-line slices (off, ignored with -M)\n"
+            << "-l print per-stage latency histograms every N seconds (off)\n"
+            << "-T write a Chrome/Perfetto trace of pipeline activity to file on exit (off)\n"
+            << "-e serve Prometheus metrics on [address:]port, address defaults to 127.0.0.1 (off)\n"
+            << "-W run frame conversion of all streams on a shared pool of N worker threads, 0 for one per core (off)\n"
+            << "-A with -W, pin worker i to core i (off)\n"
+            << "-C run every [stream NAME] of an INI config file in this process, one thread each; other\n"
+            << "   options are defaults for all streams (off)\n";
 }
 
 /**
@@ -85,143 +126,440 @@ char picTypeToChar(camera_toolkit::PictureType type) {
   }
 }
 
-}  // anonymous namespace
+/**
+ * @brief 单路流的选项，命令行和配置文件的[stream NAME]节都解析到这里
+ */
+struct StreamOptions {
+  std::string name; /**< 流名称(配置文件的节名)，用于日志前缀和指标的stream标签，单路运行时为空 */
+
+  camera_toolkit::CaptureParams capParams;          /**< 采集参数 */
+  camera_toolkit::ConvertParams cvtParams;          /**< 转换参数 */
+  camera_toolkit::EncoderParams encParams;          /**< 编码参数 */
+  camera_toolkit::RTPPackerParams pacParams;        /**< RTP打包参数 */
+  camera_toolkit::TsMuxerParams tsParams;           /**< MPEG-TS封装参数 */
+  camera_toolkit::NetworkParams netParams;          /**< 网络参数 */
+  camera_toolkit::PacerParams pcrParams;            /**< 定时发送参数 */
+  camera_toolkit::CongestionControlParams ccParams; /**< 拥塞控制参数 */
+  camera_toolkit::TimestampParams tmsParams;        /**< 时间戳叠加参数 */
+  camera_toolkit::OsdParams osdParams;              /**< OSD参数 */
+  camera_toolkit::PrivacyMaskParams pmkParams;      /**< 隐私遮挡参数 */
+  camera_toolkit::StreamServerParams httpParams;    /**< HTTP直播参数 */
+  camera_toolkit::FileWriterParams writerParams;    /**< 输出文件写入参数 */
+
+  bool mpegTs = false;         /**< 以MPEG-TS代替RTP打包 */
+  bool paced = false;          /**< 定时发送 */
+  bool adaptive = false;       /**< 按RTCP接收者报告调整码率 */
+  bool fused = false;          /**< 在转换中绘制时间戳/OSD */
+  bool httpEnabled = false;    /**< 启用HTTP直播 */
+  int latencyInterval = 0;     /**< 时延直方图输出间隔(秒)，0表示不输出 */
+  int stage = 0b00000011;      /**< 流水线阶段掩码 */
+  std::string outFilename;     /**< 输出文件 */
+  std::string recordDirectory; /**< 录像目录 */
+  int preEventSeconds = 0;     /**< 事件前保留时长(秒) */
+
+  /**
+   * @brief 构造函数，设置默认参数
+   */
+  StreamOptions() {
+    capParams.deviceName = "/dev/video0";
+    capParams.width = 640;
+    capParams.height = 480;
+    capParams.pixelFormat = camera_toolkit::PixelFormat::YUYV;
+    capParams.frameRate = 15;
+
+    cvtParams.inWidth = 640;
+    cvtParams.inHeight = 480;
+    cvtParams.inPixelFormat = camera_toolkit::PixelFormat::YUYV;
+    cvtParams.outWidth = 640;
+    cvtParams.outHeight = 480;
+    cvtParams.outPixelFormat = camera_toolkit::PixelFormat::YUV420;
+
+    encParams.srcWidth = 640;
+    encParams.srcHeight = 480;
+    encParams.encWidth = 640;
+    encParams.encHeight = 480;
+    encParams.chromaInterleave = false;
+    encParams.fps = 15;
+    encParams.gop = 12;
+    encParams.bitrate = 1000;
+
+    pacParams.maxPacketLength = 1400;
+    pacParams.ssrc = 1234;
+
+    netParams.type = camera_toolkit::NetworkType::UDP;
+    netParams.serverIP = "";
+    netParams.serverPort = -1;
+
+    pcrParams.bitrate = 1000;
+    pcrParams.fps = 15;
+
+    tmsParams.startX = 10;
+    tmsParams.startY = 10;
+    tmsParams.videoWidth = 640;
+    tmsParams.factor = 0;
+
+    osdParams.videoWidth = 640;
+    osdParams.videoHeight = 480;
+
+    pmkParams.videoWidth = 640;
+    pmkParams.videoHeight = 480;
+
+    // 两个缓冲区可容纳约两帧1080p YUYV，另两个吸收磁盘抖动
+    writerParams.bufferSize = 8 << 20;
+    writerParams.bufferCount = 4;
+  }
+};
 
 /**
- * @brief 主函数
- * @param argc 命令行参数数量
- * @param argv 命令行参数数组
- * @return 成功返回0，失败返回-1
+ * @brief 进程级选项，只能出现在命令行或配置文件的[global]节
  */
-int main(int argc, char* argv[]) {
-  // 默认参数
-  camera_toolkit::CaptureParams capParams;
-  capParams.deviceName = "/dev/video0";
-  capParams.width = 640;
-  capParams.height = 480;
-  capParams.pixelFormat = camera_toolkit::PixelFormat::YUYV;
-  capParams.frameRate = 15;
-
-  camera_toolkit::ConvertParams cvtParams;
-  cvtParams.inWidth = 640;
-  cvtParams.inHeight = 480;
-  cvtParams.inPixelFormat = camera_toolkit::PixelFormat::YUYV;
-  cvtParams.outWidth = 640;
-  cvtParams.outHeight = 480;
-  cvtParams.outPixelFormat = camera_toolkit::PixelFormat::YUV420;
-
-  camera_toolkit::EncoderParams encParams;
-  encParams.srcWidth = 640;
-  encParams.srcHeight = 480;
-  encParams.encWidth = 640;
-  encParams.encHeight = 480;
-  encParams.chromaInterleave = false;
-  encParams.fps = 15;
-  encParams.gop = 12;
-  encParams.bitrate = 1000;
-
-  camera_toolkit::RTPPackerParams pacParams;
-  pacParams.maxPacketLength = 1400;
-  pacParams.ssrc = 1234;
-
-  camera_toolkit::NetworkParams netParams;
-  netParams.type = camera_toolkit::NetworkType::UDP;
-  netParams.serverIP = "";
-  netParams.serverPort = -1;
-
-  camera_toolkit::TimestampParams tmsParams;
-  tmsParams.startX = 10;
-  tmsParams.startY = 10;
-  tmsParams.videoWidth = 640;
-  tmsParams.factor = 0;
-
-  int stage = 0b00000011;
-  std::string outFilename;
+struct GlobalOptions {
+  std::string traceFilename;                           /**< 跟踪输出文件 */
+  camera_toolkit::MetricsServerParams metricsParams;   /**< 指标端点参数 */
+  bool metricsEnabled = false;                         /**< 启用指标端点 */
+  camera_toolkit::TaskSchedulerParams schedulerParams; /**< 共享工作线程池参数 */
+  bool schedulerEnabled = false;                       /**< 启用共享工作线程池 */
+};
 
-  // 解析命令行选项
-  static const char* optString = "?vdi:o:a:p:w:h:r:f:t:g:s:c:";
-  int opt;
+/**
+ * @brief 配置文件键与命令行选项的对应关系
+ */
+struct ConfigKey {
+  const char* key; /**< 配置文件中的键 */
+  char opt;        /**< 对应的命令行选项 */
+  bool flag;       /**< 是否为开关选项(取值true/false) */
+};
 
-  while ((opt = getopt(argc, argv, optString)) != -1) {
-    switch (opt) {
-      case '?':
-        displayUsage();
-        return 0;
-      case 'v':
-        displayVersion();
-        return 0;
-      case 'd':
-        debug = true;
-        break;
-      case 's':
-        stage = std::stoi(optarg);
-        break;
-      case 'i':
-        capParams.deviceName = optarg;
-        break;
-      case 'o':
-        outFilename = optarg;
-        break;
-      case 'a':
-        netParams.serverIP = optarg;
-        break;
-      case 'p':
-        netParams.serverPort = std::stoi(optarg);
-        break;
-      case 'c': {
-        int fmt = std::stoi(optarg);
-        if (fmt == 1) {
-          capParams.pixelFormat = camera_toolkit::PixelFormat::YUV420;
-        } else {
-          capParams.pixelFormat = camera_toolkit::PixelFormat::YUYV;
-        }
-        break;
+const ConfigKey CONFIG_KEYS[] = {
+    {"stage", 's', false},
+    {"device", 'i', false},
+    {"output", 'o', false},
+    {"direct_io", 'D', true},
+    {"record", 'R', false},
+    {"mpeg_ts", 'X', true},
+    {"pre_event", 'E', false},
+    {"http", 'H', false},
+    {"address", 'a', false},
+    {"port", 'p', false},
+    {"format", 'c', false},
+    {"width", 'w', false},
+    {"height", 'h', false},
+    {"bitrate", 'r', false},
+    {"fps", 'f', false},
+    {"chroma_interleave", 't', false},
+    {"gop", 'g', false},
+    {"encoder_threads", 'j', false},
+    {"paced", 'k', true},
+    {"adaptive", 'b', true},
+    {"milliseconds", 'm', true},
+    {"name", 'n', false},
+    {"osd", 'O', false},
+    {"mask", 'M', false},
+    {"pixelate", 'P', true},
+    {"fused", 'F', true},
+    {"latency", 'l', false},
+    {"debug", 'd', true},
+    {"trace", 'T', false},
+    {"metrics", 'e', false},
+    {"workers", 'W', false},
+    {"pin_workers", 'A', true},
+};
+
+/**
+ * @brief 解析[address:]port形式的监听地址
+ * @param text 文本
+ * @param address 地址(未指定时不修改)
+ * @param port 端口
+ */
+void parseEndpoint(const std::string& text, std::string& address, int& port) {
+  std::string endpoint = text;
+  size_t colon = endpoint.rfind(':');
+  if (colon != std::string::npos) {
+    address = endpoint.substr(0, colon);
+    endpoint = endpoint.substr(colon + 1);
+  }
+  port = std::stoi(endpoint);
+}
+
+/**
+ * @brief 应用一个流选项
+ * @param options 流选项
+ * @param opt 选项字母
+ * @param arg 选项参数(开关选项忽略)
+ * @return 是流选项返回true
+ * @throws std::logic_error 数值无法解析时由std::stoi抛出
+ * @throws CameraToolkitException 遮挡区域格式错误时抛出
+ */
+bool applyStreamOption(StreamOptions& options, int opt, const std::string& arg) {
+  switch (opt) {
+    case 's':
+      options.stage = std::stoi(arg);
+      break;
+    case 'i':
+      options.capParams.deviceName = arg;
+      break;
+    case 'o':
+      options.outFilename = arg;
+      break;
+    case 'D':
+      options.writerParams.directIO = true;
+      break;
+    case 'R':
+      options.recordDirectory = arg;
+      break;
+    case 'X':
+      options.mpegTs = true;
+      break;
+    case 'E':
+      options.preEventSeconds = std::stoi(arg);
+      break;
+    case 'a':
+      options.netParams.serverIP = arg;
+      break;
+    case 'p':
+      options.netParams.serverPort = std::stoi(arg);
+      break;
+    case 'c':
+      if (std::stoi(arg) == 1) {
+        options.capParams.pixelFormat = camera_toolkit::PixelFormat::YUV420;
+      } else {
+        options.capParams.pixelFormat = camera_toolkit::PixelFormat::YUYV;
       }
-      case 'w': {
-        int width = std::stoi(optarg);
-        capParams.width = cvtParams.inWidth = cvtParams.outWidth = encParams.srcWidth = encParams.encWidth =
-            tmsParams.videoWidth = width;
-        break;
+      break;
+    case 'w': {
+      int width = std::stoi(arg);
+      options.capParams.width = options.cvtParams.inWidth = options.cvtParams.outWidth = options.encParams.srcWidth =
+          options.encParams.encWidth = options.tmsParams.videoWidth = options.osdParams.videoWidth =
+              options.pmkParams.videoWidth = width;
+      break;
+    }
+    case 'h': {
+      int height = std::stoi(arg);
+      options.capParams.height = options.cvtParams.inHeight = options.cvtParams.outHeight =
+          options.encParams.srcHeight = options.encParams.encHeight = options.osdParams.videoHeight =
+              options.pmkParams.videoHeight = height;
+      break;
+    }
+    case 'r':
+      options.encParams.bitrate = options.pcrParams.bitrate = std::stoi(arg);
+      break;
+    case 'f':
+      options.capParams.frameRate = options.encParams.fps = options.pcrParams.fps = std::stoi(arg);
+      break;
+    case 't':
+      options.encParams.chromaInterleave = (std::stoi(arg) != 0);
+      break;
+    case 'g':
+      options.encParams.gop = std::stoi(arg);
+      break;
+    case 'j':
+      options.encParams.threads = std::stoi(arg);
+      break;
+    case 'k':
+      options.paced = true;
+      break;
+    case 'b':
+      options.adaptive = true;
+      break;
+    case 'm':
+      options.tmsParams.milliseconds = options.osdParams.milliseconds = true;
+      break;
+    case 'n':
+      options.osdParams.cameraName = arg;
+      break;
+    case 'M': {
+      int x, y, w, h;
+      if (sscanf(arg.c_str(), "%d,%d,%d,%d", &x, &y, &w, &h) != 4) {
+        throw camera_toolkit::CameraToolkitException("Invalid privacy mask: " + arg);
       }
-      case 'h': {
-        int height = std::stoi(optarg);
-        capParams.height = cvtParams.inHeight = cvtParams.outHeight = encParams.srcHeight = encParams.encHeight =
-            height;
-        break;
+      options.pmkParams.regions.push_back(camera_toolkit::MaskRegion::rectangle(x, y, w, h));
+      break;
+    }
+    case 'P':
+      options.pmkParams.mode = camera_toolkit::MaskMode::Pixelate;
+      break;
+    case 'F':
+      options.fused = true;
+      break;
+    case 'l':
+      options.latencyInterval = std::stoi(arg);
+      break;
+    case 'H':
+      parseEndpoint(arg, options.httpParams.address, options.httpParams.port);
+      options.httpEnabled = true;
+      break;
+    case 'O':
+      if (options.osdParams.regions.size() < 4) {
+        camera_toolkit::OsdRegion region;
+        region.format = arg;
+        options.osdParams.regions.push_back(region);
+      }
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 应用一个进程级选项
+ * @param options 进程级选项
+ * @param opt 选项字母
+ * @param arg 选项参数(开关选项忽略)
+ * @return 是进程级选项返回true
+ * @throws std::logic_error 端口无法解析时由std::stoi抛出
+ */
+bool applyGlobalOption(GlobalOptions& options, int opt, const std::string& arg) {
+  switch (opt) {
+    case 'd':
+      debug = true;
+      break;
+    case 'T':
+      options.traceFilename = arg;
+      break;
+    case 'e':
+      parseEndpoint(arg, options.metricsParams.address, options.metricsParams.port);
+      options.metricsEnabled = true;
+      break;
+    case 'W':
+      options.schedulerParams.threads = std::stoi(arg);
+      options.schedulerEnabled = true;
+      break;
+    case 'A':
+      options.schedulerParams.pinThreads = true;
+      break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 把配置节中的各项应用到选项上
+ * @param config 配置文件(用于错误位置)
+ * @param section 配置节
+ * @param stream 流选项
+ * @param global 进程级选项，为nullptr时(流节中)不接受进程级的键
+ * @throws CameraToolkitException 未知的键或非法的值时抛出，消息带文件名和行号
+ */
+void applySection(const camera_toolkit::ConfigFile& config, const camera_toolkit::ConfigSection& section,
+                  StreamOptions& stream, GlobalOptions* global) {
+  for (const camera_toolkit::ConfigEntry& entry : section.entries) {
+    const ConfigKey* key = nullptr;
+    for (const ConfigKey& candidate : CONFIG_KEYS) {
+      if (entry.key == candidate.key) key = &candidate;
+    }
+    if (key == nullptr) {
+      throw camera_toolkit::CameraToolkitException(config.describe(entry.line, "unknown key: " + entry.key));
+    }
+    if (key->flag) {
+      if (entry.value == "false" || entry.value == "0") continue;
+      if (entry.value != "true" && entry.value != "1") {
+        throw camera_toolkit::CameraToolkitException(
+            config.describe(entry.line, entry.key + " must be true or false: " + entry.value));
       }
-      case 'r':
-        encParams.bitrate = std::stoi(optarg);
-        break;
-      case 'f':
-        capParams.frameRate = encParams.fps = std::stoi(optarg);
-        break;
-      case 't':
-        encParams.chromaInterleave = (std::stoi(optarg) != 0);
-        break;
-      case 'g':
-        encParams.gop = std::stoi(optarg);
-        break;
-      default:
-        std::cerr << "Unknown option: " << optarg << std::endl;
-        displayUsage();
-        return -1;
+    }
+    bool applied;
+    try {
+      applied = applyStreamOption(stream, key->opt, entry.value) ||
+                (global != nullptr && applyGlobalOption(*global, key->opt, entry.value));
+    } catch (const std::logic_error&) {
+      throw camera_toolkit::CameraToolkitException(
+          config.describe(entry.line, "invalid value for " + entry.key + ": " + entry.value));
+    } catch (const camera_toolkit::CameraToolkitException& e) {
+      throw camera_toolkit::CameraToolkitException(config.describe(entry.line, e.what()));
+    }
+    if (!applied) {
+      throw camera_toolkit::CameraToolkitException(
+          config.describe(entry.line, entry.key + " is only allowed in [global]"));
     }
   }
+}
 
-  // 打开输出文件(如果指定)
-  if (!outFilename.empty()) {
-    outFile = std::make_unique<std::ofstream>(outFilename, std::ios::binary);
-    if (!outFile->is_open()) {
-      std::cerr << "--- Failed to open output file: " << outFilename << std::endl;
-      return -1;
+/**
+ * @brief 读取多路流配置文件
+ *
+ * [global]节中的流选项作为所有流的默认值，每个[stream NAME]节在此基础上生成一路流，
+ * 节名同时作为OSD的{camera}字段默认值
+ * @param path 配置文件路径
+ * @param defaults 命令行给出的流选项默认值
+ * @param global 进程级选项
+ * @return 各路流的选项
+ * @throws CameraToolkitException 配置文件无法读取或内容非法时抛出
+ */
+std::vector<StreamOptions> loadStreams(const std::string& path, const StreamOptions& defaults,
+                                       GlobalOptions& global) {
+  const camera_toolkit::ConfigFile config = camera_toolkit::ConfigFile::load(path);
+  StreamOptions base = defaults;
+  for (const camera_toolkit::ConfigSection& section : config.getSections()) {
+    if (section.type == "global") {
+      applySection(config, section, base, &global);
+    } else if (section.type != "stream" || section.name.empty()) {
+      throw camera_toolkit::CameraToolkitException(
+          config.describe(section.line, "expected [global] or [stream NAME], got [" + section.type + "]"));
     }
   }
 
-  // 设置信号处理
-  signal(SIGINT, signalHandler);
+  std::vector<StreamOptions> streams;
+  for (const camera_toolkit::ConfigSection* section : config.getSections("stream")) {
+    StreamOptions stream = base;
+    stream.name = section->name;
+    if (stream.osdParams.cameraName.empty()) stream.osdParams.cameraName = section->name;
+    applySection(config, *section, stream, nullptr);
+    streams.push_back(stream);
+  }
+  if (streams.empty()) {
+    throw camera_toolkit::CameraToolkitException(path + ": no [stream NAME] sections");
+  }
+  return streams;
+}
 
-  // 打印版本信息
-  displayVersion();
+/**
+ * @brief 运行一路流的采集、转换、编码和输出流水线，直到收到退出信号
+ * @param options 流选项
+ * @param metrics 指标注册表(多路流共用，以stream标签区分)
+ * @param metricsEnabled 是否需要每秒更新仪表
+ * @return 成功返回0，失败返回-1
+ */
+int runStream(StreamOptions& options, camera_toolkit::MetricsRegistry& metrics, bool metricsEnabled) {
+  auto& capParams = options.capParams;
+  auto& cvtParams = options.cvtParams;
+  auto& encParams = options.encParams;
+  auto& pacParams = options.pacParams;
+  auto& tsParams = options.tsParams;
+  auto& netParams = options.netParams;
+  auto& pcrParams = options.pcrParams;
+  auto& ccParams = options.ccParams;
+  auto& tmsParams = options.tmsParams;
+  auto& osdParams = options.osdParams;
+  auto& pmkParams = options.pmkParams;
+  auto& httpParams = options.httpParams;
+  auto& writerParams = options.writerParams;
+  const bool mpegTs = options.mpegTs;
+  const bool paced = options.paced;
+  const bool adaptive = options.adaptive;
+  const bool httpEnabled = options.httpEnabled;
+  const int latencyInterval = options.latencyInterval;
+  const int stage = options.stage;
+  const int preEventSeconds = options.preEventSeconds;
+  bool fused = options.fused;
+  const std::string& outFilename = options.outFilename;
+  const std::string& recordDirectory = options.recordDirectory;
+  // 多路运行时消息以流名称开头
+  const std::string tag = options.name.empty() ? std::string() : "[" + options.name + "] ";
+
+  std::unique_ptr<camera_toolkit::AsyncFileWriter> outFile;
+
+  // 打开输出文件(如果指定)，写盘在后台线程进行，慢速磁盘不阻塞采集
+  if (!outFilename.empty()) {
+    writerParams.path = outFilename;
+    try {
+      outFile = std::make_unique<camera_toolkit::AsyncFileWriter>(writerParams);
+    } catch (const camera_toolkit::CameraToolkitException& e) {
+      std::cerr << "--- " << tag << e.what() << std::endl;
+      return -1;
+    }
+  }
 
   try {
     // 创建组件
@@ -230,11 +568,28 @@ int main(int argc, char* argv[]) {
     std::unique_ptr<camera_toolkit::Convert> convert;
     std::unique_ptr<camera_toolkit::Encoder> encoder;
     std::unique_ptr<camera_toolkit::RTPPacker> packer;
+    std::unique_ptr<camera_toolkit::TsMuxer> tsMuxer;
     std::unique_ptr<camera_toolkit::Network> network;
+    std::unique_ptr<camera_toolkit::Pacer> pacer;
+    std::unique_ptr<camera_toolkit::CongestionController> congestion;
     std::unique_ptr<camera_toolkit::Timestamp> timestamp;
+    std::unique_ptr<camera_toolkit::Osd> osd;
+    std::unique_ptr<camera_toolkit::PrivacyMask> privacyMask;
+    std::unique_ptr<camera_toolkit::LatencyTracer> latency;
+    std::unique_ptr<camera_toolkit::Recorder> videoRecorder;
+    std::unique_ptr<camera_toolkit::PreEventBuffer> preEvent;
+    std::unique_ptr<camera_toolkit::StreamServer> httpServer;
+
+    if (latencyInterval > 0) {
+      latency = std::make_unique<camera_toolkit::LatencyTracer>();
+    }
+
+    // 遮挡须先于文字绘制，启用遮挡时仍在转换后整帧处理
+    fused = fused && pmkParams.regions.empty() && capParams.pixelFormat != camera_toolkit::PixelFormat::YUV420;
 
     if ((stage & 0b00000001) != 0) {
       cvtParams.inPixelFormat = capParams.pixelFormat;
+      if (fused) cvtParams.sliceHeight = 16;
       convert = std::make_unique<camera_toolkit::Convert>(cvtParams);
     }
 
@@ -242,30 +597,207 @@ int main(int argc, char* argv[]) {
       encoder = std::make_unique<camera_toolkit::Encoder>(encParams);
     }
 
-    if ((stage & 0b00000100) != 0) {
+    if (!recordDirectory.empty()) {
+      if ((stage & 0b00000010) == 0) {
+        std::cerr << "--- " << tag << "Recording requires the encode stage" << std::endl;
+        return -1;
+      }
+      // 文件名前缀为启动时间，多次运行的录像不会互相覆盖
+      char prefix[32];
+      time_t now = time(nullptr);
+      struct tm local{};
+      localtime_r(&now, &local);
+      strftime(prefix, sizeof(prefix), "%Y%m%d-%H%M%S", &local);
+
+      camera_toolkit::RecorderParams recParams;
+      recParams.directory = recordDirectory;
+      recParams.prefix = prefix;
+      recParams.width = encParams.encWidth;
+      recParams.height = encParams.encHeight;
+      recParams.fps = encParams.fps;
+      recParams.directIO = writerParams.directIO;
+      videoRecorder = std::make_unique<camera_toolkit::Recorder>(recParams);
+
+      if (preEventSeconds > 0) {
+        // 按码率上限留出保留时长加一个GOP的两倍空间，输出追赶期间旧帧仍被引用
+        const int64_t seconds = preEventSeconds + encParams.gop / std::max(encParams.fps, 1) + 1;
+        camera_toolkit::PreEventBufferParams preParams;
+        preParams.durationMs = preEventSeconds * 1000;
+        preParams.poolBytes = static_cast<size_t>(std::max<int64_t>(encParams.bitrate * 125 * seconds * 2, 4 << 20));
+        preParams.maxFrames = static_cast<int>(encParams.fps * seconds * 2);
+        preEvent = std::make_unique<camera_toolkit::PreEventBuffer>(preParams);
+      }
+    }
+
+    if (httpEnabled) {
+      if ((stage & 0b00000010) == 0) {
+        std::cerr << "--- " << tag << "HTTP streaming requires the encode stage" << std::endl;
+        return -1;
+      }
+      httpParams.width = encParams.encWidth;
+      httpParams.height = encParams.encHeight;
+      httpParams.fps = encParams.fps;
+      httpServer = std::make_unique<camera_toolkit::StreamServer>(httpParams);
+    }
+
+    if ((stage & 0b00000100) != 0 && !mpegTs) {
       packer = std::make_unique<camera_toolkit::RTPPacker>(pacParams);
     }
 
     if ((stage & 0b00001000) != 0) {
       if (netParams.serverIP.empty() || netParams.serverPort == -1) {
-        std::cerr << "--- Server IP and port must be specified when using network" << std::endl;
+        std::cerr << "--- " << tag << "Server IP and port must be specified when using network" << std::endl;
         return -1;
       }
+      netParams.txTime = paced && !mpegTs;  // TS按数据报批量发送，不做平滑
+      if (adaptive) {
+        netParams.receiveTimeoutMs = 200;  // 让RTCP接收线程能定期检查退出标志
+      }
       network = std::make_unique<camera_toolkit::Network>(netParams);
+      // 用户态定时会在采集编码线程上睡眠，拖慢整条流水线，因此只在内核负责定时时平滑发送
+      if (netParams.txTime && network->isKernelPacing()) {
+        pacer = std::make_unique<camera_toolkit::Pacer>(pcrParams);
+      } else if (netParams.txTime) {
+        std::cerr << "--- " << tag << "Kernel pacing unavailable (needs fq qdisc), sending unpaced" << std::endl;
+      }
+      if (adaptive) {
+        ccParams.startBitrate = ccParams.maxBitrate = encParams.bitrate;
+        ccParams.minBitrate = std::max(encParams.bitrate / 10, 1);
+        congestion = std::make_unique<camera_toolkit::CongestionController>(ccParams);
+      }
+    }
+
+    if (!pmkParams.regions.empty()) {
+      privacyMask = std::make_unique<camera_toolkit::PrivacyMask>(pmkParams);
+    }
+
+    if (osdParams.regions.empty()) {
+      timestamp = std::make_unique<camera_toolkit::Timestamp>(tmsParams);
+    } else {
+      // 区域依次放在四个角上，右侧区域右对齐，底部区域向上展开
+      for (size_t i = 0; i < osdParams.regions.size(); i++) {
+        osdParams.regions[i].x = (i % 2 == 0) ? 10 : osdParams.videoWidth - 10;
+        osdParams.regions[i].y = (i < 2) ? 10 : osdParams.videoHeight - 18;
+      }
+      osd = std::make_unique<camera_toolkit::Osd>(osdParams);
+    }
+
+    // 融合绘制: 转换器每输出一批行就在这些行上绘制文字，避免再遍历一次整帧
+    int64_t frameTimeUs = 0;
+    if (fused && convert) {
+      convert->setRowCallback([&](const camera_toolkit::FrameView& frame, int firstRow, int lastRow) {
+        if (osd) {
+          osd->draw(frame, frameTimeUs, firstRow, lastRow);
+        } else {
+          timestamp->draw(frame, frameTimeUs, firstRow, lastRow);
+        }
+      });
     }
 
-    timestamp = std::make_unique<camera_toolkit::Timestamp>(tmsParams);
+    // 运行指标: 流水线只做原子更新，抓取在MetricsServer线程中进行；多路流以stream标签区分
+    camera_toolkit::MetricLabels labels;
+    if (!options.name.empty()) labels.emplace_back("stream", options.name);
+    auto& framesCaptured =
+        metrics.counter("camera_toolkit_frames_captured_total", "Frames dequeued from the camera", 1.0, labels);
+    auto& framesDropped = metrics.counter("camera_toolkit_frames_dropped_total",
+                                          "Frames dropped by the driver (V4L2 sequence gaps)", 1.0, labels);
+    auto& framesDiscarded = metrics.counter("camera_toolkit_frames_discarded_total",
+                                            "Frames discarded after a convert or encode failure", 1.0, labels);
+    auto& framesEncoded = metrics.counter("camera_toolkit_frames_encoded_total", "Frames encoded", 1.0, labels);
+    auto& encodeTime =
+        metrics.counter("camera_toolkit_encode_seconds_total", "Time spent in the encoder", 1e-9, labels);
+    auto& encodedBytes = metrics.counter("camera_toolkit_encoded_bytes_total", "Encoded bitstream bytes", 1.0, labels);
+    auto& packetsSent = metrics.counter("camera_toolkit_packets_sent_total", "RTP packets sent", 1.0, labels);
+    auto& sendErrors = metrics.counter("camera_toolkit_send_errors_total", "Failed or short packet sends", 1.0, labels);
+    auto& fpsGauge = metrics.gauge("camera_toolkit_fps", "Captured frames per second over the last second", labels);
+    auto& bitrateGauge = metrics.gauge("camera_toolkit_bitrate_kbps", "Encoded bitrate over the last second", labels);
+    auto& targetBitrate =
+        metrics.gauge("camera_toolkit_target_bitrate_kbps", "Current encoder bitrate setting", labels);
+    auto& socketQueue =
+        metrics.gauge("camera_toolkit_socket_queued_bytes", "Bytes queued in the socket send buffer", labels);
+    auto& writerQueue =
+        metrics.gauge("camera_toolkit_writer_queued_bytes", "Bytes waiting for the dump file writer", labels);
+    targetBitrate.set(encParams.bitrate);
+
+    auto countSend = [&](int ret, int size) { (ret == size ? packetsSent : sendErrors).add(); };
+
+    // MPEG-TS: 每帧的数据报一次写入文件，或用一次sendmmsg发出
+    if ((stage & 0b00000100) != 0 && mpegTs) {
+      tsMuxer = std::make_unique<camera_toolkit::TsMuxer>(
+          tsParams, [&](const camera_toolkit::Buffer* datagrams, int count) {
+            if (!network) {
+              // 数据报在内存中连续存放
+              if (outFile) {
+                int size = 0;
+                for (int i = 0; i < count; i++) size += datagrams[i].size;
+                outFile->write(datagrams[0].data, size);
+              }
+              return;
+            }
+            int sent = network->sendBatch(datagrams, count);
+            for (int i = 0; i < count; i++) countSend(i < sent ? datagrams[i].size : -1, datagrams[i].size);
+            if (sent != count) {
+              camera_toolkit::log::warn(tag + "send failed, " + std::to_string(sent) + "/" + std::to_string(count) +
+                                        " datagrams, err: " + strerror(errno));
+            }
+            if (debug) std::cout << '>' << std::flush;
+          });
+    }
+    uint64_t driverDrops = 0;
 
     // 开始采集循环
     capture->start();
 
+    // RTCP接收线程：服务器在同一UDP端口回送接收者报告(RTP/RTCP复用)
+    std::atomic<bool> rtcpQuit{false};
+    std::thread rtcpThread;
+    if (congestion) {
+      rtcpThread = std::thread([&] {
+        uint8_t rtcp[1500];
+        while (!rtcpQuit) {
+          int n = network->receive(rtcp, sizeof(rtcp));
+          camera_toolkit::ReceiverReport rr;
+          if (n > 0 && camera_toolkit::CongestionController::parseReceiverReport(rtcp, n, pacParams.ssrc, &rr)) {
+            struct timespec now{};
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            congestion->onReceiverReport(rr, static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000);
+          }
+        }
+      });
+    }
+    // 任何退出路径(包括异常)都先停止线程，再销毁其引用的network
+    struct ThreadJoiner {
+      std::atomic<bool>& quit;
+      std::thread& thread;
+      ~ThreadJoiner() {
+        quit = true;
+        if (thread.joinable()) thread.join();
+      }
+    } rtcpJoiner{rtcpQuit, rtcpThread};
+    int currentBitrate = encParams.bitrate;
+
     struct timeval currentTime, lastTime;
     unsigned long fpsCounter = 0;
+    unsigned long frameCounter = 0;
+    uint64_t byteCounter = 0;
     gettimeofday(&lastTime, nullptr);
 
+    // 每帧的跟踪记录在本轮循环结束(包括提前continue)时汇总到直方图
+    camera_toolkit::FrameTrace trace;
+    struct TraceRecorder {
+      camera_toolkit::LatencyTracer* tracer;
+      camera_toolkit::FrameTrace& trace;
+      ~TraceRecorder() {
+        if (tracer) tracer->record(trace);
+      }
+    };
+    int handledEvent = eventRequest;
+    struct timespec lastDump{};
+    clock_gettime(CLOCK_MONOTONIC, &lastDump);
+
     while (!quit) {
-      // FPS计算
-      if (debug) {
+      // FPS计算，OSD的{fps}/{kbps}字段同样每秒更新一次
+      if (debug || osd || metricsEnabled) {
         gettimeofday(&currentTime, nullptr);
         int sec = currentTime.tv_sec - lastTime.tv_sec;
         int usec = currentTime.tv_usec - lastTime.tv_usec;
@@ -276,26 +808,83 @@ int main(int argc, char* argv[]) {
         double statTime = (sec * 1000000) + usec;
 
         if (statTime >= 1000000) {
-          std::cout << "\n*** FPS: " << fpsCounter << std::endl;
+          fpsGauge.set(frameCounter * 1000000.0 / statTime);
+          bitrateGauge.set(byteCounter * 8000.0 / statTime);
+          if (network) socketQueue.set(network->getStats().queuedBytes);
+          if (outFile) writerQueue.set(static_cast<double>(outFile->getStats().queuedBytes));
+          if (osd) {
+            camera_toolkit::OsdStats stats;
+            stats.fps = frameCounter * 1000000.0 / statTime;
+            stats.kbps = static_cast<int>(byteCounter * 8000.0 / statTime);
+            osd->update(stats);
+          }
+          if (debug) std::cout << "\n*** FPS: " << fpsCounter << std::endl;
+          if (debug && network) {
+            camera_toolkit::NetworkStats stats = network->getStats();
+            std::cout << "*** Sent: " << stats.packetsSent << " pkts / " << stats.bytesSent << " bytes, short: "
+                      << stats.shortSends << ", eagain: " << stats.wouldBlock << ", errors: " << stats.errors
+                      << ", queued: " << stats.queuedBytes << std::endl;
+          }
+          if (debug && outFile) {
+            camera_toolkit::FileWriterStats stats = outFile->getStats();
+            std::cout << "*** Written: " << stats.bytesWritten << " bytes, queued: " << stats.queuedBuffers << " bufs / "
+                      << stats.queuedBytes << " bytes (max " << stats.maxQueuedBuffers << "), stalls: " << stats.stalls
+                      << ", errors: " << stats.errors << std::endl;
+          }
           fpsCounter = 0;
+          frameCounter = 0;
+          byteCounter = 0;
           lastTime = currentTime;
         }
         fpsCounter++;
       }
 
+      // 定期输出各阶段时延直方图
+      if (latency) {
+        struct timespec now{};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec - lastDump.tv_sec >= latencyInterval) {
+          std::cout << "\n" << tag << latency->report() << std::flush;
+          latency->reset();
+          lastDump = now;
+        }
+      }
+
+      // 事件录像：缓冲的帧和之后的实时帧由后台线程写入录像文件
+      const int request = eventRequest;
+      if (request != handledEvent) {
+        handledEvent = request;
+        if ((request & 1) == 0 && preEvent && !preEvent->isDumping()) {
+          std::cout << "\n*** " << tag << "Event recording started" << std::endl;
+          preEvent->startDump([&](const camera_toolkit::EncodedFrame& f) { videoRecorder->write(f); });
+        } else if ((request & 1) != 0 && preEvent && preEvent->isDumping()) {
+          preEvent->stopDump();
+          videoRecorder->close();
+          std::cout << "\n*** " << tag << "Event recording stopped" << std::endl;
+        }
+      }
+
       // 采集
       camera_toolkit::Buffer capBuf = capture->getData();
       if (capBuf.empty()) {
         usleep(10000);
         continue;
       }
+      trace.clear();
+      trace.mark(camera_toolkit::TraceStage::Dequeue);
+      TraceRecorder recorder{latency.get(), trace};
+
+      framesCaptured.add();
+      framesDropped.add(capture->getDroppedFrames() - driverDrops);
+      driverDrops = capture->getDroppedFrames();
 
+      frameCounter++;
       if (debug) std::cout << '.' << std::flush;
 
       if ((stage & 0b00000001) == 0) {
         // 仅采集
         if (outFile) {
-          outFile->write(static_cast<char*>(capBuf.data), capBuf.size);
+          outFile->write(capBuf.data, capBuf.size);
         }
         continue;
       }
@@ -305,22 +894,35 @@ int main(int argc, char* argv[]) {
       if (capParams.pixelFormat == camera_toolkit::PixelFormat::YUV420) {
         cvtBuf = capBuf;  // 无需转换
       } else {
+        frameTimeUs = capture->getLastTimestamp();
         cvtBuf = convert->convert(capBuf);
         if (cvtBuf.empty()) {
-          std::cerr << "!!! No convert data" << std::endl;
+          camera_toolkit::log::warn(tag + "No convert data");
+          framesDiscarded.add();
           continue;
         }
+        trace.mark(camera_toolkit::TraceStage::Convert);
       }
 
       if (debug) std::cout << '-' << std::flush;
 
-      // 绘制时间戳
-      timestamp->draw(static_cast<uint8_t*>(cvtBuf.data));
+      // 隐私遮挡，然后绘制时间戳或OSD(融合模式下已在转换中绘制)
+      camera_toolkit::FrameView frame = camera_toolkit::FrameView::contiguous(
+          static_cast<uint8_t*>(cvtBuf.data), cvtParams.outWidth, cvtParams.outHeight);
+      if (privacyMask) privacyMask->apply(frame);
+      if (!fused) {
+        if (osd) {
+          osd->draw(frame, capture->getLastTimestamp());
+        } else {
+          timestamp->draw(frame, capture->getLastTimestamp());
+        }
+      }
+      trace.mark(camera_toolkit::TraceStage::Overlay);
 
       if ((stage & 0b00000010) == 0) {
         // 无编码
         if (outFile) {
-          outFile->write(static_cast<char*>(cvtBuf.data), cvtBuf.size);
+          outFile->write(cvtBuf.data, cvtBuf.size);
         }
         continue;
       }
@@ -328,14 +930,26 @@ int main(int argc, char* argv[]) {
       // 获取头信息(SPS/PPS)
       while (auto header = encoder->getHeaders()) {
         if (debug) std::cout << 'S' << std::flush;
+        if (preEvent) {
+          preEvent->push(*header);
+        } else if (videoRecorder) {
+          videoRecorder->write(*header);
+        }
+        if (httpServer) httpServer->write(*header);
 
         if ((stage & 0b00000100) == 0) {
           if (outFile) {
-            outFile->write(static_cast<char*>(header->buffer.data), header->buffer.size);
+            outFile->write(header->buffer.data, header->buffer.size);
           }
           continue;
         }
 
+        // 头信息暂存在封装器中，随下一帧输出
+        if (tsMuxer) {
+          tsMuxer->write(*header);
+          continue;
+        }
+
         // 打包头信息
         packer->put(header->buffer);
         while (auto packet = packer->get()) {
@@ -343,54 +957,107 @@ int main(int argc, char* argv[]) {
 
           if ((stage & 0b00001000) == 0) {
             if (outFile) {
-              outFile->write(static_cast<char*>(packet->data), packet->size);
+              outFile->write(packet->data, packet->size);
             }
             continue;
           }
 
           // 发送
-          int ret = network->send(*packet);
+          int ret = pacer ? network->sendAt(*packet, pacer->next(packet->size)) : network->send(*packet);
+          countSend(ret, packet->size);
           if (ret != packet->size) {
-            std::cerr << "!!! send failed, size: " << packet->size << ", err: " << strerror(errno) << std::endl;
+            camera_toolkit::log::warn(tag + "send failed, size: " + std::to_string(packet->size) +
+                                      ", err: " + strerror(errno));
           }
           if (debug) std::cout << '>' << std::flush;
         }
       }
 
+      // 按拥塞控制目标码率调整编码和发送速率
+      if (congestion && congestion->getTargetBitrate() != currentBitrate) {
+        int target = congestion->getTargetBitrate();
+        if (encoder->setBitrate(target)) {
+          currentBitrate = target;
+          targetBitrate.set(target);
+          if (pacer) pacer->setBitrate(target);
+          if (debug) std::cout << "\n*** Bitrate: " << target << " kbps" << std::endl;
+        }
+      }
+
       // 编码
+      trace.mark(camera_toolkit::TraceStage::EncodeSubmit);
       auto encoded = encoder->encode(cvtBuf);
+      trace.mark(camera_toolkit::TraceStage::EncodeReturn);
       if (encoded.empty()) {
-        std::cerr << "!!! No encode data" << std::endl;
+        camera_toolkit::log::warn(tag + "No encode data");
+        framesDiscarded.add();
         continue;
       }
 
+      framesEncoded.add();
+      encodeTime.add(trace.stamps[static_cast<int>(camera_toolkit::TraceStage::EncodeReturn)] -
+                     trace.stamps[static_cast<int>(camera_toolkit::TraceStage::EncodeSubmit)]);
+      encodedBytes.add(encoded.buffer.size);
+      byteCounter += encoded.buffer.size;
       if (debug) std::cout << picTypeToChar(encoded.type) << std::flush;
+      if (preEvent) {
+        preEvent->push(encoded);
+      } else if (videoRecorder) {
+        videoRecorder->write(encoded);
+      }
+      if (httpServer) httpServer->write(encoded);
 
       if ((stage & 0b00000100) == 0) {
         // 无打包
         if (outFile) {
-          outFile->write(static_cast<char*>(encoded.buffer.data), encoded.buffer.size);
+          outFile->write(encoded.buffer.data, encoded.buffer.size);
         }
         continue;
       }
 
       // 打包
+      if (pacer) {
+        // 发送窗口从采集时刻算起，编码耗时计入窗口；采集时间戳是墙上时间，按两个时钟的当前差值换算
+        struct timespec mono{};
+        struct timespec real{};
+        clock_gettime(CLOCK_MONOTONIC, &mono);
+        clock_gettime(CLOCK_REALTIME, &real);
+        const int64_t monoNs = static_cast<int64_t>(mono.tv_sec) * 1000000000 + mono.tv_nsec;
+        const int64_t realNs = static_cast<int64_t>(real.tv_sec) * 1000000000 + real.tv_nsec;
+        const int64_t captureUs = capture->getLastTimestamp();
+        const int64_t captureNs = captureUs > 0 ? captureUs * 1000 - (realNs - monoNs)
+                                                : trace.stamps[static_cast<int>(camera_toolkit::TraceStage::Dequeue)];
+        pacer->onFrame(std::min(captureNs, monoNs));
+      }
+      if (tsMuxer) {
+        tsMuxer->write(encoded);
+        continue;
+      }
       packer->put(encoded.buffer);
       while (auto packet = packer->get()) {
         if (debug) std::cout << '#' << std::flush;
+        if (!trace.has(camera_toolkit::TraceStage::FirstPacket)) trace.mark(camera_toolkit::TraceStage::FirstPacket);
+        trace.mark(camera_toolkit::TraceStage::LastPacket);
 
         if ((stage & 0b00001000) == 0) {
           // 无网络
           if (outFile) {
-            outFile->write(static_cast<char*>(packet->data), packet->size);
+            outFile->write(packet->data, packet->size);
           }
           continue;
         }
 
-        // 网络发送
-        int ret = network->send(*packet);
+        // 网络发送，定时发送时由内核在计划时刻发出
+        int64_t sendTimeNs = pacer ? pacer->next(packet->size) : 0;
+        int ret = pacer ? network->sendAt(*packet, sendTimeNs) : network->send(*packet);
+        countSend(ret, packet->size);
         if (ret != packet->size) {
-          std::cerr << "!!! send failed, size: " << packet->size << ", err: " << strerror(errno) << std::endl;
+          camera_toolkit::log::warn(tag + "send failed, size: " + std::to_string(packet->size) +
+                                    ", err: " + strerror(errno));
+        }
+        trace.mark(camera_toolkit::TraceStage::Sent);
+        if (sendTimeNs > trace.stamps[static_cast<int>(camera_toolkit::TraceStage::Sent)]) {
+          trace.mark(camera_toolkit::TraceStage::Sent, sendTimeNs);
         }
         if (debug) std::cout << '>' << std::flush;
       }
@@ -398,14 +1065,159 @@ int main(int argc, char* argv[]) {
 
     capture->stop();
 
+    if (preEvent) {
+      preEvent->stopDump();
+      auto stats = preEvent->getStats();
+      if (stats.dropped > 0 || stats.lost > 0) {
+        std::cout << "--- " << tag << "Pre-event buffer dropped " << stats.dropped << " frames, lost "
+                  << stats.lost << " while dumping" << std::endl;
+      }
+    }
+    if (videoRecorder) {
+      videoRecorder->close();
+      auto stats = videoRecorder->getStats();
+      std::cout << "--- " << tag << "Recorded " << stats.frames << " frames in " << stats.segments << " segments ("
+                << stats.bytes << " bytes)" << std::endl;
+    }
+    if (httpServer) {
+      auto stats = httpServer->getStats();
+      std::cout << "--- " << tag << "Served " << stats.accepted << " HTTP connections, " << stats.bytesSent
+                << " bytes, " << stats.overflows << " viewer overflows" << std::endl;
+    }
+
+  } catch (const camera_toolkit::CameraToolkitException& e) {
+    std::cerr << "--- " << tag << "Error: " << e.what() << std::endl;
+    return -1;
+  }
+
+  return 0;
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief 主函数
+ * @param argc 命令行参数数量
+ * @param argv 命令行参数数组
+ * @return 成功返回0，失败返回-1
+ */
+int main(int argc, char* argv[]) {
+  StreamOptions defaults;
+  GlobalOptions global;
+  std::string configFilename;
+
+  // 解析命令行选项
+  static const char* optString = "?vdkbmPFDXAi:o:a:p:w:h:r:f:t:g:j:s:c:n:O:M:l:T:e:R:E:H:C:W:";
+  int opt;
+
+  while ((opt = getopt(argc, argv, optString)) != -1) {
+    switch (opt) {
+      case '?':
+        displayUsage();
+        return 0;
+      case 'v':
+        displayVersion();
+        return 0;
+      case 'C':
+        configFilename = optarg;
+        break;
+      default:
+        try {
+          const std::string arg = optarg ? optarg : "";
+          if (!applyStreamOption(defaults, opt, arg) && !applyGlobalOption(global, opt, arg)) {
+            std::cerr << "Unknown option: " << static_cast<char>(opt) << std::endl;
+            displayUsage();
+            return -1;
+          }
+        } catch (const std::logic_error&) {
+          std::cerr << "--- Invalid value for -" << static_cast<char>(opt) << ": " << optarg << std::endl;
+          return -1;
+        } catch (const camera_toolkit::CameraToolkitException& e) {
+          std::cerr << "--- " << e.what() << std::endl;
+          return -1;
+        }
+    }
+  }
+
+  // 多路流: 每个[stream NAME]节一路，编码线程按核数分摊，避免各路都按全部核数建线程
+  std::vector<StreamOptions> streams;
+  if (configFilename.empty()) {
+    streams.push_back(defaults);
+  } else {
+    try {
+      streams = loadStreams(configFilename, defaults, global);
+    } catch (const camera_toolkit::CameraToolkitException& e) {
+      std::cerr << "--- " << e.what() << std::endl;
+      return -1;
+    }
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (StreamOptions& stream : streams) {
+      if (stream.encParams.threads == 0) {
+        stream.encParams.threads = std::max(1, cores / static_cast<int>(streams.size()));
+      }
+    }
+  }
+
+  // 设置信号处理
+  signal(SIGINT, signalHandler);
+  signal(SIGUSR1, eventHandler);
+  signal(SIGUSR2, eventHandler);
+
+  // 打印版本信息
+  displayVersion();
+
+  // 各路流共用一个指标注册表和端点，以及一组转换工作线程(线程数不随流数增加)
+  camera_toolkit::MetricsRegistry metrics;
+  std::unique_ptr<camera_toolkit::MetricsServer> metricsServer;
+  std::unique_ptr<camera_toolkit::TaskScheduler> scheduler;
+  try {
+    if (global.metricsEnabled) {
+      metricsServer = std::make_unique<camera_toolkit::MetricsServer>(global.metricsParams, metrics);
+    }
+    if (global.schedulerEnabled) {
+      scheduler = std::make_unique<camera_toolkit::TaskScheduler>(global.schedulerParams);
+      for (StreamOptions& stream : streams) stream.cvtParams.scheduler = scheduler.get();
+    }
   } catch (const camera_toolkit::CameraToolkitException& e) {
     std::cerr << "--- Error: " << e.what() << std::endl;
     return -1;
   }
 
-  if (outFile) {
-    outFile->close();
+  if (!global.traceFilename.empty()) {
+    camera_toolkit::startTracing();
   }
 
-  return 0;
+  // 单路流在主线程运行；多路流每路一个线程，一路失败不影响其他路
+  int result = 0;
+  if (streams.size() == 1) {
+    result = runStream(streams[0], metrics, global.metricsEnabled);
+  } else {
+    std::vector<int> results(streams.size(), 0);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < streams.size(); i++) {
+      threads.emplace_back([&, i] { results[i] = runStream(streams[i], metrics, global.metricsEnabled); });
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (size_t i = 0; i < streams.size(); i++) {
+      if (results[i] != 0) {
+        std::cerr << "--- Stream " << streams[i].name << " failed" << std::endl;
+        result = -1;
+      }
+    }
+  }
+
+  if (!global.traceFilename.empty()) {
+    camera_toolkit::stopTracing();
+    try {
+      camera_toolkit::saveTrace(global.traceFilename);
+    } catch (const camera_toolkit::CameraToolkitException& e) {
+      std::cerr << "--- Error: " << e.what() << std::endl;
+      return -1;
+    }
+    auto stats = camera_toolkit::getTraceStats();
+    std::cout << "--- Trace saved to " << global.traceFilename << " (" << stats.events << " events, "
+              << stats.dropped << " dropped)" << std::endl;
+  }
+
+  return result;
 }
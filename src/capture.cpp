@@ -15,8 +15,10 @@
 
 #include <cerrno>
 #include <cstring>
+#include <ctime>
 #include <vector>
 
+#include "camera_toolkit/trace.h"
 #include "log.h"
 
 namespace camera_toolkit {
@@ -38,6 +40,30 @@ int xioctl(int fd, unsigned long request, void* arg) {
   return r;
 }
 
+/**
+ * @brief 将V4L2缓冲区时间戳换算为墙上时间
+ * @param buf 已出队的V4L2缓冲区
+ * @return CLOCK_REALTIME微秒
+ *
+ * 多数驱动使用CLOCK_MONOTONIC时间戳，按出队时刻两个时钟的差值换算；
+ * 驱动未提供单调时间戳时使用出队时刻
+ */
+int64_t toRealtimeUs(const struct v4l2_buffer& buf) {
+  struct timespec real{};
+  clock_gettime(CLOCK_REALTIME, &real);
+  int64_t realUs = static_cast<int64_t>(real.tv_sec) * 1000000 + real.tv_nsec / 1000;
+
+  if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) != V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+    return realUs;
+  }
+
+  struct timespec mono{};
+  clock_gettime(CLOCK_MONOTONIC, &mono);
+  int64_t monoUs = static_cast<int64_t>(mono.tv_sec) * 1000000 + mono.tv_nsec / 1000;
+  int64_t frameUs = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000 + buf.timestamp.tv_usec;
+  return realUs - (monoUs - frameUs);
+}
+
 /**
  * @brief 将camera_toolkit像素格式转换为V4L2格式
  * @param format camera_toolkit像素格式
@@ -49,6 +75,8 @@ uint32_t toV4L2Format(PixelFormat format) {
       return V4L2_PIX_FMT_YUYV;
     case PixelFormat::YUV420:
       return V4L2_PIX_FMT_YUV420;
+    case PixelFormat::NV12:
+      return V4L2_PIX_FMT_NV12;
     case PixelFormat::RGB565:
       return V4L2_PIX_FMT_RGB565;
     case PixelFormat::RGB24:
@@ -137,6 +165,7 @@ class Capture::Impl {
     }
 
     v4lBufPut_ = true;
+    imageCounter_ = 0;
     log::info("Capture started");
   }
 
@@ -155,6 +184,7 @@ class Capture::Impl {
    * @throws CaptureException 发生错误时抛出
    */
   Buffer getData() {
+    CK_TRACE_SCOPE("capture.dequeue");
     fd_set fds;
     FD_ZERO(&fds);
     FD_SET(fd_, &fds);
@@ -198,11 +228,29 @@ class Capture::Impl {
     }
 
     v4lBufPut_ = false;
+    // 驱动为每个采集周期递增序号(包括因缓冲区不足丢弃的帧)，序号跳变即为丢帧
+    if (imageCounter_ > 0 && v4lBuf_.sequence > lastSequence_ + 1) {
+      droppedFrames_ += v4lBuf_.sequence - lastSequence_ - 1;
+    }
+    lastSequence_ = v4lBuf_.sequence;
     imageCounter_++;
+    lastTimestampUs_ = toRealtimeUs(v4lBuf_);
 
     return Buffer(buffers_[v4lBuf_.index].start, imageSize_);
   }
 
+  /**
+   * @brief 获取最近一帧的采集时间戳
+   * @return 墙上时间(微秒)
+   */
+  int64_t getLastTimestamp() const { return lastTimestampUs_; }
+
+  /**
+   * @brief 获取驱动丢帧数
+   * @return 帧数
+   */
+  uint64_t getDroppedFrames() const { return droppedFrames_; }
+
   /**
    * @brief 查询控制参数范围
    * @param controlId V4L2控制ID
@@ -401,6 +449,9 @@ class Capture::Impl {
   struct v4l2_buffer v4lBuf_{};     /**< V4L2缓冲区 */
   bool v4lBufPut_ = true;           /**< 缓冲区是否已入队 */
   unsigned long imageCounter_ = 0;  /**< 图像计数器 */
+  int64_t lastTimestampUs_ = 0;     /**< 最近一帧的采集时间戳(墙上时间微秒) */
+  uint32_t lastSequence_ = 0;       /**< 最近一帧的驱动序号 */
+  uint64_t droppedFrames_ = 0;      /**< 驱动序号跳变累计的丢帧数 */
 };
 
 // ============================================================================
@@ -417,6 +468,10 @@ void Capture::stop() { pImpl_->stop(); }
 
 Buffer Capture::getData() { return pImpl_->getData(); }
 
+int64_t Capture::getLastTimestamp() const { return pImpl_->getLastTimestamp(); }
+
+uint64_t Capture::getDroppedFrames() const { return pImpl_->getDroppedFrames(); }
+
 std::optional<ControlRange> Capture::queryBrightness() const { return pImpl_->queryControl(V4L2_CID_BRIGHTNESS); }
 
 std::optional<int> Capture::getBrightness() const { return pImpl_->getControl(V4L2_CID_BRIGHTNESS); }
@@ -0,0 +1,119 @@
+/**
+ * @file clock_formatter.cpp
+ * @brief 带缓存的本地时间格式化工具实现
+ */
+#include "clock_formatter.h"
+
+#include <cstring>
+#include <ctime>
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int64_t SEC_PER_MINUTE = 60;  /**< 每分钟秒数 */
+constexpr int64_t SEC_PER_DAY = 86400;  /**< 每天秒数 */
+
+/**
+ * @brief 向下取整的整数除法
+ */
+int64_t floorDiv(int64_t a, int64_t b) { return a / b - ((a % b != 0) && ((a < 0) != (b < 0))); }
+
+/**
+ * @brief 写入定宽十进制数字
+ * @param dst 目标位置
+ * @param value 数值(非负)
+ * @param width 位数
+ */
+void writeDigits(char* dst, int64_t value, int width) {
+  for (int i = width - 1; i >= 0; i--) {
+    dst[i] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+}  // anonymous namespace
+
+ClockFormatter::ClockFormatter(bool milliseconds)
+    : milliseconds_(milliseconds), suffixPos_(milliseconds ? TIME_END + 4 : TIME_END) {
+  std::memcpy(text_, "0000-00-00 00:00:00.000", suffixPos_);
+}
+
+bool ClockFormatter::format(int64_t timeUs) {
+  int64_t sec = floorDiv(timeUs, 1000000);
+  bool changed = false;
+
+  if (sec < zoneStart_ || sec >= zoneEnd_) {
+    refreshZone(sec);
+    changed = true;
+  }
+
+  int64_t local = sec + offsetSec_;
+  if (local != lastSec_) {
+    lastSec_ = local;
+    int64_t days = floorDiv(local, SEC_PER_DAY);
+    if (days != lastDay_) {
+      lastDay_ = days;
+      writeDate(days);
+    }
+    writeTime(static_cast<int>(local - days * SEC_PER_DAY));
+    changed = true;
+  }
+
+  if (milliseconds_) {
+    int ms = static_cast<int>(floorDiv(timeUs, 1000) - sec * 1000);
+    if (ms != lastMs_) {
+      lastMs_ = ms;
+      writeDigits(text_ + TIME_END + 1, ms, 3);
+      changed = true;
+    }
+  }
+
+  return changed;
+}
+
+void ClockFormatter::refreshZone(int64_t sec) {
+  // 时区切换发生在本地整分，半小时/45分偏移的时区(如纽芬兰)不落在UTC整点，按UTC分钟重新查询
+  zoneStart_ = floorDiv(sec, SEC_PER_MINUTE) * SEC_PER_MINUTE;
+  zoneEnd_ = zoneStart_ + SEC_PER_MINUTE;
+
+  time_t t = static_cast<time_t>(sec);
+  struct tm tm{};
+  localtime_r(&t, &tm);
+
+  // 偏移变化后本地日期/秒需要重新推算
+  if (tm.tm_gmtoff != offsetSec_) {
+    offsetSec_ = tm.tm_gmtoff;
+    lastDay_ = INT64_MIN;
+    lastSec_ = INT64_MIN;
+  }
+
+  char* suffix = text_ + suffixPos_;
+  size_t room = sizeof(text_) - suffixPos_;
+  std::strftime(suffix, room, " (%Z)", &tm);
+}
+
+void ClockFormatter::writeDate(int64_t days) {
+  // 由天数推算公历日期(Howard Hinnant civil_from_days算法)
+  int64_t z = days + 719468;
+  int64_t era = floorDiv(z, 146097);
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  int64_t day = doy - (153 * mp + 2) / 5 + 1;
+  int64_t month = mp < 10 ? mp + 3 : mp - 9;
+  int64_t year = yoe + era * 400 + (month <= 2);
+
+  writeDigits(text_, year, 4);
+  writeDigits(text_ + 5, month, 2);
+  writeDigits(text_ + 8, day, 2);
+}
+
+void ClockFormatter::writeTime(int secOfDay) {
+  writeDigits(text_ + 11, secOfDay / 3600, 2);
+  writeDigits(text_ + 14, secOfDay / 60 % 60, 2);
+  writeDigits(text_ + 17, secOfDay % 60, 2);
+}
+
+}  // namespace camera_toolkit
@@ -0,0 +1,76 @@
+/**
+ * @file clock_formatter.h
+ * @brief 带缓存的本地时间格式化工具
+ *
+ * 仅供库内部源文件使用，不对外暴露。
+ */
+#pragma once
+
+#include <cstdint>
+
+namespace camera_toolkit {
+
+/**
+ * @class ClockFormatter
+ * @brief 带缓存的本地时间格式化类
+ *
+ * 输出格式为"YYYY-MM-DD HH:MM:SS[.mmm] (TZ)"。时区偏移和名称每个UTC分钟只通过
+ * localtime_r查询一次，其余时间用整数运算推算日期和时分秒，并且只改写发生变化的字段，
+ * 避免每帧进入glibc的时区锁
+ *
+ * @note 每个实例只应在一个线程中使用；实例之间没有共享状态，多路采集线程各自持有即可
+ */
+class ClockFormatter {
+ public:
+  /**
+   * @brief 构造函数
+   * @param milliseconds 是否输出毫秒字段
+   */
+  explicit ClockFormatter(bool milliseconds);
+
+  /**
+   * @brief 格式化指定时刻
+   * @param timeUs 墙上时间(CLOCK_REALTIME微秒)
+   * @return 文本与上次相比有变化返回true
+   */
+  bool format(int64_t timeUs);
+
+  /**
+   * @brief 获取最近一次格式化的文本
+   * @return 以'\0'结尾的字符串
+   */
+  const char* text() const { return text_; }
+
+ private:
+  /**
+   * @brief 查询包含指定时刻的UTC分钟内的时区偏移和名称
+   * @param sec UTC秒数
+   */
+  void refreshZone(int64_t sec);
+
+  /**
+   * @brief 写入日期字段
+   * @param days 本地时间自1970-01-01起的天数
+   */
+  void writeDate(int64_t days);
+
+  /**
+   * @brief 写入时分秒字段
+   * @param secOfDay 本地时间当天的秒数
+   */
+  void writeTime(int secOfDay);
+
+  static constexpr int TIME_END = 19; /**< "YYYY-MM-DD HH:MM:SS"长度 */
+
+  bool milliseconds_;           /**< 是否输出毫秒 */
+  int suffixPos_;               /**< 时区后缀起始位置 */
+  int64_t zoneStart_ = 1;       /**< 缓存时区信息的有效起点(UTC秒)，初始为无效区间 */
+  int64_t zoneEnd_ = 0;         /**< 缓存时区信息的有效终点(UTC秒，不含) */
+  int64_t offsetSec_ = 0;       /**< 本地时间相对UTC的偏移(秒) */
+  int64_t lastDay_ = INT64_MIN; /**< 已写入的本地日期 */
+  int64_t lastSec_ = INT64_MIN; /**< 已写入的本地秒 */
+  int lastMs_ = -1;             /**< 已写入的毫秒 */
+  char text_[64] = {};          /**< 格式化结果 */
+};
+
+}  // namespace camera_toolkit
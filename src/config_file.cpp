@@ -0,0 +1,140 @@
+/**
+ * @file config_file.cpp
+ * @brief INI格式配置文件解析实现
+ */
+#include "camera_toolkit/config_file.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace camera_toolkit {
+
+namespace {
+
+/**
+ * @brief 去掉两端空白
+ * @param text 文本
+ * @return 去掉空白后的文本
+ */
+std::string trim(const std::string& text) {
+  const char* spaces = " \t\r\n";
+  const size_t first = text.find_first_not_of(spaces);
+  if (first == std::string::npos) return std::string();
+  return text.substr(first, text.find_last_not_of(spaces) - first + 1);
+}
+
+/**
+ * @brief 检查节类型、节名或键是否只含字母、数字、下划线、连字符和点
+ * @param text 文本
+ * @return 合法返回true
+ */
+bool isValidIdentifier(const std::string& text) {
+  if (text.empty()) return false;
+  for (char c : text) {
+    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+                       c == '-' || c == '.';
+    if (!valid) return false;
+  }
+  return true;
+}
+
+}  // anonymous namespace
+
+const ConfigEntry* ConfigSection::find(const std::string& key) const {
+  for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+    if (it->key == key) return &*it;
+  }
+  return nullptr;
+}
+
+ConfigFile ConfigFile::parse(const std::string& text, const std::string& origin) {
+  ConfigFile config;
+  config.origin_ = origin;
+
+  std::istringstream stream(text);
+  std::string raw;
+  int lineNumber = 0;
+  while (std::getline(stream, raw)) {
+    lineNumber++;
+    const std::string line = trim(raw);
+    if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+    if (line[0] == '[') {
+      if (line.back() != ']') {
+        throw CameraToolkitException(config.describe(lineNumber, "unterminated section header"));
+      }
+      // [类型] 或 [类型 名称]
+      const std::string header = trim(line.substr(1, line.size() - 2));
+      const size_t space = header.find_first_of(" \t");
+      ConfigSection section;
+      section.type = header.substr(0, space);
+      section.name = space == std::string::npos ? std::string() : trim(header.substr(space));
+      section.line = lineNumber;
+      if (!isValidIdentifier(section.type) || (!section.name.empty() && !isValidIdentifier(section.name))) {
+        throw CameraToolkitException(config.describe(lineNumber, "invalid section header: " + line));
+      }
+      for (const ConfigSection& other : config.sections_) {
+        if (other.type == section.type && other.name == section.name) {
+          throw CameraToolkitException(config.describe(
+              lineNumber, "duplicate section " + line + ", first defined at line " + std::to_string(other.line)));
+        }
+      }
+      config.sections_.push_back(section);
+      continue;
+    }
+
+    const size_t equals = line.find('=');
+    if (equals == std::string::npos) {
+      throw CameraToolkitException(config.describe(lineNumber, "expected key = value: " + line));
+    }
+    ConfigEntry entry;
+    entry.key = trim(line.substr(0, equals));
+    entry.value = trim(line.substr(equals + 1));
+    entry.line = lineNumber;
+    if (!isValidIdentifier(entry.key)) {
+      throw CameraToolkitException(config.describe(lineNumber, "invalid key: " + entry.key));
+    }
+    if (!entry.value.empty() && entry.value[0] == '"') {
+      if (entry.value.size() < 2 || entry.value.back() != '"') {
+        throw CameraToolkitException(config.describe(lineNumber, "unterminated quoted value"));
+      }
+      entry.value = entry.value.substr(1, entry.value.size() - 2);
+    }
+    if (config.sections_.empty()) {
+      throw CameraToolkitException(config.describe(lineNumber, "entry outside of a section: " + entry.key));
+    }
+    config.sections_.back().entries.push_back(entry);
+  }
+  return config;
+}
+
+ConfigFile ConfigFile::load(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw CameraToolkitException("Failed to open config file: " + path);
+  }
+  std::ostringstream text;
+  text << file.rdbuf();
+  if (file.bad()) {
+    throw CameraToolkitException("Failed to read config file: " + path);
+  }
+  return parse(text.str(), path);
+}
+
+const std::vector<ConfigSection>& ConfigFile::getSections() const { return sections_; }
+
+std::vector<const ConfigSection*> ConfigFile::getSections(const std::string& type) const {
+  std::vector<const ConfigSection*> result;
+  for (const ConfigSection& section : sections_) {
+    if (section.type == type) result.push_back(&section);
+  }
+  return result;
+}
+
+const std::string& ConfigFile::getOrigin() const { return origin_; }
+
+std::string ConfigFile::describe(int line, const std::string& message) const {
+  return origin_ + ":" + std::to_string(line) + ": " + message;
+}
+
+}  // namespace camera_toolkit
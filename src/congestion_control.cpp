@@ -0,0 +1,456 @@
+/**
+ * @file congestion_control.cpp
+ * @brief 拥塞控制类实现
+ */
+#include "camera_toolkit/congestion_control.h"
+
+#include <arpa/inet.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <deque>
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int64_t BURST_INTERVAL_US = 5000;           /**< 同一包组的最大发送间隔 */
+constexpr size_t TRENDLINE_WINDOW = 20;               /**< 趋势线拟合窗口(包组数) */
+constexpr double TRENDLINE_SMOOTHING = 0.9;           /**< 累积延迟平滑系数 */
+constexpr double TRENDLINE_GAIN = 4.0;                /**< 趋势斜率放大系数 */
+constexpr int MAX_DELTAS_FOR_GAIN = 60;               /**< 参与放大的最大样本数 */
+constexpr double OVERUSE_TIME_MS = 10.0;              /**< 判定过载需持续的时间 */
+constexpr double THRESHOLD_INITIAL = 12.5;            /**< 自适应阈值初值 */
+constexpr double THRESHOLD_MIN = 6.0;                 /**< 自适应阈值下限 */
+constexpr double THRESHOLD_MAX = 600.0;               /**< 自适应阈值上限 */
+constexpr double THRESHOLD_K_UP = 0.0087;             /**< 阈值上调系数 */
+constexpr double THRESHOLD_K_DOWN = 0.039;            /**< 阈值下调系数 */
+constexpr double DECREASE_BETA = 0.85;                /**< 过载时的乘性降低系数 */
+constexpr double INCREASE_PER_SECOND = 1.08;          /**< 每秒乘性增长系数 */
+constexpr int64_t DECREASE_INTERVAL_US = 200000;      /**< 两次降低的最小间隔 */
+constexpr int64_t ACKED_WINDOW_US = 500000;           /**< 确认码率统计窗口 */
+constexpr double LOSS_LOW = 0.02;                     /**< 低于此丢包率时增长 */
+constexpr double LOSS_HIGH = 0.10;                    /**< 高于此丢包率时降低 */
+constexpr int64_t LOSS_DECREASE_INTERVAL_US = 300000; /**< 丢包降低的最小间隔 */
+
+constexpr uint8_t RTCP_SR = 200; /**< RTCP发送者报告 */
+constexpr uint8_t RTCP_RR = 201; /**< RTCP接收者报告 */
+
+/**
+ * @brief 包组(发送间隔小于BURST_INTERVAL_US的连续包)
+ */
+struct PacketGroup {
+  int64_t firstSendUs = -1;   /**< 首包发送时刻 */
+  int64_t lastSendUs = -1;    /**< 末包发送时刻 */
+  int64_t lastArrivalUs = -1; /**< 最晚到达时刻 */
+
+  bool valid() const { return firstSendUs >= 0; }
+};
+
+/**
+ * @brief 趋势线样本
+ */
+struct TrendSample {
+  double arrivalMs;     /**< 相对首个样本的到达时刻 */
+  double smoothedDelay; /**< 平滑后的累积延迟 */
+};
+
+/**
+ * @brief 最小二乘拟合斜率
+ * @param samples 样本窗口
+ * @return 斜率，无法拟合时返回0
+ */
+double linearFitSlope(const std::deque<TrendSample>& samples) {
+  double sumX = 0;
+  double sumY = 0;
+  for (const auto& s : samples) {
+    sumX += s.arrivalMs;
+    sumY += s.smoothedDelay;
+  }
+  double avgX = sumX / samples.size();
+  double avgY = sumY / samples.size();
+
+  double num = 0;
+  double den = 0;
+  for (const auto& s : samples) {
+    num += (s.arrivalMs - avgX) * (s.smoothedDelay - avgY);
+    den += (s.arrivalMs - avgX) * (s.arrivalMs - avgX);
+  }
+  return den == 0 ? 0 : num / den;
+}
+
+/**
+ * @brief 读取大端32位整数
+ */
+uint32_t readU32(const uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return ntohl(v);
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief CongestionController类的PIMPL实现
+ */
+class CongestionController::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 拥塞控制参数
+   */
+  explicit Impl(const CongestionControlParams& params) : params_(params) {
+    delayRateKbps_ = lossRateKbps_ = clamp(params_.startBitrate);
+    targetKbps_.store(static_cast<int>(delayRateKbps_), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 处理RTCP接收者报告
+   * @param report 报告块
+   * @param nowUs 当前时刻
+   */
+  void onReceiverReport(const ReceiverReport& report, int64_t nowUs) {
+    updateLossBased(report.fractionLost / 256.0, nowUs);
+    updateTarget();
+  }
+
+  /**
+   * @brief 处理传输层逐包反馈
+   * @param feedback 逐包反馈
+   * @param nowUs 当前时刻
+   */
+  void onTransportFeedback(const std::vector<PacketFeedback>& feedback, int64_t nowUs) {
+    if (feedback.empty()) {
+      return;
+    }
+
+    int lost = 0;
+    for (const auto& pkt : feedback) {
+      if (pkt.arrivalTimeUs < 0) {
+        lost++;
+        continue;
+      }
+      onPacketArrived(pkt);
+    }
+
+    hasDelayFeedback_ = true;
+    updateDelayBased(nowUs);
+    updateLossBased(static_cast<double>(lost) / feedback.size(), nowUs);
+    updateTarget();
+  }
+
+  /**
+   * @brief 获取目标码率
+   * @return 目标码率(kbps)
+   */
+  int getTargetBitrate() const { return targetKbps_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 获取带宽使用状态
+   * @return 带宽使用状态
+   */
+  BandwidthUsage getUsage() const { return usage_; }
+
+  /**
+   * @brief 获取拥塞控制参数
+   * @return 拥塞控制参数引用
+   */
+  const CongestionControlParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 处理单个已到达的包：统计确认码率并按包组计算延迟变化
+   * @param pkt 逐包反馈
+   */
+  void onPacketArrived(const PacketFeedback& pkt) {
+    acked_.push_back({pkt.arrivalTimeUs, pkt.size});
+    ackedBytes_ += pkt.size;
+    while (!acked_.empty() && pkt.arrivalTimeUs - acked_.front().first > ACKED_WINDOW_US) {
+      ackedBytes_ -= acked_.front().second;
+      acked_.pop_front();
+    }
+
+    if (!current_.valid()) {
+      current_ = {pkt.sendTimeUs, pkt.sendTimeUs, pkt.arrivalTimeUs};
+      return;
+    }
+
+    if (pkt.sendTimeUs - current_.firstSendUs <= BURST_INTERVAL_US) {
+      current_.lastSendUs = std::max(current_.lastSendUs, pkt.sendTimeUs);
+      current_.lastArrivalUs = std::max(current_.lastArrivalUs, pkt.arrivalTimeUs);
+      return;
+    }
+
+    // 当前包组完成，与上一包组比较
+    if (previous_.valid()) {
+      double sendDeltaMs = (current_.lastSendUs - previous_.lastSendUs) / 1000.0;
+      double arrivalDeltaMs = (current_.lastArrivalUs - previous_.lastArrivalUs) / 1000.0;
+      updateTrendline(sendDeltaMs, arrivalDeltaMs, current_.lastArrivalUs / 1000.0);
+    }
+    previous_ = current_;
+    current_ = {pkt.sendTimeUs, pkt.sendTimeUs, pkt.arrivalTimeUs};
+  }
+
+  /**
+   * @brief 更新趋势线并检测过载
+   * @param sendDeltaMs 包组发送间隔
+   * @param arrivalDeltaMs 包组到达间隔
+   * @param arrivalMs 包组到达时刻
+   */
+  void updateTrendline(double sendDeltaMs, double arrivalDeltaMs, double arrivalMs) {
+    numDeltas_ = std::min(numDeltas_ + 1, 1000);
+    accumulatedDelay_ += arrivalDeltaMs - sendDeltaMs;
+    smoothedDelay_ = TRENDLINE_SMOOTHING * smoothedDelay_ + (1 - TRENDLINE_SMOOTHING) * accumulatedDelay_;
+
+    if (firstArrivalMs_ < 0) {
+      firstArrivalMs_ = arrivalMs;
+    }
+    samples_.push_back({arrivalMs - firstArrivalMs_, smoothedDelay_});
+    if (samples_.size() > TRENDLINE_WINDOW) {
+      samples_.pop_front();
+    }
+
+    double trend = prevTrend_;
+    if (samples_.size() == TRENDLINE_WINDOW) {
+      trend = linearFitSlope(samples_);
+    }
+
+    detect(trend, sendDeltaMs, arrivalMs);
+  }
+
+  /**
+   * @brief 过载检测
+   * @param trend 趋势斜率
+   * @param sendDeltaMs 包组发送间隔
+   * @param nowMs 当前到达时刻
+   */
+  void detect(double trend, double sendDeltaMs, double nowMs) {
+    double modified = std::min(numDeltas_, MAX_DELTAS_FOR_GAIN) * trend * TRENDLINE_GAIN;
+
+    if (modified > threshold_) {
+      timeOverUsingMs_ = timeOverUsingMs_ < 0 ? sendDeltaMs / 2 : timeOverUsingMs_ + sendDeltaMs;
+      overuseCounter_++;
+      if (timeOverUsingMs_ > OVERUSE_TIME_MS && overuseCounter_ > 1 && trend >= prevTrend_) {
+        timeOverUsingMs_ = 0;
+        overuseCounter_ = 0;
+        usage_ = BandwidthUsage::Overusing;
+      }
+    } else if (modified < -threshold_) {
+      timeOverUsingMs_ = -1;
+      overuseCounter_ = 0;
+      usage_ = BandwidthUsage::Underusing;
+    } else {
+      timeOverUsingMs_ = -1;
+      overuseCounter_ = 0;
+      usage_ = BandwidthUsage::Normal;
+    }
+
+    prevTrend_ = trend;
+    updateThreshold(modified, nowMs);
+  }
+
+  /**
+   * @brief 更新自适应阈值
+   * @param modified 放大后的趋势
+   * @param nowMs 当前时刻
+   */
+  void updateThreshold(double modified, double nowMs) {
+    if (lastThresholdMs_ < 0) {
+      lastThresholdMs_ = nowMs;
+    }
+
+    // 突发的大幅延迟变化(如路由切换)不参与阈值调整
+    double absModified = std::fabs(modified);
+    if (absModified > threshold_ + 15.0) {
+      lastThresholdMs_ = nowMs;
+      return;
+    }
+
+    double k = absModified < threshold_ ? THRESHOLD_K_DOWN : THRESHOLD_K_UP;
+    double dt = std::min(nowMs - lastThresholdMs_, 100.0);
+    threshold_ = std::clamp(threshold_ + k * (absModified - threshold_) * dt, THRESHOLD_MIN, THRESHOLD_MAX);
+    lastThresholdMs_ = nowMs;
+  }
+
+  /**
+   * @brief 延迟控制器的AIMD码率更新
+   * @param nowUs 当前时刻
+   */
+  void updateDelayBased(int64_t nowUs) {
+    double ackedKbps = ackedBitrateKbps();
+    double dtSec = lastDelayUpdateUs_ < 0 ? 0 : std::min<double>(nowUs - lastDelayUpdateUs_, 1000000) / 1e6;
+    lastDelayUpdateUs_ = nowUs;
+
+    switch (usage_) {
+      case BandwidthUsage::Overusing:
+        if (nowUs - lastDecreaseUs_ >= DECREASE_INTERVAL_US) {
+          double base = ackedKbps > 0 ? ackedKbps : delayRateKbps_;
+          delayRateKbps_ = std::min(delayRateKbps_, DECREASE_BETA * base);
+          lastDecreaseUs_ = nowUs;
+        }
+        break;
+      case BandwidthUsage::Underusing:
+        // 队列正在排空，保持码率
+        break;
+      default:
+        delayRateKbps_ *= std::pow(INCREASE_PER_SECOND, dtSec);
+        // 发送受限于应用时不能无限增长
+        if (ackedKbps > 0) {
+          delayRateKbps_ = std::min(delayRateKbps_, 1.5 * ackedKbps + 10);
+        }
+        break;
+    }
+    delayRateKbps_ = clamp(delayRateKbps_);
+  }
+
+  /**
+   * @brief 丢包控制器的码率更新
+   * @param lossFraction 丢包率(0-1)
+   * @param nowUs 当前时刻
+   */
+  void updateLossBased(double lossFraction, int64_t nowUs) {
+    double dtSec = lastLossUpdateUs_ < 0 ? 0 : std::min<double>(nowUs - lastLossUpdateUs_, 1000000) / 1e6;
+    lastLossUpdateUs_ = nowUs;
+
+    if (lossFraction < LOSS_LOW) {
+      lossRateKbps_ *= std::pow(INCREASE_PER_SECOND, dtSec);
+    } else if (lossFraction > LOSS_HIGH && nowUs - lastLossDecreaseUs_ >= LOSS_DECREASE_INTERVAL_US) {
+      lossRateKbps_ *= 1 - 0.5 * lossFraction;
+      lastLossDecreaseUs_ = nowUs;
+    }
+    lossRateKbps_ = clamp(lossRateKbps_);
+  }
+
+  /**
+   * @brief 合并两个控制器的结果
+   */
+  void updateTarget() {
+    double target = hasDelayFeedback_ ? std::min(delayRateKbps_, lossRateKbps_) : lossRateKbps_;
+    // 丢包控制器不应远超延迟控制器，否则恢复时会先过冲
+    if (hasDelayFeedback_) {
+      lossRateKbps_ = std::min(lossRateKbps_, 1.5 * delayRateKbps_);
+    }
+
+    targetKbps_.store(static_cast<int>(clamp(target)), std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 统计窗口内的确认码率
+   * @return 确认码率(kbps)，样本不足返回0
+   */
+  double ackedBitrateKbps() const {
+    if (acked_.size() < 2) {
+      return 0;
+    }
+    int64_t spanUs = acked_.back().first - acked_.front().first;
+    if (spanUs < ACKED_WINDOW_US / 2) {
+      return 0;
+    }
+    return ackedBytes_ * 8.0 * 1000.0 / spanUs;
+  }
+
+  /**
+   * @brief 将码率限制在配置范围内
+   */
+  double clamp(double kbps) const {
+    return std::clamp<double>(kbps, params_.minBitrate, params_.maxBitrate);
+  }
+
+  CongestionControlParams params_; /**< 拥塞控制参数 */
+  std::atomic<int> targetKbps_{0}; /**< 目标码率(kbps) */
+
+  // 延迟控制器
+  PacketGroup current_;                           /**< 当前包组 */
+  PacketGroup previous_;                          /**< 上一包组 */
+  std::deque<TrendSample> samples_;               /**< 趋势线样本窗口 */
+  std::deque<std::pair<int64_t, int>> acked_;     /**< 已确认包(到达时刻,大小) */
+  int64_t ackedBytes_ = 0;                        /**< 窗口内确认字节数 */
+  int numDeltas_ = 0;                             /**< 样本计数 */
+  double accumulatedDelay_ = 0;                   /**< 累积延迟变化 */
+  double smoothedDelay_ = 0;                      /**< 平滑累积延迟 */
+  double firstArrivalMs_ = -1;                    /**< 首个样本到达时刻 */
+  double prevTrend_ = 0;                          /**< 上次趋势 */
+  double threshold_ = THRESHOLD_INITIAL;          /**< 自适应阈值 */
+  double lastThresholdMs_ = -1;                   /**< 上次阈值更新时刻 */
+  double timeOverUsingMs_ = -1;                   /**< 持续过载时长 */
+  int overuseCounter_ = 0;                        /**< 过载计数 */
+  BandwidthUsage usage_ = BandwidthUsage::Normal; /**< 带宽使用状态 */
+  double delayRateKbps_ = 0;                      /**< 延迟控制器码率 */
+  int64_t lastDelayUpdateUs_ = -1;                /**< 上次延迟码率更新时刻 */
+  int64_t lastDecreaseUs_ = INT64_MIN / 2;        /**< 上次降低时刻 */
+  bool hasDelayFeedback_ = false;                 /**< 是否收到过逐包反馈 */
+
+  // 丢包控制器
+  double lossRateKbps_ = 0;                    /**< 丢包控制器码率 */
+  int64_t lastLossUpdateUs_ = -1;              /**< 上次丢包码率更新时刻 */
+  int64_t lastLossDecreaseUs_ = INT64_MIN / 2; /**< 上次丢包降低时刻 */
+};
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+CongestionController::CongestionController(const CongestionControlParams& params)
+    : pImpl_(std::make_unique<Impl>(params)) {}
+
+CongestionController::~CongestionController() = default;
+
+void CongestionController::onReceiverReport(const ReceiverReport& report, int64_t nowUs) {
+  pImpl_->onReceiverReport(report, nowUs);
+}
+
+void CongestionController::onTransportFeedback(const std::vector<PacketFeedback>& feedback, int64_t nowUs) {
+  pImpl_->onTransportFeedback(feedback, nowUs);
+}
+
+int CongestionController::getTargetBitrate() const { return pImpl_->getTargetBitrate(); }
+
+BandwidthUsage CongestionController::getUsage() const { return pImpl_->getUsage(); }
+
+const CongestionControlParams& CongestionController::getParams() const { return pImpl_->getParams(); }
+
+bool CongestionController::parseReceiverReport(const void* data, int size, uint32_t ssrc, ReceiverReport* report) {
+  const auto* p = static_cast<const uint8_t*>(data);
+  int offset = 0;
+
+  // 遍历RTCP复合包
+  while (offset + 8 <= size) {
+    const uint8_t* hdr = p + offset;
+    if ((hdr[0] >> 6) != 2) {
+      return false;
+    }
+    int count = hdr[0] & 0x1f;
+    uint8_t type = hdr[1];
+    int length = ((hdr[2] << 8) | hdr[3]) * 4 + 4;
+    if (offset + length > size) {
+      return false;
+    }
+
+    // SR在报告块前有20字节发送者信息；一个包可以报告多个源，只取报告本端流的块
+    int blockOffset = type == RTCP_SR ? 28 : 8;
+    for (int i = 0; (type == RTCP_SR || type == RTCP_RR) && i < count && blockOffset + 24 <= length; i++) {
+      const uint8_t* block = hdr + blockOffset;
+      blockOffset += 24;
+      if (readU32(block) != ssrc) {
+        continue;
+      }
+      report->ssrc = ssrc;
+      report->fractionLost = block[4];
+      int32_t lost = (block[5] << 16) | (block[6] << 8) | block[7];
+      report->cumulativeLost = (lost & 0x800000) ? lost - 0x1000000 : lost;
+      report->highestSequence = readU32(block + 8);
+      report->jitter = readU32(block + 12);
+      report->lastSenderReport = readU32(block + 16);
+      report->delaySinceLastSr = readU32(block + 20);
+      return true;
+    }
+
+    offset += length;
+  }
+
+  return false;
+}
+
+}  // namespace camera_toolkit
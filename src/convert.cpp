@@ -4,8 +4,12 @@
  */
 #include "camera_toolkit/convert.h"
 
+#include <algorithm>
 #include <cstring>
+#include <utility>
+#include <vector>
 
+#include "camera_toolkit/trace.h"
 #include "ffmpeg_common.h"
 #include "log.h"
 
@@ -77,6 +81,36 @@ class Convert::Impl {
     av_image_fill_arrays(dstFrame_->data, dstFrame_->linesize, dstBuffer_, outAVFormat_, params_.outWidth,
                          params_.outHeight, 1);
 
+    output_.width = params_.outWidth;
+    output_.height = params_.outHeight;
+    output_.format = params_.outPixelFormat;
+    for (int i = 0; i < 3; i++) {
+      output_.planes[i] = dstFrame_->data[i];
+      output_.strides[i] = dstFrame_->linesize[i];
+    }
+
+    // 分条高度须为输入色度垂直采样间隔的整数倍
+    chromaShift_ = av_pix_fmt_desc_get(inAVFormat_)->log2_chroma_h;
+    if (params_.sliceHeight > 0) {
+      const int align = 1 << chromaShift_;
+      sliceHeight_ = (params_.sliceHeight + align - 1) / align * align;
+    }
+
+    // 尺寸不变时各行的转换互不依赖，可以按水平带并行
+    if (params_.scheduler && params_.inWidth == params_.outWidth && params_.inHeight == params_.outHeight) {
+      try {
+        createBands();
+      } catch (...) {
+        freeBands();
+        av_free(dstBuffer_);
+        av_frame_free(&dstFrame_);
+        av_free(srcBuffer_);
+        av_frame_free(&srcFrame_);
+        sws_freeContext(swsCtx_);
+        throw;
+      }
+    }
+
     log::info("Convert opened");
   }
 
@@ -84,6 +118,7 @@ class Convert::Impl {
    * @brief 析构函数
    */
   ~Impl() {
+    freeBands();
     if (dstBuffer_) av_free(dstBuffer_);
     if (dstFrame_) av_frame_free(&dstFrame_);
     if (srcBuffer_) av_free(srcBuffer_);
@@ -99,18 +134,65 @@ class Convert::Impl {
    * @return 包含转换后图像的Buffer
    */
   Buffer convert(const Buffer& input) {
+    CK_TRACE_SCOPE("convert");
     if (input.size != srcBufferSize_) {
       throw ConvertException("Input buffer size mismatch: expected " + std::to_string(srcBufferSize_) + ", got " +
                              std::to_string(input.size));
     }
 
-    std::memcpy(srcBuffer_, input.data, input.size);
+    if (!bands_.empty() && (sliceHeight_ <= 0 || !rowCallback_)) {
+      convertBands(input);
+      if (rowCallback_) rowCallback_(output_, 0, params_.outHeight);
+      return Buffer(dstBuffer_, dstBufferSize_);
+    }
 
-    sws_scale(swsCtx_, srcFrame_->data, srcFrame_->linesize, 0, params_.inHeight, dstFrame_->data, dstFrame_->linesize);
+    if (sliceHeight_ <= 0 || !rowCallback_) {
+      std::memcpy(srcBuffer_, input.data, input.size);
+      sws_scale(swsCtx_, srcFrame_->data, srcFrame_->linesize, 0, params_.inHeight, dstFrame_->data,
+                dstFrame_->linesize);
+      if (rowCallback_) rowCallback_(output_, 0, params_.outHeight);
+      return Buffer(dstBuffer_, dstBufferSize_);
+    }
+
+    // 分条转换: 每条输入只拷贝和缩放一次，新输出的行趁还在缓存中交给回调绘制
+    int written = 0;
+    int drawn = 0;
+    for (int y = 0; y < params_.inHeight; y += sliceHeight_) {
+      const int height = std::min(sliceHeight_, params_.inHeight - y);
+      const uint8_t* slice[4] = {};
+      for (int i = 0; i < 4 && srcFrame_->data[i]; i++) {
+        const int row = i == 0 || i == 3 ? y : y >> chromaShift_;
+        const int rows = i == 0 || i == 3 ? height : (height + (1 << chromaShift_) - 1) >> chromaShift_;
+        const size_t offset = static_cast<size_t>(srcFrame_->data[i] - srcBuffer_) +
+                              static_cast<size_t>(row) * srcFrame_->linesize[i];
+        std::memcpy(srcBuffer_ + offset, static_cast<const uint8_t*>(input.data) + offset,
+                    static_cast<size_t>(rows) * srcFrame_->linesize[i]);
+        slice[i] = srcBuffer_ + offset;
+      }
+      const int lines = sws_scale(swsCtx_, slice, srcFrame_->linesize, y, height, dstFrame_->data, dstFrame_->linesize);
+      if (lines < 0) {
+        throw ConvertException("Failed to scale slice at row " + std::to_string(y));
+      }
+      written += lines;
+
+      // 除最后一批外只交出偶数行，保证4:2:0输出的色度行与亮度行一起完成
+      const int ready = written >= params_.outHeight ? params_.outHeight : written & ~1;
+      if (ready > drawn) {
+        rowCallback_(output_, drawn, ready);
+        drawn = ready;
+      }
+    }
+    if (drawn < params_.outHeight) rowCallback_(output_, drawn, params_.outHeight);
 
     return Buffer(dstBuffer_, dstBufferSize_);
   }
 
+  /**
+   * @brief 设置行回调
+   * @param callback 行回调
+   */
+  void setRowCallback(RowCallback callback) { rowCallback_ = std::move(callback); }
+
   /**
    * @brief 获取转换参数
    * @return 转换参数引用
@@ -124,6 +206,94 @@ class Convert::Impl {
   int getOutputSize() const { return dstBufferSize_; }
 
  private:
+  /**
+   * @brief 并行转换的水平带
+   */
+  struct Band {
+    int y = 0;                    /**< 首行 */
+    int height = 0;               /**< 行数 */
+    SwsContext* swsCtx = nullptr; /**< 该带专用的swscale上下文 */
+  };
+
+  /**
+   * @brief 按调度器线程数切分水平带，每带创建一个只转换该带的swscale上下文
+   * @throws ConvertException 创建上下文失败时抛出
+   */
+  void createBands() {
+    // 带高取16行的整数倍，满足输入输出色度的垂直采样间隔，且每带不至于太薄
+    constexpr int BAND_ALIGN = 16;
+    const int maxBands = std::min(params_.scheduler->getThreadCount(), params_.inHeight / BAND_ALIGN);
+    if (maxBands < 2) return;
+    const int perBand = (params_.inHeight + maxBands - 1) / maxBands;
+    const int bandHeight = (perBand + BAND_ALIGN - 1) / BAND_ALIGN * BAND_ALIGN;
+
+    outChromaShift_ = av_pix_fmt_desc_get(outAVFormat_)->log2_chroma_h;
+    for (int y = 0; y < params_.inHeight; y += bandHeight) {
+      Band band;
+      band.y = y;
+      band.height = std::min(bandHeight, params_.inHeight - y);
+      band.swsCtx = sws_getContext(params_.inWidth, band.height, inAVFormat_, params_.outWidth, band.height,
+                                   outAVFormat_, SWS_BILINEAR, nullptr, nullptr, nullptr);
+      if (!band.swsCtx) {
+        throw ConvertException("Failed to create scale context for band at row " + std::to_string(y));
+      }
+      bands_.push_back(band);
+    }
+  }
+
+  /**
+   * @brief 释放各水平带的swscale上下文
+   */
+  void freeBands() {
+    for (Band& band : bands_) sws_freeContext(band.swsCtx);
+    bands_.clear();
+  }
+
+  /**
+   * @brief 计算平面中某行的偏移
+   * @param plane 平面序号
+   * @param row 亮度行号
+   * @param shift 色度垂直下采样位移
+   * @param linesize 该平面的行跨度
+   * @return 相对平面起点的字节偏移
+   */
+  static size_t rowOffset(int plane, int row, int shift, int linesize) {
+    const int planeRow = plane == 0 || plane == 3 ? row : row >> shift;
+    return static_cast<size_t>(planeRow) * linesize;
+  }
+
+  /**
+   * @brief 在调度器上并行转换各水平带，每带拷贝并转换自己的输入行
+   * @param input 输入缓冲区
+   * @throws ConvertException 某带转换失败时抛出
+   */
+  void convertBands(const Buffer& input) {
+    CK_TRACE_SCOPE("convert.bands");
+    params_.scheduler->parallelFor(
+        static_cast<int>(bands_.size()),
+        [this, &input](int index) {
+          const Band& band = bands_[static_cast<size_t>(index)];
+          const uint8_t* src[4] = {};
+          uint8_t* dst[4] = {};
+          for (int i = 0; i < 4 && srcFrame_->data[i]; i++) {
+            const int rows =
+                i == 0 || i == 3 ? band.height : (band.height + (1 << chromaShift_) - 1) >> chromaShift_;
+            const size_t offset = static_cast<size_t>(srcFrame_->data[i] - srcBuffer_) +
+                                  rowOffset(i, band.y, chromaShift_, srcFrame_->linesize[i]);
+            std::memcpy(srcBuffer_ + offset, static_cast<const uint8_t*>(input.data) + offset,
+                        static_cast<size_t>(rows) * srcFrame_->linesize[i]);
+            src[i] = srcBuffer_ + offset;
+          }
+          for (int i = 0; i < 4 && dstFrame_->data[i]; i++) {
+            dst[i] = dstFrame_->data[i] + rowOffset(i, band.y, outChromaShift_, dstFrame_->linesize[i]);
+          }
+          if (sws_scale(band.swsCtx, src, srcFrame_->linesize, 0, band.height, dst, dstFrame_->linesize) < 0) {
+            throw ConvertException("Failed to scale band at row " + std::to_string(band.y));
+          }
+        },
+        TaskPriority::High);
+  }
+
   ConvertParams params_;                        /**< 转换参数 */
   SwsContext* swsCtx_ = nullptr;                /**< swscale上下文 */
   AVFrame* srcFrame_ = nullptr;                 /**< 源帧 */
@@ -134,6 +304,12 @@ class Convert::Impl {
   int dstBufferSize_ = 0;                       /**< 目标缓冲区大小 */
   AVPixelFormat inAVFormat_ = AV_PIX_FMT_NONE;  /**< 输入FFmpeg格式 */
   AVPixelFormat outAVFormat_ = AV_PIX_FMT_NONE; /**< 输出FFmpeg格式 */
+  FrameView output_;                            /**< 目标帧视图 */
+  RowCallback rowCallback_;                     /**< 行回调 */
+  int sliceHeight_ = 0;                         /**< 分条高度(输入行数，0=整帧) */
+  int chromaShift_ = 0;                         /**< 输入色度垂直下采样位移 */
+  std::vector<Band> bands_;                     /**< 并行转换的水平带，为空表示整帧顺序转换 */
+  int outChromaShift_ = 0;                      /**< 并行转换时输出色度垂直下采样位移 */
 };
 
 // ============================================================================
@@ -146,6 +322,8 @@ Convert::~Convert() = default;
 
 Buffer Convert::convert(const Buffer& input) { return pImpl_->convert(input); }
 
+void Convert::setRowCallback(RowCallback callback) { pImpl_->setRowCallback(std::move(callback)); }
+
 const ConvertParams& Convert::getParams() const { return pImpl_->getParams(); }
 
 int Convert::getOutputSize() const { return pImpl_->getOutputSize(); }
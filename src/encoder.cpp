@@ -6,6 +6,7 @@
 
 #include <cstring>
 
+#include "camera_toolkit/trace.h"
 #include "ffmpeg_common.h"
 #include "log.h"
 
@@ -43,6 +44,7 @@ class Encoder::Impl {
     ctx_->gop_size = params_.gop;
     ctx_->max_b_frames = 1;
     ctx_->pix_fmt = AV_PIX_FMT_YUV420P;
+    ctx_->thread_count = params_.threads;
 
     // 设置低延迟选项
     av_opt_set(ctx_->priv_data, "preset", "ultrafast", 0);
@@ -117,6 +119,7 @@ class Encoder::Impl {
    * @throws EncodeException 编码失败时抛出
    */
   EncodedFrame encode(const Buffer& input) {
+    CK_TRACE_SCOPE("encode");
     if (input.size != inBufferSize_) {
       throw EncodeException("Input buffer size mismatch: expected " + std::to_string(inBufferSize_) + ", got " +
                             std::to_string(input.size));
@@ -148,6 +151,8 @@ class Encoder::Impl {
 
     EncodedFrame result;
     result.buffer = Buffer(packet_->data, packet_->size);
+    result.ptsUs = packet_->pts * 1000000 * ctx_->time_base.num / ctx_->time_base.den;
+    result.dtsUs = packet_->dts * 1000000 * ctx_->time_base.num / ctx_->time_base.den;
 
     // 确定帧类型
     if (packet_->flags & AV_PKT_FLAG_KEY) {
@@ -10,6 +10,7 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
@@ -28,6 +29,8 @@ inline AVPixelFormat toAVPixelFormat(PixelFormat format) {
   switch (format) {
     case PixelFormat::YUV420:
       return AV_PIX_FMT_YUV420P;
+    case PixelFormat::NV12:
+      return AV_PIX_FMT_NV12;
     case PixelFormat::YUYV:
       return AV_PIX_FMT_YUYV422;
     case PixelFormat::RGB565:
@@ -48,6 +51,8 @@ inline AVPixelFormat v4l2ToAVPixelFormat(uint32_t v4lFormat) {
   switch (v4lFormat) {
     case V4L2_PIX_FMT_YUV420:
       return AV_PIX_FMT_YUV420P;
+    case V4L2_PIX_FMT_NV12:
+      return AV_PIX_FMT_NV12;
     case V4L2_PIX_FMT_YUYV:
       return AV_PIX_FMT_YUYV422;
     case V4L2_PIX_FMT_RGB565:
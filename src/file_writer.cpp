@@ -0,0 +1,411 @@
+/**
+ * @file file_writer.cpp
+ * @brief 异步文件写入类实现
+ */
+#include "camera_toolkit/file_writer.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/trace.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr size_t ALIGNMENT = 4096; /**< O_DIRECT要求的缓冲区地址、长度和文件偏移对齐 */
+
+/**
+ * @brief 向上取整到对齐边界
+ * @param value 值
+ * @return 对齐后的值
+ */
+size_t alignUp(size_t value) { return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+}  // anonymous namespace
+
+/**
+ * @brief AsyncFileWriter类的PIMPL实现
+ */
+class AsyncFileWriter::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   */
+  explicit Impl(const FileWriterParams& params)
+      : params_(params), bufferSize_(alignUp(std::max<size_t>(params.bufferSize, 1))), path_(params.path) {
+    if (!openFile()) {
+      throw CameraToolkitException("Failed to open output file " + path_ + ": " + std::strerror(errno));
+    }
+
+    const int count = std::max(params_.bufferCount, 2);
+    for (int i = 0; i < count; i++) {
+      void* data = nullptr;
+      if (posix_memalign(&data, ALIGNMENT, bufferSize_) != 0) {
+        releaseBuffers();
+        close(fd_);
+        throw CameraToolkitException("Failed to allocate file writer buffers");
+      }
+      blocks_.push_back(Block{static_cast<uint8_t*>(data), 0, 0});
+      if (i > 0) free_.push_back(i);
+    }
+    current_ = 0;
+
+    thread_ = std::thread(&Impl::run, this);
+    log::info("File writer opened " + path_ + (direct_ ? " (O_DIRECT)" : ""));
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() {
+    flush();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      quit_ = true;
+    }
+    writeCv_.notify_one();
+    thread_.join();
+    closeFile();
+    releaseBuffers();
+  }
+
+  /**
+   * @brief 追加数据
+   * @param data 数据指针
+   * @param size 数据大小
+   * @return 成功返回true，被丢弃返回false
+   */
+  bool write(const void* data, size_t size) {
+    Block* block = &blocks_[current_];
+    const size_t room = bufferSize_ - block->used;
+    if (size > room && params_.dropWhenFull) {
+      // 整块数据要么全部写入要么全部丢弃，避免文件中出现半个包
+      const size_t needed = (size - room + bufferSize_ - 1) / bufferSize_;
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_.size() < needed) {
+        stats_.dropped++;
+        return false;
+      }
+    }
+
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+      const size_t n = std::min(size, bufferSize_ - block->used);
+      std::memcpy(block->data + block->used, src, n);
+      block->used += n;
+      src += n;
+      size -= n;
+      if (block->used == bufferSize_) {
+        submit(0);
+        block = &blocks_[current_];
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief 写出全部数据并等待完成
+   */
+  void flush() {
+    const Block& block = blocks_[current_];
+    if (block.used > 0) {
+      // O_DIRECT只能整页写入：不满一页的尾部补零写出，同时保留在下一个缓冲区开头，下次从对齐位置重写。
+      // 按请求的directIO判断，实际退回普通写入时重写相同数据也不影响结果
+      submit(params_.directIO ? block.used % ALIGNMENT : 0);
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    freeCv_.wait(lock, [this] { return full_.empty() && !busy_; });
+  }
+
+  /**
+   * @brief 之后追加的数据写入新文件
+   * @param path 新文件路径
+   */
+  void reopen(const std::string& path) {
+    if (blocks_[current_].used > 0) submit(0);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      reopens_.push_back(path);
+      full_.push_back(REOPEN);
+    }
+    writeCv_.notify_one();
+    fileOffset_ = 0;
+  }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  FileWriterStats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FileWriterStats stats = stats_;
+    stats.queuedBuffers = static_cast<int>(full_.size() - reopens_.size());
+    stats.directIO = direct_;
+    return stats;
+  }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const FileWriterParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 缓冲区
+   */
+  struct Block {
+    uint8_t* data;   /**< 对齐的数据区 */
+    size_t used;     /**< 已填充字节数 */
+    uint64_t offset; /**< 在文件中的起始偏移 */
+  };
+
+  /**
+   * @brief 打开path_，按需启用O_DIRECT和预分配
+   * @return 成功返回true，失败时errno为错误码
+   */
+  bool openFile() {
+    const int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    bool direct = false;
+    if (params_.directIO) {
+      fd_ = open(path_.c_str(), flags | O_DIRECT, 0644);
+      if (fd_ >= 0) {
+        direct = true;
+      } else if (errno == EINVAL) {
+        log::warn("O_DIRECT not supported for " + path_ + ", using buffered writes");
+      }
+    }
+    if (fd_ < 0) {
+      fd_ = open(path_.c_str(), flags, 0644);
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      direct_ = direct;
+    }
+    if (fd_ < 0) return false;
+    if (params_.preallocate > 0 &&
+        fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(params_.preallocate)) != 0) {
+      log::warn("fallocate failed for " + path_ + ": " + std::strerror(errno));
+    }
+    writtenEnd_ = 0;
+    return true;
+  }
+
+  /**
+   * @brief 释放预分配但未使用的空间并关闭文件
+   */
+  void closeFile() {
+    if (fd_ < 0) return;
+    if (params_.preallocate > 0 && ftruncate(fd_, static_cast<off_t>(writtenEnd_)) != 0) {
+      log::warn("Failed to trim preallocated space: " + std::string(std::strerror(errno)));
+    }
+    close(fd_);
+    fd_ = -1;
+  }
+
+  /**
+   * @brief 在写盘线程中关闭当前文件并打开下一个文件
+   * @param path 新文件路径
+   */
+  void switchFile(std::string path) {
+    closeFile();
+    path_ = std::move(path);
+    if (!openFile()) {
+      log::error("Failed to open output file " + path_ + ": " + std::strerror(errno));
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.errors++;
+      return;
+    }
+    log::info("File writer switched to " + path_ + (direct_ ? " (O_DIRECT)" : ""));
+  }
+
+  /**
+   * @brief 把当前缓冲区交给写盘线程，并取一个空闲缓冲区继续填充
+   * @param keep 当前缓冲区末尾需要复制到新缓冲区开头的字节数
+   */
+  void submit(size_t keep) {
+    Block& block = blocks_[current_];
+    block.offset = fileOffset_;
+    fileOffset_ += block.used - keep;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    full_.push_back(current_);
+    stats_.queuedBytes += block.used;
+    stats_.maxQueuedBuffers = std::max(stats_.maxQueuedBuffers, static_cast<int>(full_.size()));
+    writeCv_.notify_one();
+
+    if (free_.empty()) {
+      stats_.stalls++;
+      freeCv_.wait(lock, [this] { return !free_.empty(); });
+    }
+    const int next = free_.front();
+    free_.pop_front();
+    lock.unlock();
+
+    blocks_[next].used = keep;
+    if (keep > 0) std::memcpy(blocks_[next].data, block.data + block.used - keep, keep);
+    current_ = next;
+  }
+
+  /**
+   * @brief 写盘线程主循环
+   */
+  void run() {
+    while (true) {
+      int index;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        writeCv_.wait(lock, [this] { return !full_.empty() || quit_; });
+        if (full_.empty()) return;
+        index = full_.front();
+        busy_ = true;
+      }
+
+      if (index == REOPEN) {
+        std::string path;
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          path = std::move(reopens_.front());
+          reopens_.pop_front();
+        }
+        switchFile(std::move(path));
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          full_.pop_front();
+          busy_ = false;
+        }
+        freeCv_.notify_all();
+        continue;
+      }
+
+      Block& block = blocks_[index];
+      size_t length = block.used;
+      if (direct_ && length % ALIGNMENT != 0) {
+        length = alignUp(length);
+        std::memset(block.data + block.used, 0, length - block.used);
+      }
+      uint64_t writes = 0;
+      // 文件打开失败时丢弃数据，错误已在打开时计数
+      const bool ok = fd_ >= 0 && writeAll(block.data, length, block.offset, &writes);
+      if (ok) writtenEnd_ = std::max<uint64_t>(writtenEnd_, block.offset + block.used);
+      if (ok && length != block.used) trimPadding(block.offset + block.used);
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        full_.pop_front();
+        free_.push_back(index);
+        busy_ = false;
+        stats_.queuedBytes -= block.used;
+        stats_.writes += writes;
+        if (ok) {
+          stats_.bytesWritten += block.used;
+        } else if (fd_ >= 0) {
+          stats_.errors++;
+        }
+      }
+      freeCv_.notify_all();
+    }
+  }
+
+  /**
+   * @brief 截掉补零写出的尾部，并恢复被截断释放的预分配空间
+   * @param end 有效数据的文件末尾
+   *
+   * ftruncate会连同FALLOC_FL_KEEP_SIZE预分配的部分一起释放文件末尾之后的空间，需要重新预分配
+   */
+  void trimPadding(uint64_t end) {
+    if (ftruncate(fd_, static_cast<off_t>(end)) != 0) {
+      log::warn("Failed to truncate padded write: " + std::string(std::strerror(errno)));
+      return;
+    }
+    const uint64_t preallocate = static_cast<uint64_t>(params_.preallocate);
+    if (preallocate > end &&
+        fallocate(fd_, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(end), static_cast<off_t>(preallocate - end)) != 0) {
+      log::warn("fallocate failed for " + path_ + ": " + std::strerror(errno));
+    }
+  }
+
+  /**
+   * @brief 在指定偏移写入全部数据
+   * @param data 数据
+   * @param length 长度
+   * @param offset 文件偏移
+   * @param writes 输出系统调用次数
+   * @return 成功返回true
+   */
+  bool writeAll(const uint8_t* data, size_t length, uint64_t offset, uint64_t* writes) {
+    CK_TRACE_SCOPE("file.write");
+    size_t done = 0;
+    while (done < length) {
+      const ssize_t n = pwrite(fd_, data + done, length - done, static_cast<off_t>(offset + done));
+      (*writes)++;
+      if (n < 0 && errno == EINTR) continue;
+      if (n <= 0) {
+        log::error("Write to " + path_ + " failed: " + std::string(n < 0 ? std::strerror(errno) : "no progress"));
+        return false;
+      }
+      done += static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  /**
+   * @brief 释放缓冲区
+   */
+  void releaseBuffers() {
+    for (Block& block : blocks_) std::free(block.data);
+    blocks_.clear();
+  }
+
+  static constexpr int REOPEN = -1; /**< full_中的切换文件标记，对应reopens_队首的路径 */
+
+  FileWriterParams params_;         /**< 配置参数 */
+  size_t bufferSize_;               /**< 对齐后的缓冲区大小 */
+  std::string path_;                /**< 当前文件路径(构造后只由写盘线程访问) */
+  int fd_ = -1;                     /**< 文件描述符(构造后只由写盘线程访问)，打开失败时为-1 */
+  bool direct_ = false;             /**< 当前文件实际是否使用O_DIRECT(写盘线程持锁修改) */
+  uint64_t writtenEnd_ = 0;         /**< 当前文件已写数据的末尾(写盘线程) */
+  std::vector<Block> blocks_;       /**< 全部缓冲区 */
+  int current_ = 0;                 /**< 调用线程正在填充的缓冲区 */
+  uint64_t fileOffset_ = 0;         /**< 当前缓冲区在文件中的起始偏移 */
+  mutable std::mutex mutex_;        /**< 保护队列和统计 */
+  std::condition_variable writeCv_; /**< 通知写盘线程 */
+  std::condition_variable freeCv_;  /**< 通知调用线程有空闲缓冲区或写盘完成 */
+  std::deque<int> full_;            /**< 等待写盘的缓冲区或REOPEN(队首可能正在处理) */
+  std::deque<std::string> reopens_; /**< 等待切换的文件路径 */
+  std::deque<int> free_;            /**< 空闲缓冲区 */
+  bool busy_ = false;               /**< 写盘线程正在写 */
+  bool quit_ = false;               /**< 退出标志 */
+  FileWriterStats stats_;           /**< 统计 */
+  std::thread thread_;              /**< 写盘线程 */
+};
+
+AsyncFileWriter::AsyncFileWriter(const FileWriterParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+AsyncFileWriter::~AsyncFileWriter() = default;
+
+bool AsyncFileWriter::write(const void* data, size_t size) { return pImpl_->write(data, size); }
+
+void AsyncFileWriter::flush() { pImpl_->flush(); }
+
+void AsyncFileWriter::reopen(const std::string& path) { pImpl_->reopen(path); }
+
+FileWriterStats AsyncFileWriter::getStats() const { return pImpl_->getStats(); }
+
+const FileWriterParams& AsyncFileWriter::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
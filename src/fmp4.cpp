@@ -0,0 +1,300 @@
+/**
+ * @file fmp4.cpp
+ * @brief 分段MP4(fMP4)生成实现
+ */
+#include "fmp4.h"
+
+#include "h264_nal.h"
+
+namespace camera_toolkit {
+
+namespace fmp4 {
+
+namespace {
+
+constexpr uint32_t SAMPLE_FLAGS_SYNC = 0x02000000;     /**< sample_depends_on=2(不依赖其他帧) */
+constexpr uint32_t SAMPLE_FLAGS_NON_SYNC = 0x01010000; /**< sample_depends_on=1，sample_is_non_sync_sample=1 */
+
+/**
+ * @brief 大端序MP4 box写入器，写入调用方提供的(可复用的)缓冲区
+ */
+class BoxWriter {
+ public:
+  /**
+   * @brief 构造函数
+   * @param out 输出缓冲区
+   */
+  explicit BoxWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  void u8(uint32_t v) { out_.push_back(static_cast<uint8_t>(v)); }
+
+  void u16(uint32_t v) {
+    u8(v >> 8);
+    u8(v);
+  }
+
+  void u32(uint32_t v) {
+    u16(v >> 16);
+    u16(v);
+  }
+
+  void u64(uint64_t v) {
+    u32(static_cast<uint32_t>(v >> 32));
+    u32(static_cast<uint32_t>(v));
+  }
+
+  void bytes(const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    out_.insert(out_.end(), p, p + size);
+  }
+
+  void zeros(size_t count) { out_.insert(out_.end(), count, 0); }
+
+  /**
+   * @brief 开始一个box
+   * @param type 四字符类型
+   * @return box起始位置，传给end()
+   */
+  size_t begin(const char* type) {
+    const size_t pos = out_.size();
+    u32(0);
+    bytes(type, 4);
+    return pos;
+  }
+
+  /**
+   * @brief 开始一个full box
+   * @param type 四字符类型
+   * @param version 版本
+   * @param flags 标志
+   * @return box起始位置
+   */
+  size_t beginFull(const char* type, uint32_t version, uint32_t flags) {
+    const size_t pos = begin(type);
+    u32(version << 24 | flags);
+    return pos;
+  }
+
+  /**
+   * @brief 结束box，回填大小
+   * @param pos begin()返回的位置
+   */
+  void end(size_t pos) { patch32(pos, static_cast<uint32_t>(out_.size() - pos)); }
+
+  /**
+   * @brief 回填32位值
+   * @param pos 位置
+   * @param v 值
+   */
+  void patch32(size_t pos, uint32_t v) {
+    out_[pos] = static_cast<uint8_t>(v >> 24);
+    out_[pos + 1] = static_cast<uint8_t>(v >> 16);
+    out_[pos + 2] = static_cast<uint8_t>(v >> 8);
+    out_[pos + 3] = static_cast<uint8_t>(v);
+  }
+
+  size_t size() const { return out_.size(); }
+
+ private:
+  std::vector<uint8_t>& out_; /**< 输出缓冲区 */
+};
+
+/**
+ * @brief 写入单位变换矩阵
+ * @param w 写入器
+ */
+void writeMatrix(BoxWriter& w) {
+  const uint32_t matrix[9] = {0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000};
+  for (uint32_t v : matrix) w.u32(v);
+}
+
+}  // anonymous namespace
+
+void writeInit(std::vector<uint8_t>& out, int width, int height, const std::vector<uint8_t>& sps,
+               const std::vector<uint8_t>& pps) {
+  BoxWriter w(out);
+  size_t ftyp = w.begin("ftyp");
+  w.bytes("isom", 4);
+  w.u32(0x200);
+  w.bytes("isomiso6avc1mp41", 16);
+  w.end(ftyp);
+
+  size_t moov = w.begin("moov");
+  size_t mvhd = w.beginFull("mvhd", 0, 0);
+  w.u32(0);  // creation_time
+  w.u32(0);  // modification_time
+  w.u32(1000);
+  w.u32(0);  // duration由片段决定
+  w.u32(0x00010000);
+  w.u16(0x0100);
+  w.zeros(10);
+  writeMatrix(w);
+  w.zeros(24);
+  w.u32(TRACK_ID + 1);
+  w.end(mvhd);
+
+  size_t trak = w.begin("trak");
+  size_t tkhd = w.beginFull("tkhd", 0, 3);  // enabled | in_movie
+  w.u32(0);
+  w.u32(0);
+  w.u32(TRACK_ID);
+  w.u32(0);
+  w.u32(0);
+  w.zeros(8);
+  w.u16(0);  // layer
+  w.u16(0);  // alternate_group
+  w.u16(0);  // volume
+  w.u16(0);
+  writeMatrix(w);
+  w.u32(static_cast<uint32_t>(width) << 16);
+  w.u32(static_cast<uint32_t>(height) << 16);
+  w.end(tkhd);
+
+  size_t mdia = w.begin("mdia");
+  size_t mdhd = w.beginFull("mdhd", 0, 0);
+  w.u32(0);
+  w.u32(0);
+  w.u32(TIMESCALE);
+  w.u32(0);
+  w.u16(0x55C4);  // "und"
+  w.u16(0);
+  w.end(mdhd);
+  size_t hdlr = w.beginFull("hdlr", 0, 0);
+  w.u32(0);
+  w.bytes("vide", 4);
+  w.zeros(12);
+  w.bytes("VideoHandler", 13);
+  w.end(hdlr);
+
+  size_t minf = w.begin("minf");
+  size_t vmhd = w.beginFull("vmhd", 0, 1);
+  w.zeros(8);
+  w.end(vmhd);
+  size_t dinf = w.begin("dinf");
+  size_t dref = w.beginFull("dref", 0, 0);
+  w.u32(1);
+  size_t url = w.beginFull("url ", 0, 1);  // 数据在同一文件中
+  w.end(url);
+  w.end(dref);
+  w.end(dinf);
+
+  size_t stbl = w.begin("stbl");
+  size_t stsd = w.beginFull("stsd", 0, 0);
+  w.u32(1);
+  size_t avc1 = w.begin("avc1");
+  w.zeros(6);
+  w.u16(1);  // data_reference_index
+  w.zeros(16);
+  w.u16(static_cast<uint32_t>(width));
+  w.u16(static_cast<uint32_t>(height));
+  w.u32(0x00480000);  // 72dpi
+  w.u32(0x00480000);
+  w.u32(0);
+  w.u16(1);  // frame_count
+  w.zeros(32);
+  w.u16(0x0018);
+  w.u16(0xFFFF);
+  size_t avcC = w.begin("avcC");
+  w.u8(1);
+  w.u8(sps[1]);  // profile_idc
+  w.u8(sps[2]);  // constraint flags
+  w.u8(sps[3]);  // level_idc
+  w.u8(0xFF);     // 4字节长度前缀
+  w.u8(0xE1);     // 1个SPS
+  w.u16(static_cast<uint32_t>(sps.size()));
+  w.bytes(sps.data(), sps.size());
+  w.u8(1);
+  w.u16(static_cast<uint32_t>(pps.size()));
+  w.bytes(pps.data(), pps.size());
+  if (sps[1] == 100 || sps[1] == 110 || sps[1] == 122 || sps[1] == 244) {
+    // High系列profile的扩展字段：编码器输入固定为8位4:2:0
+    w.u8(0xFC | 1);
+    w.u8(0xF8);
+    w.u8(0xF8);
+    w.u8(0);
+  }
+  w.end(avcC);
+  w.end(avc1);
+  w.end(stsd);
+  for (const char* type : {"stts", "stsc", "stco"}) {
+    size_t box = w.beginFull(type, 0, 0);
+    w.u32(0);
+    w.end(box);
+  }
+  size_t stsz = w.beginFull("stsz", 0, 0);
+  w.u32(0);
+  w.u32(0);
+  w.end(stsz);
+  w.end(stbl);
+  w.end(minf);
+  w.end(mdia);
+  w.end(trak);
+
+  size_t mvex = w.begin("mvex");
+  size_t trex = w.beginFull("trex", 0, 0);
+  w.u32(TRACK_ID);
+  w.u32(1);
+  w.u32(0);
+  w.u32(0);
+  w.u32(0);
+  w.end(trex);
+  w.end(mvex);
+  w.end(moov);
+}
+
+void writeFragment(std::vector<uint8_t>& out, uint32_t sequence, int64_t baseDts, const Sample* samples,
+                   size_t count) {
+  const size_t start = out.size();
+  BoxWriter w(out);
+  size_t moof = w.begin("moof");
+  size_t mfhd = w.beginFull("mfhd", 0, 0);
+  w.u32(sequence);
+  w.end(mfhd);
+
+  size_t traf = w.begin("traf");
+  size_t tfhd = w.beginFull("tfhd", 0, 0x020000);  // default-base-is-moof
+  w.u32(TRACK_ID);
+  w.end(tfhd);
+  size_t tfdt = w.beginFull("tfdt", 1, 0);
+  w.u64(static_cast<uint64_t>(baseDts));
+  w.end(tfdt);
+
+  // data-offset | duration | size | flags | composition-time-offset
+  size_t trun = w.beginFull("trun", 1, 0x000F01);
+  w.u32(static_cast<uint32_t>(count));
+  const size_t dataOffset = w.size();
+  w.u32(0);
+  size_t payload = 0;
+  for (size_t i = 0; i < count; i++) {
+    w.u32(samples[i].duration);
+    w.u32(samples[i].size);
+    w.u32(samples[i].sync ? SAMPLE_FLAGS_SYNC : SAMPLE_FLAGS_NON_SYNC);
+    w.u32(static_cast<uint32_t>(samples[i].compositionOffset));
+    payload += samples[i].size;
+  }
+  w.end(trun);
+  w.end(traf);
+  w.end(moof);
+
+  // 数据偏移相对moof起始，指向mdat box头之后
+  w.patch32(dataOffset, static_cast<uint32_t>(out.size() - start + 8));
+  w.u32(static_cast<uint32_t>(payload + 8));
+  w.bytes("mdat", 4);
+}
+
+size_t appendSample(std::vector<uint8_t>& out, const uint8_t* data, size_t size) {
+  const size_t before = out.size();
+  forEachNal(data, size, [&](const uint8_t* unit, size_t len) {
+    const int type = unit[0] & 0x1F;
+    if (type == nal::SPS || type == nal::PPS || type == nal::AUD) return;
+    const uint8_t prefix[4] = {static_cast<uint8_t>(len >> 24), static_cast<uint8_t>(len >> 16),
+                               static_cast<uint8_t>(len >> 8), static_cast<uint8_t>(len)};
+    out.insert(out.end(), prefix, prefix + 4);
+    out.insert(out.end(), unit, unit + len);
+  });
+  return out.size() - before;
+}
+
+}  // namespace fmp4
+
+}  // namespace camera_toolkit
@@ -0,0 +1,73 @@
+/**
+ * @file fmp4.h
+ * @brief 分段MP4(fMP4)的H264初始化段和片段生成
+ *
+ * 仅供库内部源文件使用，不对外暴露。
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace camera_toolkit {
+
+namespace fmp4 {
+
+constexpr uint32_t TIMESCALE = 90000; /**< 媒体时间刻度(90kHz，与RTP一致) */
+constexpr uint32_t TRACK_ID = 1;      /**< 视频轨道ID */
+
+/**
+ * @brief 片段中的一个样本
+ */
+struct Sample {
+  uint32_t size = 0;             /**< 样本字节数(长度前缀格式) */
+  uint32_t duration = 0;         /**< 时长(刻度) */
+  int32_t compositionOffset = 0; /**< 显示时刻减解码时刻(刻度) */
+  bool sync = false;             /**< 是否为IDR */
+};
+
+/**
+ * @brief 微秒换算为媒体时间刻度(四舍五入)
+ * @param us 微秒
+ * @return 90kHz刻度
+ */
+inline int64_t toTicks(int64_t us) {
+  const int64_t scaled = us * TIMESCALE;
+  return (scaled >= 0 ? scaled + 500000 : scaled - 500000) / 1000000;
+}
+
+/**
+ * @brief 追加初始化段(ftyp + moov)
+ * @param out 输出缓冲区
+ * @param width 视频宽度
+ * @param height 视频高度
+ * @param sps SPS(不含起始码，至少4字节)
+ * @param pps PPS(不含起始码)
+ */
+void writeInit(std::vector<uint8_t>& out, int width, int height, const std::vector<uint8_t>& sps,
+               const std::vector<uint8_t>& pps);
+
+/**
+ * @brief 追加片段头(moof + mdat box头)，调用方随后写入各样本数据
+ * @param out 输出缓冲区
+ * @param sequence moof序号
+ * @param baseDts 首个样本的解码时刻(刻度)
+ * @param samples 样本
+ * @param count 样本数
+ */
+void writeFragment(std::vector<uint8_t>& out, uint32_t sequence, int64_t baseDts, const Sample* samples,
+                   size_t count);
+
+/**
+ * @brief 把Annex-B访问单元转换为4字节长度前缀格式追加到缓冲区，跳过SPS/PPS/AUD
+ * @param out 输出缓冲区
+ * @param data 访问单元
+ * @param size 访问单元字节数
+ * @return 追加的字节数
+ */
+size_t appendSample(std::vector<uint8_t>& out, const uint8_t* data, size_t size);
+
+}  // namespace fmp4
+
+}  // namespace camera_toolkit
@@ -0,0 +1,70 @@
+/**
+ * @file h264_nal.h
+ * @brief H264 Annex-B码流NAL单元遍历
+ *
+ * 仅供库内部源文件使用，不对外暴露。
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace camera_toolkit {
+
+/**
+ * @brief H264 NAL单元类型
+ */
+namespace nal {
+constexpr int SLICE = 1; /**< 非IDR图像条带 */
+constexpr int IDR = 5;   /**< IDR图像条带 */
+constexpr int SPS = 7;   /**< 序列参数集 */
+constexpr int PPS = 8;   /**< 图像参数集 */
+constexpr int AUD = 9;   /**< 访问单元分隔符 */
+}  // namespace nal
+
+/**
+ * @brief 遍历Annex-B码流中的NAL单元
+ * @param data 码流
+ * @param size 码流大小
+ * @param fn 回调fn(nal, size)，nal不含起始码
+ */
+template <typename Fn>
+void forEachNal(const uint8_t* data, size_t size, Fn&& fn) {
+  // 查找下一个00 00 01起始码，返回其后第一个字节的位置
+  auto next = [&](size_t from) {
+    for (size_t i = from; i + 3 <= size; i++) {
+      if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1) return i + 3;
+    }
+    return size;
+  };
+  size_t start = next(0);
+  while (start < size) {
+    const size_t following = next(start);
+    size_t end = following < size ? following - 3 : size;
+    while (end > start && data[end - 1] == 0) end--;  // 4字节起始码的前导0和trailing_zero_8bits
+    if (end > start) fn(data + start, end - start);
+    start = following;
+  }
+}
+
+/**
+ * @brief 判断访问单元是否含图像数据以及是否为IDR
+ * @param data 码流
+ * @param size 码流大小
+ * @param idr 输出是否含IDR条带
+ * @return 含图像条带返回true，只有参数集等头信息时返回false
+ */
+inline bool scanAccessUnit(const uint8_t* data, size_t size, bool* idr) {
+  bool picture = false;
+  *idr = false;
+  forEachNal(data, size, [&](const uint8_t* unit, size_t) {
+    const int type = unit[0] & 0x1F;
+    if (type >= nal::SLICE && type <= nal::IDR) {
+      picture = true;
+      *idr = *idr || type == nal::IDR;
+    }
+  });
+  return picture;
+}
+
+}  // namespace camera_toolkit
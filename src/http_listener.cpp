@@ -0,0 +1,224 @@
+/**
+ * @file http_listener.cpp
+ * @brief 基于epoll的HTTP监听实现
+ */
+#include "http_listener.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <utility>
+
+#include "camera_toolkit/common.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr size_t MAX_REQUEST_SIZE = 8192; /**< 请求头最大长度 */
+constexpr int MAX_EVENTS = 64;            /**< 每次epoll_wait处理的事件数 */
+
+/**
+ * @brief 获取单调时钟毫秒数
+ * @return 毫秒
+ */
+int64_t nowMs() {
+  struct timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+}  // anonymous namespace
+
+HttpListener::HttpListener(const HttpListenerParams& params) : params_(params) {
+  struct sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(params_.port));
+  if (params_.port < 0 || params_.port > 65535 || inet_pton(AF_INET, params_.address.c_str(), &addr.sin_addr) != 1) {
+    throw NetworkException("Invalid " + params_.name + " address: " + params_.address + ":" +
+                           std::to_string(params_.port));
+  }
+
+  listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listenFd_ < 0) {
+    throw NetworkException("Failed to create " + params_.name + " socket");
+  }
+  int reuse = 1;
+  setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+  if (bind(listenFd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0 ||
+      listen(listenFd_, params_.backlog) < 0) {
+    const std::string reason = std::strerror(errno);
+    close(listenFd_);
+    throw NetworkException("Failed to listen on " + params_.address + ":" + std::to_string(params_.port) + ": " +
+                           reason);
+  }
+  socklen_t len = sizeof(addr);
+  getsockname(listenFd_, reinterpret_cast<struct sockaddr*>(&addr), &len);
+  port_ = ntohs(addr.sin_port);
+
+  epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+  wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (epollFd_ < 0 || wakeFd_ < 0) {
+    closeAll();
+    throw NetworkException("Failed to create " + params_.name + " event loop");
+  }
+  control(listenFd_, EPOLLIN, EPOLL_CTL_ADD);
+  control(wakeFd_, EPOLLIN, EPOLL_CTL_ADD);
+}
+
+HttpListener::~HttpListener() {
+  stop();
+  closeAll();
+}
+
+void HttpListener::start(HttpHandlers handlers) {
+  handlers_ = std::move(handlers);
+  thread_ = std::thread([this] { run(); });
+}
+
+void HttpListener::stop() {
+  running_ = false;
+  wake();
+  if (thread_.joinable()) thread_.join();
+}
+
+void HttpListener::wake() {
+  uint64_t one = 1;
+  if (write(wakeFd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+    log::warn("Failed to wake " + params_.name + " thread");
+  }
+}
+
+void HttpListener::watch(int fd, uint32_t events) { control(fd, events, EPOLL_CTL_MOD); }
+
+void HttpListener::drop(int fd) {
+  auto it = connections_.find(fd);
+  if (it == connections_.end()) return;
+  connections_.erase(it);
+  epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+  close(fd);
+  if (handlers_.closed) handlers_.closed(fd);
+}
+
+void HttpListener::run() {
+  struct epoll_event events[MAX_EVENTS];
+  while (true) {
+    const int n = epoll_wait(epollFd_, events, MAX_EVENTS, std::min(params_.idleTimeoutMs, 1000));
+    if (n < 0 && errno != EINTR) {
+      log::error("Failed to wait for " + params_.name + " events: " + std::string(std::strerror(errno)));
+      return;
+    }
+    for (int i = 0; i < n; i++) {
+      const int fd = events[i].data.fd;
+      if (fd == wakeFd_) {
+        uint64_t count;
+        if (read(wakeFd_, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+          log::warn("Failed to read " + params_.name + " wake counter");
+        }
+        if (!running_) return;
+        if (handlers_.wake) handlers_.wake();
+      } else if (fd == listenFd_) {
+        acceptAll();
+      } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        drop(fd);
+      } else {
+        // 同一批事件中前面的回调可能已关闭该连接
+        if ((events[i].events & EPOLLOUT) && handlers_.writable && connections_.count(fd) != 0) {
+          handlers_.writable(fd);
+        }
+        auto it = connections_.find(fd);
+        if ((events[i].events & EPOLLIN) && it != connections_.end()) receive(fd, it->second);
+      }
+    }
+    expire();
+  }
+}
+
+void HttpListener::acceptAll() {
+  while (true) {
+    const int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) return;
+    if (static_cast<int>(connections_.size()) >= params_.maxConnections) {
+      close(fd);
+      continue;
+    }
+    connections_[fd].acceptMs = nowMs();
+    if (handlers_.accept) handlers_.accept(fd);
+    control(fd, EPOLLIN, EPOLL_CTL_ADD);
+  }
+}
+
+void HttpListener::receive(int fd, Connection& conn) {
+  char data[2048];
+  while (true) {
+    const ssize_t n = read(fd, data, sizeof(data));
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      drop(fd);
+      return;
+    }
+    if (n < 0) break;
+    if (conn.answered) continue;  // 请求之后的数据忽略
+    conn.request.append(data, static_cast<size_t>(n));
+    if (conn.request.size() > MAX_REQUEST_SIZE) {
+      conn.answered = true;
+      conn.request.clear();
+      if (handlers_.oversized) {
+        handlers_.oversized(fd);
+      } else {
+        drop(fd);
+      }
+      return;
+    }
+  }
+  if (conn.answered || conn.request.find("\r\n\r\n") == std::string::npos) return;
+
+  // 请求行: METHOD SP PATH SP VERSION
+  const size_t methodEnd = conn.request.find(' ');
+  const size_t pathEnd = conn.request.find(' ', methodEnd + 1);
+  const std::string method = conn.request.substr(0, methodEnd);
+  std::string path = conn.request.substr(methodEnd + 1, pathEnd - methodEnd - 1);
+  path = path.substr(0, path.find('?'));
+  conn.answered = true;
+  conn.request.clear();
+  if (handlers_.request) handlers_.request(fd, method, path);
+}
+
+void HttpListener::expire() {
+  const int64_t now = nowMs();
+  stale_.clear();
+  for (const auto& entry : connections_) {
+    const Connection& conn = entry.second;
+    const bool waiting = !conn.answered && now - conn.acceptMs > params_.idleTimeoutMs;
+    if (waiting || (conn.answered && handlers_.stalled && handlers_.stalled(entry.first, now))) {
+      stale_.push_back(entry.first);
+    }
+  }
+  for (int fd : stale_) drop(fd);
+}
+
+void HttpListener::control(int fd, uint32_t events, int op) {
+  struct epoll_event ev{};
+  ev.events = events;
+  ev.data.fd = fd;
+  epoll_ctl(epollFd_, op, fd, &ev);
+}
+
+void HttpListener::closeAll() {
+  for (const auto& entry : connections_) close(entry.first);
+  connections_.clear();
+  if (wakeFd_ >= 0) close(wakeFd_);
+  if (epollFd_ >= 0) close(epollFd_);
+  if (listenFd_ >= 0) close(listenFd_);
+  wakeFd_ = epollFd_ = listenFd_ = -1;
+}
+
+}  // namespace camera_toolkit
@@ -0,0 +1,166 @@
+/**
+ * @file http_listener.h
+ * @brief 基于epoll的HTTP监听和请求行解析
+ *
+ * 仅供库内部源文件使用，不对外暴露。直播服务和指标端点共用它管理监听套接字、
+ * 事件循环、连接接受、请求头读取和超时，响应的生成和发送由各自的回调负责。
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace camera_toolkit {
+
+/**
+ * @brief HTTP监听配置参数
+ */
+struct HttpListenerParams {
+  std::string name;         /**< 服务名称，用于日志和异常信息(如"stream") */
+  std::string address;      /**< 监听地址 */
+  int port = 0;             /**< 监听端口(0表示由系统分配) */
+  int backlog = 16;         /**< listen队列长度 */
+  int maxConnections = 16;  /**< 最大连接数，超出的新连接直接关闭 */
+  int idleTimeoutMs = 5000; /**< 请求头须在此时间内收完，回调判定停滞的连接也在超时检查时关闭 */
+};
+
+/**
+ * @brief HTTP监听事件回调，都在服务线程中调用，未设置的回调忽略
+ */
+struct HttpHandlers {
+  /** 请求回调(连接、方法、路径) */
+  using Request = std::function<void(int fd, const std::string& method, const std::string& path)>;
+
+  std::function<void(int fd)> accept;                 /**< 接受新连接后(可设置套接字选项) */
+  Request request;                                    /**< 收到完整请求头，path不含查询串；之后收到的数据丢弃 */
+  std::function<void(int fd)> oversized;              /**< 请求头超过长度上限，未设置时关闭连接 */
+  std::function<void(int fd)> writable;               /**< 连接可写(回调用watch关注EPOLLOUT后) */
+  std::function<bool(int fd, int64_t nowMs)> stalled; /**< 已收到请求的连接是否停滞，返回true时关闭 */
+  std::function<void(int fd)> closed;                 /**< 连接已关闭，释放回调方的连接状态 */
+  std::function<void()> wake;                         /**< wake()唤醒了服务线程 */
+};
+
+/**
+ * @class HttpListener
+ * @brief HTTP监听类
+ *
+ * 构造时绑定端口并创建epoll实例和eventfd，start()启动服务线程。连接由本类接受、读取请求头
+ * 并解析请求行，之后交给回调生成响应；回调通过watch()切换关注的事件，通过drop()关闭连接。
+ *
+ * @note wake()、stop()和getPort()可在任意线程调用，其余成员函数只应在回调中(服务线程)调用
+ */
+class HttpListener {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   * @throws NetworkException 地址无效或监听失败时抛出
+   */
+  explicit HttpListener(const HttpListenerParams& params);
+
+  /**
+   * @brief 析构函数，停止服务线程并关闭所有连接
+   */
+  ~HttpListener();
+
+  HttpListener(const HttpListener&) = delete;
+  HttpListener& operator=(const HttpListener&) = delete;
+
+  /**
+   * @brief 启动服务线程
+   * @param handlers 事件回调
+   */
+  void start(HttpHandlers handlers);
+
+  /**
+   * @brief 停止并等待服务线程，可重复调用
+   */
+  void stop();
+
+  /**
+   * @brief 唤醒服务线程，调用wake回调
+   */
+  void wake();
+
+  /**
+   * @brief 修改连接关注的epoll事件
+   * @param fd 连接
+   * @param events 事件(EPOLLIN/EPOLLOUT组合)
+   */
+  void watch(int fd, uint32_t events);
+
+  /**
+   * @brief 关闭连接并调用closed回调，连接不存在时忽略
+   * @param fd 连接
+   */
+  void drop(int fd);
+
+  /**
+   * @brief 获取实际监听端口
+   * @return 端口
+   */
+  int getPort() const { return port_; }
+
+ private:
+  /**
+   * @brief 连接状态
+   */
+  struct Connection {
+    std::string request;   /**< 已收到的请求数据 */
+    int64_t acceptMs = 0;  /**< 接受连接的时刻 */
+    bool answered = false; /**< 已把请求交给回调 */
+  };
+
+  /**
+   * @brief 事件循环
+   */
+  void run();
+
+  /**
+   * @brief 接受所有待处理的连接
+   */
+  void acceptAll();
+
+  /**
+   * @brief 读取请求头，收完后解析请求行并调用request回调
+   * @param fd 连接
+   * @param conn 连接状态
+   */
+  void receive(int fd, Connection& conn);
+
+  /**
+   * @brief 关闭超时未收完请求头或回调判定停滞的连接
+   */
+  void expire();
+
+  /**
+   * @brief 注册或修改epoll关注的事件
+   * @param fd 文件描述符
+   * @param events 事件
+   * @param op EPOLL_CTL_ADD或EPOLL_CTL_MOD
+   */
+  void control(int fd, uint32_t events, int op);
+
+  /**
+   * @brief 关闭所有文件描述符
+   */
+  void closeAll();
+
+  HttpListenerParams params_;                       /**< 配置参数 */
+  HttpHandlers handlers_;                           /**< 事件回调 */
+  int listenFd_ = -1;                               /**< 监听套接字 */
+  int epollFd_ = -1;                                /**< epoll实例 */
+  int wakeFd_ = -1;                                 /**< 唤醒和停止通知 */
+  int port_ = 0;                                    /**< 实际监听端口 */
+  std::atomic<bool> running_{true};                 /**< 服务线程运行标志 */
+  std::unordered_map<int, Connection> connections_; /**< 活动连接(只在服务线程访问) */
+  std::vector<int> stale_;                          /**< 待关闭的连接(复用) */
+  std::thread thread_;                              /**< 服务线程 */
+};
+
+}  // namespace camera_toolkit
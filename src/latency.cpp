@@ -0,0 +1,218 @@
+/**
+ * @file latency.cpp
+ * @brief 逐帧时延跟踪类实现
+ */
+#include "camera_toolkit/latency.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int SUB_BITS = 6;                                         /**< 每个2的幂区间的细分位数 */
+constexpr int SUB_COUNT = 1 << SUB_BITS;                            /**< 每个2的幂区间的桶数 */
+constexpr int MAX_BITS = 40;                                        /**< 量程位数(2^40纳秒约18分钟) */
+constexpr int64_t MAX_VALUE = (int64_t{1} << MAX_BITS) - 1;         /**< 最大可记录值 */
+constexpr int BUCKET_COUNT = (MAX_BITS - SUB_BITS + 1) * SUB_COUNT; /**< 桶总数 */
+
+/**
+ * @brief 计算值所在的桶
+ * @param value 值(0到MAX_VALUE)
+ * @return 桶序号
+ * @note 小于2*SUB_COUNT的值每个值一个桶，之后每个2的幂区间SUB_COUNT个桶
+ */
+int bucketIndex(int64_t value) {
+  const int msb = 63 - __builtin_clzll(static_cast<uint64_t>(value) | 1);
+  const int shift = std::max(0, msb - SUB_BITS);
+  return shift * SUB_COUNT + static_cast<int>(value >> shift);
+}
+
+/**
+ * @brief 计算桶内的最大可能值
+ * @param index 桶序号
+ * @return 值
+ */
+int64_t bucketHighest(int index) {
+  const int shift = index < 2 * SUB_COUNT ? 0 : index / SUB_COUNT - 1;
+  const int64_t mantissa = index - shift * SUB_COUNT;
+  return ((mantissa + 1) << shift) - 1;
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// FrameTrace
+// ============================================================================
+
+void FrameTrace::mark(TraceStage stage) {
+  struct timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  mark(stage, static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec);
+}
+
+// ============================================================================
+// LatencyHistogram
+// ============================================================================
+
+LatencyHistogram::LatencyHistogram() : buckets_(BUCKET_COUNT, 0) {}
+
+void LatencyHistogram::record(int64_t valueNs) {
+  const int64_t value = std::clamp<int64_t>(valueNs, 0, MAX_VALUE);
+  buckets_[bucketIndex(value)]++;
+  min_ = count_ ? std::min(min_, value) : value;
+  max_ = std::max(max_, value);
+  sum_ += static_cast<double>(value);
+  count_++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+  if (other.count_ == 0) return;
+  for (int i = 0; i < BUCKET_COUNT; i++) buckets_[i] += other.buckets_[i];
+  min_ = count_ ? std::min(min_, other.min_) : other.min_;
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+  count_ += other.count_;
+}
+
+void LatencyHistogram::reset() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = 0;
+  min_ = 0;
+  max_ = 0;
+  sum_ = 0;
+}
+
+double LatencyHistogram::getMean() const { return count_ ? sum_ / static_cast<double>(count_) : 0; }
+
+int64_t LatencyHistogram::getPercentile(double percentile) const {
+  if (count_ == 0) return 0;
+  const double p = std::clamp(percentile, 0.0, 100.0);
+  // 减去微小量，避免99.9%这类不能精确表示的百分位因舍入多取一名
+  const double rank = std::ceil(p / 100.0 * static_cast<double>(count_) - 1e-9);
+  const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(rank));
+  uint64_t seen = 0;
+  for (int i = 0; i < BUCKET_COUNT; i++) {
+    seen += buckets_[i];
+    if (seen >= target) return std::min(bucketHighest(i), max_);
+  }
+  return max_;
+}
+
+// ============================================================================
+// LatencyTracer
+// ============================================================================
+
+/**
+ * @brief LatencyTracer类的PIMPL实现
+ */
+class LatencyTracer::Impl {
+ public:
+  /**
+   * @brief 汇总一帧的跟踪记录
+   * @param trace 跟踪记录
+   */
+  void record(const FrameTrace& trace) {
+    int64_t first = 0;
+    int64_t previous = 0;
+    int marked = 0;
+    for (int i = 0; i < TRACE_STAGE_COUNT; i++) {
+      const int64_t stamp = trace.stamps[i];
+      if (stamp == 0) continue;
+      if (marked++ == 0) {
+        first = stamp;
+      } else {
+        stages_[i].record(stamp - previous);
+      }
+      previous = stamp;
+    }
+    if (marked >= 2) endToEnd_.record(previous - first);
+  }
+
+  /**
+   * @brief 生成文本报表
+   * @return 报表文本
+   */
+  std::string report() const {
+    std::string text = "latency (us)        count      min      p50      p90      p99    p99.9      max\n";
+    for (int i = 0; i <= TRACE_STAGE_COUNT; i++) {
+      const bool total = i == TRACE_STAGE_COUNT;
+      const LatencyHistogram& h = total ? endToEnd_ : stages_[i];
+      if (h.getCount() == 0) continue;
+      char line[160];
+      snprintf(line, sizeof(line), "%-14s %10llu %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n",
+               total ? "end-to-end" : stageName(static_cast<TraceStage>(i)),
+               static_cast<unsigned long long>(h.getCount()), h.getMin() / 1e3, h.getPercentile(50) / 1e3,
+               h.getPercentile(90) / 1e3, h.getPercentile(99) / 1e3, h.getPercentile(99.9) / 1e3,
+               h.getMax() / 1e3);
+      text += line;
+    }
+    return text;
+  }
+
+  /**
+   * @brief 清空所有直方图
+   */
+  void reset() {
+    for (LatencyHistogram& h : stages_) h.reset();
+    endToEnd_.reset();
+  }
+
+  /**
+   * @brief 获取阶段直方图
+   * @param stage 阶段
+   * @return 直方图引用
+   */
+  const LatencyHistogram& getStage(TraceStage stage) const { return stages_[static_cast<int>(stage)]; }
+
+  /**
+   * @brief 获取端到端直方图
+   * @return 直方图引用
+   */
+  const LatencyHistogram& getEndToEnd() const { return endToEnd_; }
+
+ private:
+  LatencyHistogram stages_[TRACE_STAGE_COUNT]; /**< 各阶段直方图 */
+  LatencyHistogram endToEnd_;                  /**< 端到端直方图 */
+};
+
+LatencyTracer::LatencyTracer() : pImpl_(std::make_unique<Impl>()) {}
+
+LatencyTracer::~LatencyTracer() = default;
+
+void LatencyTracer::record(const FrameTrace& trace) { pImpl_->record(trace); }
+
+const LatencyHistogram& LatencyTracer::getStage(TraceStage stage) const { return pImpl_->getStage(stage); }
+
+const LatencyHistogram& LatencyTracer::getEndToEnd() const { return pImpl_->getEndToEnd(); }
+
+std::string LatencyTracer::report() const { return pImpl_->report(); }
+
+void LatencyTracer::reset() { pImpl_->reset(); }
+
+const char* LatencyTracer::stageName(TraceStage stage) {
+  switch (stage) {
+    case TraceStage::Dequeue:
+      return "dequeue";
+    case TraceStage::Convert:
+      return "convert";
+    case TraceStage::Overlay:
+      return "overlay";
+    case TraceStage::EncodeSubmit:
+      return "encode-submit";
+    case TraceStage::EncodeReturn:
+      return "encode";
+    case TraceStage::FirstPacket:
+      return "pack-first";
+    case TraceStage::LastPacket:
+      return "pack-last";
+    case TraceStage::Sent:
+      return "send";
+  }
+  return "unknown";
+}
+
+}  // namespace camera_toolkit
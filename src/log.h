@@ -2,34 +2,71 @@
  * @file log.h
  * @brief Camera Toolkit 内部日志工具
  *
- * 提供统一的日志输出接口，便于后续集中替换为正式日志框架。
- * 仅供库内部源文件使用，不对外暴露。
+ * 库内部源文件统一通过此接口记录日志，消息交给异步日志器(logger.h)由后台线程输出。
+ * 低于编译期级别CK_LOG_LEVEL的调用在编译时被去除。仅供库内部源文件使用，不对外暴露。
  */
 #pragma once
 
-#include <iostream>
 #include <string>
 
+#include "camera_toolkit/logger.h"
+
+/**
+ * @brief 编译期日志级别(0=Debug，1=Info，2=Warn，3=Error，4=Off)，默认调试构建为Debug，否则为Info
+ */
+#ifndef CK_LOG_LEVEL
+#ifdef DEBUG_MODE
+#define CK_LOG_LEVEL 0
+#else
+#define CK_LOG_LEVEL 1
+#endif
+#endif
+
 namespace camera_toolkit {
 namespace log {
 
+/**
+ * @brief 判断级别是否在编译期启用
+ * @param level 日志级别
+ * @return 是否启用
+ */
+constexpr bool enabled(LogLevel level) { return static_cast<int>(level) >= CK_LOG_LEVEL; }
+
+/**
+ * @brief 输出调试日志
+ * @param msg 日志消息
+ */
+inline void debug(const char* msg) {
+  if constexpr (enabled(LogLevel::Debug)) logMessage(LogLevel::Debug, msg);
+}
+inline void debug(const std::string& msg) { debug(msg.c_str()); }
+
 /**
  * @brief 输出信息日志（组件生命周期事件）
  * @param msg 日志消息
  */
-inline void info(const std::string& msg) { std::cout << "+++ " << msg << std::endl; }
+inline void info(const char* msg) {
+  if constexpr (enabled(LogLevel::Info)) logMessage(LogLevel::Info, msg);
+}
+inline void info(const std::string& msg) { info(msg.c_str()); }
 
 /**
  * @brief 输出警告日志（非致命异常路径）
  * @param msg 日志消息
  */
-inline void warn(const std::string& msg) { std::cerr << "!!! " << msg << std::endl; }
+inline void warn(const char* msg) {
+  if constexpr (enabled(LogLevel::Warn)) logMessage(LogLevel::Warn, msg);
+}
+inline void warn(const std::string& msg) { warn(msg.c_str()); }
 
 /**
  * @brief 输出错误日志（操作失败）
  * @param msg 日志消息
  */
-inline void error(const std::string& msg) { std::cerr << "--- " << msg << std::endl; }
+inline void error(const char* msg) {
+  if constexpr (enabled(LogLevel::Error)) logMessage(LogLevel::Error, msg);
+}
+inline void error(const std::string& msg) { error(msg.c_str()); }
 
 }  // namespace log
 }  // namespace camera_toolkit
@@ -0,0 +1,359 @@
+/**
+ * @file logger.cpp
+ * @brief 异步日志实现
+ */
+#include "camera_toolkit/logger.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr uint64_t QUEUE_SLOTS = 512;          /**< 环形缓冲槽数(2的幂) */
+constexpr size_t MESSAGE_SIZE = 240;           /**< 单条消息最大长度(含结尾'\0') */
+constexpr size_t RATE_SLOTS = 64;              /**< 限流表大小 */
+constexpr uint32_t RATE_BURST = 5;             /**< 限流窗口内允许输出的相同消息数 */
+constexpr int64_t RATE_WINDOW_NS = 1000000000; /**< 限流窗口长度 */
+constexpr useconds_t DRAIN_INTERVAL_US = 5000; /**< 队列为空时后台线程的轮询间隔 */
+
+static_assert((QUEUE_SLOTS & (QUEUE_SLOTS - 1)) == 0, "QUEUE_SLOTS must be a power of two");
+
+/**
+ * @brief 获取单调时钟(粗粒度，vDSO读取，无系统调用)
+ * @return 纳秒
+ */
+int64_t monotonicNs() {
+  struct timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief 计算消息的限流键(FNV-1a)
+ * @param level 日志级别
+ * @param message 日志消息
+ * @return 64位哈希
+ */
+uint64_t messageKey(LogLevel level, const char* message) {
+  uint64_t hash = 14695981039346656037ULL ^ static_cast<uint64_t>(level);
+  for (const char* p = message; *p != '\0'; p++) {
+    hash = (hash ^ static_cast<uint8_t>(*p)) * 1099511628211ULL;
+  }
+  return hash;
+}
+
+/**
+ * @brief 获取日志级别对应的行前缀
+ * @param level 日志级别
+ * @return 前缀字符串
+ */
+const char* levelPrefix(LogLevel level) {
+  switch (level) {
+    case LogLevel::Debug:
+      return "*** ";
+    case LogLevel::Info:
+      return "+++ ";
+    case LogLevel::Warn:
+      return "!!! ";
+    default:
+      return "--- ";
+  }
+}
+
+/**
+ * @brief 异步日志器
+ *
+ * 多生产者单消费者的有界环形队列(每槽一个序号，生产者CAS认领槽位)，后台线程批量输出后统一刷新
+ */
+class Logger {
+ public:
+  /**
+   * @brief 获取全局日志器
+   * @return 日志器引用
+   * @note 有意不析构: 静态对象析构期间仍可能记录日志，退出时由atexit回调停止后台线程并转为同步输出
+   */
+  static Logger& instance() {
+    static Logger* logger = new Logger();
+    return *logger;
+  }
+
+  /**
+   * @brief 记录一条日志
+   * @param level 日志级别
+   * @param message 日志消息
+   */
+  void log(LogLevel level, const char* message) {
+    if (message == nullptr || level >= LogLevel::Off) return;
+    if (static_cast<int>(level) < level_.load(std::memory_order_relaxed)) return;
+    uint32_t suppressed = 0;
+    if (!admit(level, message, &suppressed)) return;
+
+    // 先登记再检查stopped_，与shutdown()的顺序相反: 要么这里看到已停止，要么shutdown()等入队完成后再输出
+    producers_.fetch_add(1);
+    if (stopped_.load()) {
+      producers_.fetch_sub(1);
+      std::lock_guard<std::mutex> lock(sinkMutex_);
+      emit(level, message, suppressed);
+      flushStreams();
+      return;
+    }
+    enqueue(level, message, suppressed);
+    producers_.fetch_sub(1, std::memory_order_release);
+  }
+
+  /**
+   * @brief 设置运行时日志级别
+   * @param level 日志级别
+   */
+  void setLevel(LogLevel level) { level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+
+  /**
+   * @brief 获取运行时日志级别
+   * @return 日志级别
+   */
+  LogLevel getLevel() const { return static_cast<LogLevel>(level_.load(std::memory_order_relaxed)); }
+
+  /**
+   * @brief 设置输出回调
+   * @param sink 输出回调
+   */
+  void setSink(LogSink sink) {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    sink_ = std::move(sink);
+  }
+
+  /**
+   * @brief 等待已入队的日志全部输出
+   */
+  void flush() {
+    const uint64_t target = tail_.load(std::memory_order_acquire);
+    while (drained_.load(std::memory_order_acquire) < target && !stopped_.load(std::memory_order_acquire)) {
+      usleep(1000);
+    }
+  }
+
+  /**
+   * @brief 获取统计信息
+   * @return 统计信息
+   */
+  LogStats getStats() const {
+    LogStats stats;
+    stats.written = written_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.suppressed = suppressed_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+ private:
+  /**
+   * @brief 环形缓冲槽
+   */
+  struct Slot {
+    std::atomic<uint64_t> seq{0};    /**< 槽序号: 等于写位置时可写，等于写位置+1时可读 */
+    LogLevel level = LogLevel::Info; /**< 日志级别 */
+    uint32_t suppressed = 0;         /**< 此前被限流的相同消息数 */
+    char text[MESSAGE_SIZE] = {};    /**< 消息文本 */
+  };
+
+  /**
+   * @brief 限流表项
+   */
+  struct RateSlot {
+    std::atomic<uint64_t> key{0};        /**< 消息键 */
+    std::atomic<int64_t> windowStart{0}; /**< 当前窗口起始时刻 */
+    std::atomic<uint32_t> count{0};      /**< 当前窗口内的消息数 */
+    std::atomic<uint32_t> suppressed{0}; /**< 当前窗口内被限流的消息数 */
+  };
+
+  /**
+   * @brief 构造函数，启动后台输出线程
+   */
+  Logger() {
+    for (uint64_t i = 0; i < QUEUE_SLOTS; i++) slots_[i].seq.store(i, std::memory_order_relaxed);
+    thread_ = std::thread(&Logger::run, this);
+    std::atexit([] { instance().shutdown(); });
+  }
+
+  /**
+   * @brief 限流判断: 相同消息在一个窗口内只输出前RATE_BURST条
+   * @param level 日志级别
+   * @param message 日志消息
+   * @param suppressed 输出上一窗口被限流的条数
+   * @return 是否输出
+   * @note 表项冲突时新消息直接接管表项，竞争下计数可能略有偏差，但不会丢弃首条消息
+   */
+  bool admit(LogLevel level, const char* message, uint32_t* suppressed) {
+    const uint64_t key = messageKey(level, message);
+    const int64_t now = monotonicNs();
+    RateSlot& slot = rates_[key % RATE_SLOTS];
+
+    if (slot.key.load(std::memory_order_relaxed) != key) {
+      slot.key.store(key, std::memory_order_relaxed);
+      slot.windowStart.store(now, std::memory_order_relaxed);
+      slot.count.store(1, std::memory_order_relaxed);
+      slot.suppressed.store(0, std::memory_order_relaxed);
+      return true;
+    }
+    int64_t start = slot.windowStart.load(std::memory_order_relaxed);
+    if (now - start >= RATE_WINDOW_NS && slot.windowStart.compare_exchange_strong(start, now)) {
+      slot.count.store(1, std::memory_order_relaxed);
+      *suppressed = slot.suppressed.exchange(0, std::memory_order_relaxed);
+      return true;
+    }
+    if (slot.count.fetch_add(1, std::memory_order_relaxed) < RATE_BURST) return true;
+    slot.suppressed.fetch_add(1, std::memory_order_relaxed);
+    suppressed_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  /**
+   * @brief 消息入队，队列满时丢弃
+   * @param level 日志级别
+   * @param message 日志消息
+   * @param suppressed 此前被限流的相同消息数
+   */
+  void enqueue(LogLevel level, const char* message, uint32_t suppressed) {
+    uint64_t pos = tail_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &slots_[pos & (QUEUE_SLOTS - 1)];
+      const int64_t diff = static_cast<int64_t>(slot->seq.load(std::memory_order_acquire) - pos);
+      if (diff == 0) {
+        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        pos = tail_.load(std::memory_order_relaxed);
+      }
+    }
+    const size_t length = strnlen(message, MESSAGE_SIZE - 1);
+    std::memcpy(slot->text, message, length);
+    slot->text[length] = '\0';
+    slot->level = level;
+    slot->suppressed = suppressed;
+    slot->seq.store(pos + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief 后台线程主循环
+   */
+  void run() {
+    while (running_.load(std::memory_order_acquire)) {
+      if (drain() == 0) usleep(DRAIN_INTERVAL_US);
+    }
+  }
+
+  /**
+   * @brief 输出队列中所有已就绪的消息
+   * @return 输出的消息数
+   */
+  size_t drain() {
+    std::lock_guard<std::mutex> lock(sinkMutex_);
+    size_t count = 0;
+    for (;;) {
+      Slot& slot = slots_[head_ & (QUEUE_SLOTS - 1)];
+      if (slot.seq.load(std::memory_order_acquire) != head_ + 1) break;
+      emit(slot.level, slot.text, slot.suppressed);
+      slot.seq.store(head_ + QUEUE_SLOTS, std::memory_order_release);
+      head_++;
+      count++;
+    }
+    if (count > 0) {
+      flushStreams();
+      drained_.store(head_, std::memory_order_release);
+    }
+    return count;
+  }
+
+  /**
+   * @brief 输出一条消息(调用方持有sinkMutex_)
+   * @param level 日志级别
+   * @param text 消息文本
+   * @param suppressed 此前被限流的相同消息数
+   */
+  void emit(LogLevel level, const char* text, uint32_t suppressed) {
+    written_.fetch_add(1, std::memory_order_relaxed);
+    char line[MESSAGE_SIZE + 48];
+    const char* message = text;
+    if (suppressed > 0) {
+      snprintf(line, sizeof(line), "%s (%u similar messages suppressed)", text, suppressed);
+      message = line;
+    }
+    if (sink_) {
+      sink_(level, message);
+      return;
+    }
+    FILE* stream = level >= LogLevel::Warn ? stderr : stdout;
+    fputs(levelPrefix(level), stream);
+    fputs(message, stream);
+    fputc('\n', stream);
+  }
+
+  /**
+   * @brief 使用默认输出时刷新标准流
+   */
+  void flushStreams() {
+    if (sink_) return;
+    fflush(stdout);
+    fflush(stderr);
+  }
+
+  /**
+   * @brief 进程退出时停止后台线程，输出剩余消息并转为同步输出
+   */
+  void shutdown() {
+    stopped_.store(true);
+    running_.store(false, std::memory_order_release);
+    if (thread_.joinable()) thread_.join();
+    // 等检查stopped_时尚未看到停止的生产者入队完毕(入队不会阻塞)
+    while (producers_.load(std::memory_order_acquire) > 0) std::this_thread::yield();
+    drain();
+  }
+
+  Slot slots_[QUEUE_SLOTS];                                   /**< 环形缓冲区 */
+  RateSlot rates_[RATE_SLOTS];                                /**< 限流表 */
+  alignas(64) std::atomic<uint64_t> tail_{0};                 /**< 写位置(生产者共享) */
+  std::atomic<int> producers_{0};                             /**< 正在入队的生产者数，shutdown()据此等待 */
+  alignas(64) uint64_t head_ = 0;                             /**< 读位置(仅后台线程) */
+  std::atomic<uint64_t> drained_{0};                          /**< 已输出位置，供flush()等待 */
+  std::atomic<int> level_{static_cast<int>(LogLevel::Debug)}; /**< 运行时级别 */
+  std::atomic<uint64_t> written_{0};                          /**< 已输出消息数 */
+  std::atomic<uint64_t> dropped_{0};                          /**< 丢弃消息数 */
+  std::atomic<uint64_t> suppressed_{0};                       /**< 限流消息数 */
+  std::atomic<bool> running_{true};                           /**< 后台线程运行标志 */
+  std::atomic<bool> stopped_{false};                          /**< 已转为同步输出 */
+  std::mutex sinkMutex_;                                      /**< 保护输出回调与标准流(生产者不获取) */
+  LogSink sink_;                                              /**< 输出回调 */
+  std::thread thread_;                                        /**< 后台输出线程 */
+};
+
+}  // anonymous namespace
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+void logMessage(LogLevel level, const char* message) { Logger::instance().log(level, message); }
+
+void setLogLevel(LogLevel level) { Logger::instance().setLevel(level); }
+
+LogLevel getLogLevel() { return Logger::instance().getLevel(); }
+
+void setLogSink(LogSink sink) { Logger::instance().setSink(std::move(sink)); }
+
+void flushLog() { Logger::instance().flush(); }
+
+LogStats getLogStats() { return Logger::instance().getStats(); }
+
+}  // namespace camera_toolkit
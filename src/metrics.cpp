@@ -0,0 +1,397 @@
+/**
+ * @file metrics.cpp
+ * @brief 运行指标与Prometheus HTTP端点实现
+ */
+#include "camera_toolkit/metrics.h"
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "http_listener.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+/**
+ * @brief 检查指标名是否符合Prometheus命名规则
+ * @param name 指标名
+ * @return 合法返回true
+ */
+bool isValidName(const std::string& name) {
+  if (name.empty()) return false;
+  for (size_t i = 0; i < name.size(); i++) {
+    const char c = name[i];
+    const bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':';
+    if (!alpha && (i == 0 || c < '0' || c > '9')) return false;
+  }
+  return true;
+}
+
+/**
+ * @brief 检查标签名是否符合Prometheus命名规则(不含冒号，__前缀保留)
+ * @param name 标签名
+ * @return 合法返回true
+ */
+bool isValidLabelName(const std::string& name) {
+  return isValidName(name) && name.find(':') == std::string::npos && name.compare(0, 2, "__") != 0;
+}
+
+/**
+ * @brief 追加HELP说明，转义反斜杠和换行
+ * @param out 输出
+ * @param help 说明文字
+ */
+void appendHelp(std::string& out, const std::string& help) {
+  for (char c : help) {
+    if (c == '\\') {
+      out += "\\\\";
+    } else if (c == '\n') {
+      out += "\\n";
+    } else {
+      out += c;
+    }
+  }
+}
+
+/**
+ * @brief 追加标签集合，如{stream="cam1"}，值中转义反斜杠、双引号和换行
+ * @param out 输出
+ * @param labels 标签(非空)
+ */
+void appendLabels(std::string& out, const MetricLabels& labels) {
+  out += '{';
+  for (size_t i = 0; i < labels.size(); i++) {
+    if (i > 0) out += ',';
+    out += labels[i].first;
+    out += "=\"";
+    for (char c : labels[i].second) {
+      if (c == '\\' || c == '"') {
+        out += '\\';
+        out += c;
+      } else if (c == '\n') {
+        out += "\\n";
+      } else {
+        out += c;
+      }
+    }
+    out += '"';
+  }
+  out += '}';
+}
+
+/**
+ * @brief 追加浮点数值
+ * @param out 输出
+ * @param value 值
+ */
+void appendValue(std::string& out, double value) {
+  if (std::isnan(value)) {
+    out += "NaN";
+  } else if (std::isinf(value)) {
+    out += value > 0 ? "+Inf" : "-Inf";
+  } else {
+    char text[32];
+    snprintf(text, sizeof(text), "%.10g", value);
+    out += text;
+  }
+}
+
+/**
+ * @brief 获取CLOCK_MONOTONIC时刻
+ * @return 毫秒
+ */
+int64_t nowMs() {
+  struct timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+}  // anonymous namespace
+
+// ============================================================================
+// MetricsRegistry
+// ============================================================================
+
+/**
+ * @brief MetricsRegistry类的PIMPL实现
+ */
+class MetricsRegistry::Impl {
+ public:
+  /**
+   * @brief 注册计数器
+   * @param name 指标名
+   * @param help 说明文字
+   * @param scale 输出换算系数
+   * @param labels 标签
+   * @return 计数器引用
+   */
+  Counter& counter(const std::string& name, const std::string& help, double scale, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = add(name, help, labels, true);
+    entry.counter = std::make_unique<Counter>();
+    entry.scale = scale;
+    return *entry.counter;
+  }
+
+  /**
+   * @brief 注册仪表
+   * @param name 指标名
+   * @param help 说明文字
+   * @param labels 标签
+   * @return 仪表引用
+   */
+  Gauge& gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Entry& entry = add(name, help, labels, false);
+    entry.gauge = std::make_unique<Gauge>();
+    return *entry.gauge;
+  }
+
+  /**
+   * @brief 输出文本格式
+   * @return 文本
+   */
+  std::string render() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    out.reserve(entries_.size() * 128);
+    std::vector<bool> rendered(entries_.size(), false);
+    for (size_t i = 0; i < entries_.size(); i++) {
+      if (rendered[i]) continue;
+      // 同族的时间序列须连续输出，按族首次注册的顺序
+      const Entry& family = entries_[i];
+      out += "# HELP ";
+      out += family.name;
+      out += ' ';
+      appendHelp(out, family.help);
+      out += "\n# TYPE ";
+      out += family.name;
+      out += family.counter ? " counter\n" : " gauge\n";
+      for (size_t j = i; j < entries_.size(); j++) {
+        const Entry& entry = entries_[j];
+        if (rendered[j] || entry.name != family.name) continue;
+        rendered[j] = true;
+        out += entry.name;
+        if (!entry.labels.empty()) appendLabels(out, entry.labels);
+        out += ' ';
+        if (entry.counter && entry.scale == 1.0) {
+          out += std::to_string(entry.counter->get());
+        } else if (entry.counter) {
+          appendValue(out, static_cast<double>(entry.counter->get()) * entry.scale);
+        } else {
+          appendValue(out, entry.gauge->get());
+        }
+        out += '\n';
+      }
+    }
+    return out;
+  }
+
+ private:
+  /**
+   * @brief 指标条目
+   */
+  struct Entry {
+    std::string name;                 /**< 指标名 */
+    std::string help;                 /**< 说明文字 */
+    MetricLabels labels;              /**< 标签 */
+    std::unique_ptr<Counter> counter; /**< 计数器(仪表条目为空) */
+    std::unique_ptr<Gauge> gauge;     /**< 仪表(计数器条目为空) */
+    double scale = 1.0;               /**< 计数器输出换算系数 */
+  };
+
+  /**
+   * @brief 校验名称和标签并追加条目(调用方持有mutex_)
+   * @param name 指标名
+   * @param help 说明文字
+   * @param labels 标签
+   * @param isCounter 是否为计数器
+   * @return 新条目
+   * @throws CameraToolkitException 名称或标签名非法、重复或类型冲突时抛出
+   */
+  Entry& add(const std::string& name, const std::string& help, const MetricLabels& labels, bool isCounter) {
+    if (!isValidName(name)) {
+      throw CameraToolkitException("Invalid metric name: " + name);
+    }
+    for (const auto& label : labels) {
+      if (!isValidLabelName(label.first)) {
+        throw CameraToolkitException("Invalid label name for " + name + ": " + label.first);
+      }
+    }
+    for (const Entry& entry : entries_) {
+      if (entry.name != name) continue;
+      if ((entry.counter != nullptr) != isCounter) {
+        throw CameraToolkitException("Metric type mismatch: " + name);
+      }
+      if (entry.labels == labels) {
+        throw CameraToolkitException("Duplicate metric name: " + name);
+      }
+    }
+    entries_.push_back(Entry{name, help, labels, nullptr, nullptr, 1.0});
+    return entries_.back();
+  }
+
+  mutable std::mutex mutex_;  /**< 保护条目列表(只在注册和抓取时获取) */
+  std::deque<Entry> entries_; /**< 按注册顺序的条目 */
+};
+
+MetricsRegistry::MetricsRegistry() : pImpl_(std::make_unique<Impl>()) {}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, double scale,
+                                  const MetricLabels& labels) {
+  return pImpl_->counter(name, help, scale, labels);
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+  return pImpl_->gauge(name, help, labels);
+}
+
+std::string MetricsRegistry::render() const { return pImpl_->render(); }
+
+// ============================================================================
+// MetricsServer
+// ============================================================================
+
+/**
+ * @brief MetricsServer类的PIMPL实现
+ */
+class MetricsServer::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   * @param registry 指标注册表
+   */
+  Impl(const MetricsServerParams& params, const MetricsRegistry& registry)
+      : params_(params),
+        registry_(registry),
+        listener_(HttpListenerParams{"metrics", params.address, params.port, 16, params.maxConnections,
+                                     params.idleTimeoutMs}) {
+    HttpHandlers handlers;
+    handlers.request = [this](int fd, const std::string& method, const std::string& path) {
+      serve(fd, method, path);
+    };
+    handlers.oversized = [this](int fd) {
+      respond(fd, "431 Request Header Fields Too Large", "text/plain", "request too large\n", true);
+    };
+    handlers.writable = [this](int fd) { flush(fd); };
+    handlers.stalled = [this](int fd, int64_t now) {
+      auto it = connections_.find(fd);
+      return it != connections_.end() && now - it->second.respondMs > params_.idleTimeoutMs;
+    };
+    handlers.closed = [this](int fd) { connections_.erase(fd); };
+    listener_.start(std::move(handlers));
+    log::info("Metrics endpoint listening on " + params_.address + ":" + std::to_string(listener_.getPort()));
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { listener_.stop(); }
+
+  /**
+   * @brief 获取监听端口
+   * @return 端口
+   */
+  int getPort() const { return listener_.getPort(); }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const MetricsServerParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 连接状态
+   */
+  struct Connection {
+    std::string response;  /**< 待发送的响应 */
+    size_t sent = 0;       /**< 已发送的响应字节数 */
+    int64_t respondMs = 0; /**< 开始发送响应的时刻 */
+  };
+
+  /**
+   * @brief 按请求生成响应
+   * @param fd 连接
+   * @param method 请求方法
+   * @param path 请求路径
+   */
+  void serve(int fd, const std::string& method, const std::string& path) {
+    if (method != "GET" && method != "HEAD") {
+      respond(fd, "405 Method Not Allowed", "text/plain", "method not allowed\n", true);
+    } else if (path != "/metrics") {
+      respond(fd, "404 Not Found", "text/plain", "not found\n", method == "GET");
+    } else {
+      respond(fd, "200 OK", "text/plain; version=0.0.4; charset=utf-8", registry_.render(), method == "GET");
+    }
+  }
+
+  /**
+   * @brief 生成响应并开始发送
+   * @param fd 连接
+   * @param status 状态行
+   * @param contentType 内容类型
+   * @param body 响应体
+   * @param withBody 是否发送响应体(HEAD请求不发送)
+   */
+  void respond(int fd, const char* status, const char* contentType, const std::string& body, bool withBody) {
+    Connection& conn = connections_[fd];
+    conn.respondMs = nowMs();
+    conn.response = std::string("HTTP/1.1 ") + status + "\r\nContent-Type: " + contentType +
+                    "\r\nContent-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+    if (withBody) conn.response += body;
+    listener_.watch(fd, EPOLLOUT);
+    flush(fd);
+  }
+
+  /**
+   * @brief 发送待发送的响应，发完后关闭连接
+   * @param fd 连接
+   */
+  void flush(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    Connection& conn = it->second;
+    while (conn.sent < conn.response.size()) {
+      const ssize_t n = send(fd, conn.response.data() + conn.sent, conn.response.size() - conn.sent, MSG_NOSIGNAL);
+      if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) listener_.drop(fd);
+        return;
+      }
+      conn.sent += static_cast<size_t>(n);
+    }
+    listener_.drop(fd);
+  }
+
+  MetricsServerParams params_;                      /**< 配置参数 */
+  const MetricsRegistry& registry_;                 /**< 指标注册表 */
+  std::unordered_map<int, Connection> connections_; /**< 活动连接(只在服务线程访问) */
+  HttpListener listener_;                           /**< HTTP监听和服务线程，最后构造、最先停止 */
+};
+
+MetricsServer::MetricsServer(const MetricsServerParams& params, const MetricsRegistry& registry)
+    : pImpl_(std::make_unique<Impl>(params, registry)) {}
+
+MetricsServer::~MetricsServer() = default;
+
+int MetricsServer::getPort() const { return pImpl_->getPort(); }
+
+const MetricsServerParams& MetricsServer::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
@@ -5,17 +5,155 @@
 #include "camera_toolkit/network.h"
 
 #include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/net_tstamp.h>
+#include <linux/rtnetlink.h>
+#include <linux/sockios.h>
+#include <net/if.h>
 #include <netinet/in.h>
+#include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/time.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <cstring>
+#include <ctime>
+#include <vector>
 
+#include "camera_toolkit/trace.h"
 #include "log.h"
 
 namespace camera_toolkit {
 
+namespace {
+
+/**
+ * @brief 查找本地IPv4地址所属网络接口的索引
+ * @param local 本地地址
+ * @return 接口索引，未找到返回0
+ */
+unsigned int findInterfaceIndex(const struct sockaddr_in& local) {
+  struct ifaddrs* addrs = nullptr;
+  if (getifaddrs(&addrs) < 0) {
+    return 0;
+  }
+
+  unsigned int index = 0;
+  for (struct ifaddrs* ifa = addrs; ifa; ifa = ifa->ifa_next) {
+    if (!ifa->ifa_addr || ifa->ifa_addr->sa_family != AF_INET) {
+      continue;
+    }
+    auto* addr = reinterpret_cast<struct sockaddr_in*>(ifa->ifa_addr);
+    if (addr->sin_addr.s_addr == local.sin_addr.s_addr) {
+      index = if_nametoindex(ifa->ifa_name);
+      break;
+    }
+  }
+
+  freeifaddrs(addrs);
+  return index;
+}
+
+/**
+ * @brief 检查网络接口上是否挂载了fq qdisc
+ * @param ifindex 接口索引
+ * @return 存在fq qdisc返回true
+ *
+ * @note 没有fq时内核会忽略SO_TXTIME时间戳并立即发送。etf同样按时间戳调度，但它只接受与自身时钟
+ *       (通常为CLOCK_TAI)一致的时间戳并丢弃其余的包，而这里按CLOCK_MONOTONIC设置时间戳，因此不使用
+ */
+bool hasPacingQdisc(unsigned int ifindex) {
+  int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+  if (fd < 0) {
+    return false;
+  }
+
+  struct {
+    struct nlmsghdr nh;
+    struct tcmsg tc;
+  } req{};
+  req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct tcmsg));
+  req.nh.nlmsg_type = RTM_GETQDISC;
+  req.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.tc.tcm_family = AF_UNSPEC;
+
+  if (::send(fd, &req, req.nh.nlmsg_len, 0) < 0) {
+    close(fd);
+    return false;
+  }
+
+  bool found = false;
+  bool done = false;
+  alignas(struct nlmsghdr) char buf[16384];
+
+  while (!done) {
+    int len = ::recv(fd, buf, sizeof(buf), 0);
+    if (len <= 0) {
+      break;
+    }
+
+    for (auto* nh = reinterpret_cast<struct nlmsghdr*>(buf); NLMSG_OK(nh, static_cast<unsigned int>(len));
+         nh = NLMSG_NEXT(nh, len)) {
+      if (nh->nlmsg_type == NLMSG_DONE || nh->nlmsg_type == NLMSG_ERROR) {
+        done = true;
+        break;
+      }
+      if (nh->nlmsg_type != RTM_NEWQDISC) {
+        continue;
+      }
+
+      auto* tc = static_cast<struct tcmsg*>(NLMSG_DATA(nh));
+      if (static_cast<unsigned int>(tc->tcm_ifindex) != ifindex) {
+        continue;
+      }
+
+      int attrLen = static_cast<int>(nh->nlmsg_len - NLMSG_LENGTH(sizeof(*tc)));
+      for (auto* rta = reinterpret_cast<struct rtattr*>(reinterpret_cast<char*>(tc) + NLMSG_ALIGN(sizeof(*tc)));
+           RTA_OK(rta, attrLen); rta = RTA_NEXT(rta, attrLen)) {
+        if (rta->rta_type != TCA_KIND) {
+          continue;
+        }
+        const char* kind = static_cast<const char*>(RTA_DATA(rta));
+        if (std::strcmp(kind, "fq") == 0) {
+          found = true;
+        }
+      }
+    }
+  }
+
+  close(fd);
+  return found;
+}
+
+/**
+ * @brief 获取当前CLOCK_MONOTONIC时刻
+ * @return 当前时刻(纳秒)
+ */
+int64_t monotonicNs() {
+  struct timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+/**
+ * @brief 在用户态睡眠直到指定的CLOCK_MONOTONIC时刻
+ * @param deadlineNs 目标时刻(纳秒)
+ */
+void sleepUntil(int64_t deadlineNs) {
+  struct timespec ts{};
+  ts.tv_sec = deadlineNs / 1000000000;
+  ts.tv_nsec = deadlineNs % 1000000000;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+  }
+}
+
+}  // anonymous namespace
+
 /**
  * @brief Network类的PIMPL实现
  */
@@ -27,6 +165,478 @@ class Network::Impl {
    * @throws NetworkException 连接失败时抛出
    */
   explicit Impl(const NetworkParams& params) : params_(params) {
+    if (params_.type == NetworkType::UNIX) {
+      openUnix();
+    } else {
+      openInet();
+    }
+
+    setupBatch();
+    setupSocketOptions();
+
+    connected_ = true;
+    log::info("Network opened (" + describe() + ")");
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() {
+    if (socketFd_ >= 0) {
+      close(socketFd_);
+      socketFd_ = -1;
+    }
+    log::info("Network closed");
+  }
+
+  /**
+   * @brief 发送数据
+   * @param data 要发送的数据缓冲区
+   * @param size 数据大小(字节)
+   * @return 发送的字节数，错误返回-1
+   */
+  int send(const void* data, int size) {
+    CK_TRACE_SCOPE("network.send");
+    int64_t startNs = monotonicNs();
+    return recordSend(::send(socketFd_, data, size, MSG_NOSIGNAL), size, startNs);
+  }
+
+  /**
+   * @brief 批量发送数据
+   * @param buffers 每个包一个缓冲区
+   * @param count 包数
+   * @return 发送的包数，第一个包就失败时返回-1
+   *
+   * @note 不附带SCM_TXTIME，启用内核定时时fq把这些包当作无发送时刻的包立即发出
+   */
+  int sendBatch(const Buffer* buffers, int count) {
+    CK_TRACE_SCOPE("network.sendBatch");
+    if (sendMsgs_.empty()) {
+      // 未分配批量数组时逐个发送
+      for (int i = 0; i < count; ++i) {
+        if (send(buffers[i].data, buffers[i].size) < 0) return i > 0 ? i : -1;
+      }
+      return count;
+    }
+
+    int sent = 0;
+    while (sent < count) {
+      const int n = std::min(count - sent, static_cast<int>(sendMsgs_.size()));
+      for (int i = 0; i < n; ++i) {
+        sendIov_[i].iov_base = buffers[sent + i].data;
+        sendIov_[i].iov_len = static_cast<size_t>(buffers[sent + i].size);
+      }
+
+      int64_t startNs = monotonicNs();
+      int ret = ::sendmmsg(socketFd_, sendMsgs_.data(), n, MSG_NOSIGNAL);
+      if (ret == 0) {
+        // 一个包也没发出但没有报错，此时errno是之前遗留的值，按发送缓冲区满记录
+        errno = EAGAIN;
+      }
+      if (ret <= 0) {
+        recordSend(-1, 0, startNs);
+        return sent > 0 ? sent : -1;
+      }
+      recordLatency(startNs);
+      for (int i = 0; i < ret; ++i) {
+        recordResult(static_cast<int>(sendMsgs_[i].msg_len), static_cast<int>(sendIov_[i].iov_len));
+      }
+      sent += ret;
+      if (ret < n) break;  // 其余的包遇到错误，下次调用时由内核报告
+    }
+    return sent;
+  }
+
+  /**
+   * @brief 接收数据
+   * @param data 接收缓冲区
+   * @param size 最大接收字节数
+   * @return 接收的字节数，错误返回-1
+   */
+  int receive(void* data, int size) { return ::recv(socketFd_, data, size, 0); }
+
+  /**
+   * @brief 批量接收数据
+   * @param packets 输出包信息数组
+   * @param max packets数组容量
+   * @return 接收的包数，错误返回-1
+   */
+  int receiveBatch(ReceivedPacket* packets, int max) {
+    if (batchMsgs_.empty()) {
+      allocateReceiveBatch();
+    }
+    int count = std::min(max, static_cast<int>(batchMsgs_.size()));
+    if (count <= 0) {
+      return 0;
+    }
+
+    // recvmmsg会改写msg_controllen和msg_flags，每次调用前复位
+    for (int i = 0; i < count; ++i) {
+      struct msghdr& hdr = batchMsgs_[i].msg_hdr;
+      hdr.msg_controllen = params_.rxTimestamp ? sizeof(BatchControl) : 0;
+      hdr.msg_flags = 0;
+    }
+
+    int ret = ::recvmmsg(socketFd_, batchMsgs_.data(), count, MSG_WAITFORONE, nullptr);
+    if (ret < 0) {
+      return ret;
+    }
+
+    for (int i = 0; i < ret; ++i) {
+      struct msghdr& hdr = batchMsgs_[i].msg_hdr;
+      ReceivedPacket& pkt = packets[i];
+      pkt.data = static_cast<const uint8_t*>(batchIov_[i].iov_base);
+      pkt.size = static_cast<int>(batchMsgs_[i].msg_len);
+      pkt.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+      pkt.timestampNs = 0;
+
+      for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+          struct timespec ts;
+          std::memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+          pkt.timestampNs = static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+        }
+      }
+    }
+
+    return ret;
+  }
+
+  /**
+   * @brief 在指定时刻发送数据
+   * @param data 要发送的数据缓冲区
+   * @param size 数据大小(字节)
+   * @param txTimeNs 发送时刻(CLOCK_MONOTONIC纳秒)
+   * @return 发送的字节数，错误返回-1
+   *
+   * @note 内核定时可用时通过SCM_TXTIME交给fq qdisc调度，立即返回；
+   *       否则在用户态睡眠到发送时刻再发送
+   */
+  int sendAt(const void* data, int size, int64_t txTimeNs) {
+    CK_TRACE_SCOPE("network.sendAt");
+    if (!kernelPacing_) {
+      sleepUntil(txTimeNs);
+      return send(data, size);
+    }
+
+    struct iovec iov{const_cast<void*>(data), static_cast<size_t>(size)};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(uint64_t))] = {};
+
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_TXTIME;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint64_t));
+    uint64_t txTime = static_cast<uint64_t>(txTimeNs);
+    std::memcpy(CMSG_DATA(cmsg), &txTime, sizeof(txTime));
+
+    int64_t startNs = monotonicNs();
+    return recordSend(::sendmsg(socketFd_, &msg, MSG_NOSIGNAL), size, startNs);
+  }
+
+  /**
+   * @brief 是否由内核(SO_TXTIME + fq)负责发送定时
+   * @return 内核定时生效返回true
+   */
+  bool isKernelPacing() const { return kernelPacing_; }
+
+  /**
+   * @brief 发送文件描述符及附带的元数据
+   * @param fd 要传递的文件描述符
+   * @param meta 元数据缓冲区
+   * @param size 元数据大小(字节)
+   * @return 发送的元数据字节数，错误返回-1
+   * @throws NetworkException 非UNIX类型时抛出
+   */
+  int sendFd(int fd, const void* meta, int size) {
+    requireUnix("sendFd");
+
+    struct iovec iov{const_cast<void*>(meta), static_cast<size_t>(size)};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+
+    int64_t startNs = monotonicNs();
+    return recordSend(::sendmsg(socketFd_, &msg, MSG_NOSIGNAL), size, startNs);
+  }
+
+  /**
+   * @brief 接收文件描述符及附带的元数据
+   * @param meta 元数据接收缓冲区
+   * @param size 最大接收字节数
+   * @param fd 输出收到的文件描述符，未携带时为-1
+   * @return 接收的元数据字节数，错误返回-1
+   * @throws NetworkException 非UNIX类型时抛出
+   */
+  int receiveFd(void* meta, int size, int* fd) {
+    requireUnix("receiveFd");
+    *fd = -1;
+
+    struct iovec iov{meta, static_cast<size_t>(size)};
+    alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_PASSED_FDS)] = {};
+
+    struct msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    int ret = ::recvmsg(socketFd_, &msg, MSG_CMSG_CLOEXEC);
+    if (ret < 0) {
+      return ret;
+    }
+
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) {
+        continue;
+      }
+
+      // 只保留第一个描述符，多余的立即关闭以免泄漏
+      int count = static_cast<int>((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+      for (int i = 0; i < count; ++i) {
+        int received;
+        std::memcpy(&received, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+        if (*fd < 0) {
+          *fd = received;
+        } else {
+          close(received);
+        }
+      }
+    }
+
+    if (msg.msg_flags & MSG_CTRUNC) {
+      log::warn("Ancillary data truncated, some file descriptors were dropped");
+    }
+
+    return ret;
+  }
+
+  /**
+   * @brief 检查连接是否有效
+   * @return 已连接返回true
+   */
+  bool isConnected() const { return connected_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief 获取发送统计
+   * @return 统计快照
+   */
+  NetworkStats getStats() const {
+    NetworkStats stats;
+    stats.packetsSent = packetsSent_.load(std::memory_order_relaxed);
+    stats.bytesSent = bytesSent_.load(std::memory_order_relaxed);
+    stats.shortSends = shortSends_.load(std::memory_order_relaxed);
+    stats.wouldBlock = wouldBlock_.load(std::memory_order_relaxed);
+    stats.errors = errors_.load(std::memory_order_relaxed);
+    for (int i = 0; i < NetworkStats::LATENCY_BUCKETS; ++i) {
+      stats.sendLatency[i] = sendLatency_[i].load(std::memory_order_relaxed);
+    }
+
+    if (ioctl(socketFd_, SIOCOUTQ, &stats.queuedBytes) < 0) {
+      stats.queuedBytes = 0;
+    }
+    socklen_t len = sizeof(int);
+    getsockopt(socketFd_, SOL_SOCKET, SO_SNDBUF, &stats.sendBufferSize, &len);
+    len = sizeof(int);
+    getsockopt(socketFd_, SOL_SOCKET, SO_RCVBUF, &stats.receiveBufferSize, &len);
+    return stats;
+  }
+
+  /**
+   * @brief 清零发送计数器和耗时直方图
+   */
+  void resetStats() {
+    packetsSent_ = 0;
+    bytesSent_ = 0;
+    shortSends_ = 0;
+    wouldBlock_ = 0;
+    errors_ = 0;
+    for (auto& bucket : sendLatency_) {
+      bucket = 0;
+    }
+  }
+
+  /**
+   * @brief 获取网络参数
+   * @return 网络参数引用
+   */
+  const NetworkParams& getParams() const { return params_; }
+
+ private:
+  static constexpr int MAX_PASSED_FDS = 4; /**< 单条消息最多接收的描述符数 */
+
+  /**
+   * @brief 记录一次发送的结果和耗时
+   * @param ret 发送系统调用返回值
+   * @param size 请求发送的字节数
+   * @param startNs 系统调用开始时刻
+   * @return ret(errno保持不变)
+   */
+  int recordSend(int ret, int size, int64_t startNs) {
+    int savedErrno = errno;
+    recordLatency(startNs);
+    errno = savedErrno;
+    return recordResult(ret, size);
+  }
+
+  /**
+   * @brief 记录一次发送系统调用的耗时
+   * @param startNs 系统调用开始时刻
+   */
+  void recordLatency(int64_t startNs) {
+    uint64_t us = static_cast<uint64_t>(monotonicNs() - startNs) / 1000;
+    int bucket = us == 0 ? 0 : std::min(64 - __builtin_clzll(us), NetworkStats::LATENCY_BUCKETS - 1);
+    sendLatency_[bucket].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief 记录一个包的发送结果
+   * @param ret 发送的字节数，失败为-1(errno为错误码)
+   * @param size 请求发送的字节数
+   * @return ret(errno保持不变)
+   */
+  int recordResult(int ret, int size) {
+    int savedErrno = errno;
+    if (ret >= 0) {
+      packetsSent_.fetch_add(1, std::memory_order_relaxed);
+      bytesSent_.fetch_add(ret, std::memory_order_relaxed);
+      if (ret < size) {
+        shortSends_.fetch_add(1, std::memory_order_relaxed);
+      }
+    } else if (savedErrno == EAGAIN || savedErrno == EWOULDBLOCK) {
+      wouldBlock_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      errors_.fetch_add(1, std::memory_order_relaxed);
+      if (savedErrno == EPIPE || savedErrno == ECONNRESET || savedErrno == ENOTCONN) {
+        connected_.store(false, std::memory_order_relaxed);
+      }
+    }
+
+    errno = savedErrno;
+    return ret;
+  }
+
+  /**
+   * @brief 应用超时、缓冲区大小、TOS和优先级等套接字选项
+   *
+   * 设置失败只记录警告，不影响连接
+   */
+  void setupSocketOptions() {
+    if (params_.receiveTimeoutMs > 0) {
+      struct timeval tv{};
+      tv.tv_sec = params_.receiveTimeoutMs / 1000;
+      tv.tv_usec = (params_.receiveTimeoutMs % 1000) * 1000;
+      setOption(SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv), "SO_RCVTIMEO");
+    }
+    if (params_.sendBufferSize > 0) {
+      setOption(SOL_SOCKET, SO_SNDBUF, &params_.sendBufferSize, sizeof(int), "SO_SNDBUF");
+    }
+    if (params_.receiveBufferSize > 0) {
+      setOption(SOL_SOCKET, SO_RCVBUF, &params_.receiveBufferSize, sizeof(int), "SO_RCVBUF");
+    }
+    if (params_.tos >= 0) {
+      if (params_.type == NetworkType::UNIX) {
+        log::warn("IP_TOS ignored for UNIX transport");
+      } else {
+        setOption(IPPROTO_IP, IP_TOS, &params_.tos, sizeof(int), "IP_TOS");
+      }
+    }
+    if (params_.priority >= 0) {
+      setOption(SOL_SOCKET, SO_PRIORITY, &params_.priority, sizeof(int), "SO_PRIORITY");
+    }
+  }
+
+  /**
+   * @brief 设置套接字选项，失败时记录警告
+   */
+  void setOption(int level, int name, const void* value, socklen_t len, const char* label) {
+    if (setsockopt(socketFd_, level, name, value, len) < 0) {
+      log::warn(std::string("Failed to set ") + label + ": " + std::strerror(errno));
+    }
+  }
+
+  /**
+   * @brief 单个包的辅助数据缓冲区(容纳SCM_TIMESTAMPNS)
+   */
+  struct BatchControl {
+    alignas(struct cmsghdr) char data[CMSG_SPACE(sizeof(struct timespec))];
+  };
+
+  /**
+   * @brief 校验批量参数，分配批量发送数组并按需启用内核接收时间戳
+   * @throws NetworkException 参数无效时抛出
+   *
+   * 接收缓冲池(batchSize * batchBufferSize字节)只在首次receiveBatch()时分配，只发送的连接不占用
+   */
+  void setupBatch() {
+    if (params_.batchSize < 0 || (params_.batchSize > 0 && params_.batchBufferSize <= 0)) {
+      close(socketFd_);
+      socketFd_ = -1;
+      throw NetworkException("Invalid batch receive parameters");
+    }
+
+    if (params_.rxTimestamp) {
+      int on = 1;
+      if (setsockopt(socketFd_, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) < 0) {
+        log::warn("SO_TIMESTAMPNS not supported (" + std::string(std::strerror(errno)) +
+                  "), receive timestamps disabled");
+        params_.rxTimestamp = false;
+      }
+    }
+
+    size_t count = static_cast<size_t>(params_.batchSize);
+    sendIov_.resize(count);
+    sendMsgs_.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+      std::memset(&sendMsgs_[i], 0, sizeof(sendMsgs_[i]));
+      sendMsgs_[i].msg_hdr.msg_iov = &sendIov_[i];
+      sendMsgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+  }
+
+  /**
+   * @brief 分配批量接收缓冲池和recvmmsg消息数组，batchSize为0时不分配
+   */
+  void allocateReceiveBatch() {
+    size_t count = static_cast<size_t>(params_.batchSize);
+    batchPool_.resize(count * params_.batchBufferSize);
+    batchIov_.resize(count);
+    batchControl_.resize(count);
+    batchMsgs_.resize(count);
+
+    for (size_t i = 0; i < count; ++i) {
+      batchIov_[i].iov_base = batchPool_.data() + i * params_.batchBufferSize;
+      batchIov_[i].iov_len = params_.batchBufferSize;
+
+      std::memset(&batchMsgs_[i], 0, sizeof(batchMsgs_[i]));
+      struct msghdr& hdr = batchMsgs_[i].msg_hdr;
+      hdr.msg_iov = &batchIov_[i];
+      hdr.msg_iovlen = 1;
+      hdr.msg_control = batchControl_[i].data;
+    }
+  }
+
+  /**
+   * @brief 创建并连接UDP/TCP套接字
+   * @throws NetworkException 创建或连接失败时抛出
+   */
+  void openInet() {
     // 创建套接字
     if (params_.type == NetworkType::TCP) {
       socketFd_ = socket(AF_INET, SOCK_STREAM, 0);
@@ -58,55 +668,117 @@ class Network::Impl {
                              std::to_string(params_.serverPort));
     }
 
-    connected_ = true;
-    log::info("Network opened (" + std::string(params_.type == NetworkType::TCP ? "TCP" : "UDP") + " -> " +
-              params_.serverIP + ":" + std::to_string(params_.serverPort) + ")");
+    if (params_.txTime) {
+      setupTxTime();
+    }
   }
 
   /**
-   * @brief 析构函数
+   * @brief 启用SO_TXTIME内核定时发送
+   *
+   * 内核不支持SO_TXTIME、非UDP传输或出接口未挂载fq qdisc时
+   * 保持用户态定时，sendAt()仍按时发送
    */
-  ~Impl() {
-    if (socketFd_ >= 0) {
-      close(socketFd_);
-      socketFd_ = -1;
+  void setupTxTime() {
+    if (params_.type != NetworkType::UDP) {
+      log::warn("SO_TXTIME is only used for UDP, falling back to userspace pacing");
+      return;
     }
-    log::info("Network closed");
+
+    struct sock_txtime cfg{};
+    cfg.clockid = CLOCK_MONOTONIC;
+    cfg.flags = 0;
+    if (setsockopt(socketFd_, SOL_SOCKET, SO_TXTIME, &cfg, sizeof(cfg)) < 0) {
+      log::warn("SO_TXTIME not supported (" + std::string(std::strerror(errno)) +
+                "), falling back to userspace pacing");
+      return;
+    }
+
+    struct sockaddr_in local{};
+    socklen_t len = sizeof(local);
+    if (getsockname(socketFd_, reinterpret_cast<struct sockaddr*>(&local), &len) < 0 ||
+        !hasPacingQdisc(findInterfaceIndex(local))) {
+      log::warn("No fq qdisc on egress interface, falling back to userspace pacing");
+      return;
+    }
+
+    kernelPacing_ = true;
+    log::info("Kernel-paced transmission enabled (SO_TXTIME)");
   }
 
   /**
-   * @brief 发送数据
-   * @param data 要发送的数据缓冲区
-   * @param size 数据大小(字节)
-   * @return 发送的字节数，错误返回-1
+   * @brief 创建并连接Unix域套接字
+   * @throws NetworkException 路径无效或连接失败时抛出
+   *
+   * @note 使用SOCK_SEQPACKET以保留消息边界，每条元数据消息与其描述符一一对应
    */
-  int send(const void* data, int size) { return ::send(socketFd_, data, size, 0); }
+  void openUnix() {
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
 
-  /**
-   * @brief 接收数据
-   * @param data 接收缓冲区
-   * @param size 最大接收字节数
-   * @return 接收的字节数，错误返回-1
-   */
-  int receive(void* data, int size) { return ::recv(socketFd_, data, size, 0); }
+    if (params_.socketPath.empty() || params_.socketPath.size() >= sizeof(addr.sun_path)) {
+      throw NetworkException("Invalid unix socket path: " + params_.socketPath);
+    }
+    std::memcpy(addr.sun_path, params_.socketPath.c_str(), params_.socketPath.size());
+
+    socketFd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (socketFd_ < 0) {
+      throw NetworkException("Failed to create unix socket");
+    }
+
+    int ret = connect(socketFd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    if (ret < 0) {
+      close(socketFd_);
+      socketFd_ = -1;
+      throw NetworkException("Failed to connect to unix socket " + params_.socketPath + ": " + std::strerror(errno));
+    }
+  }
 
   /**
-   * @brief 检查连接是否有效
-   * @return 已连接返回true
+   * @brief 检查当前传输是否为UNIX类型
+   * @param op 操作名称(用于错误消息)
+   * @throws NetworkException 非UNIX类型时抛出
    */
-  bool isConnected() const { return connected_; }
+  void requireUnix(const char* op) const {
+    if (params_.type != NetworkType::UNIX) {
+      throw NetworkException(std::string(op) + " requires UNIX transport");
+    }
+  }
 
   /**
-   * @brief 获取网络参数
-   * @return 网络参数引用
+   * @brief 生成连接描述字符串(用于日志)
+   * @return 形如"UDP -> 1.2.3.4:5"的字符串
    */
-  const NetworkParams& getParams() const { return params_; }
+  std::string describe() const {
+    switch (params_.type) {
+      case NetworkType::TCP:
+        return "TCP -> " + params_.serverIP + ":" + std::to_string(params_.serverPort);
+      case NetworkType::UNIX:
+        return "UNIX -> " + params_.socketPath;
+      default:
+        return "UDP -> " + params_.serverIP + ":" + std::to_string(params_.serverPort);
+    }
+  }
 
- private:
-  NetworkParams params_;            /**< 网络参数 */
-  int socketFd_ = -1;               /**< 套接字文件描述符 */
-  struct sockaddr_in serverAddr_{}; /**< 服务器地址 */
-  bool connected_ = false;          /**< 连接状态 */
+  NetworkParams params_;               /**< 网络参数 */
+  int socketFd_ = -1;                  /**< 套接字文件描述符 */
+  struct sockaddr_in serverAddr_{};    /**< 服务器地址 */
+  std::atomic<bool> connected_{false}; /**< 连接状态 */
+  bool kernelPacing_ = false;          /**< 是否由内核定时发送 */
+
+  std::atomic<uint64_t> packetsSent_{0};                                  /**< 成功发送的包数 */
+  std::atomic<uint64_t> bytesSent_{0};                                    /**< 成功发送的字节数 */
+  std::atomic<uint64_t> shortSends_{0};                                   /**< 部分发送次数 */
+  std::atomic<uint64_t> wouldBlock_{0};                                   /**< EAGAIN次数 */
+  std::atomic<uint64_t> errors_{0};                                       /**< 其他错误次数 */
+  std::atomic<uint64_t> sendLatency_[NetworkStats::LATENCY_BUCKETS] = {}; /**< 发送耗时直方图 */
+
+  std::vector<uint8_t> batchPool_;         /**< 批量接收缓冲池(batchSize * batchBufferSize)，首次接收时分配 */
+  std::vector<struct iovec> batchIov_;     /**< 每个包的iovec */
+  std::vector<BatchControl> batchControl_; /**< 每个包的辅助数据缓冲区 */
+  std::vector<struct mmsghdr> batchMsgs_;  /**< recvmmsg消息数组 */
+  std::vector<struct iovec> sendIov_;      /**< 批量发送每个包的iovec */
+  std::vector<struct mmsghdr> sendMsgs_;   /**< sendmmsg消息数组 */
 };
 
 // ============================================================================
@@ -121,10 +793,30 @@ int Network::send(const void* data, int size) { return pImpl_->send(data, size);
 
 int Network::send(const Buffer& buffer) { return pImpl_->send(buffer.data, buffer.size); }
 
+int Network::sendBatch(const Buffer* buffers, int count) { return pImpl_->sendBatch(buffers, count); }
+
 int Network::receive(void* data, int size) { return pImpl_->receive(data, size); }
 
+int Network::receiveBatch(ReceivedPacket* packets, int max) { return pImpl_->receiveBatch(packets, max); }
+
+int Network::sendAt(const void* data, int size, int64_t txTimeNs) { return pImpl_->sendAt(data, size, txTimeNs); }
+
+int Network::sendAt(const Buffer& buffer, int64_t txTimeNs) {
+  return pImpl_->sendAt(buffer.data, buffer.size, txTimeNs);
+}
+
+bool Network::isKernelPacing() const { return pImpl_->isKernelPacing(); }
+
+int Network::sendFd(int fd, const void* meta, int size) { return pImpl_->sendFd(fd, meta, size); }
+
+int Network::receiveFd(void* meta, int size, int* fd) { return pImpl_->receiveFd(meta, size, fd); }
+
 bool Network::isConnected() const { return pImpl_->isConnected(); }
 
+NetworkStats Network::getStats() const { return pImpl_->getStats(); }
+
+void Network::resetStats() { pImpl_->resetStats(); }
+
 const NetworkParams& Network::getParams() const { return pImpl_->getParams(); }
 
 }  // namespace camera_toolkit
@@ -0,0 +1,301 @@
+/**
+ * @file osd.cpp
+ * @brief 屏幕叠加(OSD)类实现
+ */
+#include "camera_toolkit/osd.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "clock_formatter.h"
+#include "log.h"
+#include "text_strip.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+/**
+ * @brief 模板字段类型枚举
+ */
+enum class Field {
+  Literal = 0, /**< 原文 */
+  Time,        /**< {time} */
+  Fps,         /**< {fps} */
+  Kbps,        /**< {kbps} */
+  Camera       /**< {camera} */
+};
+
+/**
+ * @brief 模板片段
+ */
+struct Segment {
+  Field field = Field::Literal; /**< 字段类型 */
+  std::string literal;          /**< 原文(仅Literal有效) */
+};
+
+/**
+ * @brief 按字段名查找字段类型
+ * @param name 字段名(不含花括号)
+ * @param len 字段名长度
+ * @return 字段类型，未知字段返回Literal
+ */
+Field lookupField(const char* name, size_t len) {
+  struct Entry {
+    const char* name;
+    Field field;
+  };
+  static constexpr Entry FIELDS[] = {
+      {"time", Field::Time}, {"fps", Field::Fps}, {"kbps", Field::Kbps}, {"camera", Field::Camera}};
+  for (const Entry& e : FIELDS) {
+    if (strlen(e.name) == len && strncmp(e.name, name, len) == 0) return e.field;
+  }
+  return Field::Literal;
+}
+
+/**
+ * @brief 解析文字模板
+ * @param format 模板
+ * @return 片段列表，相邻原文合并为一个片段
+ */
+std::vector<Segment> parseTemplate(const std::string& format) {
+  std::vector<Segment> segments;
+  auto appendLiteral = [&segments](const char* text, size_t len) {
+    if (segments.empty() || segments.back().field != Field::Literal) segments.emplace_back();
+    segments.back().literal.append(text, len);
+  };
+
+  size_t pos = 0;
+  while (pos < format.size()) {
+    size_t open = format.find('{', pos);
+    size_t close = open == std::string::npos ? std::string::npos : format.find('}', open);
+    if (close == std::string::npos) {
+      appendLiteral(format.data() + pos, format.size() - pos);
+      break;
+    }
+    appendLiteral(format.data() + pos, open - pos);
+    Field field = lookupField(format.data() + open + 1, close - open - 1);
+    if (field == Field::Literal) {
+      appendLiteral(format.data() + open, close - open + 1);
+    } else {
+      segments.push_back({field, {}});
+    }
+    pos = close + 1;
+  }
+  return segments;
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief Osd类的PIMPL实现
+ */
+class Osd::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params OSD参数
+   */
+  explicit Impl(const OsdParams& params) : params_(params), clock_(params.milliseconds) {
+    if (params_.videoWidth <= 0 || params_.videoHeight <= 0) {
+      throw CameraToolkitException("Invalid OSD video size");
+    }
+    regions_.resize(params_.regions.size());
+    for (size_t i = 0; i < regions_.size(); i++) {
+      regions_[i].segments = parseTemplate(params_.regions[i].format);
+      for (const Segment& seg : regions_[i].segments) {
+        regions_[i].uses[static_cast<int>(seg.field)] = true;
+      }
+      usesTime_ = usesTime_ || regions_[i].uses[static_cast<int>(Field::Time)];
+    }
+    update(OsdStats());
+    log::info("Osd opened, " + std::to_string(regions_.size()) + " region(s)");
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { log::info("Osd closed"); }
+
+  /**
+   * @brief 更新动态字段统计值
+   * @param stats 统计值
+   */
+  void update(const OsdStats& stats) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f", stats.fps);
+    setField(Field::Fps, buf);
+    snprintf(buf, sizeof(buf), "%d", stats.kbps);
+    setField(Field::Kbps, buf);
+  }
+
+  /**
+   * @brief 在帧上绘制所有区域，{time}取当前系统时间
+   * @param frame 帧视图
+   */
+  void draw(const FrameView& frame) {
+    struct timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    draw(frame, static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000);
+  }
+
+  /**
+   * @brief 在帧上绘制所有区域
+   * @param frame 帧视图
+   * @param timeUs {time}字段的墙上时间(CLOCK_REALTIME微秒)
+   */
+  void draw(const FrameView& frame, int64_t timeUs) { draw(frame, timeUs, 0, frame.height); }
+
+  /**
+   * @brief 在帧的指定行范围内绘制所有区域
+   * @param frame 帧视图
+   * @param timeUs {time}字段的墙上时间(CLOCK_REALTIME微秒)
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   */
+  void draw(const FrameView& frame, int64_t timeUs, int firstRow, int lastRow) {
+    if (usesTime_ && clock_.format(timeUs)) dirty_[static_cast<int>(Field::Time)] = true;
+
+    // 只有引用了变化字段的区域才重新拼接文字，条带内部再按字符增量重绘
+    int top = frame.height;
+    int bottom = 0;
+    for (size_t i = 0; i < regions_.size(); i++) {
+      Region& region = regions_[i];
+      if (!region.laidOut || region.touches(dirty_)) {
+        const OsdRegion& cfg = params_.regions[i];
+        compose(region);
+        region.block.layout(region.text.c_str(), cfg.x, cfg.y, cfg.factor, params_.videoWidth);
+        region.laidOut = true;
+      }
+      top = std::min(top, region.block.top());
+      bottom = std::max(bottom, region.block.bottom());
+    }
+    std::fill(std::begin(dirty_), std::end(dirty_), false);
+
+    // 所有区域覆盖行的并集上自上而下合成一遍，每行只访问一次
+    const int width = std::min(params_.videoWidth, frame.width);
+    top = std::max({top, firstRow, 0});
+    bottom = std::min({bottom, lastRow, frame.height});
+    for (int y = top; y < bottom; y++) {
+      uint8_t* row = frame.planes[0] + static_cast<ptrdiff_t>(y) * frame.strides[0];
+      for (const Region& region : regions_) {
+        if (y >= region.block.top() && y < region.block.bottom()) {
+          region.block.blitRow(row, y, width);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 获取OSD参数
+   * @return OSD参数引用
+   */
+  const OsdParams& getParams() const { return params_; }
+
+  /**
+   * @brief 把连续存放的Y平面包装为帧视图
+   * @param image 图像数据指针
+   * @return 帧视图
+   */
+  FrameView wrap(uint8_t* image) const {
+    return FrameView::contiguous(image, params_.videoWidth, params_.videoHeight);
+  }
+
+ private:
+  static constexpr int FIELD_COUNT = static_cast<int>(Field::Camera) + 1; /**< 字段类型数 */
+
+  /**
+   * @brief 一个文字区域的运行时状态
+   */
+  struct Region {
+    std::vector<Segment> segments; /**< 解析后的模板 */
+    bool uses[FIELD_COUNT] = {};   /**< 模板引用的字段 */
+    std::string text;              /**< 拼接后的文字 */
+    TextBlock block;               /**< 文字块 */
+    bool laidOut = false;          /**< 是否已布局 */
+
+    /**
+     * @brief 检查模板是否引用了任一变化字段
+     * @param dirty 各字段的变化标记
+     * @return 引用了变化字段返回true
+     */
+    bool touches(const bool* dirty) const {
+      for (int f = 1; f < FIELD_COUNT; f++) {
+        if (uses[f] && dirty[f]) return true;
+      }
+      return false;
+    }
+  };
+
+  /**
+   * @brief 设置字段文字，值变化时标记该字段
+   * @param field 字段类型
+   * @param text 字段文字
+   */
+  void setField(Field field, const char* text) {
+    std::string& value = values_[static_cast<int>(field)];
+    if (value != text) {
+      value = text;
+      dirty_[static_cast<int>(field)] = true;
+    }
+  }
+
+  /**
+   * @brief 按模板拼接区域文字
+   * @param region 文字区域
+   */
+  void compose(Region& region) const {
+    region.text.clear();
+    for (const Segment& seg : region.segments) {
+      switch (seg.field) {
+        case Field::Literal:
+          region.text += seg.literal;
+          break;
+        case Field::Time:
+          region.text += clock_.text();
+          break;
+        case Field::Camera:
+          region.text += params_.cameraName;
+          break;
+        default:
+          region.text += values_[static_cast<int>(seg.field)];
+          break;
+      }
+    }
+  }
+
+  OsdParams params_;                /**< OSD参数 */
+  ClockFormatter clock_;            /**< {time}格式化器，所有区域共用 */
+  bool usesTime_ = false;           /**< 是否有区域引用{time} */
+  std::vector<Region> regions_;     /**< 各区域状态 */
+  std::string values_[FIELD_COUNT]; /**< 统计字段的当前文字 */
+  bool dirty_[FIELD_COUNT] = {};    /**< 自上次绘制以来变化的字段 */
+};
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+Osd::Osd(const OsdParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+Osd::~Osd() = default;
+
+void Osd::update(const OsdStats& stats) { pImpl_->update(stats); }
+
+void Osd::draw(uint8_t* image) { pImpl_->draw(pImpl_->wrap(image)); }
+
+void Osd::draw(uint8_t* image, int64_t timeUs) { pImpl_->draw(pImpl_->wrap(image), timeUs); }
+
+void Osd::draw(const FrameView& frame) { pImpl_->draw(frame); }
+
+void Osd::draw(const FrameView& frame, int64_t timeUs) { pImpl_->draw(frame, timeUs); }
+
+void Osd::draw(const FrameView& frame, int64_t timeUs, int firstRow, int lastRow) {
+  pImpl_->draw(frame, timeUs, firstRow, lastRow);
+}
+
+const OsdParams& Osd::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
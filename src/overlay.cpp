@@ -0,0 +1,415 @@
+/**
+ * @file overlay.cpp
+ * @brief 彩色叠加层类实现
+ */
+#include "camera_toolkit/overlay.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "alpha_blend.h"
+#include "log.h"
+#include "text_strip.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+/**
+ * @brief 非预乘的YUVA像素
+ */
+struct Yuva {
+  uint8_t y = 0; /**< 亮度 */
+  uint8_t u = 0; /**< 色度U */
+  uint8_t v = 0; /**< 色度V */
+  uint8_t a = 0; /**< 不透明度 */
+};
+
+/**
+ * @brief RGB转BT.601有限范围YUV(定点)
+ * @param r 红
+ * @param g 绿
+ * @param b 蓝
+ * @param a 不透明度
+ * @return YUVA像素
+ */
+Yuva rgbToYuva(int r, int g, int b, int a) {
+  Yuva p;
+  p.y = static_cast<uint8_t>(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+  p.u = static_cast<uint8_t>(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+  p.v = static_cast<uint8_t>(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+  p.a = static_cast<uint8_t>(a);
+  return p;
+}
+
+/**
+ * @brief 向下取整的除以2(负数同样向下取整)
+ */
+inline int floorHalf(int v) { return v >= 0 ? v / 2 : -((1 - v) / 2); }
+
+}  // anonymous namespace
+
+/**
+ * @brief Overlay类的PIMPL实现
+ */
+class Overlay::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 叠加层参数
+   */
+  explicit Impl(const OverlayParams& params) : params_(params) {
+    if (params_.pixelFormat != PixelFormat::YUV420 && params_.pixelFormat != PixelFormat::NV12) {
+      throw CameraToolkitException("Overlay supports YUV420 and NV12 only");
+    }
+    if (params_.videoWidth <= 0 || params_.videoHeight <= 0) {
+      throw CameraToolkitException("Invalid overlay video size");
+    }
+    nv12_ = params_.pixelFormat == PixelFormat::NV12;
+    chromaWidth_ = (params_.videoWidth + 1) / 2;
+    chromaHeight_ = (params_.videoHeight + 1) / 2;
+    log::info("Overlay opened");
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { log::info("Overlay closed"); }
+
+  /**
+   * @brief 添加RGBA位图层
+   */
+  int addImage(const uint8_t* rgba, int width, int height, int stride, int x, int y, uint8_t alpha) {
+    if (rgba == nullptr || width <= 0 || height <= 0 || stride < width * 4) {
+      throw CameraToolkitException("Invalid overlay image");
+    }
+    Layer& layer = newLayer(x, y);
+    layer.width = width;
+    layer.height = height;
+    layer.pixels.resize(static_cast<size_t>(width) * height);
+    for (int j = 0; j < height; j++) {
+      const uint8_t* src = rgba + static_cast<size_t>(j) * stride;
+      Yuva* dst = &layer.pixels[static_cast<size_t>(j) * width];
+      for (int i = 0; i < width; i++, src += 4) {
+        dst[i] = rgbToYuva(src[0], src[1], src[2], div255(static_cast<uint32_t>(src[3]) * alpha));
+      }
+    }
+    build(layer);
+    return layer.id;
+  }
+
+  /**
+   * @brief 添加彩色文字层
+   */
+  int addText(const char* text, int x, int y, int factor, const OverlayColor& color, const OverlayColor& outline,
+              uint8_t alpha) {
+    Layer& layer = newLayer(x, y);
+    layer.isText = true;
+    layer.scale = std::max(factor, 0) + 1;
+    layer.fill = rgbToYuva(color.r, color.g, color.b, alpha);
+    layer.outline = rgbToYuva(outline.r, outline.g, outline.b, alpha);
+    int id = layer.id;
+    renderText(layer, text != nullptr ? text : "");
+    return id;
+  }
+
+  /**
+   * @brief 更新文字层内容
+   */
+  void setText(int id, const char* text) {
+    Layer& layer = find(id);
+    if (!layer.isText) throw CameraToolkitException("Overlay layer " + std::to_string(id) + " is not text");
+    if (text == nullptr) text = "";
+    if (layer.text == text) return;
+    renderText(layer, text);
+  }
+
+  /**
+   * @brief 移动图层
+   */
+  void setPosition(int id, int x, int y) {
+    Layer& layer = find(id);
+    bool parityChanged = ((layer.x ^ x) & 1) != 0 || ((layer.y ^ y) & 1) != 0;
+    layer.x = x;
+    layer.y = y;
+    // 色度网格与奇偶位置相关，奇偶性变化时重新下采样
+    if (parityChanged) buildChroma(layer);
+  }
+
+  /**
+   * @brief 删除图层
+   */
+  void remove(int id) {
+    layers_.erase(std::remove_if(layers_.begin(), layers_.end(), [id](const Layer& l) { return l.id == id; }),
+                  layers_.end());
+  }
+
+  /**
+   * @brief 按添加顺序在指定行范围内合成所有图层
+   * @param frame 帧视图
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   */
+  void draw(const FrameView& frame, int firstRow, int lastRow) {
+    if (frame.format != params_.pixelFormat) {
+      throw CameraToolkitException("Overlay frame format does not match params");
+    }
+    const int width = std::min(params_.videoWidth, frame.width);
+    const int height = std::min({params_.videoHeight, frame.height, lastRow});
+    const int chromaWidth = std::min(chromaWidth_, (frame.width + 1) / 2);
+    // 色度行r随亮度行2r所在的行范围合成，相邻行范围的色度行互不重叠
+    const int chromaHeight = std::min(chromaHeight_, (std::min(frame.height, lastRow) + 1) / 2);
+    const int firstChroma = (std::max(firstRow, 0) + 1) / 2;
+
+    for (const Layer& layer : layers_) {
+      if (layer.width == 0) continue;
+
+      // 亮度: 裁剪一次后逐行混合
+      int x0 = std::max(layer.x, 0);
+      int x1 = std::min(layer.x + layer.width, width);
+      int y0 = std::max({layer.y, firstRow, 0});
+      int y1 = std::min(layer.y + layer.height, height);
+      for (int y = y0; y < y1 && x0 < x1; y++) {
+        size_t src = static_cast<size_t>(y - layer.y) * layer.width + (x0 - layer.x);
+        uint8_t* dst = frame.planes[0] + static_cast<ptrdiff_t>(y) * frame.strides[0] + x0;
+        alphaBlendRow(dst, &layer.invY[src], &layer.premY[src], x1 - x0);
+      }
+
+      // 色度: 图层色度网格原点为(floor(x/2), floor(y/2))
+      int cx = floorHalf(layer.x);
+      int cy = floorHalf(layer.y);
+      int c0 = std::max(cx, 0);
+      int c1 = std::min(cx + layer.chromaWidth, chromaWidth);
+      int r0 = std::max(cy, firstChroma);
+      int r1 = std::min(cy + layer.chromaHeight, chromaHeight);
+      for (int r = r0; r < r1 && c0 < c1; r++) {
+        size_t src = static_cast<size_t>(r - cy) * layer.chromaWidth + (c0 - cx);
+        if (nv12_) {
+          // UV交织，掩码与预乘值在加载时已按交织布局展开
+          uint8_t* dst = frame.planes[1] + static_cast<ptrdiff_t>(r) * frame.strides[1] + c0 * 2;
+          alphaBlendRow(dst, &layer.invC[src * 2], &layer.premU[src * 2], (c1 - c0) * 2);
+        } else {
+          uint8_t* dstU = frame.planes[1] + static_cast<ptrdiff_t>(r) * frame.strides[1] + c0;
+          uint8_t* dstV = frame.planes[2] + static_cast<ptrdiff_t>(r) * frame.strides[2] + c0;
+          alphaBlendRow(dstU, &layer.invC[src], &layer.premU[src], c1 - c0);
+          alphaBlendRow(dstV, &layer.invC[src], &layer.premV[src], c1 - c0);
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief 获取叠加层参数
+   * @return 叠加层参数引用
+   */
+  const OverlayParams& getParams() const { return params_; }
+
+  /**
+   * @brief 把连续存放的帧包装为帧视图
+   * @param image 图像数据指针
+   * @return 帧视图
+   */
+  FrameView wrap(uint8_t* image) const {
+    return FrameView::contiguous(image, params_.videoWidth, params_.videoHeight, params_.pixelFormat);
+  }
+
+ private:
+  /**
+   * @brief 一个叠加图层
+   */
+  struct Layer {
+    int id = 0;                 /**< 图层ID */
+    int x = 0;                  /**< 左上角X坐标 */
+    int y = 0;                  /**< 左上角Y坐标 */
+    int width = 0;              /**< 宽度 */
+    int height = 0;             /**< 高度 */
+    std::vector<Yuva> pixels;   /**< 源像素(非预乘) */
+    std::vector<uint8_t> invY;  /**< 亮度反Alpha */
+    std::vector<uint8_t> premY; /**< 预乘亮度 */
+    int chromaWidth = 0;        /**< 色度宽度(色度样本数) */
+    int chromaHeight = 0;       /**< 色度高度 */
+    std::vector<uint8_t> invC;  /**< 色度反Alpha(NV12时按UV交织展开) */
+    std::vector<uint8_t> premU; /**< 预乘U(NV12时为交织的UV) */
+    std::vector<uint8_t> premV; /**< 预乘V(仅YUV420) */
+
+    bool isText = false;           /**< 是否为文字层 */
+    std::string text;              /**< 当前文字 */
+    int scale = 1;                 /**< 文字缩放倍数 */
+    Yuva fill;                     /**< 文字颜色 */
+    Yuva outline;                  /**< 描边颜色 */
+    std::vector<TextStrip> strips; /**< 各行文字条带 */
+  };
+
+  /**
+   * @brief 追加一个空图层
+   */
+  Layer& newLayer(int x, int y) {
+    layers_.emplace_back();
+    Layer& layer = layers_.back();
+    layer.id = nextId_++;
+    layer.x = x;
+    layer.y = y;
+    return layer;
+  }
+
+  /**
+   * @brief 按ID查找图层
+   */
+  Layer& find(int id) {
+    for (Layer& layer : layers_) {
+      if (layer.id == id) return layer;
+    }
+    throw CameraToolkitException("Invalid overlay layer id " + std::to_string(id));
+  }
+
+  /**
+   * @brief 把文字渲染为图层源像素
+   * @param layer 文字层
+   * @param text 文字(使用\\n作为换行符)
+   */
+  void renderText(Layer& layer, const char* text) {
+    layer.text = text;
+
+    constexpr const char* NEWLINE = "\\n";
+    std::vector<std::pair<const char*, int>> spans;
+    const char* begin = text;
+    const char* end;
+    while ((end = strstr(begin, NEWLINE))) {
+      spans.emplace_back(begin, static_cast<int>(end - begin));
+      begin = end + 2;
+    }
+    spans.emplace_back(begin, static_cast<int>(strlen(begin)));
+
+    const int lineSpace = (GLYPH_H + 1) * layer.scale;
+    layer.strips.resize(spans.size());
+    layer.width = 0;
+    for (size_t i = 0; i < spans.size(); i++) {
+      layer.strips[i].update(spans[i].first, spans[i].second, layer.scale);
+      layer.width = std::max(layer.width, layer.strips[i].width());
+    }
+    layer.height = lineSpace * static_cast<int>(spans.size() - 1) + GLYPH_H * layer.scale;
+
+    // 条带掩码为文字像素，亮度0xFF为填充、0为描边
+    layer.pixels.assign(static_cast<size_t>(layer.width) * layer.height, Yuva());
+    for (size_t i = 0; i < layer.strips.size(); i++) {
+      const TextStrip& strip = layer.strips[i];
+      for (int row = 0; row < strip.height(); row++) {
+        const uint8_t* mask = strip.maskRow(row);
+        const uint8_t* value = strip.valueRow(row);
+        Yuva* dst = &layer.pixels[(i * lineSpace + row) * static_cast<size_t>(layer.width)];
+        for (int x = 0; x < strip.width(); x++) {
+          if (mask[x]) dst[x] = value[x] ? layer.fill : layer.outline;
+        }
+      }
+    }
+    build(layer);
+  }
+
+  /**
+   * @brief 由源像素生成亮度和色度的预乘平面
+   */
+  void build(Layer& layer) {
+    size_t n = layer.pixels.size();
+    layer.invY.resize(n);
+    layer.premY.resize(n);
+    for (size_t i = 0; i < n; i++) {
+      const Yuva& p = layer.pixels[i];
+      layer.invY[i] = static_cast<uint8_t>(255 - p.a);
+      layer.premY[i] = div255(static_cast<uint32_t>(p.y) * p.a);
+    }
+    buildChroma(layer);
+  }
+
+  /**
+   * @brief 按图层当前位置的奇偶性对预乘色度做2x2下采样
+   *
+   * 对预乘值而非颜色求平均，半透明边缘不会向外渗色；
+   * round(sumU / 1020) <= round(sumA / 4)，保证混合结果不超过255
+   */
+  void buildChroma(Layer& layer) {
+    const int px = layer.x & 1;
+    const int py = layer.y & 1;
+    layer.chromaWidth = (layer.width + px + 1) / 2;
+    layer.chromaHeight = (layer.height + py + 1) / 2;
+    const int step = nv12_ ? 2 : 1;
+    size_t n = static_cast<size_t>(layer.chromaWidth) * layer.chromaHeight;
+    layer.invC.assign(n * step, 255);
+    layer.premU.assign(n * step, 0);
+    layer.premV.assign(nv12_ ? 0 : n, 0);
+
+    for (int r = 0; r < layer.chromaHeight; r++) {
+      for (int c = 0; c < layer.chromaWidth; c++) {
+        uint32_t sumA = 0;
+        uint32_t sumU = 0;
+        uint32_t sumV = 0;
+        for (int dy = 0; dy < 2; dy++) {
+          int j = r * 2 + dy - py;
+          if (j < 0 || j >= layer.height) continue;
+          for (int dx = 0; dx < 2; dx++) {
+            int i = c * 2 + dx - px;
+            if (i < 0 || i >= layer.width) continue;
+            const Yuva& p = layer.pixels[static_cast<size_t>(j) * layer.width + i];
+            sumA += p.a;
+            sumU += static_cast<uint32_t>(p.u) * p.a;
+            sumV += static_cast<uint32_t>(p.v) * p.a;
+          }
+        }
+        auto inv = static_cast<uint8_t>(255 - (sumA + 2) / 4);
+        auto u = static_cast<uint8_t>((sumU + 510) / 1020);
+        auto v = static_cast<uint8_t>((sumV + 510) / 1020);
+        size_t k = static_cast<size_t>(r) * layer.chromaWidth + c;
+        if (nv12_) {
+          layer.invC[k * 2] = layer.invC[k * 2 + 1] = inv;
+          layer.premU[k * 2] = u;
+          layer.premU[k * 2 + 1] = v;
+        } else {
+          layer.invC[k] = inv;
+          layer.premU[k] = u;
+          layer.premV[k] = v;
+        }
+      }
+    }
+  }
+
+  OverlayParams params_;      /**< 叠加层参数 */
+  bool nv12_ = false;         /**< 是否为NV12 */
+  int chromaWidth_ = 0;       /**< 帧色度宽度 */
+  int chromaHeight_ = 0;      /**< 帧色度高度 */
+  std::vector<Layer> layers_; /**< 图层(按合成顺序) */
+  int nextId_ = 1;            /**< 下一个图层ID */
+};
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+Overlay::Overlay(const OverlayParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+Overlay::~Overlay() = default;
+
+int Overlay::addImage(const uint8_t* rgba, int width, int height, int stride, int x, int y, uint8_t alpha) {
+  return pImpl_->addImage(rgba, width, height, stride, x, y, alpha);
+}
+
+int Overlay::addText(const char* text, int x, int y, int factor, const OverlayColor& color,
+                     const OverlayColor& outline, uint8_t alpha) {
+  return pImpl_->addText(text, x, y, factor, color, outline, alpha);
+}
+
+void Overlay::setText(int id, const char* text) { pImpl_->setText(id, text); }
+
+void Overlay::setPosition(int id, int x, int y) { pImpl_->setPosition(id, x, y); }
+
+void Overlay::remove(int id) { pImpl_->remove(id); }
+
+void Overlay::draw(uint8_t* image) { draw(pImpl_->wrap(image)); }
+
+void Overlay::draw(const FrameView& frame) { pImpl_->draw(frame, 0, frame.height); }
+
+void Overlay::draw(const FrameView& frame, int firstRow, int lastRow) { pImpl_->draw(frame, firstRow, lastRow); }
+
+const OverlayParams& Overlay::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
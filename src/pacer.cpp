@@ -0,0 +1,118 @@
+/**
+ * @file pacer.cpp
+ * @brief 发送节奏控制类实现
+ */
+#include "camera_toolkit/pacer.h"
+
+#include <algorithm>
+#include <ctime>
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int64_t NSEC_PER_SEC = 1000000000; /**< 每秒纳秒数 */
+
+/**
+ * @brief 获取当前CLOCK_MONOTONIC时刻
+ * @return 当前时刻(纳秒)
+ */
+int64_t monotonicNow() {
+  struct timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief Pacer类的PIMPL实现
+ */
+class Pacer::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 节奏控制参数
+   */
+  explicit Impl(const PacerParams& params) : params_(params) {
+    setBitrate(params_.bitrate);
+    frameIntervalNs_ = params_.fps > 0 ? NSEC_PER_SEC / params_.fps : 0;
+  }
+
+  /**
+   * @brief 标记新帧开始
+   * @param frameTimeNs 帧就绪时刻
+   */
+  void onFrame(int64_t frameTimeNs) {
+    // 上一帧未发完时顺延，空闲时从本帧时刻重新开始，不累积突发额度
+    nextSendNs_ = std::max(nextSendNs_, frameTimeNs);
+    frameDeadlineNs_ = frameIntervalNs_ > 0 ? nextSendNs_ + frameIntervalNs_ : 0;
+  }
+
+  /**
+   * @brief 计算下一个包的发送时刻
+   * @param bytes 包大小(字节)
+   * @param nowNs 当前时刻
+   * @return 发送时刻
+   */
+  int64_t next(int bytes, int64_t nowNs) {
+    int64_t sendNs = std::max(nextSendNs_, nowNs);
+    nextSendNs_ = sendNs + static_cast<int64_t>(bytes) * 8 * NSEC_PER_SEC / pacingRateBps_;
+
+    // 单帧超出发送窗口(如大I帧)时，剩余包压缩到窗口末尾发出，避免积压到后续帧
+    if (frameDeadlineNs_ > 0 && nextSendNs_ > frameDeadlineNs_) {
+      nextSendNs_ = std::max(frameDeadlineNs_, sendNs);
+    }
+    return sendNs;
+  }
+
+  /**
+   * @brief 设置媒体码率
+   * @param bitrate 新码率(kbps)
+   */
+  void setBitrate(int bitrate) {
+    params_.bitrate = bitrate;
+    pacingRateBps_ = std::max<int64_t>(static_cast<int64_t>(bitrate * params_.pacingFactor * 1000), 1);
+  }
+
+  /**
+   * @brief 获取当前发送速率
+   * @return 发送速率(kbps)
+   */
+  int getPacingRate() const { return static_cast<int>(pacingRateBps_ / 1000); }
+
+  /**
+   * @brief 获取节奏控制参数
+   * @return 节奏控制参数引用
+   */
+  const PacerParams& getParams() const { return params_; }
+
+ private:
+  PacerParams params_;          /**< 节奏控制参数 */
+  int64_t pacingRateBps_ = 1;   /**< 发送速率(bps) */
+  int64_t frameIntervalNs_ = 0; /**< 帧间隔(纳秒) */
+  int64_t nextSendNs_ = 0;      /**< 下一个包最早发送时刻 */
+  int64_t frameDeadlineNs_ = 0; /**< 当前帧发送窗口截止时刻 */
+};
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+Pacer::Pacer(const PacerParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+Pacer::~Pacer() = default;
+
+void Pacer::onFrame(int64_t frameTimeNs) { pImpl_->onFrame(frameTimeNs); }
+
+int64_t Pacer::next(int bytes, int64_t nowNs) { return pImpl_->next(bytes, nowNs); }
+
+int64_t Pacer::next(int bytes) { return pImpl_->next(bytes, monotonicNow()); }
+
+void Pacer::setBitrate(int bitrate) { pImpl_->setBitrate(bitrate); }
+
+int Pacer::getPacingRate() const { return pImpl_->getPacingRate(); }
+
+const PacerParams& Pacer::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
@@ -0,0 +1,270 @@
+/**
+ * @file packet_pool.cpp
+ * @brief 编码包内存池实现
+ */
+#include "camera_toolkit/packet_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr size_t ALIGNMENT = 64; /**< 槽位对齐(缓存行)，槽位头和数据都从对齐地址开始 */
+
+/**
+ * @brief 向上取整到对齐边界
+ * @param value 值
+ * @return 对齐后的值
+ */
+constexpr size_t alignUp(size_t value) { return (value + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+
+}  // anonymous namespace
+
+/**
+ * @brief 池中槽位：槽位头后紧跟包数据
+ */
+struct PacketSlot {
+  PacketPool::Impl* owner; /**< 所属内存池 */
+  size_t span;             /**< 槽位占用的字节数(含槽位头) */
+  size_t size;             /**< 数据字节数 */
+  int64_t ptsUs;           /**< 显示时间戳 */
+  int64_t dtsUs;           /**< 解码时间戳 */
+  bool keyframe;           /**< 是否为IDR帧 */
+  bool released;           /**< 已无引用，等待回收(受内存池锁保护) */
+  std::atomic<int> refs;   /**< 引用计数 */
+
+  uint8_t* data();
+};
+
+namespace {
+
+constexpr size_t HEADER_SIZE = alignUp(sizeof(PacketSlot)); /**< 槽位头大小 */
+
+}  // anonymous namespace
+
+uint8_t* PacketSlot::data() { return reinterpret_cast<uint8_t*>(this) + HEADER_SIZE; }
+
+/**
+ * @brief PacketPool类的PIMPL实现
+ *
+ * 已占用区域为[tail_, head_)(可能回绕)，新槽位追加在head_，尾部放不下时
+ * 用一个已释放的填充槽位占满剩余空间后从头开始
+ */
+class PacketPool::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param capacity 容量
+   */
+  explicit Impl(size_t capacity) : capacity_(alignUp(std::max(capacity, HEADER_SIZE))) {
+    void* arena = nullptr;
+    if (posix_memalign(&arena, ALIGNMENT, capacity_) != 0) {
+      throw CameraToolkitException("Failed to allocate packet pool");
+    }
+    arena_ = static_cast<uint8_t*>(arena);
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() {
+    if (live_ > 0) {
+      log::error("Packet pool destroyed with " + std::to_string(live_) + " live packets");
+    }
+    std::free(arena_);
+  }
+
+  /**
+   * @brief 分配槽位并复制数据
+   * @param data 数据
+   * @param size 数据大小
+   * @param ptsUs 显示时间戳
+   * @param dtsUs 解码时间戳
+   * @param keyframe 是否为IDR帧
+   * @return 持有一个引用的槽位，空间不足时返回nullptr
+   */
+  PacketSlot* allocate(const void* data, size_t size, int64_t ptsUs, int64_t dtsUs, bool keyframe) {
+    const size_t span = HEADER_SIZE + alignUp(size);
+    PacketSlot* slot;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_t offset;
+      if (!reserve(span, &offset)) {
+        failures_++;
+        return nullptr;
+      }
+      // 槽位一旦计入已占用区域，其他线程的release()就会从tail_遍历到它，槽位头须在解锁前写好
+      slot = new (arena_ + offset) PacketSlot{this, span, size, ptsUs, dtsUs, keyframe, false, {1}};
+      used_ += span;
+      head_ = offset + span;
+      live_++;
+      allocations_++;
+    }
+
+    // release()只读槽位头，数据复制不需要持锁
+    if (size > 0) std::memcpy(slot->data(), data, size);
+    return slot;
+  }
+
+  /**
+   * @brief 释放槽位，并回收从tail_开始连续的已释放槽位
+   * @param slot 槽位
+   */
+  void release(PacketSlot* slot) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slot->released = true;
+    live_--;
+    while (used_ > 0) {
+      PacketSlot* oldest = reinterpret_cast<PacketSlot*>(arena_ + tail_);
+      if (!oldest->released) break;
+      used_ -= oldest->span;
+      tail_ += oldest->span;
+      if (tail_ == capacity_) tail_ = 0;
+    }
+    if (used_ == 0) head_ = tail_ = 0;
+  }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  PacketPoolStats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PacketPoolStats stats;
+    stats.capacity = capacity_;
+    stats.used = used_;
+    stats.livePackets = live_;
+    stats.allocations = allocations_;
+    stats.failures = failures_;
+    return stats;
+  }
+
+  /**
+   * @brief 获取容量
+   * @return 字节数
+   */
+  size_t capacity() const { return capacity_; }
+
+ private:
+  /**
+   * @brief 查找放得下span字节的连续空间(需持锁)
+   * @param span 槽位大小
+   * @param offset 输出槽位偏移
+   * @return 找到返回true
+   */
+  bool reserve(size_t span, size_t* offset) {
+    if (used_ == capacity_) return false;
+    if (head_ < tail_) {
+      if (tail_ - head_ < span) return false;
+      *offset = head_;
+      return true;
+    }
+    // 已占用区域不回绕(或为空)：优先放在尾部，放不下时回绕到开头
+    if (capacity_ - head_ >= span) {
+      *offset = head_;
+      return true;
+    }
+    if (tail_ < span) return false;
+    if (head_ < capacity_) {
+      const size_t gap = capacity_ - head_;
+      new (arena_ + head_) PacketSlot{this, gap, 0, 0, 0, false, true, {0}};
+      used_ += gap;
+    }
+    *offset = 0;
+    return true;
+  }
+
+  const size_t capacity_;    /**< 容量 */
+  uint8_t* arena_ = nullptr; /**< 环形内存 */
+  mutable std::mutex mutex_; /**< 保护分配位置和统计 */
+  size_t head_ = 0;          /**< 下一个槽位的偏移 */
+  size_t tail_ = 0;          /**< 最早槽位的偏移 */
+  size_t used_ = 0;          /**< 已占用字节数 */
+  size_t live_ = 0;          /**< 仍被引用的包数 */
+  uint64_t allocations_ = 0; /**< 成功分配次数 */
+  uint64_t failures_ = 0;    /**< 分配失败次数 */
+};
+
+// ============================================================================
+// Packet
+// ============================================================================
+
+Packet::Packet(const Packet& other) : slot_(other.slot_) {
+  if (slot_) slot_->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+Packet::Packet(Packet&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+
+Packet& Packet::operator=(const Packet& other) {
+  if (this != &other) {
+    if (other.slot_) other.slot_->refs.fetch_add(1, std::memory_order_relaxed);
+    reset();
+    slot_ = other.slot_;
+  }
+  return *this;
+}
+
+Packet& Packet::operator=(Packet&& other) noexcept {
+  if (this != &other) {
+    reset();
+    slot_ = other.slot_;
+    other.slot_ = nullptr;
+  }
+  return *this;
+}
+
+Packet::~Packet() { reset(); }
+
+void Packet::reset() {
+  if (slot_ && slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    slot_->owner->release(slot_);
+  }
+  slot_ = nullptr;
+}
+
+const uint8_t* Packet::data() const { return slot_ ? slot_->data() : nullptr; }
+
+size_t Packet::size() const { return slot_ ? slot_->size : 0; }
+
+int64_t Packet::ptsUs() const { return slot_ ? slot_->ptsUs : 0; }
+
+int64_t Packet::dtsUs() const { return slot_ ? slot_->dtsUs : 0; }
+
+bool Packet::keyframe() const { return slot_ && slot_->keyframe; }
+
+EncodedFrame Packet::frame() const {
+  EncodedFrame frame;
+  if (slot_) {
+    frame.buffer = Buffer(slot_->data(), static_cast<int>(slot_->size));
+    frame.type = slot_->keyframe ? PictureType::I : PictureType::None;
+    frame.ptsUs = slot_->ptsUs;
+    frame.dtsUs = slot_->dtsUs;
+  }
+  return frame;
+}
+
+// ============================================================================
+// PacketPool
+// ============================================================================
+
+PacketPool::PacketPool(size_t capacity) : pImpl_(std::make_unique<Impl>(capacity)) {}
+
+PacketPool::~PacketPool() = default;
+
+Packet PacketPool::allocate(const void* data, size_t size, int64_t ptsUs, int64_t dtsUs, bool keyframe) {
+  return Packet(pImpl_->allocate(data, size, ptsUs, dtsUs, keyframe));
+}
+
+PacketPoolStats PacketPool::getStats() const { return pImpl_->getStats(); }
+
+size_t PacketPool::capacity() const { return pImpl_->capacity(); }
+
+}  // namespace camera_toolkit
@@ -0,0 +1,311 @@
+/**
+ * @file pre_event_buffer.cpp
+ * @brief 事件前录像缓冲类实现
+ */
+#include "camera_toolkit/pre_event_buffer.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/trace.h"
+#include "h264_nal.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief PreEventBuffer类的PIMPL实现
+ *
+ * 帧按写入顺序编号，缓冲为固定大小的句柄环，输出线程按编号追赶写入位置。
+ * 输出线程只在持锁时复制句柄(增加引用计数)，回调在锁外进行，push()不会被输出阻塞
+ */
+class PreEventBuffer::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   */
+  explicit Impl(const PreEventBufferParams& params)
+      : params_(params), pool_(params.poolBytes), ring_(static_cast<size_t>(std::max(params.maxFrames, 1))) {
+    batch_.reserve(ring_.size());
+    headers_.reserve(256);
+    headerCopy_.reserve(256);
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { stopDump(); }
+
+  /**
+   * @brief 写入一个编码帧
+   * @param frame 编码帧
+   * @return 已缓冲返回true
+   */
+  bool push(const EncodedFrame& frame) {
+    CK_TRACE_SCOPE("preevent.push");
+    const uint8_t* data = static_cast<const uint8_t*>(frame.buffer.data);
+    const size_t size = frame.empty() ? 0 : static_cast<size_t>(frame.buffer.size);
+
+    bool idr = false;
+    if (!scanAccessUnit(data, size, &idr)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      headers_.assign(data, data + size);
+      return size > 0;
+    }
+
+    // 缓冲开头或丢帧之后必须从IDR帧重新开始
+    if (waitIdr_ && !idr) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stats_.dropped++;
+      return false;
+    }
+
+    Packet packet = pool_.allocate(data, size, frame.ptsUs, frame.dtsUs, idr);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 空间不足时淘汰最早的GOP；新帧为IDR时连当前GOP也可以淘汰
+    while ((packet.empty() || count_ == ring_.size()) && evictGop(idr)) {
+      if (packet.empty()) packet = pool_.allocate(data, size, frame.ptsUs, frame.dtsUs, idr);
+    }
+    if (packet.empty() || count_ == ring_.size()) {
+      stats_.dropped++;
+      waitIdr_ = true;
+      return false;
+    }
+    waitIdr_ = false;
+
+    if (idr) {
+      if (count_ > 0 && secondGop_ == 0) secondGop_ = count_;
+      gops_++;
+    }
+    bytes_ += size;
+    ring_[(front_ + count_) % ring_.size()] = std::move(packet);
+    count_++;
+    stats_.pushed++;
+
+    // 淘汰后剩余部分仍覆盖保留时长时才淘汰，保证事件前至少有durationMs的画面
+    const int64_t durationUs = params_.durationMs * 1000;
+    while (secondGop_ > 0 && frame.dtsUs - at(secondGop_).dtsUs() >= durationUs) {
+      evictGop(false);
+    }
+
+    if (dumping_) cv_.notify_one();
+    return true;
+  }
+
+  /**
+   * @brief 开始输出
+   * @param sink 输出回调
+   */
+  void startDump(Sink sink) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (dumping_) {
+      throw CameraToolkitException("Pre-event buffer is already dumping");
+    }
+
+    // 已输出过的帧不再重复，从其后第一个IDR帧开始
+    dumpSeq_ = std::max(frontSeq_, dumpedUntil_);
+    needKeyframe_ = true;
+    sendHeaders_ = true;
+    sink_ = std::move(sink);
+    dumping_ = true;
+    stopping_ = false;
+    thread_ = std::thread(&Impl::run, this);
+    log::info("Pre-event dump started with " + std::to_string(frontSeq_ + count_ - dumpSeq_) + " buffered frames");
+  }
+
+  /**
+   * @brief 停止输出
+   */
+  void stopDump() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!dumping_) return;
+      stopping_ = true;
+    }
+    cv_.notify_one();
+    thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    dumping_ = false;
+    stopping_ = false;
+    sink_ = nullptr;
+  }
+
+  /**
+   * @brief 是否正在输出
+   * @return 是返回true
+   */
+  bool isDumping() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dumping_;
+  }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  PreEventBufferStats getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PreEventBufferStats stats = stats_;
+    stats.frames = static_cast<int>(count_);
+    stats.gops = gops_;
+    stats.bytes = bytes_;
+    stats.durationUs = count_ > 0 ? at(count_ - 1).dtsUs() - at(0).dtsUs() : 0;
+    stats.pool = pool_.getStats();
+    return stats;
+  }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const PreEventBufferParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 获取缓冲中的第index帧(需持锁)
+   * @param index 相对最早一帧的序号
+   * @return 包句柄
+   */
+  const Packet& at(size_t index) const { return ring_[(front_ + index) % ring_.size()]; }
+
+  /**
+   * @brief 淘汰最早的GOP(需持锁)
+   * @param allowLast 是否允许淘汰唯一的GOP
+   * @return 淘汰了返回true
+   */
+  bool evictGop(bool allowLast) {
+    if (count_ == 0 || (secondGop_ == 0 && !allowLast)) return false;
+    const size_t n = secondGop_ > 0 ? secondGop_ : count_;
+    for (size_t i = 0; i < n; i++) {
+      Packet& packet = ring_[(front_ + i) % ring_.size()];
+      bytes_ -= packet.size();
+      packet.reset();
+    }
+    front_ = (front_ + n) % ring_.size();
+    count_ -= n;
+    frontSeq_ += n;
+    gops_--;
+    stats_.evictedGops++;
+
+    secondGop_ = 0;
+    for (size_t i = 1; i < count_; i++) {
+      if (at(i).keyframe()) {
+        secondGop_ = i;
+        break;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief 输出线程主循环
+   */
+  void run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return dumpSeq_ < frontSeq_ + count_ || stopping_; });
+
+      // 送出前已被淘汰的帧无法补回，从下一个IDR帧继续
+      if (dumpSeq_ < frontSeq_) {
+        stats_.lost += frontSeq_ - dumpSeq_;
+        dumpSeq_ = frontSeq_;
+        needKeyframe_ = true;
+      }
+
+      const bool withHeaders = sendHeaders_ && !headers_.empty();
+      if (withHeaders) headerCopy_.assign(headers_.begin(), headers_.end());
+      sendHeaders_ = sendHeaders_ && !withHeaders;
+
+      const uint64_t end = frontSeq_ + count_;
+      for (; dumpSeq_ < end; dumpSeq_++) {
+        const Packet& packet = at(dumpSeq_ - frontSeq_);
+        if (needKeyframe_ && !packet.keyframe()) continue;
+        needKeyframe_ = false;
+        batch_.push_back(packet);
+      }
+      dumpedUntil_ = dumpSeq_;
+      const bool done = stopping_;
+      lock.unlock();
+
+      {
+        CK_TRACE_SCOPE("preevent.dump");
+        if (withHeaders) {
+          EncodedFrame header;
+          header.buffer = Buffer(headerCopy_.data(), static_cast<int>(headerCopy_.size()));
+          header.type = PictureType::SPS;
+          deliver(header);
+        }
+        for (const Packet& packet : batch_) deliver(packet.frame());
+      }
+      const size_t delivered = batch_.size();
+      batch_.clear();
+
+      lock.lock();
+      stats_.dumped += delivered;
+      if (done) break;
+    }
+  }
+
+  /**
+   * @brief 调用输出回调，回调异常只记录日志
+   * @param frame 编码帧
+   */
+  void deliver(const EncodedFrame& frame) {
+    try {
+      sink_(frame);
+    } catch (const std::exception& e) {
+      log::error("Pre-event sink failed: " + std::string(e.what()));
+    }
+  }
+
+  PreEventBufferParams params_;  /**< 配置参数 */
+  PacketPool pool_;              /**< 包内存池(在全部句柄之后析构) */
+  std::vector<Packet> ring_;     /**< 帧句柄环 */
+  size_t front_ = 0;             /**< 最早一帧在环中的位置 */
+  size_t count_ = 0;             /**< 缓冲帧数 */
+  size_t secondGop_ = 0;         /**< 第二个GOP相对最早一帧的序号，只有一个GOP时为0 */
+  int gops_ = 0;                 /**< 缓冲GOP数 */
+  size_t bytes_ = 0;             /**< 缓冲数据字节数 */
+  uint64_t frontSeq_ = 0;        /**< 最早一帧的编号 */
+  bool waitIdr_ = true;          /**< 等待IDR帧(只由写入线程访问) */
+  std::vector<uint8_t> headers_; /**< 最近的SPS/PPS头信息 */
+  PreEventBufferStats stats_;    /**< 统计 */
+
+  mutable std::mutex mutex_;        /**< 保护缓冲和输出状态 */
+  std::condition_variable cv_;      /**< 通知输出线程 */
+  std::thread thread_;              /**< 输出线程 */
+  Sink sink_;                       /**< 输出回调 */
+  bool dumping_ = false;            /**< 正在输出 */
+  bool stopping_ = false;           /**< 请求停止输出 */
+  bool needKeyframe_ = false;       /**< 输出需从IDR帧重新开始 */
+  bool sendHeaders_ = false;        /**< 输出前先送出头信息 */
+  uint64_t dumpSeq_ = 0;            /**< 下一个要输出的帧编号 */
+  uint64_t dumpedUntil_ = 0;        /**< 已输出帧编号的上界 */
+  std::vector<Packet> batch_;       /**< 输出线程本轮要送出的帧(预留容量，不按帧分配) */
+  std::vector<uint8_t> headerCopy_; /**< 输出线程的头信息副本 */
+};
+
+PreEventBuffer::PreEventBuffer(const PreEventBufferParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+PreEventBuffer::~PreEventBuffer() = default;
+
+bool PreEventBuffer::push(const EncodedFrame& frame) { return pImpl_->push(frame); }
+
+void PreEventBuffer::startDump(Sink sink) { pImpl_->startDump(std::move(sink)); }
+
+void PreEventBuffer::stopDump() { pImpl_->stopDump(); }
+
+bool PreEventBuffer::isDumping() const { return pImpl_->isDumping(); }
+
+PreEventBufferStats PreEventBuffer::getStats() const { return pImpl_->getStats(); }
+
+const PreEventBufferParams& PreEventBuffer::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
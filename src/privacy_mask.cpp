@@ -0,0 +1,426 @@
+/**
+ * @file privacy_mask.cpp
+ * @brief 隐私遮挡类实现
+ */
+#include "camera_toolkit/privacy_mask.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+/**
+ * @brief 一行内的遮挡区间[x0, x1)
+ */
+struct Span {
+  int x0 = 0; /**< 起点(含) */
+  int x1 = 0; /**< 终点(不含) */
+};
+
+/**
+ * @brief 逐行区间表(CSR布局，所有行的区间连续存放)
+ */
+struct SpanTable {
+  std::vector<int> rowBegin; /**< 第y行区间为spans[rowBegin[y], rowBegin[y+1]) */
+  std::vector<Span> spans;   /**< 区间 */
+
+  /**
+   * @brief 追加一行的区间(调用前须已按行号顺序追加前面的行)
+   * @param row 该行区间，会被排序合并
+   */
+  void appendRow(std::vector<Span>& row) {
+    std::sort(row.begin(), row.end(), [](const Span& a, const Span& b) { return a.x0 < b.x0; });
+    size_t first = spans.size();
+    for (const Span& s : row) {
+      if (s.x1 <= s.x0) continue;
+      if (spans.size() > first && s.x0 <= spans.back().x1) {
+        spans.back().x1 = std::max(spans.back().x1, s.x1);
+      } else {
+        spans.push_back(s);
+      }
+    }
+    rowBegin.push_back(static_cast<int>(spans.size()));
+  }
+};
+
+/**
+ * @brief 把多边形区域光栅化为亮度区间表
+ * @param regions 遮挡区域
+ * @param width 帧宽度
+ * @param height 帧高度
+ * @return 区间表，区间已裁剪到帧内
+ */
+SpanTable rasterize(const std::vector<MaskRegion>& regions, int width, int height) {
+  SpanTable table;
+  table.rowBegin.push_back(0);
+  std::vector<Span> row;
+  std::vector<double> xs;
+  for (int y = 0; y < height; y++) {
+    row.clear();
+    // 在像素中心所在的扫描线上求交，奇偶规则配对
+    const double yc = y + 0.5;
+    for (const MaskRegion& region : regions) {
+      xs.clear();
+      const auto& poly = region.polygon;
+      for (size_t i = 0; i < poly.size(); i++) {
+        const MaskPoint& p = poly[i];
+        const MaskPoint& q = poly[(i + 1) % poly.size()];
+        if ((p.y <= yc) == (q.y <= yc)) continue;
+        xs.push_back(p.x + (yc - p.y) * (q.x - p.x) / (q.y - p.y));
+      }
+      std::sort(xs.begin(), xs.end());
+      for (size_t i = 0; i + 1 < xs.size(); i += 2) {
+        // 像素中心 x + 0.5 落在[xa, xb)内
+        int x0 = static_cast<int>(std::ceil(xs[i] - 0.5));
+        int x1 = static_cast<int>(std::ceil(xs[i + 1] - 0.5));
+        row.push_back({std::max(x0, 0), std::min(x1, width)});
+      }
+    }
+    table.appendRow(row);
+  }
+  return table;
+}
+
+/**
+ * @brief 由亮度区间表生成4:2:0色度区间表
+ *
+ * 色度样本只要覆盖到一个被遮挡的亮度像素就被遮挡，避免遮挡区域边缘透出原始颜色
+ */
+SpanTable downsample(const SpanTable& luma, int lumaHeight, int chromaWidth, int chromaHeight) {
+  SpanTable table;
+  table.rowBegin.push_back(0);
+  std::vector<Span> row;
+  for (int cy = 0; cy < chromaHeight; cy++) {
+    row.clear();
+    for (int y = cy * 2; y < std::min(cy * 2 + 2, lumaHeight); y++) {
+      for (int i = luma.rowBegin[y]; i < luma.rowBegin[y + 1]; i++) {
+        row.push_back({luma.spans[i].x0 / 2, std::min((luma.spans[i].x1 + 1) / 2, chromaWidth)});
+      }
+    }
+    table.appendRow(row);
+  }
+  return table;
+}
+
+/**
+ * @brief 求一行像素之和
+ */
+uint32_t sumRow(const uint8_t* src, int n) {
+  uint32_t sum = 0;
+  int x = 0;
+#if defined(__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+  for (; x + 16 <= n; x += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+  }
+  sum = static_cast<uint32_t>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#elif defined(__ARM_NEON)
+  uint32x4_t acc = vdupq_n_u32(0);
+  for (; x + 16 <= n; x += 16) {
+    acc = vpadalq_u16(acc, vpaddlq_u8(vld1q_u8(src + x)));
+  }
+  sum = vgetq_lane_u32(acc, 0) + vgetq_lane_u32(acc, 1) + vgetq_lane_u32(acc, 2) + vgetq_lane_u32(acc, 3);
+#endif
+  for (; x < n; x++) sum += src[x];
+  return sum;
+}
+
+/**
+ * @brief 分别求一行交织像素(UVUV...)偶数和奇数位置之和
+ */
+void sumRowPairs(const uint8_t* src, int pairs, uint32_t* even, uint32_t* odd) {
+  uint32_t a = 0;
+  uint32_t b = 0;
+  int x = 0;
+#if defined(__SSE2__)
+  // 16位通道内高字节清零后，SAD的结果即为对应字节之和
+  const __m128i lowMask = _mm_set1_epi16(0x00FF);
+  __m128i accA = _mm_setzero_si128();
+  __m128i accB = _mm_setzero_si128();
+  for (; x + 8 <= pairs; x += 8) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * 2));
+    accA = _mm_add_epi64(accA, _mm_sad_epu8(_mm_and_si128(v, lowMask), _mm_setzero_si128()));
+    accB = _mm_add_epi64(accB, _mm_sad_epu8(_mm_srli_epi16(v, 8), _mm_setzero_si128()));
+  }
+  a = static_cast<uint32_t>(_mm_cvtsi128_si32(accA) + _mm_cvtsi128_si32(_mm_srli_si128(accA, 8)));
+  b = static_cast<uint32_t>(_mm_cvtsi128_si32(accB) + _mm_cvtsi128_si32(_mm_srli_si128(accB, 8)));
+#elif defined(__ARM_NEON)
+  uint32x4_t accA = vdupq_n_u32(0);
+  uint32x4_t accB = vdupq_n_u32(0);
+  for (; x + 16 <= pairs; x += 16) {
+    uint8x16x2_t v = vld2q_u8(src + x * 2);
+    accA = vpadalq_u16(accA, vpaddlq_u8(v.val[0]));
+    accB = vpadalq_u16(accB, vpaddlq_u8(v.val[1]));
+  }
+  a = vgetq_lane_u32(accA, 0) + vgetq_lane_u32(accA, 1) + vgetq_lane_u32(accA, 2) + vgetq_lane_u32(accA, 3);
+  b = vgetq_lane_u32(accB, 0) + vgetq_lane_u32(accB, 1) + vgetq_lane_u32(accB, 2) + vgetq_lane_u32(accB, 3);
+#endif
+  for (; x < pairs; x++) {
+    a += src[x * 2];
+    b += src[x * 2 + 1];
+  }
+  *even = a;
+  *odd = b;
+}
+
+/**
+ * @brief 用两字节图样填充交织像素
+ */
+void fillPairs(uint8_t* dst, uint8_t even, uint8_t odd, int pairs) {
+  int x = 0;
+#if defined(__SSE2__)
+  const __m128i v = _mm_set1_epi16(static_cast<int16_t>(even | (odd << 8)));
+  for (; x + 8 <= pairs; x += 8) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), v);
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16x2_t v = {{vdupq_n_u8(even), vdupq_n_u8(odd)}};
+  for (; x + 16 <= pairs; x += 16) {
+    vst2q_u8(dst + x * 2, v);
+  }
+#endif
+  for (; x < pairs; x++) {
+    dst[x * 2] = even;
+    dst[x * 2 + 1] = odd;
+  }
+}
+
+/**
+ * @brief 一个平面的遮挡作业
+ */
+struct PlaneMask {
+  int width = 0;              /**< 平面宽度(样本数) */
+  int height = 0;             /**< 平面高度 */
+  int block = 0;              /**< 马赛克块大小 */
+  SpanTable table;            /**< 区间表 */
+  std::vector<int> bandBegin; /**< 第b个块行的块列为tiles[bandBegin[b], bandBegin[b+1]) */
+  std::vector<int> tiles;     /**< 与遮挡区间相交的块列号 */
+  std::vector<uint8_t> avg;   /**< 每个块列的平均值(交织时每块两个) */
+
+  /**
+   * @brief 预先统计每个块行中与区间相交的块
+   */
+  void prepareTiles(int channels) {
+    const int bands = (height + block - 1) / block;
+    bandBegin.assign(1, 0);
+    for (int b = 0; b < bands; b++) {
+      size_t first = tiles.size();
+      for (int y = b * block; y < std::min(height, (b + 1) * block); y++) {
+        for (int i = table.rowBegin[y]; i < table.rowBegin[y + 1]; i++) {
+          for (int bx = table.spans[i].x0 / block; bx * block < table.spans[i].x1; bx++) tiles.push_back(bx);
+        }
+      }
+      std::sort(tiles.begin() + first, tiles.end());
+      tiles.erase(std::unique(tiles.begin() + first, tiles.end()), tiles.end());
+      bandBegin.push_back(static_cast<int>(tiles.size()));
+    }
+    avg.assign(static_cast<size_t>((width + block - 1) / block) * channels, 0);
+  }
+};
+
+/**
+ * @brief 按区间表对平面做纯色填充
+ * @param plane 平面起始地址
+ * @param stride 行跨度
+ * @param mask 平面遮挡作业
+ * @param channels 每个样本的字节数(交织色度为2)
+ * @param a 填充值(交织时为偶数位置)
+ * @param b 交织时奇数位置的填充值
+ */
+void fillPlane(uint8_t* plane, int stride, const PlaneMask& mask, int channels, uint8_t a, uint8_t b) {
+  for (int y = 0; y < mask.height; y++) {
+    uint8_t* row = plane + static_cast<ptrdiff_t>(y) * stride;
+    for (int i = mask.table.rowBegin[y]; i < mask.table.rowBegin[y + 1]; i++) {
+      const Span& s = mask.table.spans[i];
+      if (channels == 1) {
+        memset(row + s.x0, a, s.x1 - s.x0);
+      } else {
+        fillPairs(row + s.x0 * 2, a, b, s.x1 - s.x0);
+      }
+    }
+  }
+}
+
+/**
+ * @brief 按区间表对平面做马赛克
+ *
+ * 每个与遮挡区间相交的块取整块(裁剪到帧内)的平均值，再只回填块内被遮挡的像素
+ */
+void pixelatePlane(uint8_t* plane, int stride, PlaneMask& mask, int channels) {
+  const int block = mask.block;
+  for (size_t band = 0; band + 1 < mask.bandBegin.size(); band++) {
+    const int y0 = static_cast<int>(band) * block;
+    const int y1 = std::min(mask.height, y0 + block);
+
+    for (int t = mask.bandBegin[band]; t < mask.bandBegin[band + 1]; t++) {
+      const int bx = mask.tiles[t];
+      const int x0 = bx * block;
+      const int x1 = std::min(mask.width, x0 + block);
+      const uint32_t count = static_cast<uint32_t>((x1 - x0) * (y1 - y0));
+      uint32_t sumA = 0;
+      uint32_t sumB = 0;
+      for (int y = y0; y < y1; y++) {
+        const uint8_t* row = plane + static_cast<ptrdiff_t>(y) * stride + x0 * channels;
+        if (channels == 1) {
+          sumA += sumRow(row, x1 - x0);
+        } else {
+          uint32_t a;
+          uint32_t b;
+          sumRowPairs(row, x1 - x0, &a, &b);
+          sumA += a;
+          sumB += b;
+        }
+      }
+      mask.avg[bx * channels] = static_cast<uint8_t>((sumA + count / 2) / count);
+      if (channels == 2) mask.avg[bx * 2 + 1] = static_cast<uint8_t>((sumB + count / 2) / count);
+    }
+
+    for (int y = y0; y < y1; y++) {
+      uint8_t* row = plane + static_cast<ptrdiff_t>(y) * stride;
+      for (int i = mask.table.rowBegin[y]; i < mask.table.rowBegin[y + 1]; i++) {
+        const Span& s = mask.table.spans[i];
+        // 区间按块边界切段，每段填充所在块的平均值
+        for (int x = s.x0; x < s.x1;) {
+          const int bx = x / block;
+          const int end = std::min(s.x1, (bx + 1) * block);
+          if (channels == 1) {
+            memset(row + x, mask.avg[bx], end - x);
+          } else {
+            fillPairs(row + x * 2, mask.avg[bx * 2], mask.avg[bx * 2 + 1], end - x);
+          }
+          x = end;
+        }
+      }
+    }
+  }
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief PrivacyMask类的PIMPL实现
+ */
+class PrivacyMask::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 隐私遮挡参数
+   */
+  explicit Impl(const PrivacyMaskParams& params) : params_(params) {
+    if (params_.pixelFormat != PixelFormat::YUV420 && params_.pixelFormat != PixelFormat::NV12) {
+      throw CameraToolkitException("Privacy mask supports YUV420 and NV12 only");
+    }
+    if (params_.videoWidth <= 0 || params_.videoHeight <= 0) {
+      throw CameraToolkitException("Invalid privacy mask video size");
+    }
+    if (params_.blockSize < 2 || params_.blockSize % 2 != 0) {
+      throw CameraToolkitException("Privacy mask block size must be even and >= 2");
+    }
+    for (const MaskRegion& region : params_.regions) {
+      if (region.polygon.size() < 3) {
+        throw CameraToolkitException("Privacy mask region needs at least 3 points");
+      }
+    }
+    nv12_ = params_.pixelFormat == PixelFormat::NV12;
+
+    luma_.width = params_.videoWidth;
+    luma_.height = params_.videoHeight;
+    luma_.block = params_.blockSize;
+    luma_.table = rasterize(params_.regions, luma_.width, luma_.height);
+    chroma_.width = (params_.videoWidth + 1) / 2;
+    chroma_.height = (params_.videoHeight + 1) / 2;
+    chroma_.block = params_.blockSize / 2;
+    chroma_.table = downsample(luma_.table, luma_.height, chroma_.width, chroma_.height);
+    if (params_.mode == MaskMode::Pixelate) {
+      luma_.prepareTiles(1);
+      chroma_.prepareTiles(nv12_ ? 2 : 1);
+    }
+    log::info("PrivacyMask opened, " + std::to_string(params_.regions.size()) + " region(s), " +
+              std::to_string(luma_.table.spans.size()) + " span(s)");
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { log::info("PrivacyMask closed"); }
+
+  /**
+   * @brief 对帧应用遮挡
+   * @param frame 帧视图
+   */
+  void apply(const FrameView& frame) {
+    if (frame.format != params_.pixelFormat) {
+      throw CameraToolkitException("Privacy mask frame format does not match params");
+    }
+    if (frame.width < params_.videoWidth || frame.height < params_.videoHeight) {
+      throw CameraToolkitException("Privacy mask frame is smaller than params");
+    }
+    if (params_.mode == MaskMode::Fill) {
+      fillPlane(frame.planes[0], frame.strides[0], luma_, 1, params_.fillY, 0);
+      if (nv12_) {
+        fillPlane(frame.planes[1], frame.strides[1], chroma_, 2, params_.fillU, params_.fillV);
+      } else {
+        fillPlane(frame.planes[1], frame.strides[1], chroma_, 1, params_.fillU, 0);
+        fillPlane(frame.planes[2], frame.strides[2], chroma_, 1, params_.fillV, 0);
+      }
+    } else {
+      pixelatePlane(frame.planes[0], frame.strides[0], luma_, 1);
+      if (nv12_) {
+        pixelatePlane(frame.planes[1], frame.strides[1], chroma_, 2);
+      } else {
+        pixelatePlane(frame.planes[1], frame.strides[1], chroma_, 1);
+        pixelatePlane(frame.planes[2], frame.strides[2], chroma_, 1);
+      }
+    }
+  }
+
+  /**
+   * @brief 把连续存放的帧包装为帧视图
+   * @param image 图像数据指针
+   * @return 帧视图
+   */
+  FrameView wrap(uint8_t* image) const {
+    return FrameView::contiguous(image, params_.videoWidth, params_.videoHeight, params_.pixelFormat);
+  }
+
+  /**
+   * @brief 获取隐私遮挡参数
+   * @return 隐私遮挡参数引用
+   */
+  const PrivacyMaskParams& getParams() const { return params_; }
+
+ private:
+  PrivacyMaskParams params_; /**< 隐私遮挡参数 */
+  bool nv12_ = false;        /**< 是否为NV12 */
+  PlaneMask luma_;           /**< 亮度平面作业 */
+  PlaneMask chroma_;         /**< 色度平面作业(U/V共用) */
+};
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+PrivacyMask::PrivacyMask(const PrivacyMaskParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+PrivacyMask::~PrivacyMask() = default;
+
+void PrivacyMask::apply(uint8_t* image) { pImpl_->apply(pImpl_->wrap(image)); }
+
+void PrivacyMask::apply(const FrameView& frame) { pImpl_->apply(frame); }
+
+const PrivacyMaskParams& PrivacyMask::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
@@ -0,0 +1,309 @@
+/**
+ * @file recorder.cpp
+ * @brief 分段fMP4录像类实现
+ */
+#include "camera_toolkit/recorder.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "camera_toolkit/file_writer.h"
+#include "camera_toolkit/trace.h"
+#include "fmp4.h"
+#include "h264_nal.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+/**
+ * @brief Recorder类的PIMPL实现
+ */
+class Recorder::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   */
+  explicit Impl(const RecorderParams& params) : params_(params) {
+    samples_.reserve(256);
+    entries_.reserve(256);
+    payload_.reserve(1 << 20);
+    header_.reserve(64 * 1024);
+    fragments_.reserve(1024);
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { close(); }
+
+  /**
+   * @brief 写入一个访问单元
+   * @param frame 编码帧
+   */
+  void write(const EncodedFrame& frame) {
+    CK_TRACE_SCOPE("recorder.write");
+    const uint8_t* data = static_cast<const uint8_t*>(frame.buffer.data);
+    const size_t size = frame.empty() ? 0 : static_cast<size_t>(frame.buffer.size);
+
+    // 提取参数集，判断是否为含图像数据的访问单元以及是否为IDR
+    bool picture = false;
+    bool idr = false;
+    forEachNal(data, size, [&](const uint8_t* unit, size_t len) {
+      const int type = unit[0] & 0x1F;
+      if (type == nal::SPS) {
+        sps_.assign(unit, unit + len);
+      } else if (type == nal::PPS) {
+        pps_.assign(unit, unit + len);
+      } else if (type >= nal::SLICE && type <= nal::IDR) {
+        picture = true;
+        idr = idr || type == nal::IDR;
+      }
+    });
+    if (!picture) return;
+
+    const int64_t dts = fmp4::toTicks(frame.dtsUs);
+    if (open_) {
+      if (!samples_.empty() && (idr || dts - segmentBase_ - samples_.front().dts >= fragmentTicks())) {
+        flushFragment(dts - segmentBase_);
+      }
+      if (idr && shouldRotate(frame.dtsUs)) closeSegment();
+    }
+    if (!open_) {
+      // 文件必须以带参数集的IDR帧开始
+      if (!idr || sps_.size() < 4 || pps_.empty()) {
+        stats_.skipped++;
+        return;
+      }
+      openSegment(frame.dtsUs);
+    }
+
+    // 转换为4字节长度前缀格式，参数集已在avcC中，AUD和参数集不写入样本
+    const size_t sampleSize = fmp4::appendSample(payload_, data, size);
+
+    Sample sample;
+    sample.size = static_cast<uint32_t>(sampleSize);
+    sample.dts = dts - segmentBase_;
+    sample.pts = fmp4::toTicks(frame.ptsUs) - segmentBase_;
+    sample.ptsUs = frame.ptsUs;
+    sample.sync = idr;
+    samples_.push_back(sample);
+    stats_.frames++;
+  }
+
+  /**
+   * @brief 关闭当前文件
+   */
+  void close() {
+    if (open_) closeSegment();
+    writer_.reset();
+  }
+
+  /**
+   * @brief 获取当前文件路径
+   * @return 路径
+   */
+  std::string getSegmentPath() const { return open_ ? segmentPath_ : std::string(); }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  RecorderStats getStats() const { return stats_; }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const RecorderParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 缓冲中的样本
+   */
+  struct Sample {
+    uint32_t size = 0; /**< 样本字节数 */
+    int64_t dts = 0;   /**< 解码时刻(文件内刻度) */
+    int64_t pts = 0;   /**< 显示时刻(文件内刻度) */
+    int64_t ptsUs = 0; /**< 原始显示时间戳(微秒) */
+    bool sync = false; /**< 是否为IDR */
+  };
+
+  /**
+   * @brief 已写出的片段，用于生成索引
+   */
+  struct Fragment {
+    int64_t ptsUs = 0;   /**< 首个样本的显示时间戳(微秒) */
+    uint64_t offset = 0; /**< moof在文件中的偏移 */
+    uint32_t size = 0;   /**< moof+mdat字节数 */
+    bool sync = false;   /**< 是否以IDR开始 */
+  };
+
+  /**
+   * @brief 片段最大时长(刻度)
+   * @return 刻度
+   */
+  int64_t fragmentTicks() const { return static_cast<int64_t>(params_.fragmentDurationMs) * (fmp4::TIMESCALE / 1000); }
+
+  /**
+   * @brief 判断是否应在当前IDR帧处切换文件
+   * @param dtsUs 当前帧解码时间戳
+   * @return 应切换返回true
+   */
+  bool shouldRotate(int64_t dtsUs) const {
+    return (params_.segmentDurationMs > 0 && dtsUs - segmentStartUs_ >= params_.segmentDurationMs * 1000) ||
+           (params_.segmentBytes > 0 && static_cast<int64_t>(segmentBytes_) >= params_.segmentBytes);
+  }
+
+  /**
+   * @brief 打开新文件并写入ftyp和moov
+   * @param dtsUs 首帧解码时间戳
+   */
+  void openSegment(int64_t dtsUs) {
+    char name[32];
+    snprintf(name, sizeof(name), "-%06llu.mp4", static_cast<unsigned long long>(stats_.segments + 1));
+    segmentPath_ = params_.directory + "/" + params_.prefix + name;
+
+    if (writer_) {
+      // 切换文件由写盘线程完成，旧文件的剩余数据照常写出
+      writer_->reopen(segmentPath_);
+    } else {
+      FileWriterParams writerParams;
+      writerParams.path = segmentPath_;
+      writerParams.bufferSize = 1 << 20;
+      writerParams.bufferCount = 4;
+      writerParams.directIO = params_.directIO;
+      writer_ = std::make_unique<AsyncFileWriter>(writerParams);
+    }
+    open_ = true;
+
+    segmentBase_ = fmp4::toTicks(dtsUs);
+    segmentStartUs_ = dtsUs;
+    segmentBytes_ = 0;
+    sequence_ = 1;
+    fragments_.clear();
+    stats_.segments++;
+
+    header_.clear();
+    writeInit();
+    writer_->write(header_.data(), header_.size());
+    segmentBytes_ += header_.size();
+    stats_.bytes += header_.size();
+    log::info("Recording to " + segmentPath_);
+  }
+
+  /**
+   * @brief 写出缓冲的片段并写索引，写入器保留给下一个文件
+   */
+  void closeSegment() {
+    flushFragment(-1);
+    open_ = false;
+    writeIndex();
+  }
+
+  /**
+   * @brief 生成ftyp和moov(初始化段)
+   */
+  void writeInit() {
+    fmp4::writeInit(header_, params_.width, params_.height, sps_, pps_);
+  }
+
+  /**
+   * @brief 把缓冲的样本写为一个moof+mdat片段
+   * @param nextDts 下一帧的解码时刻(文件内刻度)，未知时为负数
+   */
+  void flushFragment(int64_t nextDts) {
+    if (samples_.empty()) return;
+
+    entries_.clear();
+    for (size_t i = 0; i < samples_.size(); i++) {
+      const Sample& sample = samples_[i];
+      int64_t duration;
+      if (i + 1 < samples_.size()) {
+        duration = samples_[i + 1].dts - sample.dts;
+      } else if (nextDts > sample.dts) {
+        duration = nextDts - sample.dts;
+      } else {
+        duration = lastDuration_ > 0 ? lastDuration_ : fmp4::TIMESCALE / std::max(params_.fps, 1);
+      }
+      lastDuration_ = duration;
+
+      fmp4::Sample entry;
+      entry.size = sample.size;
+      entry.duration = static_cast<uint32_t>(duration);
+      entry.compositionOffset = static_cast<int32_t>(sample.pts - sample.dts);
+      entry.sync = sample.sync;
+      entries_.push_back(entry);
+    }
+    header_.clear();
+    fmp4::writeFragment(header_, sequence_++, samples_.front().dts, entries_.data(), entries_.size());
+
+    writer_->write(header_.data(), header_.size());
+    writer_->write(payload_.data(), payload_.size());
+
+    Fragment fragment;
+    fragment.ptsUs = samples_.front().ptsUs;
+    fragment.offset = segmentBytes_;
+    fragment.size = static_cast<uint32_t>(header_.size() + payload_.size());
+    fragment.sync = samples_.front().sync;
+    fragments_.push_back(fragment);
+
+    segmentBytes_ += fragment.size;
+    stats_.bytes += fragment.size;
+    stats_.fragments++;
+    samples_.clear();
+    payload_.clear();
+  }
+
+  /**
+   * @brief 写文件旁的索引(<文件名>.idx)，每行一个片段
+   */
+  void writeIndex() {
+    std::ofstream index(segmentPath_ + ".idx");
+    index << "# pts_us offset size sync\n";
+    for (const Fragment& fragment : fragments_) {
+      index << fragment.ptsUs << ' ' << fragment.offset << ' ' << fragment.size << ' ' << (fragment.sync ? 1 : 0)
+            << '\n';
+    }
+    if (!index) {
+      log::warn("Failed to write index for " + segmentPath_);
+    }
+  }
+
+  RecorderParams params_;                   /**< 配置参数 */
+  std::unique_ptr<AsyncFileWriter> writer_; /**< 文件写入器，各分段复用，close()时释放 */
+  bool open_ = false;                       /**< 是否有打开的文件 */
+  std::string segmentPath_;                 /**< 当前文件路径 */
+  std::vector<uint8_t> sps_;                /**< 最近的SPS */
+  std::vector<uint8_t> pps_;                /**< 最近的PPS */
+  std::vector<Sample> samples_;             /**< 当前片段的样本 */
+  std::vector<fmp4::Sample> entries_;       /**< 生成trun用的样本表 */
+  std::vector<uint8_t> payload_;            /**< 当前片段的mdat数据 */
+  std::vector<uint8_t> header_;             /**< moov/moof生成缓冲区 */
+  std::vector<Fragment> fragments_;         /**< 当前文件已写出的片段 */
+  int64_t segmentBase_ = 0;                 /**< 当前文件首帧解码时刻(刻度)，文件内时间从0开始 */
+  int64_t segmentStartUs_ = 0;              /**< 当前文件首帧解码时间戳(微秒) */
+  uint64_t segmentBytes_ = 0;               /**< 当前文件已写字节数 */
+  uint32_t sequence_ = 1;                   /**< moof序号 */
+  int64_t lastDuration_ = 0;                /**< 最近一个样本的时长(刻度) */
+  RecorderStats stats_;                     /**< 统计 */
+};
+
+Recorder::Recorder(const RecorderParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+Recorder::~Recorder() = default;
+
+void Recorder::write(const EncodedFrame& frame) { pImpl_->write(frame); }
+
+void Recorder::close() { pImpl_->close(); }
+
+std::string Recorder::getSegmentPath() const { return pImpl_->getSegmentPath(); }
+
+RecorderStats Recorder::getStats() const { return pImpl_->getStats(); }
+
+const RecorderParams& Recorder::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <vector>
 
+#include "camera_toolkit/trace.h"
 #include "log.h"
 
 namespace camera_toolkit {
@@ -153,6 +154,7 @@ class RTPPacker::Impl {
    * @throws PackException 缓冲区溢出或越界时抛出
    */
   std::optional<Buffer> get() {
+    CK_TRACE_SCOPE("rtp.packetize");
     if (inBufferComplete_) {
       return std::nullopt;
     }
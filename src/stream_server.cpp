@@ -0,0 +1,554 @@
+/**
+ * @file stream_server.cpp
+ * @brief HTTP低延迟直播服务类实现
+ */
+#include "camera_toolkit/stream_server.h"
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "camera_toolkit/trace.h"
+#include "fmp4.h"
+#include "h264_nal.h"
+#include "http_listener.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int MAX_IOV = 64;           /**< 每次sendmsg聚合的片段数 */
+constexpr size_t CHUNK_HEADROOM = 16; /**< 片段前为分块长度行预留的字节数 */
+
+/**
+ * @brief 获取单调时钟毫秒数
+ * @return 毫秒
+ */
+int64_t nowMs() {
+  struct timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
+/**
+ * @brief 生成共享的响应数据
+ * @param text 内容
+ * @return 共享缓冲区
+ */
+std::shared_ptr<const std::vector<uint8_t>> shared(const std::string& text) {
+  return std::make_shared<const std::vector<uint8_t>>(text.begin(), text.end());
+}
+
+/**
+ * @brief 生成不带流的HTTP响应
+ * @param status 状态行
+ * @return 响应
+ */
+std::shared_ptr<const std::vector<uint8_t>> errorResponse(const char* status) {
+  const std::string body = std::string(status) + "\n";
+  return shared(std::string("HTTP/1.1 ") + status + "\r\nContent-Type: text/plain\r\nContent-Length: " +
+                std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+}
+
+}  // anonymous namespace
+
+/**
+ * @brief StreamServer类的PIMPL实现
+ */
+class StreamServer::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   */
+  explicit Impl(const StreamServerParams& params) : params_(params), pool_(params.poolBytes) {
+    if (params_.path.empty() || params_.path[0] != '/' || params_.maxViewers <= 0 || params_.maxQueueBytes == 0 ||
+        params_.width <= 0 || params_.height <= 0) {
+      throw CameraToolkitException("Invalid stream server parameters");
+    }
+
+    okHeader_ = shared(
+        "HTTP/1.1 200 OK\r\nContent-Type: video/mp4\r\nTransfer-Encoding: chunked\r\n"
+        "Cache-Control: no-cache, no-store\r\nAccess-Control-Allow-Origin: *\r\nConnection: close\r\n\r\n");
+    notFound_ = errorResponse("404 Not Found");
+    notAllowed_ = errorResponse("405 Method Not Allowed");
+    scratch_.reserve(1 << 20);
+    payload_.reserve(1 << 20);
+    pending_.reserve(64);
+    incoming_.reserve(64);
+
+    listener_ = std::make_unique<HttpListener>(HttpListenerParams{
+        "stream", params_.address, params_.port, 128, params_.maxViewers, params_.idleTimeoutMs});
+    HttpHandlers handlers;
+    handlers.accept = [this](int fd) { accept(fd); };
+    handlers.request = [this](int fd, const std::string& method, const std::string& path) {
+      respond(fd, method, path);
+    };
+    handlers.writable = [this](int fd) { flush(fd); };
+    handlers.stalled = [this](int fd, int64_t now) { return stalled(fd, now); };
+    handlers.closed = [this](int fd) { closed(fd); };
+    handlers.wake = [this] { distribute(); };
+    listener_->start(std::move(handlers));
+    log::info("Streaming http://" + params_.address + ":" + std::to_string(listener_->getPort()) + params_.path);
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() { listener_->stop(); }
+
+  /**
+   * @brief 封装一帧并交给服务线程
+   * @param frame 编码帧
+   */
+  void write(const EncodedFrame& frame) {
+    CK_TRACE_SCOPE("stream.write");
+    const uint8_t* data = static_cast<const uint8_t*>(frame.buffer.data);
+    const size_t size = frame.empty() ? 0 : static_cast<size_t>(frame.buffer.size);
+
+    bool picture = false;
+    bool idr = false;
+    forEachNal(data, size, [&](const uint8_t* unit, size_t len) {
+      const int type = unit[0] & 0x1F;
+      if (type == nal::SPS) {
+        sps_.assign(unit, unit + len);
+      } else if (type == nal::PPS) {
+        pps_.assign(unit, unit + len);
+      } else if (type >= nal::SLICE && type <= nal::IDR) {
+        picture = true;
+        idr = idr || type == nal::IDR;
+      }
+    });
+    if (!picture) return;
+
+    // 流从带参数集的IDR帧开始，丢帧后同样等待下一个IDR
+    if (waitIdr_ && (!idr || sps_.size() < 4 || pps_.empty())) return;
+    if (!started_) {
+      baseDts_ = fmp4::toTicks(frame.dtsUs);
+      started_ = true;
+    }
+
+    // 每帧一个moof+mdat，最后一帧的时长取上一帧间隔
+    const int64_t dts = fmp4::toTicks(frame.dtsUs) - baseDts_;
+    if (lastDts_ >= 0 && dts > lastDts_) lastDuration_ = dts - lastDts_;
+    lastDts_ = dts;
+
+    payload_.clear();
+    fmp4::Sample sample;
+    sample.size = static_cast<uint32_t>(fmp4::appendSample(payload_, data, size));
+    const int64_t duration = lastDuration_ > 0 ? lastDuration_ : fmp4::TIMESCALE / std::max(params_.fps, 1);
+    sample.duration = static_cast<uint32_t>(duration);
+    sample.compositionOffset = static_cast<int32_t>(fmp4::toTicks(frame.ptsUs) - fmp4::toTicks(frame.dtsUs));
+    sample.sync = idr;
+
+    scratch_.resize(CHUNK_HEADROOM);
+    fmp4::writeFragment(scratch_, sequence_, dts, &sample, 1);
+    scratch_.insert(scratch_.end(), payload_.begin(), payload_.end());
+    const size_t start = frameChunk(scratch_);
+
+    Packet packet = pool_.allocate(scratch_.data() + start, scratch_.size() - start, frame.ptsUs, frame.dtsUs, idr);
+    if (packet.empty()) {
+      dropped_++;
+      waitIdr_ = true;
+      return;
+    }
+    waitIdr_ = false;
+    sequence_++;
+    frames_++;
+
+    // 参数集变化时生成新的初始化段，随这个IDR帧发给所有观看者
+    std::shared_ptr<const std::vector<uint8_t>> init;
+    if (idr && (sps_ != initSps_ || pps_ != initPps_)) {
+      initSps_ = sps_;
+      initPps_ = pps_;
+      std::vector<uint8_t> body(CHUNK_HEADROOM);
+      fmp4::writeInit(body, params_.width, params_.height, sps_, pps_);
+      const size_t offset = frameChunk(body);
+      init = std::make_shared<const std::vector<uint8_t>>(body.begin() + static_cast<std::ptrdiff_t>(offset),
+                                                          body.end());
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_.push_back(Pending{std::move(packet), std::move(init)});
+    }
+    listener_->wake();
+  }
+
+  /**
+   * @brief 获取监听端口
+   * @return 端口
+   */
+  int getPort() const { return listener_->getPort(); }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  StreamServerStats getStats() const {
+    StreamServerStats stats;
+    stats.viewers = viewerCount_.load();
+    stats.accepted = accepted_.load();
+    stats.frames = frames_.load();
+    stats.bytesSent = bytesSent_.load();
+    stats.dropped = dropped_.load();
+    stats.overflows = overflows_.load();
+    stats.pool = pool_.getStats();
+    return stats;
+  }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const StreamServerParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 发送队列中的一项：内存池中的片段，或共享的响应头/初始化段
+   */
+  struct Chunk {
+    Packet packet;                                    /**< 媒体片段 */
+    std::shared_ptr<const std::vector<uint8_t>> blob; /**< 响应头或初始化段 */
+
+    const uint8_t* data() const { return blob ? blob->data() : packet.data(); }
+    size_t size() const { return blob ? blob->size() : packet.size(); }
+  };
+
+  /**
+   * @brief 写入线程交给服务线程的一帧
+   */
+  struct Pending {
+    Packet packet;                                    /**< 媒体片段 */
+    std::shared_ptr<const std::vector<uint8_t>> init; /**< 新的初始化段，未变化时为空 */
+  };
+
+  /**
+   * @brief 连接状态
+   */
+  struct Viewer {
+    std::deque<Chunk> queue;  /**< 待发送的数据 */
+    size_t offset = 0;        /**< 队首已发送的字节数 */
+    size_t queuedBytes = 0;   /**< 队列中的字节数 */
+    int64_t progressMs = 0;   /**< 最近一次发送有进展的时刻 */
+    bool streaming = false;   /**< 正在接收流 */
+    bool closing = false;     /**< 发完队列后关闭 */
+    bool blocked = false;     /**< 套接字缓冲区已满，等待EPOLLOUT */
+    bool needInit = true;     /**< 尚未收到初始化段 */
+    bool waitKeyframe = true; /**< 等待下一个IDR帧 */
+  };
+
+  /**
+   * @brief 在预留的头部空间中写入分块长度行，并在末尾追加CRLF
+   * @param buffer 前CHUNK_HEADROOM字节为预留空间的缓冲区
+   * @return 分块起始偏移
+   */
+  static size_t frameChunk(std::vector<uint8_t>& buffer) {
+    char line[CHUNK_HEADROOM];
+    const int n = snprintf(line, sizeof(line), "%zx\r\n", buffer.size() - CHUNK_HEADROOM);
+    const size_t start = CHUNK_HEADROOM - static_cast<size_t>(n);
+    std::memcpy(buffer.data() + start, line, static_cast<size_t>(n));
+    buffer.push_back('\r');
+    buffer.push_back('\n');
+    return start;
+  }
+
+  /**
+   * @brief 把新片段加入各观看者的队列并发送
+   */
+  void distribute() {
+    CK_TRACE_SCOPE("stream.distribute");
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      incoming_.swap(pending_);
+    }
+
+    for (Pending& item : incoming_) {
+      if (item.init) init_ = item.init;
+
+      // 保留当前GOP供新观看者立即开始播放，过大时放弃，避免长期占住内存池
+      if (item.packet.keyframe()) {
+        gop_.clear();
+        gopBytes_ = 0;
+        gopValid_ = true;
+      }
+      if (gopValid_) {
+        gop_.push_back(item.packet);
+        gopBytes_ += item.packet.size();
+        if (gopBytes_ > params_.poolBytes / 2) {
+          gop_.clear();
+          gopValid_ = false;
+        }
+      }
+
+      for (auto& entry : viewers_) {
+        if (entry.second.streaming) enqueue(entry.second, item);
+      }
+    }
+    incoming_.clear();
+
+    ready_.clear();
+    for (const auto& entry : viewers_) {
+      if (!entry.second.blocked && !entry.second.queue.empty()) ready_.push_back(entry.first);
+    }
+    for (int fd : ready_) flush(fd);
+  }
+
+  /**
+   * @brief 把一帧加入观看者的队列
+   * @param viewer 观看者
+   * @param item 帧
+   */
+  void enqueue(Viewer& viewer, const Pending& item) {
+    const bool keyframe = item.packet.keyframe();
+    if (viewer.waitKeyframe && !keyframe) return;
+
+    if (viewer.queuedBytes + item.packet.size() > params_.maxQueueBytes) {
+      // 积压过多：丢弃队列中尚未开始发送的片段，从下一个IDR帧继续
+      trim(viewer);
+      overflows_++;
+      if (!keyframe) return;
+    }
+
+    if (keyframe && (viewer.needInit || item.init)) {
+      push(viewer, Chunk{Packet(), init_});
+      viewer.needInit = false;
+    }
+    push(viewer, Chunk{item.packet, nullptr});
+    viewer.waitKeyframe = false;
+  }
+
+  /**
+   * @brief 追加到发送队列
+   * @param viewer 观看者
+   * @param chunk 数据
+   */
+  void push(Viewer& viewer, Chunk chunk) {
+    if (viewer.queue.empty()) viewer.progressMs = nowMs();
+    viewer.queuedBytes += chunk.size();
+    viewer.queue.push_back(std::move(chunk));
+  }
+
+  /**
+   * @brief 丢弃队列中的媒体片段，保留已开始发送的队首和响应头/初始化段
+   * @param viewer 观看者
+   *
+   * 已开始发送的队首片段必须发完才能接上下一个分块，把未发送的部分复制出内存池，
+   * 避免停滞的观看者在超时前一直占住先进先出的内存池
+   */
+  void trim(Viewer& viewer) {
+    if (viewer.offset > 0 && !viewer.queue.front().blob) {
+      Chunk& head = viewer.queue.front();
+      head.blob = std::make_shared<const std::vector<uint8_t>>(head.packet.data() + viewer.offset,
+                                                               head.packet.data() + head.packet.size());
+      head.packet = Packet();
+      viewer.offset = 0;
+    }
+    viewer.queue.erase(std::remove_if(viewer.queue.begin(), viewer.queue.end(),
+                                      [](const Chunk& chunk) { return !chunk.blob; }),
+                       viewer.queue.end());
+    viewer.queuedBytes = 0;
+    for (const Chunk& chunk : viewer.queue) viewer.queuedBytes += chunk.size();
+    viewer.waitKeyframe = true;
+  }
+
+  /**
+   * @brief 设置新连接的套接字选项并创建观看者
+   * @param fd 连接
+   */
+  void accept(int fd) {
+    // 片段已按帧成块，关闭Nagle避免小的P帧片段被延迟
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (params_.sendBufferSize > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &params_.sendBufferSize, sizeof(params_.sendBufferSize)) < 0) {
+      log::warn("Failed to set stream SO_SNDBUF: " + std::string(std::strerror(errno)));
+    }
+    viewers_[fd];
+    accepted_++;
+  }
+
+  /**
+   * @brief 按请求开始推流或返回错误
+   * @param fd 连接
+   * @param method 请求方法
+   * @param path 请求路径
+   */
+  void respond(int fd, const std::string& method, const std::string& path) {
+    Viewer& viewer = viewers_[fd];
+    if (method != "GET" && method != "HEAD") {
+      viewer.closing = true;
+      push(viewer, Chunk{Packet(), notAllowed_});
+    } else if (path != params_.path) {
+      viewer.closing = true;
+      push(viewer, Chunk{Packet(), notFound_});
+    } else if (method == "HEAD") {
+      viewer.closing = true;
+      push(viewer, Chunk{Packet(), okHeader_});
+    } else {
+      // 有完整的当前GOP时立即从它的IDR帧开始，否则等待下一个IDR帧
+      viewer.streaming = true;
+      viewerCount_++;
+      push(viewer, Chunk{Packet(), okHeader_});
+      if (gopValid_ && init_ && !gop_.empty()) {
+        push(viewer, Chunk{Packet(), init_});
+        for (const Packet& packet : gop_) push(viewer, Chunk{packet, nullptr});
+        viewer.needInit = false;
+        viewer.waitKeyframe = false;
+      }
+    }
+    flush(fd);
+  }
+
+  /**
+   * @brief 用sendmsg聚合发送队列中的数据
+   * @param fd 连接
+   */
+  void flush(int fd) {
+    auto it = viewers_.find(fd);
+    if (it == viewers_.end()) return;
+    Viewer& viewer = it->second;
+
+    struct iovec iov[MAX_IOV];
+    while (!viewer.queue.empty()) {
+      int count = 0;
+      for (auto chunk = viewer.queue.begin(); chunk != viewer.queue.end() && count < MAX_IOV; ++chunk, ++count) {
+        const size_t skip = count == 0 ? viewer.offset : 0;
+        iov[count].iov_base = const_cast<uint8_t*>(chunk->data() + skip);
+        iov[count].iov_len = chunk->size() - skip;
+      }
+      struct msghdr msg{};
+      msg.msg_iov = iov;
+      msg.msg_iovlen = static_cast<size_t>(count);
+      const ssize_t sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+      if (sent < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+          listener_->drop(fd);
+        } else if (!viewer.blocked) {
+          viewer.blocked = true;
+          listener_->watch(fd, EPOLLIN | EPOLLOUT);
+        }
+        return;
+      }
+      bytesSent_ += static_cast<uint64_t>(sent);
+      viewer.progressMs = nowMs();
+
+      // 释放已发完的片段
+      size_t left = static_cast<size_t>(sent);
+      while (left > 0) {
+        const size_t size = viewer.queue.front().size();
+        const size_t rest = size - viewer.offset;
+        if (left < rest) {
+          viewer.offset += left;
+          break;
+        }
+        left -= rest;
+        viewer.queuedBytes -= size;
+        viewer.offset = 0;
+        viewer.queue.pop_front();
+      }
+    }
+
+    if (viewer.closing) {
+      listener_->drop(fd);
+      return;
+    }
+    if (viewer.blocked) {
+      viewer.blocked = false;
+      listener_->watch(fd, EPOLLIN);
+    }
+  }
+
+  /**
+   * @brief 判断发送是否停滞
+   * @param fd 连接
+   * @param now 当前时刻(毫秒)
+   * @return 队列非空且超时未有进展返回true
+   */
+  bool stalled(int fd, int64_t now) const {
+    auto it = viewers_.find(fd);
+    return it != viewers_.end() && !it->second.queue.empty() && now - it->second.progressMs > params_.idleTimeoutMs;
+  }
+
+  /**
+   * @brief 释放已关闭连接的观看者
+   * @param fd 连接
+   */
+  void closed(int fd) {
+    auto it = viewers_.find(fd);
+    if (it == viewers_.end()) return;
+    if (it->second.streaming) viewerCount_--;
+    viewers_.erase(it);
+  }
+
+  StreamServerParams params_;                              /**< 配置参数 */
+  PacketPool pool_;                                        /**< 片段内存池，先于持有Packet的成员构造、后于它们析构 */
+  std::shared_ptr<const std::vector<uint8_t>> okHeader_;   /**< 200响应头 */
+  std::shared_ptr<const std::vector<uint8_t>> notFound_;   /**< 404响应 */
+  std::shared_ptr<const std::vector<uint8_t>> notAllowed_; /**< 405响应 */
+
+  // 写入线程状态
+  std::vector<uint8_t> sps_;     /**< 最近的SPS */
+  std::vector<uint8_t> pps_;     /**< 最近的PPS */
+  std::vector<uint8_t> initSps_; /**< 当前初始化段使用的SPS */
+  std::vector<uint8_t> initPps_; /**< 当前初始化段使用的PPS */
+  std::vector<uint8_t> payload_; /**< 长度前缀格式的帧数据 */
+  std::vector<uint8_t> scratch_; /**< 分块生成缓冲区 */
+  bool started_ = false;         /**< 已开始 */
+  bool waitIdr_ = true;          /**< 等待IDR帧 */
+  int64_t baseDts_ = 0;          /**< 首帧解码时刻(刻度)，流内时间从0开始 */
+  int64_t lastDts_ = -1;         /**< 上一帧解码时刻(刻度) */
+  int64_t lastDuration_ = 0;     /**< 上一帧间隔(刻度) */
+  uint32_t sequence_ = 1;        /**< moof序号 */
+
+  // 线程间交接
+  std::mutex mutex_;             /**< 保护pending_ */
+  std::vector<Pending> pending_; /**< 待分发的帧 */
+
+  // 服务线程状态
+  std::vector<Pending> incoming_;                    /**< 正在分发的帧 */
+  std::unordered_map<int, Viewer> viewers_;          /**< 活动连接 */
+  std::shared_ptr<const std::vector<uint8_t>> init_; /**< 当前初始化段(已分块) */
+  std::vector<Packet> gop_;                          /**< 当前GOP的片段 */
+  size_t gopBytes_ = 0;                              /**< 当前GOP的字节数 */
+  bool gopValid_ = false;                            /**< gop_从IDR帧开始且完整 */
+  std::vector<int> ready_;                           /**< 待处理的连接(复用) */
+
+  // 统计
+  std::atomic<int> viewerCount_{0};    /**< 当前观看者数 */
+  std::atomic<uint64_t> accepted_{0};  /**< 已接受的连接数 */
+  std::atomic<uint64_t> frames_{0};    /**< 已封装的帧数 */
+  std::atomic<uint64_t> bytesSent_{0}; /**< 已发送的字节数 */
+  std::atomic<uint64_t> dropped_{0};   /**< 内存池已满丢弃的帧数 */
+  std::atomic<uint64_t> overflows_{0}; /**< 积压超限次数 */
+
+  std::unique_ptr<HttpListener> listener_; /**< HTTP监听和服务线程，最后构造、最先停止 */
+};
+
+StreamServer::StreamServer(const StreamServerParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+StreamServer::~StreamServer() = default;
+
+void StreamServer::write(const EncodedFrame& frame) { pImpl_->write(frame); }
+
+int StreamServer::getPort() const { return pImpl_->getPort(); }
+
+StreamServerStats StreamServer::getStats() const { return pImpl_->getStats(); }
+
+const StreamServerParams& StreamServer::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
@@ -0,0 +1,337 @@
+/**
+ * @file task_scheduler.cpp
+ * @brief 工作窃取任务调度器实现
+ */
+#include "camera_toolkit/task_scheduler.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int PRIORITY_COUNT = 3; /**< 优先级数 */
+
+}  // anonymous namespace
+
+/**
+ * @brief TaskScheduler类的PIMPL实现
+ */
+class TaskScheduler::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   * @throws CameraToolkitException 线程数为负时抛出
+   */
+  explicit Impl(const TaskSchedulerParams& params) : params_(params) {
+    if (params_.threads < 0) {
+      throw CameraToolkitException("Invalid scheduler thread count: " + std::to_string(params_.threads));
+    }
+    if (params_.threads == 0) {
+      params_.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    for (int i = 0; i < params_.threads; i++) workers_.push_back(std::make_unique<Worker>());
+    for (int i = 0; i < params_.threads; i++) {
+      threads_.emplace_back([this, i] { run(i); });
+      if (params_.pinThreads) pin(threads_.back(), params_.firstCore + i);
+    }
+    log::info("Task scheduler started with " + std::to_string(params_.threads) + " threads");
+  }
+
+  /**
+   * @brief 析构函数
+   */
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex_);
+      stop_ = true;
+    }
+    workReady_.notify_all();
+    for (auto& thread : threads_) thread.join();
+  }
+
+  /**
+   * @brief 提交任务
+   * @param group 所属任务组，可为nullptr
+   * @param task 任务
+   * @param priority 优先级
+   */
+  void submit(TaskGroup* group, Task task, TaskPriority priority) {
+    if (group) {
+      std::lock_guard<std::mutex> lock(group->mutex_);
+      group->pending_++;
+    }
+    const int index = current_.scheduler == this ? current_.worker
+                                                 : static_cast<int>(next_++ % static_cast<unsigned>(workers_.size()));
+    Worker& worker = *workers_[static_cast<size_t>(index)];
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.queues[static_cast<int>(priority)].push_back(Item{std::move(task), group});
+    }
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+    if (group) {
+      std::lock_guard<std::mutex> lock(group->mutex_);
+      group->queued_++;
+    }
+
+    // 先增加待执行数再检查睡眠线程数，与睡眠方的顺序相反，两者至少有一方看到对方的修改。
+    // 工作线程与任务组等待方分用两个条件变量，notify_one不会落到不能执行该任务的等待方身上
+    pending_.fetch_add(1);
+    const bool wakeWorker = idleWorkers_.load() > 0;
+    const bool wakeWaiters = group && groupWaiters_.load() > 0;
+    if (wakeWorker || wakeWaiters) {
+      { std::lock_guard<std::mutex> lock(sleepMutex_); }
+      if (wakeWorker) workReady_.notify_one();
+      if (wakeWaiters) groupChanged_.notify_all();
+    }
+  }
+
+  /**
+   * @brief 等待任务组完成
+   * @param group 任务组
+   */
+  void wait(TaskGroup& group) {
+    const int index = current_.scheduler == this ? current_.worker : -1;
+    while (!group.done()) {
+      Item item;
+      if (take(index, &group, item)) {
+        execute(item);
+        continue;
+      }
+      // 组内剩余任务都在其他线程执行中，等待完成或组内的新任务
+      std::unique_lock<std::mutex> lock(sleepMutex_);
+      groupWaiters_.fetch_add(1);
+      groupChanged_.wait(lock, [&] {
+        std::lock_guard<std::mutex> groupLock(group.mutex_);
+        return group.pending_ == 0 || group.queued_ > 0;
+      });
+      groupWaiters_.fetch_sub(1);
+    }
+
+    std::exception_ptr error;
+    {
+      std::lock_guard<std::mutex> lock(group.mutex_);
+      std::swap(error, group.error_);
+    }
+    if (error) std::rethrow_exception(error);
+  }
+
+  /**
+   * @brief 获取工作线程数
+   * @return 工作线程数
+   */
+  int getThreadCount() const { return params_.threads; }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  TaskSchedulerStats getStats() const {
+    TaskSchedulerStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.executed = executed_.load(std::memory_order_relaxed);
+    stats.stolen = stolen_.load(std::memory_order_relaxed);
+    stats.failed = failed_.load(std::memory_order_relaxed);
+    return stats;
+  }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const TaskSchedulerParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 队列中的任务
+   */
+  struct Item {
+    Task task;                  /**< 任务 */
+    TaskGroup* group = nullptr; /**< 所属任务组 */
+  };
+
+  /**
+   * @brief 工作线程的任务队列，按缓存行对齐避免相邻线程的锁互相干扰
+   */
+  struct alignas(64) Worker {
+    std::mutex mutex;                        /**< 保护队列，本线程和窃取方都通过它访问 */
+    std::deque<Item> queues[PRIORITY_COUNT]; /**< 按优先级分开的队列 */
+  };
+
+  /**
+   * @brief 当前线程所属的调度器和工作线程序号
+   */
+  struct Current {
+    const Impl* scheduler = nullptr; /**< 调度器，非工作线程为nullptr */
+    int worker = -1;                 /**< 工作线程序号 */
+  };
+
+  /**
+   * @brief 工作线程主循环
+   * @param index 工作线程序号
+   */
+  void run(int index) {
+    current_.scheduler = this;
+    current_.worker = index;
+    while (true) {
+      Item item;
+      if (take(index, nullptr, item)) {
+        execute(item);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMutex_);
+      idleWorkers_.fetch_add(1);
+      workReady_.wait(lock, [this] { return stop_ || pending_.load() > 0; });
+      idleWorkers_.fetch_sub(1);
+      if (stop_ && pending_.load() == 0) return;
+    }
+  }
+
+  /**
+   * @brief 按优先级取一个任务，先查本线程队列，再依次窃取其他线程的队列
+   * @param index 本线程序号，非工作线程为-1
+   * @param group 只取属于该组的任务，nullptr表示任意任务
+   * @param item 取得的任务
+   * @return 取得任务返回true
+   */
+  bool take(int index, const TaskGroup* group, Item& item) {
+    if (pending_.load(std::memory_order_relaxed) <= 0) return false;
+    const int count = static_cast<int>(workers_.size());
+    const int start = index >= 0 ? index : static_cast<int>(next_.load(std::memory_order_relaxed) % count);
+    for (int priority = 0; priority < PRIORITY_COUNT; priority++) {
+      for (int i = 0; i < count; i++) {
+        Worker& worker = *workers_[static_cast<size_t>((start + i) % count)];
+        {
+          std::lock_guard<std::mutex> lock(worker.mutex);
+          std::deque<Item>& queue = worker.queues[priority];
+          auto it = queue.begin();
+          if (group) {
+            while (it != queue.end() && it->group != group) ++it;
+          }
+          if (it == queue.end()) continue;
+          item = std::move(*it);
+          queue.erase(it);
+          pending_.fetch_sub(1);
+        }
+        if (index < 0 || i > 0) stolen_.fetch_add(1, std::memory_order_relaxed);
+        if (item.group) {
+          std::lock_guard<std::mutex> lock(item.group->mutex_);
+          item.group->queued_--;
+        }
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief 执行任务并更新所属任务组
+   * @param item 任务
+   */
+  void execute(Item& item) {
+    std::exception_ptr error;
+    try {
+      item.task();
+    } catch (const std::exception& e) {
+      error = std::current_exception();
+      if (!item.group) log::error(std::string("Scheduled task failed: ") + e.what());
+    } catch (...) {
+      error = std::current_exception();
+      if (!item.group) log::error("Scheduled task failed");
+    }
+    item.task = nullptr;
+    executed_.fetch_add(1, std::memory_order_relaxed);
+    if (error) failed_.fetch_add(1, std::memory_order_relaxed);
+    if (!item.group) return;
+
+    // 解锁组之后不再访问它，等待方看到完成后即可销毁组
+    bool finished;
+    {
+      std::lock_guard<std::mutex> lock(item.group->mutex_);
+      if (error && !item.group->error_) item.group->error_ = error;
+      finished = --item.group->pending_ == 0;
+    }
+    if (finished) {
+      { std::lock_guard<std::mutex> lock(sleepMutex_); }
+      groupChanged_.notify_all();
+    }
+  }
+
+  /**
+   * @brief 把线程绑定到指定核
+   * @param thread 线程
+   * @param core 核号
+   */
+  static void pin(std::thread& thread, int core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(static_cast<size_t>(core) % CPU_SETSIZE, &set);
+    const int ret = pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    if (ret != 0) {
+      log::warn("Failed to pin scheduler thread to core " + std::to_string(core) + ": " + std::strerror(ret));
+    }
+  }
+
+  static thread_local Current current_; /**< 当前线程所属的调度器 */
+
+  TaskSchedulerParams params_;                   /**< 配置参数 */
+  std::vector<std::unique_ptr<Worker>> workers_; /**< 各工作线程的任务队列 */
+  std::vector<std::thread> threads_;             /**< 工作线程 */
+  std::atomic<int> pending_{0};                  /**< 队列中尚未取走的任务数 */
+  std::atomic<int> idleWorkers_{0};              /**< 正在等待新任务的工作线程数 */
+  std::atomic<int> groupWaiters_{0};             /**< 正在等待任务组的线程数 */
+  std::atomic<unsigned> next_{0};                /**< 非工作线程提交时轮流选择的队列 */
+  std::mutex sleepMutex_;                        /**< 与两个条件变量配合，保护stop_ */
+  std::condition_variable workReady_;            /**< 有新任务或停止时通知工作线程 */
+  std::condition_variable groupChanged_;         /**< 任务组完成或有组内新任务时通知等待方 */
+  bool stop_ = false;                            /**< 停止标志 */
+  std::atomic<uint64_t> submitted_{0};           /**< 已提交的任务数 */
+  std::atomic<uint64_t> executed_{0};            /**< 已执行的任务数 */
+  std::atomic<uint64_t> stolen_{0};              /**< 窃取的任务数 */
+  std::atomic<uint64_t> failed_{0};              /**< 抛出异常的任务数 */
+};
+
+thread_local TaskScheduler::Impl::Current TaskScheduler::Impl::current_;
+
+TaskScheduler::TaskScheduler(const TaskSchedulerParams& params) : pImpl_(std::make_unique<Impl>(params)) {}
+
+TaskScheduler::~TaskScheduler() = default;
+
+void TaskScheduler::submit(Task task, TaskPriority priority) { pImpl_->submit(nullptr, std::move(task), priority); }
+
+void TaskScheduler::submit(TaskGroup& group, Task task, TaskPriority priority) {
+  pImpl_->submit(&group, std::move(task), priority);
+}
+
+void TaskScheduler::wait(TaskGroup& group) { pImpl_->wait(group); }
+
+void TaskScheduler::parallelFor(int count, const std::function<void(int)>& body, TaskPriority priority) {
+  TaskGroup group;
+  for (int i = 0; i < count; i++) {
+    pImpl_->submit(&group, [&body, i] { body(i); }, priority);
+  }
+  pImpl_->wait(group);
+}
+
+int TaskScheduler::getThreadCount() const { return pImpl_->getThreadCount(); }
+
+TaskSchedulerStats TaskScheduler::getStats() const { return pImpl_->getStats(); }
+
+const TaskSchedulerParams& TaskScheduler::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
@@ -0,0 +1,743 @@
+/**
+ * @file text_strip.cpp
+ * @brief 预渲染文字条带实现
+ */
+#include "text_strip.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int ASCII_MAX = 127; /**< ASCII最大值 */
+
+/**
+ * @brief 小字符绘制数据结构体
+ */
+struct DrawChar {
+  unsigned char ascii;     /**< ASCII码 */
+  unsigned char pix[8][7]; /**< 像素数据(8行7列) */
+};
+
+/**
+ * @brief 字符绘制表(小字符)
+ */
+constexpr DrawChar drawTable[] = {
+    {' ',
+     {{0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0}}},
+    {'0',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 2, 2, 1},
+      {1, 2, 1, 2, 1, 2, 1},
+      {1, 2, 1, 2, 1, 2, 1},
+      {1, 2, 2, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'1',
+     {{0, 0, 0, 1, 0, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'2',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 1, 2, 2, 1, 0},
+      {0, 1, 2, 1, 1, 0, 0},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 1, 1, 0}}},
+    {'3',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 1, 2, 2, 1, 0},
+      {0, 1, 0, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'4',
+     {{0, 0, 0, 0, 1, 0, 0},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 1, 2, 2, 1, 0},
+      {0, 1, 2, 1, 2, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 2, 1, 0},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 0, 0, 1, 0, 0}}},
+    {'5',
+     {{0, 1, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {0, 1, 1, 1, 1, 2, 0},
+      {0, 1, 1, 1, 1, 2, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {0, 1, 1, 1, 1, 0, 0}}},
+    {'6',
+     {{0, 0, 1, 1, 1, 1, 0},
+      {0, 1, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'7',
+     {{0, 1, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 1, 2, 1},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {0, 0, 1, 0, 0, 0, 0}}},
+    {'8',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'9',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {':',
+     {{0, 0, 1, 1, 0, 0, 0},
+      {0, 1, 2, 2, 1, 0, 0},
+      {0, 1, 2, 2, 1, 0, 0},
+      {0, 0, 1, 1, 0, 0, 0},
+      {0, 0, 1, 1, 0, 0, 0},
+      {0, 1, 2, 2, 1, 0, 0},
+      {0, 1, 2, 2, 1, 0, 0},
+      {0, 0, 1, 1, 0, 0, 0}}},
+    {'-',
+     {{0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0},
+      {0, 0, 0, 0, 0, 0, 0}}},
+    {'(',
+     {{0, 0, 0, 1, 0, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 0, 1, 0, 0, 0}}},
+    {')',
+     {{0, 0, 0, 1, 0, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 0, 1, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 0, 1, 0, 0, 0}}},
+    {'A',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'B',
+     {{0, 1, 1, 1, 1, 0, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 1, 0},
+      {0, 1, 1, 1, 1, 0, 0}}},
+    {'C',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 0, 0, 1, 0},
+      {1, 2, 1, 0, 0, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'D',
+     {{0, 1, 1, 1, 1, 0, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 1, 0},
+      {0, 1, 1, 1, 1, 0, 0}}},
+    {'E',
+     {{0, 1, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 0, 0},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 1, 1, 0}}},
+    {'F',
+     {{0, 1, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {0, 1, 0, 0, 0, 0, 0}}},
+    {'G',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 1, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'H',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'I',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'J',
+     {{0, 0, 1, 1, 1, 1, 0},
+      {0, 1, 2, 2, 2, 2, 1},
+      {0, 0, 1, 1, 1, 2, 1},
+      {0, 0, 0, 0, 1, 2, 1},
+      {0, 1, 0, 0, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'K',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 1, 2, 1, 0},
+      {1, 2, 1, 2, 1, 0, 0},
+      {1, 2, 2, 2, 1, 0, 0},
+      {1, 2, 1, 1, 2, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'L',
+     {{0, 1, 0, 0, 0, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {1, 2, 1, 1, 1, 0, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {0, 1, 1, 1, 1, 0, 0}}},
+    {'M',
+     {{0, 1, 1, 0, 1, 1, 0},
+      {1, 2, 2, 1, 2, 2, 1},
+      {1, 2, 1, 2, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'N',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 2, 1, 1, 2, 1},
+      {1, 2, 1, 2, 1, 2, 1},
+      {1, 2, 1, 1, 2, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'O',
+     {{0, 0, 1, 1, 1, 0, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 0, 0}}},
+    {'P',
+     {{0, 1, 1, 1, 1, 0, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {1, 2, 1, 0, 0, 0, 0},
+      {0, 1, 0, 0, 0, 0, 0}}},
+    {'R',
+     {{0, 1, 1, 1, 1, 0, 0},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 1, 0},
+      {1, 2, 1, 2, 1, 0, 0},
+      {1, 2, 1, 1, 2, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'S',
+     {{0, 0, 1, 1, 1, 1, 0},
+      {0, 1, 2, 2, 2, 2, 1},
+      {1, 2, 1, 1, 1, 1, 0},
+      {0, 1, 2, 2, 2, 1, 0},
+      {0, 0, 1, 1, 1, 2, 1},
+      {0, 1, 1, 1, 1, 2, 1},
+      {1, 2, 2, 2, 2, 1, 0},
+      {0, 1, 1, 1, 1, 0, 0}}},
+    {'T',
+     {{0, 1, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 2, 1, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 0, 1, 0, 0, 0}}},
+    {'U',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {0, 1, 2, 2, 2, 2, 1},
+      {0, 0, 1, 1, 1, 1, 0}}},
+    {'V',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 2, 1, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 0, 1, 0, 0, 0}}},
+    {'W',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 0, 1, 2, 1},
+      {1, 2, 1, 1, 1, 2, 1},
+      {1, 2, 1, 2, 1, 2, 1},
+      {1, 2, 1, 2, 1, 2, 1},
+      {0, 1, 2, 1, 2, 1, 0},
+      {0, 0, 1, 0, 1, 0, 0}}},
+    {'X',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 2, 1, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 1, 2, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 0, 0, 0, 1, 0}}},
+    {'Y',
+     {{0, 1, 0, 0, 0, 1, 0},
+      {1, 2, 1, 0, 1, 2, 1},
+      {0, 1, 2, 1, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 0, 0, 1, 0, 0, 0}}},
+    {'Z',
+     {{0, 1, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 2, 1, 0},
+      {0, 0, 1, 2, 1, 0, 0},
+      {0, 1, 2, 1, 0, 0, 0},
+      {1, 2, 1, 1, 1, 1, 0},
+      {1, 2, 2, 2, 2, 2, 1},
+      {0, 1, 1, 1, 1, 1, 0}}},
+};
+
+constexpr size_t DRAW_TABLE_SIZE = sizeof(drawTable) / sizeof(DrawChar); /**< 绘制表大小 */
+
+constexpr int MAX_TABLE_SCALE = 4; /**< 编译期生成掩码表的最大缩放倍数 */
+
+/**
+ * @brief 指定缩放倍数下字符的黑/白字节掩码
+ *
+ * 每个像素为0x00或0xFF，行跨度为GLYPH_W * S，合成时无需逐像素分支
+ */
+template <int S>
+struct GlyphMask {
+  uint8_t black[GLYPH_H * S * GLYPH_W * S] = {}; /**< 黑色(描边)像素掩码 */
+  uint8_t white[GLYPH_H * S * GLYPH_W * S] = {}; /**< 白色(笔画)像素掩码 */
+};
+
+/**
+ * @brief 指定缩放倍数下全部字符的掩码表
+ */
+template <int S>
+struct GlyphTable {
+  GlyphMask<S> glyphs[DRAW_TABLE_SIZE] = {}; /**< 与drawTable一一对应的掩码 */
+};
+
+/**
+ * @brief 编译期按缩放倍数把字符点阵展开为黑/白掩码
+ * @return 掩码表
+ */
+template <int S>
+constexpr GlyphTable<S> makeGlyphTable() {
+  GlyphTable<S> table;
+  for (size_t i = 0; i < DRAW_TABLE_SIZE; i++) {
+    for (int y = 0; y < GLYPH_H * S; y++) {
+      for (int x = 0; x < GLYPH_W * S; x++) {
+        unsigned char p = drawTable[i].pix[y / S][x / S];
+        table.glyphs[i].black[y * GLYPH_W * S + x] = p == 1 ? 0xFF : 0x00;
+        table.glyphs[i].white[y * GLYPH_W * S + x] = p == 2 ? 0xFF : 0x00;
+      }
+    }
+  }
+  return table;
+}
+
+/**
+ * @brief 编译期生成ASCII到drawTable下标的查找表，未定义的字符映射为空格(下标0)
+ * @return 查找表
+ */
+constexpr std::array<uint8_t, ASCII_MAX> makeAsciiIndex() {
+  std::array<uint8_t, ASCII_MAX> index{};
+  for (size_t i = 0; i < DRAW_TABLE_SIZE; i++) {
+    index[drawTable[i].ascii] = static_cast<uint8_t>(i);
+  }
+  return index;
+}
+
+// 编译期生成的只读表(.rodata)，无需运行时初始化，多线程构造也无竞争
+constexpr GlyphTable<1> GLYPHS_X1 = makeGlyphTable<1>();                 /**< 1倍字符掩码 */
+constexpr GlyphTable<2> GLYPHS_X2 = makeGlyphTable<2>();                 /**< 2倍字符掩码 */
+constexpr GlyphTable<3> GLYPHS_X3 = makeGlyphTable<3>();                 /**< 3倍字符掩码 */
+constexpr GlyphTable<4> GLYPHS_X4 = makeGlyphTable<4>();                 /**< 4倍字符掩码 */
+constexpr std::array<uint8_t, ASCII_MAX> ASCII_INDEX = makeAsciiIndex(); /**< ASCII查找表 */
+
+static_assert(ASCII_INDEX['0'] != 0 && ASCII_INDEX['Z'] != 0, "glyph lookup must cover digits and letters");
+
+/**
+ * @brief 获取字符在指定缩放倍数下的掩码
+ * @param index drawTable下标
+ * @param scale 缩放倍数(1-MAX_TABLE_SCALE)
+ * @param black 输出黑色掩码
+ * @param white 输出白色掩码
+ */
+void glyphMasks(int index, int scale, const uint8_t** black, const uint8_t** white) {
+  switch (scale) {
+    case 1:
+      *black = GLYPHS_X1.glyphs[index].black;
+      *white = GLYPHS_X1.glyphs[index].white;
+      break;
+    case 2:
+      *black = GLYPHS_X2.glyphs[index].black;
+      *white = GLYPHS_X2.glyphs[index].white;
+      break;
+    case 3:
+      *black = GLYPHS_X3.glyphs[index].black;
+      *white = GLYPHS_X3.glyphs[index].white;
+      break;
+    default:
+      *black = GLYPHS_X4.glyphs[index].black;
+      *white = GLYPHS_X4.glyphs[index].white;
+      break;
+  }
+}
+
+/**
+ * @brief 把一行字符掩码叠加到条带上，后绘制的字符覆盖重叠像素
+ * @param mask 条带覆盖掩码
+ * @param value 条带预乘亮度
+ * @param black 字符黑色掩码
+ * @param white 字符白色掩码
+ * @param n 像素数
+ */
+void stampGlyphRow(uint8_t* mask, uint8_t* value, const uint8_t* black, const uint8_t* white, int n) {
+  for (int x = 0; x < n; x++) {
+    uint8_t cover = black[x] | white[x];
+    mask[x] |= cover;
+    value[x] = static_cast<uint8_t>((value[x] & ~cover) | white[x]);
+  }
+}
+
+/**
+ * @brief 合成一行像素的标量实现: dst = (dst & ~mask) | value
+ * @param dst 目标像素
+ * @param mask 覆盖掩码(0xFF为文字像素)
+ * @param value 预乘后的文字亮度
+ * @param n 像素数
+ */
+void blendRowScalar(uint8_t* dst, const uint8_t* mask, const uint8_t* value, int n) {
+  for (int x = 0; x < n; x++) {
+    dst[x] = static_cast<uint8_t>((dst[x] & ~mask[x]) | value[x]);
+  }
+}
+
+#if defined(__SSE2__)
+/**
+ * @brief 合成一行像素(SSE2，每次16像素)
+ */
+void blendRowSse2(uint8_t* dst, const uint8_t* mask, const uint8_t* value, int n) {
+  int x = 0;
+  for (; x + 16 <= n; x += 16) {
+    __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + x));
+    __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mask + x));
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(value + x));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_or_si128(_mm_andnot_si128(m, d), v));
+  }
+  blendRowScalar(dst + x, mask + x, value + x, n - x);
+}
+
+/**
+ * @brief 合成一行像素(AVX2，每次32像素)
+ */
+__attribute__((target("avx2"))) void blendRowAvx2(uint8_t* dst, const uint8_t* mask, const uint8_t* value, int n) {
+  int x = 0;
+  for (; x + 32 <= n; x += 32) {
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + x));
+    __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + x));
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(value + x));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), _mm256_or_si256(_mm256_andnot_si256(m, d), v));
+  }
+  blendRowSse2(dst + x, mask + x, value + x, n - x);
+}
+#elif defined(__ARM_NEON)
+/**
+ * @brief 合成一行像素(NEON，每次16像素)
+ */
+void blendRowNeon(uint8_t* dst, const uint8_t* mask, const uint8_t* value, int n) {
+  int x = 0;
+  for (; x + 16 <= n; x += 16) {
+    uint8x16_t d = vld1q_u8(dst + x);
+    vst1q_u8(dst + x, vbslq_u8(vld1q_u8(mask + x), vld1q_u8(value + x), d));
+  }
+  blendRowScalar(dst + x, mask + x, value + x, n - x);
+}
+#endif
+
+using BlendRowFn = void (*)(uint8_t*, const uint8_t*, const uint8_t*, int); /**< 行合成函数类型 */
+
+/**
+ * @brief 按CPU特性选择行合成实现
+ * @return 行合成函数
+ */
+BlendRowFn selectBlendRow() {
+#if defined(__SSE2__)
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2") ? blendRowAvx2 : blendRowSse2;
+#elif defined(__ARM_NEON)
+  return blendRowNeon;
+#else
+  return blendRowScalar;
+#endif
+}
+
+}  // anonymous namespace
+
+void blendRow(uint8_t* dst, const uint8_t* mask, const uint8_t* value, int n) {
+  static const BlendRowFn impl = selectBlendRow();
+  impl(dst, mask, value, n);
+}
+
+// ============================================================================
+// TextStrip
+// ============================================================================
+
+void TextStrip::update(const char* text, int len, int scale) {
+  const int adv = ADVANCE * scale;
+  const int glyphW = GLYPH_W * scale;
+
+  if (len != static_cast<int>(text_.size()) || scale != scale_) {
+    // 布局变化，整条重绘
+    scale_ = scale;
+    text_.assign(text, len);
+    width_ = len > 0 ? (len - 1) * adv + glyphW : 0;
+    height_ = GLYPH_H * scale_;
+    mask_.assign(static_cast<size_t>(width_) * height_, 0);
+    value_.assign(mask_.size(), 0);
+    render(0, width_);
+    return;
+  }
+
+  // 逐段找出变化的字符，只重绘对应列区间
+  int pos = 0;
+  while (pos < len) {
+    if (text_[pos] == text[pos]) {
+      pos++;
+      continue;
+    }
+    int end = pos;
+    while (end < len && text_[end] != text[end]) {
+      text_[end] = text[end];
+      end++;
+    }
+    render(pos * adv, (end - 1) * adv + glyphW);
+    pos = end;
+  }
+}
+
+void TextStrip::render(int lo, int hi) {
+  const int adv = ADVANCE * scale_;
+  const int glyphW = GLYPH_W * scale_;
+
+  for (int y = 0; y < height_; y++) {
+    std::memset(&mask_[static_cast<size_t>(y) * width_ + lo], 0, hi - lo);
+    std::memset(&value_[static_cast<size_t>(y) * width_ + lo], 0, hi - lo);
+  }
+
+  // 按从左到右的顺序叠加与区间相交的字符，后绘制的覆盖重叠列
+  int first = std::max(0, (lo - glyphW) / adv);
+  for (int i = first; i < static_cast<int>(text_.size()) && i * adv < hi; i++) {
+    int ascii = static_cast<unsigned char>(text_[i]);
+    if (ascii >= ASCII_MAX) ascii = ' ';
+    int index = ASCII_INDEX[ascii];
+
+    int x0 = std::max(lo, i * adv);
+    int x1 = std::min(hi, i * adv + glyphW);
+    for (int y = 0; y < height_; y++) {
+      const uint8_t* black;
+      const uint8_t* white;
+      glyphRow(index, y, &black, &white);
+      size_t off = static_cast<size_t>(y) * width_ + x0;
+      int src = x0 - i * adv;
+      stampGlyphRow(&mask_[off], &value_[off], black + src, white + src, x1 - x0);
+    }
+  }
+}
+
+void TextStrip::glyphRow(int index, int y, const uint8_t** black, const uint8_t** white) {
+  // 缩放倍数不超过MAX_TABLE_SCALE时直接引用编译期掩码表，更大的倍数从1倍掩码按最近邻展开
+  const int glyphW = GLYPH_W * scale_;
+  if (scale_ <= MAX_TABLE_SCALE) {
+    glyphMasks(index, scale_, black, white);
+    *black += y * glyphW;
+    *white += y * glyphW;
+    return;
+  }
+
+  rowBlack_.resize(glyphW);
+  rowWhite_.resize(glyphW);
+  const uint8_t* srcBlack = GLYPHS_X1.glyphs[index].black + (y / scale_) * GLYPH_W;
+  const uint8_t* srcWhite = GLYPHS_X1.glyphs[index].white + (y / scale_) * GLYPH_W;
+  for (int x = 0; x < glyphW; x++) {
+    rowBlack_[x] = srcBlack[x / scale_];
+    rowWhite_[x] = srcWhite[x / scale_];
+  }
+  *black = rowBlack_.data();
+  *white = rowWhite_.data();
+}
+
+// ============================================================================
+// TextBlock
+// ============================================================================
+
+void TextBlock::layout(const char* text, int x, int y, int factor, int width) {
+  if (x == x_ && y == y_ && factor == factor_ && text_ == text) return;
+  text_ = text;
+  x_ = x;
+  y_ = y;
+  factor_ = factor;
+
+  constexpr const char* NEWLINE = "\\n";
+  std::vector<std::pair<const char*, int>> spans;
+  const char* begin = text;
+  const char* end;
+  while ((end = strstr(begin, NEWLINE))) {
+    spans.emplace_back(begin, static_cast<int>(end - begin));
+    begin = end + 2;
+  }
+  spans.emplace_back(begin, static_cast<int>(strlen(begin)));
+
+  const int scale = std::max(factor, 0) + 1;
+  const int adv = ADVANCE * scale;
+  const int lineSpace = (GLYPH_H + 1) * scale;
+
+  // 行数不变时保留原条带，只重绘变化的字符
+  lines_.resize(spans.size());
+  int lineY = y - lineSpace * static_cast<int>(spans.size() - 1);
+  top_ = lineY;
+  for (size_t i = 0; i < spans.size(); i++, lineY += lineSpace) {
+    int lineX = x;
+    int len = spans[i].second;
+    // 位于右半边时右对齐
+    if (lineX > width / 2) {
+      lineX = std::max(0, lineX - len * adv);
+    }
+    if (lineX + len * adv >= width) {
+      len = std::max(0, (width - lineX - 1) / adv);
+    }
+    lines_[i].x = lineX;
+    lines_[i].y = lineY;
+    lines_[i].strip.update(spans[i].first, len, scale);
+  }
+  bottom_ = lineY - lineSpace + GLYPH_H * scale;
+}
+
+void TextBlock::blit(uint8_t* image, int stride, int width, int firstRow, int lastRow) const {
+  for (const Line& line : lines_) {
+    // 每行文字只裁剪一次，多行向上展开越过顶边或越过底边的部分直接跳过
+    int first = std::max(0, firstRow - line.y);
+    int last = static_cast<int>(std::min<int64_t>(line.strip.height(), static_cast<int64_t>(lastRow) - line.y));
+    // 越过左边缘的列从条带中跳过，目标位置从第0列开始
+    const int skip = std::max(0, -line.x);
+    uint8_t* dst = image + static_cast<ptrdiff_t>(line.y) * stride + line.x + skip;
+    for (int row = first; row < last; row++) {
+      line.strip.blitRow(dst + static_cast<ptrdiff_t>(row) * stride, row, skip, width - line.x - skip);
+    }
+  }
+}
+
+void TextBlock::blitRow(uint8_t* row, int y, int width) const {
+  for (const Line& line : lines_) {
+    int stripRow = y - line.y;
+    if (stripRow >= 0 && stripRow < line.strip.height()) {
+      const int skip = std::max(0, -line.x);
+      line.strip.blitRow(row + line.x + skip, stripRow, skip, width - line.x - skip);
+    }
+  }
+}
+
+}  // namespace camera_toolkit
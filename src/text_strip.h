@@ -0,0 +1,177 @@
+/**
+ * @file text_strip.h
+ * @brief 预渲染文字条带
+ *
+ * Timestamp和Osd共用的文字渲染工具，仅供库内部源文件使用，不对外暴露。
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace camera_toolkit {
+
+constexpr int GLYPH_W = 7; /**< 字符宽度(像素) */
+constexpr int GLYPH_H = 8; /**< 字符高度(像素) */
+constexpr int ADVANCE = 6; /**< 字符间距(像素)，相邻字符重叠一列 */
+
+/**
+ * @brief 合成一行像素: dst = (dst & ~mask) | value
+ * @param dst 目标像素
+ * @param mask 覆盖掩码(0xFF为文字像素)
+ * @param value 预乘后的文字亮度
+ * @param n 像素数
+ *
+ * @note 按CPU特性选择AVX2/SSE2/NEON实现
+ */
+void blendRow(uint8_t* dst, const uint8_t* mask, const uint8_t* value, int n);
+
+/**
+ * @class TextStrip
+ * @brief 预渲染的单行文字条带
+ *
+ * 文字只在内容变化时渲染到mask/value两个平面，每帧只需按行合成到图像上。
+ * 相邻字符重叠一列，因此文本变化时只重绘变化字符所在的列区间及其左右邻居
+ */
+class TextStrip {
+ public:
+  /**
+   * @brief 更新条带文字
+   * @param text 文字
+   * @param len 文字长度
+   * @param scale 缩放倍数(>=1)
+   */
+  void update(const char* text, int len, int scale);
+
+  /**
+   * @brief 将条带的一行合成到图像行上
+   * @param dst 条带第skip列对应的图像位置
+   * @param row 条带内的行号
+   * @param skip 跳过的条带左侧列数(越过图像左边缘的部分)
+   * @param maxWidth 可写入的最大宽度(超出部分裁剪)
+   */
+  void blitRow(uint8_t* dst, int row, int skip, int maxWidth) const {
+    int w = std::min(width_ - skip, maxWidth);
+    if (w <= 0) return;
+    size_t off = static_cast<size_t>(row) * width_ + skip;
+    blendRow(dst, &mask_[off], &value_[off], w);
+  }
+
+  /**
+   * @brief 获取条带宽度
+   * @return 宽度(像素)
+   */
+  int width() const { return width_; }
+
+  /**
+   * @brief 获取条带高度
+   * @return 高度(像素)
+   */
+  int height() const { return height_; }
+
+  /**
+   * @brief 获取条带一行的覆盖掩码
+   * @param row 条带内的行号
+   * @return 掩码(0xFF为文字像素)
+   */
+  const uint8_t* maskRow(int row) const { return mask_.data() + static_cast<size_t>(row) * width_; }
+
+  /**
+   * @brief 获取条带一行的亮度
+   * @param row 条带内的行号
+   * @return 亮度(0xFF为白色填充，0为黑色描边或空白)
+   */
+  const uint8_t* valueRow(int row) const { return value_.data() + static_cast<size_t>(row) * width_; }
+
+ private:
+  /**
+   * @brief 清空并重绘[lo, hi)列区间
+   */
+  void render(int lo, int hi);
+
+  /**
+   * @brief 获取字符第y行的黑/白掩码
+   */
+  void glyphRow(int index, int y, const uint8_t** black, const uint8_t** white);
+
+  std::string text_;              /**< 当前文字 */
+  int scale_ = 0;                 /**< 缩放倍数 */
+  int width_ = 0;                 /**< 条带宽度 */
+  int height_ = 0;                /**< 条带高度 */
+  std::vector<uint8_t> mask_;     /**< 覆盖掩码平面 */
+  std::vector<uint8_t> value_;    /**< 预乘亮度平面 */
+  std::vector<uint8_t> rowBlack_; /**< 大倍数展开用的黑色行缓冲 */
+  std::vector<uint8_t> rowWhite_; /**< 大倍数展开用的白色行缓冲 */
+};
+
+/**
+ * @class TextBlock
+ * @brief 多行文字块
+ *
+ * 按锚点布局多行文字(字面"\n"换行)：锚点在右半边时右对齐，多行时向上展开，
+ * 超出右边缘的字符被截掉。文字不变时不做任何工作，变化时只重绘变化的字符
+ */
+class TextBlock {
+ public:
+  /**
+   * @brief 设置文字并更新布局
+   * @param text 文字(使用\\n作为换行符)
+   * @param x 锚点X坐标
+   * @param y 最后一行的Y坐标
+   * @param factor 文字大小，按(factor + 1)倍缩放
+   * @param width 图像宽度
+   */
+  void layout(const char* text, int x, int y, int factor, int width);
+
+  /**
+   * @brief 将文字块合成到图像上
+   * @param image 图像数据指针(Y平面)
+   * @param stride 行跨度
+   * @param width 图像宽度
+   * @param firstRow 允许写入的首行
+   * @param lastRow 允许写入的末行(不含)，超出[firstRow, lastRow)的行被裁剪
+   */
+  void blit(uint8_t* image, int stride, int width, int firstRow, int lastRow) const;
+
+  /**
+   * @brief 将文字块与指定图像行相交的部分合成到该行
+   * @param row 图像行起始位置
+   * @param y 图像行号
+   * @param width 图像宽度
+   */
+  void blitRow(uint8_t* row, int y, int width) const;
+
+  /**
+   * @brief 获取文字块覆盖的首行
+   * @return 行号
+   */
+  int top() const { return top_; }
+
+  /**
+   * @brief 获取文字块覆盖的末行(不含)
+   * @return 行号
+   */
+  int bottom() const { return bottom_; }
+
+ private:
+  /**
+   * @brief 一行文字的布局
+   */
+  struct Line {
+    int x = 0;       /**< 左上角X坐标 */
+    int y = 0;       /**< 左上角Y坐标 */
+    TextStrip strip; /**< 预渲染条带 */
+  };
+
+  std::string text_;        /**< 当前布局对应的文字 */
+  int x_ = 0;               /**< 当前布局的锚点X坐标 */
+  int y_ = 0;               /**< 当前布局的锚点Y坐标 */
+  int factor_ = -1;         /**< 当前布局的放大因子 */
+  std::vector<Line> lines_; /**< 各行布局 */
+  int top_ = 0;             /**< 覆盖的首行 */
+  int bottom_ = 0;          /**< 覆盖的末行(不含) */
+};
+
+}  // namespace camera_toolkit
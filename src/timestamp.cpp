@@ -4,538 +4,16 @@
  */
 #include "camera_toolkit/timestamp.h"
 
-#include <array>
-#include <cstring>
+#include <algorithm>
 #include <ctime>
-#include <iostream>
+#include <limits>
 
-namespace camera_toolkit {
-
-namespace {
-
-constexpr int ASCII_MAX = 127; /**< ASCII最大值 */
-
-/**
- * @brief 小字符绘制数据结构体
- */
-struct DrawChar {
-  unsigned char ascii;     /**< ASCII码 */
-  unsigned char pix[8][7]; /**< 像素数据(8行7列) */
-};
-
-/**
- * @brief 大字符绘制数据结构体
- */
-struct BigChar {
-  unsigned char ascii;       /**< ASCII码 */
-  unsigned char pix[16][14]; /**< 像素数据(16行14列) */
-};
-
-/**
- * @brief 字符绘制表(小字符)
- */
-static const DrawChar drawTable[] = {
-    {' ',
-     {{0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0}}},
-    {'0',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 2, 2, 1},
-      {1, 2, 1, 2, 1, 2, 1},
-      {1, 2, 1, 2, 1, 2, 1},
-      {1, 2, 2, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'1',
-     {{0, 0, 0, 1, 0, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'2',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 1, 2, 2, 1, 0},
-      {0, 1, 2, 1, 1, 0, 0},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 1, 1, 0}}},
-    {'3',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 1, 2, 2, 1, 0},
-      {0, 1, 0, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'4',
-     {{0, 0, 0, 0, 1, 0, 0},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 1, 2, 2, 1, 0},
-      {0, 1, 2, 1, 2, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 2, 1, 0},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 0, 0, 1, 0, 0}}},
-    {'5',
-     {{0, 1, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {0, 1, 1, 1, 1, 2, 0},
-      {0, 1, 1, 1, 1, 2, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {0, 1, 1, 1, 1, 0, 0}}},
-    {'6',
-     {{0, 0, 1, 1, 1, 1, 0},
-      {0, 1, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'7',
-     {{0, 1, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 1, 2, 1},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {0, 0, 1, 0, 0, 0, 0}}},
-    {'8',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'9',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {':',
-     {{0, 0, 1, 1, 0, 0, 0},
-      {0, 1, 2, 2, 1, 0, 0},
-      {0, 1, 2, 2, 1, 0, 0},
-      {0, 0, 1, 1, 0, 0, 0},
-      {0, 0, 1, 1, 0, 0, 0},
-      {0, 1, 2, 2, 1, 0, 0},
-      {0, 1, 2, 2, 1, 0, 0},
-      {0, 0, 1, 1, 0, 0, 0}}},
-    {'-',
-     {{0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0},
-      {0, 0, 0, 0, 0, 0, 0}}},
-    {'(',
-     {{0, 0, 0, 1, 0, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 0, 1, 0, 0, 0}}},
-    {')',
-     {{0, 0, 0, 1, 0, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 0, 1, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 0, 1, 0, 0, 0}}},
-    {'A',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'B',
-     {{0, 1, 1, 1, 1, 0, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 1, 0},
-      {0, 1, 1, 1, 1, 0, 0}}},
-    {'C',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 0, 0, 1, 0},
-      {1, 2, 1, 0, 0, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'D',
-     {{0, 1, 1, 1, 1, 0, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 1, 0},
-      {0, 1, 1, 1, 1, 0, 0}}},
-    {'E',
-     {{0, 1, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 0, 0},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 1, 1, 0}}},
-    {'F',
-     {{0, 1, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {0, 1, 0, 0, 0, 0, 0}}},
-    {'G',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 1, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'H',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'I',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'J',
-     {{0, 0, 1, 1, 1, 1, 0},
-      {0, 1, 2, 2, 2, 2, 1},
-      {0, 0, 1, 1, 1, 2, 1},
-      {0, 0, 0, 0, 1, 2, 1},
-      {0, 1, 0, 0, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'K',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 1, 2, 1, 0},
-      {1, 2, 1, 2, 1, 0, 0},
-      {1, 2, 2, 2, 1, 0, 0},
-      {1, 2, 1, 1, 2, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'L',
-     {{0, 1, 0, 0, 0, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {1, 2, 1, 1, 1, 0, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {0, 1, 1, 1, 1, 0, 0}}},
-    {'M',
-     {{0, 1, 1, 0, 1, 1, 0},
-      {1, 2, 2, 1, 2, 2, 1},
-      {1, 2, 1, 2, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'N',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 2, 1, 1, 2, 1},
-      {1, 2, 1, 2, 1, 2, 1},
-      {1, 2, 1, 1, 2, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'O',
-     {{0, 0, 1, 1, 1, 0, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 0, 0}}},
-    {'P',
-     {{0, 1, 1, 1, 1, 0, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {1, 2, 1, 0, 0, 0, 0},
-      {0, 1, 0, 0, 0, 0, 0}}},
-    {'R',
-     {{0, 1, 1, 1, 1, 0, 0},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 1, 0},
-      {1, 2, 1, 2, 1, 0, 0},
-      {1, 2, 1, 1, 2, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'S',
-     {{0, 0, 1, 1, 1, 1, 0},
-      {0, 1, 2, 2, 2, 2, 1},
-      {1, 2, 1, 1, 1, 1, 0},
-      {0, 1, 2, 2, 2, 1, 0},
-      {0, 0, 1, 1, 1, 2, 1},
-      {0, 1, 1, 1, 1, 2, 1},
-      {1, 2, 2, 2, 2, 1, 0},
-      {0, 1, 1, 1, 1, 0, 0}}},
-    {'T',
-     {{0, 1, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 2, 1, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 0, 1, 0, 0, 0}}},
-    {'U',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {0, 1, 2, 2, 2, 2, 1},
-      {0, 0, 1, 1, 1, 1, 0}}},
-    {'V',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 2, 1, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 0, 1, 0, 0, 0}}},
-    {'W',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 0, 1, 2, 1},
-      {1, 2, 1, 1, 1, 2, 1},
-      {1, 2, 1, 2, 1, 2, 1},
-      {1, 2, 1, 2, 1, 2, 1},
-      {0, 1, 2, 1, 2, 1, 0},
-      {0, 0, 1, 0, 1, 0, 0}}},
-    {'X',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 2, 1, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 1, 2, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 0, 0, 0, 1, 0}}},
-    {'Y',
-     {{0, 1, 0, 0, 0, 1, 0},
-      {1, 2, 1, 0, 1, 2, 1},
-      {0, 1, 2, 1, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 0, 0, 1, 0, 0, 0}}},
-    {'Z',
-     {{0, 1, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 2, 1, 0},
-      {0, 0, 1, 2, 1, 0, 0},
-      {0, 1, 2, 1, 0, 0, 0},
-      {1, 2, 1, 1, 1, 1, 0},
-      {1, 2, 2, 2, 2, 2, 1},
-      {0, 1, 1, 1, 1, 1, 0}}},
-};
-
-constexpr size_t DRAW_TABLE_SIZE = sizeof(drawTable) / sizeof(DrawChar); /**< 绘制表大小 */
-
-// 字符查找表
-static std::array<const unsigned char*, ASCII_MAX> smallCharArrPtr; /**< 小字符指针表 */
-static std::array<const unsigned char*, ASCII_MAX> bigCharArrPtr;   /**< 大字符指针表 */
-static std::array<BigChar, DRAW_TABLE_SIZE> bigTable;               /**< 大字符表 */
-static bool initialized = false;                                    /**< 初始化标志 */
-
-/**
- * @brief 初始化字符绘制表
- */
-void initializeChars() {
-  if (initialized) return;
-
-  // 构建大字符表
-  for (size_t i = 0; i < DRAW_TABLE_SIZE; i++) {
-    bigTable[i].ascii = drawTable[i].ascii;
-    for (int x = 0; x < 14; x++) {
-      for (int y = 0; y < 16; y++) {
-        bigTable[i].pix[y][x] = drawTable[i].pix[y / 2][x / 2];
-      }
-    }
-  }
-
-  // 初始化所有字符指针为空格
-  for (int i = 0; i < ASCII_MAX; i++) {
-    smallCharArrPtr[i] = &drawTable[0].pix[0][0];
-    bigCharArrPtr[i] = &bigTable[0].pix[0][0];
-  }
-
-  // 构建查找表
-  for (size_t i = 0; i < DRAW_TABLE_SIZE; i++) {
-    int ascii = static_cast<int>(drawTable[i].ascii);
-    smallCharArrPtr[ascii] = &drawTable[i].pix[0][0];
-    bigCharArrPtr[ascii] = &bigTable[i].pix[0][0];
-  }
-
-  initialized = true;
-}
-
-/**
- * @brief 绘制指定长度的文本
- * @param image 图像数据指针
- * @param startX 起始X坐标
- * @param startY 起始Y坐标
- * @param width 图像宽度
- * @param text 文本内容
- * @param len 文本长度
- * @param factor 放大因子(0=小, 1=大)
- * @return 成功返回0
- */
-int drawTextN(unsigned char* image, unsigned int startX, unsigned int startY, unsigned int width, const char* text,
-              int len, unsigned int factor) {
-  if (startX > width / 2) {
-    startX -= len * (6 * (factor + 1));
-  }
-
-  if (startX + len * 6 * (factor + 1) >= width) {
-    len = (width - startX - 1) / (6 * (factor + 1));
-  }
-
-  int lineOffset = width - 7 * (factor + 1);
-  int nextCharOffs = width * 8 * (factor + 1) - 6 * (factor + 1);
-
-  unsigned char* imagePtr = image + startX + startY * width;
-  const auto& charArrPtr = factor ? bigCharArrPtr : smallCharArrPtr;
-
-  for (int pos = 0; pos < len; pos++) {
-    int posCheck = static_cast<int>(static_cast<unsigned char>(text[pos]));
-    if (posCheck >= ASCII_MAX) posCheck = ' ';
-
-    const unsigned char* charPtr = charArrPtr[posCheck];
-
-    for (unsigned int y = 8 * (factor + 1); y > 0; y--) {
-      for (unsigned int x = 7 * (factor + 1); x > 0; x--) {
-        if (posCheck >= 0) {
-          switch (*charPtr) {
-            case 1:
-              *imagePtr = 0;
-              break;
-            case 2:
-              *imagePtr = 255;
-              break;
-            default:
-              break;
-          }
-        }
-        imagePtr++;
-        charPtr++;
-      }
-      imagePtr += lineOffset;
-    }
-    imagePtr -= nextCharOffs;
-  }
-
-  return 0;
-}
-
-/**
- * @brief 绘制完整文本(支持换行)
- * @param image 图像数据指针
- * @param startX 起始X坐标
- * @param startY 起始Y坐标
- * @param width 图像宽度
- * @param text 文本内容(使用\\n作为换行符)
- * @param factor 放大因子(0=小, 1=大)
- * @return 成功返回0
- */
-int drawTextFull(unsigned char* image, unsigned int startX, unsigned int startY, unsigned int width, const char* text,
-                 unsigned int factor) {
-  constexpr const char* NEWLINE = "\\n";
-  int numNl = 0;
-  const char* end = text;
-  const int lineSpace = (factor + 1) * 9;
+#include "camera_toolkit/trace.h"
+#include "clock_formatter.h"
+#include "log.h"
+#include "text_strip.h"
 
-  // 计算换行数
-  while ((end = strstr(end, NEWLINE))) {
-    numNl++;
-    end += 2;
-  }
-
-  startY -= lineSpace * numNl;
-
-  const char* begin = text;
-  end = text;
-
-  while ((end = strstr(end, NEWLINE))) {
-    int len = end - begin;
-    drawTextN(image, startX, startY, width, begin, len, factor);
-    end += 2;
-    begin = end;
-    startY += lineSpace;
-  }
-
-  drawTextN(image, startX, startY, width, begin, strlen(begin), factor);
-  return 0;
-}
-
-}  // anonymous namespace
+namespace camera_toolkit {
 
 /**
  * @brief Timestamp类的PIMPL实现
@@ -546,35 +24,73 @@ class Timestamp::Impl {
    * @brief 构造函数
    * @param params 时间戳参数
    */
-  explicit Impl(const TimestampParams& params) : params_(params) {
-    initializeChars();
-    std::cout << "+++ Timestamp opened" << std::endl;
+  explicit Impl(const TimestampParams& params) : params_(params), clock_(params.milliseconds) {
+    log::info("Timestamp opened");
   }
 
   /**
    * @brief 析构函数
    */
-  ~Impl() { std::cout << "+++ Timestamp closed" << std::endl; }
+  ~Impl() { log::info("Timestamp closed"); }
 
   /**
    * @brief 在图像上绘制时间戳
-   * @param image 图像数据指针(YUV的Y平面)
+   * @param frame 帧视图
    */
-  void draw(uint8_t* image) {
-    time_t captureTime = time(nullptr);
-    char timestamp[64];
-    struct tm* tmTimestamp = localtime(&captureTime);
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S (%Z)", tmTimestamp);
-    drawTextFull(image, params_.startX, params_.startY, params_.videoWidth, timestamp, params_.factor);
+  void draw(const FrameView& frame) {
+    struct timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    draw(frame, static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000);
+  }
+
+  /**
+   * @brief 在图像上绘制指定时刻的时间戳
+   * @param frame 帧视图
+   * @param timeUs 墙上时间(CLOCK_REALTIME微秒)
+   */
+  void draw(const FrameView& frame, int64_t timeUs) { draw(frame, timeUs, 0, frame.height); }
+
+  /**
+   * @brief 在图像的指定行范围内绘制指定时刻的时间戳
+   * @param frame 帧视图
+   * @param timeUs 墙上时间(CLOCK_REALTIME微秒)
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   */
+  void draw(const FrameView& frame, int64_t timeUs, int firstRow, int lastRow) {
+    CK_TRACE_SCOPE("timestamp.draw");
+    // 文本只在字段变化时重新布局，其余帧直接合成缓存的条带
+    if (clock_.format(timeUs) || !showingClock_) {
+      showingClock_ = true;
+      layout(clock_.text());
+    }
+    blit(frame, firstRow, lastRow);
   }
 
   /**
    * @brief 在图像上绘制自定义文字
-   * @param image 图像数据指针
+   * @param frame 帧视图
    * @param text 要绘制的文字
    */
-  void drawText(uint8_t* image, const char* text) {
-    drawTextFull(image, params_.startX, params_.startY, params_.videoWidth, text, params_.factor);
+  void drawText(const FrameView& frame, const char* text) {
+    if (text == nullptr) return;
+    showingClock_ = false;
+    layout(text);
+    blit(frame, 0, frame.height);
+  }
+
+  /**
+   * @brief 把裸指针包装为帧视图
+   * @param image 图像数据指针(Y平面，行跨度为videoWidth)
+   * @return 帧视图，高度未知时只裁剪顶边
+   */
+  FrameView wrap(uint8_t* image) const {
+    FrameView frame;
+    frame.planes[0] = image;
+    frame.strides[0] = params_.videoWidth;
+    frame.width = params_.videoWidth;
+    frame.height = std::numeric_limits<int>::max();
+    return frame;
   }
 
   /**
@@ -584,7 +100,29 @@ class Timestamp::Impl {
   const TimestampParams& getParams() const { return params_; }
 
  private:
-  TimestampParams params_; /**< 时间戳参数 */
+  /**
+   * @brief 按参数布局文字
+   * @param text 文字(使用\\n作为换行符)
+   */
+  void layout(const char* text) {
+    block_.layout(text, params_.startX, params_.startY, params_.factor, params_.videoWidth);
+  }
+
+  /**
+   * @brief 合成文字块到图像的Y平面上
+   * @param frame 帧视图
+   * @param firstRow 首行
+   * @param lastRow 末行(不含)
+   */
+  void blit(const FrameView& frame, int firstRow, int lastRow) const {
+    block_.blit(frame.planes[0], frame.strides[0], std::min(params_.videoWidth, frame.width), std::max(0, firstRow),
+                std::min(frame.height, lastRow));
+  }
+
+  TimestampParams params_;    /**< 时间戳参数 */
+  TextBlock block_;           /**< 文字块 */
+  ClockFormatter clock_;      /**< 时间戳格式化器 */
+  bool showingClock_ = false; /**< 当前布局是否为时间戳文本 */
 };
 
 // ============================================================================
@@ -595,9 +133,21 @@ Timestamp::Timestamp(const TimestampParams& params) : pImpl_(std::make_unique<Im
 
 Timestamp::~Timestamp() = default;
 
-void Timestamp::draw(uint8_t* image) { pImpl_->draw(image); }
+void Timestamp::draw(uint8_t* image) { pImpl_->draw(pImpl_->wrap(image)); }
+
+void Timestamp::draw(uint8_t* image, int64_t timeUs) { pImpl_->draw(pImpl_->wrap(image), timeUs); }
+
+void Timestamp::drawText(uint8_t* image, const char* text) { pImpl_->drawText(pImpl_->wrap(image), text); }
+
+void Timestamp::draw(const FrameView& frame) { pImpl_->draw(frame); }
+
+void Timestamp::draw(const FrameView& frame, int64_t timeUs) { pImpl_->draw(frame, timeUs); }
+
+void Timestamp::draw(const FrameView& frame, int64_t timeUs, int firstRow, int lastRow) {
+  pImpl_->draw(frame, timeUs, firstRow, lastRow);
+}
 
-void Timestamp::drawText(uint8_t* image, const char* text) { pImpl_->drawText(image, text); }
+void Timestamp::drawText(const FrameView& frame, const char* text) { pImpl_->drawText(frame, text); }
 
 const TimestampParams& Timestamp::getParams() const { return pImpl_->getParams(); }
 
@@ -0,0 +1,226 @@
+/**
+ * @file trace.cpp
+ * @brief 流水线时间线跟踪实现
+ */
+#include "camera_toolkit/trace.h"
+
+#include <pthread.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "camera_toolkit/common.h"
+
+namespace camera_toolkit {
+
+namespace detail {
+
+std::atomic<bool> tracingActive{false};
+
+int64_t traceNowNs() {
+  struct timespec now{};
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+}  // namespace detail
+
+namespace {
+
+/**
+ * @brief 完整事件(Chrome trace的"X"事件)
+ */
+struct Event {
+  const char* name = nullptr; /**< 事件名 */
+  int64_t startNs = 0;        /**< 开始时刻 */
+  int64_t endNs = 0;          /**< 结束时刻 */
+};
+
+/**
+ * @brief 线程事件缓冲区，只有所属线程写入，导出线程按已发布的计数读取
+ */
+struct ThreadBuffer {
+  explicit ThreadBuffer(size_t capacity) : events(capacity) {}
+
+  std::vector<Event> events;        /**< 预分配的事件数组 */
+  std::atomic<size_t> count{0};     /**< 已发布的事件数 */
+  std::atomic<uint64_t> dropped{0}; /**< 缓冲区满丢弃的事件数 */
+  int tid = 0;                      /**< 内核线程ID */
+  char name[16] = {};               /**< 线程名 */
+};
+
+/**
+ * @brief 跟踪会话，mutex只在线程首次记录事件、开始会话和导出时获取
+ */
+struct Session {
+  std::mutex mutex;                                   /**< 保护缓冲区列表和容量 */
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers; /**< 本次会话的所有线程缓冲区 */
+  std::atomic<uint64_t> generation{0};                /**< 会话序号，线程据此发现缓冲区已过期 */
+  size_t capacity = 65536;                            /**< 每线程事件容量 */
+  int64_t startNs = 0;                                /**< 会话开始时刻，作为时间线原点 */
+};
+
+/**
+ * @brief 获取全局会话(有意不析构，线程退出时仍可能访问)
+ * @return 会话引用
+ */
+Session& session() {
+  static Session* instance = new Session();
+  return *instance;
+}
+
+/**
+ * @brief 线程本地的缓冲区引用
+ */
+struct ThreadSlot {
+  uint64_t generation = 0;              /**< 缓冲区所属会话 */
+  std::shared_ptr<ThreadBuffer> buffer; /**< 缓冲区 */
+};
+
+thread_local ThreadSlot threadSlot;
+
+/**
+ * @brief 获取当前线程在本次会话中的缓冲区，首次调用时创建并登记
+ * @return 缓冲区指针
+ */
+ThreadBuffer* threadBuffer() {
+  Session& s = session();
+  if (threadSlot.buffer && threadSlot.generation == s.generation.load(std::memory_order_acquire)) {
+    return threadSlot.buffer.get();
+  }
+  std::lock_guard<std::mutex> lock(s.mutex);
+  auto buffer = std::make_shared<ThreadBuffer>(s.capacity);
+  buffer->tid = static_cast<int>(syscall(SYS_gettid));
+  pthread_getname_np(pthread_self(), buffer->name, sizeof(buffer->name));
+  s.buffers.push_back(buffer);
+  threadSlot.generation = s.generation.load(std::memory_order_relaxed);
+  threadSlot.buffer = std::move(buffer);
+  return threadSlot.buffer.get();
+}
+
+/**
+ * @brief 追加JSON字符串(带引号和转义)
+ * @param out 输出
+ * @param text 文本
+ */
+void appendJsonString(std::string& out, const char* text) {
+  out += '"';
+  for (const char* p = text; *p != '\0'; p++) {
+    const unsigned char c = static_cast<unsigned char>(*p);
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += static_cast<char>(c);
+    } else if (c < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += static_cast<char>(c);
+    }
+  }
+  out += '"';
+}
+
+}  // anonymous namespace
+
+namespace detail {
+
+void recordTraceEvent(const char* name, int64_t startNs, int64_t endNs) {
+  ThreadBuffer* buffer = threadBuffer();
+  const size_t index = buffer->count.load(std::memory_order_relaxed);
+  if (index >= buffer->events.size()) {
+    buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  buffer->events[index] = {name, startNs, endNs};
+  buffer->count.store(index + 1, std::memory_order_release);
+}
+
+}  // namespace detail
+
+// ============================================================================
+// 公共接口实现
+// ============================================================================
+
+void startTracing(size_t eventsPerThread) {
+  Session& s = session();
+  {
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.buffers.clear();
+    s.capacity = std::max<size_t>(eventsPerThread, 1);
+    s.startNs = detail::traceNowNs();
+    s.generation.fetch_add(1, std::memory_order_release);
+  }
+  detail::tracingActive.store(true, std::memory_order_release);
+}
+
+void stopTracing() { detail::tracingActive.store(false, std::memory_order_release); }
+
+TraceStats getTraceStats() {
+  Session& s = session();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  TraceStats stats;
+  for (const auto& buffer : s.buffers) {
+    stats.events += buffer->count.load(std::memory_order_acquire);
+    stats.dropped += buffer->dropped.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+std::string getTraceJson() {
+  Session& s = session();
+  std::lock_guard<std::mutex> lock(s.mutex);
+  const int pid = static_cast<int>(getpid());
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  char field[160];
+
+  for (const auto& buffer : s.buffers) {
+    // 线程名元数据事件
+    if (buffer->name[0] != '\0') {
+      out += first ? "\n" : ",\n";
+      first = false;
+      snprintf(field, sizeof(field), "{\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":",
+               pid, buffer->tid);
+      out += field;
+      appendJsonString(out, buffer->name);
+      out += "}}";
+    }
+
+    const size_t count = buffer->count.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+      const Event& event = buffer->events[i];
+      out += first ? "\n" : ",\n";
+      first = false;
+      out += "{\"ph\":\"X\",\"cat\":\"camera_toolkit\",\"name\":";
+      appendJsonString(out, event.name);
+      // 时间单位为微秒，保留纳秒精度
+      snprintf(field, sizeof(field), ",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", pid, buffer->tid,
+               static_cast<double>(event.startNs - s.startNs) / 1e3,
+               static_cast<double>(event.endNs - event.startNs) / 1e3);
+      out += field;
+    }
+  }
+  out += "\n]}\n";
+  return out;
+}
+
+void saveTrace(const std::string& path) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    throw CameraToolkitException("Failed to open trace file: " + path);
+  }
+  file << getTraceJson();
+  if (!file) {
+    throw CameraToolkitException("Failed to write trace file: " + path);
+  }
+}
+
+}  // namespace camera_toolkit
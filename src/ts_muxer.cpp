@@ -0,0 +1,350 @@
+/**
+ * @file ts_muxer.cpp
+ * @brief MPEG-TS封装类实现
+ */
+#include "camera_toolkit/ts_muxer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "camera_toolkit/trace.h"
+#include "h264_nal.h"
+#include "log.h"
+
+namespace camera_toolkit {
+
+namespace {
+
+constexpr int TS_PACKET_SIZE = 188;                   /**< TS包大小 */
+constexpr int TS_PAYLOAD_SIZE = 184;                  /**< 不含适配域时的负载大小 */
+constexpr uint8_t SYNC_BYTE = 0x47;                   /**< 同步字节 */
+constexpr uint8_t STREAM_TYPE_H264 = 0x1B;            /**< PMT中的H264流类型 */
+constexpr uint8_t STREAM_ID_VIDEO = 0xE0;             /**< PES视频流ID */
+constexpr uint64_t TIMESTAMP_MASK = (1ULL << 33) - 1; /**< PTS/DTS/PCR基为33位 */
+
+const uint8_t AUD[6] = {0x00, 0x00, 0x00, 0x01, 0x09, 0xF0}; /**< 访问单元分隔符(primary_pic_type=7) */
+
+/**
+ * @brief 计算MPEG-2 PSI使用的CRC32(多项式0x04C11DB7，不反转)
+ * @param data 数据
+ * @param size 数据大小
+ * @return CRC
+ */
+uint32_t crc32Mpeg(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= static_cast<uint32_t>(data[i]) << 24;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+/**
+ * @brief 微秒换算为90kHz时钟
+ * @param us 微秒
+ * @return 33位90kHz时间戳
+ */
+uint64_t toClock(int64_t us) { return static_cast<uint64_t>(us * 9 / 100) & TIMESTAMP_MASK; }
+
+/**
+ * @brief 写入PES头中的5字节PTS/DTS字段
+ * @param p 输出位置
+ * @param prefix 4位前缀(PTS为2或3，DTS为1)
+ * @param ts 33位时间戳
+ */
+void writeTimestamp(uint8_t* p, int prefix, uint64_t ts) {
+  p[0] = static_cast<uint8_t>(prefix << 4 | ((ts >> 29) & 0x0E) | 1);
+  p[1] = static_cast<uint8_t>(ts >> 22);
+  p[2] = static_cast<uint8_t>(((ts >> 14) & 0xFE) | 1);
+  p[3] = static_cast<uint8_t>(ts >> 7);
+  p[4] = static_cast<uint8_t>(((ts << 1) & 0xFE) | 1);
+}
+
+/**
+ * @brief 负载片段
+ */
+struct Span {
+  const uint8_t* data; /**< 数据 */
+  size_t size;         /**< 字节数 */
+};
+
+}  // anonymous namespace
+
+/**
+ * @brief TsMuxer类的PIMPL实现
+ */
+class TsMuxer::Impl {
+ public:
+  /**
+   * @brief 构造函数
+   * @param params 配置参数
+   * @param sink 输出回调
+   */
+  Impl(const TsMuxerParams& params, Sink sink) : params_(params), sink_(std::move(sink)) {
+    auto validPid = [](int pid) { return pid >= 0x10 && pid <= 0x1FFE; };
+    if (!validPid(params_.videoPid) || !validPid(params_.pmtPid) || params_.videoPid == params_.pmtPid ||
+        params_.programNumber <= 0 || params_.programNumber > 0xFFFF || params_.packetsPerDatagram <= 0 ||
+        params_.maxDatagrams <= 0 || !sink_) {
+      throw CameraToolkitException("Invalid TS muxer parameters");
+    }
+
+    datagramSize_ = static_cast<size_t>(params_.packetsPerDatagram) * TS_PACKET_SIZE;
+    capacity_ = static_cast<size_t>(params_.packetsPerDatagram) * params_.maxDatagrams;
+    out_.resize(capacity_ * TS_PACKET_SIZE);
+    datagrams_.resize(params_.maxDatagrams);
+    headers_.reserve(256);
+    buildTables();
+  }
+
+  /**
+   * @brief 封装一个访问单元
+   * @param frame 编码帧
+   */
+  void write(const EncodedFrame& frame) {
+    CK_TRACE_SCOPE("ts.write");
+    const uint8_t* data = static_cast<const uint8_t*>(frame.buffer.data);
+    const size_t size = frame.empty() ? 0 : static_cast<size_t>(frame.buffer.size);
+
+    bool idr = false;
+    if (!scanAccessUnit(data, size, &idr)) {
+      headers_.insert(headers_.end(), data, data + size);
+      return;
+    }
+
+    if (!started_ || idr || frame.dtsUs - lastTablesUs_ >= params_.tableIntervalMs * 1000LL) {
+      writeTables();
+      lastTablesUs_ = frame.dtsUs;
+    }
+    const bool pcr = !started_ || frame.dtsUs - lastPcrUs_ >= params_.pcrIntervalMs * 1000LL;
+    if (pcr) lastPcrUs_ = frame.dtsUs;
+    started_ = true;
+
+    // PES头：长度0(视频不限长)，data_alignment_indicator，有B帧时带DTS
+    const int64_t delayUs = params_.muxDelayMs * 1000LL;
+    const uint64_t pts = toClock(frame.ptsUs + delayUs);
+    const uint64_t dts = toClock(frame.dtsUs + delayUs);
+    const bool withDts = frame.dtsUs != frame.ptsUs;
+    uint8_t pes[19] = {0x00, 0x00, 0x01, STREAM_ID_VIDEO, 0x00, 0x00, 0x84};
+    pes[7] = withDts ? 0xC0 : 0x80;
+    pes[8] = withDts ? 10 : 5;
+    writeTimestamp(pes + 9, withDts ? 3 : 2, pts);
+    if (withDts) writeTimestamp(pes + 14, 1, dts);
+
+    // H264 in TS要求每个访问单元以AUD开始，暂存的头信息放在AUD之后
+    const size_t startCode = size > 3 && data[2] == 0x01 ? 3 : 4;
+    const bool hasAud = size > startCode && (data[startCode] & 0x1F) == nal::AUD;
+    spans_[0] = {pes, static_cast<size_t>(9 + pes[8])};
+    spans_[1] = {AUD, hasAud ? 0 : sizeof(AUD)};
+    spans_[2] = {headers_.data(), headers_.size()};
+    spans_[3] = {data, size};
+    span_ = 0;
+    spanOffset_ = 0;
+
+    writePes(pcr ? toClock(frame.dtsUs) : UINT64_MAX, idr);
+    headers_.clear();
+    stats_.frames++;
+    flush();
+  }
+
+  /**
+   * @brief 获取统计
+   * @return 统计信息
+   */
+  TsMuxerStats getStats() const { return stats_; }
+
+  /**
+   * @brief 获取配置参数
+   * @return 配置参数引用
+   */
+  const TsMuxerParams& getParams() const { return params_; }
+
+ private:
+  /**
+   * @brief 生成PAT和PMT包，之后只更新连续计数器
+   */
+  void buildTables() {
+    auto section = [](uint8_t* packet, int pid, const std::vector<uint8_t>& table) {
+      std::memset(packet, 0xFF, TS_PACKET_SIZE);
+      packet[0] = SYNC_BYTE;
+      packet[1] = static_cast<uint8_t>(0x40 | pid >> 8);  // payload_unit_start_indicator
+      packet[2] = static_cast<uint8_t>(pid);
+      packet[3] = 0x10;
+      packet[4] = 0x00;  // pointer_field
+      std::memcpy(packet + 5, table.data(), table.size());
+      const uint32_t crc = crc32Mpeg(table.data(), table.size());
+      uint8_t* p = packet + 5 + table.size();
+      p[0] = static_cast<uint8_t>(crc >> 24);
+      p[1] = static_cast<uint8_t>(crc >> 16);
+      p[2] = static_cast<uint8_t>(crc >> 8);
+      p[3] = static_cast<uint8_t>(crc);
+    };
+
+    const int tsid = params_.transportStreamId;
+    const int program = params_.programNumber;
+    const int pmt = params_.pmtPid;
+    const int video = params_.videoPid;
+    section(pat_, 0x0000,
+            {0x00, 0xB0, 0x0D, static_cast<uint8_t>(tsid >> 8), static_cast<uint8_t>(tsid), 0xC1, 0x00, 0x00,
+             static_cast<uint8_t>(program >> 8), static_cast<uint8_t>(program), static_cast<uint8_t>(0xE0 | pmt >> 8),
+             static_cast<uint8_t>(pmt)});
+    section(pmt_, pmt,
+            {0x02, 0xB0, 0x12, static_cast<uint8_t>(program >> 8), static_cast<uint8_t>(program), 0xC1, 0x00, 0x00,
+             static_cast<uint8_t>(0xE0 | video >> 8), static_cast<uint8_t>(video), 0xF0, 0x00, STREAM_TYPE_H264,
+             static_cast<uint8_t>(0xE0 | video >> 8), static_cast<uint8_t>(video), 0xF0, 0x00});
+  }
+
+  /**
+   * @brief 写入PAT和PMT
+   */
+  void writeTables() {
+    uint8_t* packet = nextPacket();
+    std::memcpy(packet, pat_, TS_PACKET_SIZE);
+    packet[3] = static_cast<uint8_t>(0x10 | (patCounter_++ & 0x0F));
+    packet = nextPacket();
+    std::memcpy(packet, pmt_, TS_PACKET_SIZE);
+    packet[3] = static_cast<uint8_t>(0x10 | (pmtCounter_++ & 0x0F));
+    stats_.tables++;
+  }
+
+  /**
+   * @brief 把spans_中的PES切分为TS包
+   * @param pcr 首包携带的PCR基(90kHz)，UINT64_MAX表示不带
+   * @param idr 是否为IDR帧(首包置random_access_indicator)
+   */
+  void writePes(uint64_t pcr, bool idr) {
+    size_t remaining = 0;
+    for (const Span& span : spans_) remaining += span.size;
+
+    bool first = true;
+    while (remaining > 0) {
+      uint8_t* packet = nextPacket();
+      const bool withPcr = first && pcr != UINT64_MAX;
+
+      // 适配域：首包的PCR和随机访问标志，末包不足184字节时用于填充
+      bool adaptation = first && (withPcr || idr);
+      size_t fields = adaptation ? 1 + (withPcr ? 6 : 0) : 0;
+      size_t room = TS_PAYLOAD_SIZE - (adaptation ? 1 + fields : 0);
+      if (remaining < room) {
+        if (!adaptation) {
+          adaptation = true;
+          room = TS_PAYLOAD_SIZE - 1;
+        }
+        if (remaining < room) {
+          fields += room - remaining;
+          room = remaining;
+        }
+      }
+
+      packet[0] = SYNC_BYTE;
+      packet[1] = static_cast<uint8_t>((first ? 0x40 : 0x00) | params_.videoPid >> 8);
+      packet[2] = static_cast<uint8_t>(params_.videoPid);
+      packet[3] = static_cast<uint8_t>((adaptation ? 0x30 : 0x10) | (videoCounter_++ & 0x0F));
+      uint8_t* p = packet + 4;
+      if (adaptation) {
+        *p++ = static_cast<uint8_t>(fields);
+        if (fields > 0) {
+          uint8_t* end = p + fields;
+          *p++ = static_cast<uint8_t>((first && idr ? 0x40 : 0x00) | (withPcr ? 0x10 : 0x00));
+          if (withPcr) {
+            p[0] = static_cast<uint8_t>(pcr >> 25);
+            p[1] = static_cast<uint8_t>(pcr >> 17);
+            p[2] = static_cast<uint8_t>(pcr >> 9);
+            p[3] = static_cast<uint8_t>(pcr >> 1);
+            p[4] = static_cast<uint8_t>((pcr & 1) << 7 | 0x7E);  // 6位保留 + 扩展为0
+            p[5] = 0x00;
+            p += 6;
+            stats_.pcrs++;
+          }
+          std::memset(p, 0xFF, static_cast<size_t>(end - p));
+          p = end;
+        }
+      }
+
+      copyPayload(p, room);
+      remaining -= room;
+      first = false;
+    }
+  }
+
+  /**
+   * @brief 从spans_依次复制负载
+   * @param dst 目标
+   * @param n 字节数
+   */
+  void copyPayload(uint8_t* dst, size_t n) {
+    while (n > 0) {
+      const Span& span = spans_[span_];
+      const size_t chunk = std::min(n, span.size - spanOffset_);
+      std::memcpy(dst, span.data + spanOffset_, chunk);
+      dst += chunk;
+      n -= chunk;
+      spanOffset_ += chunk;
+      if (spanOffset_ == span.size) {
+        span_++;
+        spanOffset_ = 0;
+      }
+    }
+  }
+
+  /**
+   * @brief 获取输出缓冲区中的下一个TS包位置，缓冲区满时先输出
+   * @return 包位置
+   */
+  uint8_t* nextPacket() {
+    if (count_ == capacity_) flush();
+    stats_.packets++;
+    return out_.data() + count_++ * TS_PACKET_SIZE;
+  }
+
+  /**
+   * @brief 把缓冲的包按数据报交给输出回调
+   */
+  void flush() {
+    if (count_ == 0) return;
+    const size_t bytes = count_ * TS_PACKET_SIZE;
+    int n = 0;
+    for (size_t offset = 0; offset < bytes; offset += datagramSize_) {
+      datagrams_[n++] = Buffer(out_.data() + offset, static_cast<int>(std::min(datagramSize_, bytes - offset)));
+    }
+    sink_(datagrams_.data(), n);
+    stats_.datagrams += n;
+    stats_.batches++;
+    count_ = 0;
+  }
+
+  TsMuxerParams params_;          /**< 配置参数 */
+  Sink sink_;                     /**< 输出回调 */
+  size_t datagramSize_ = 0;       /**< 数据报字节数 */
+  size_t capacity_ = 0;           /**< 输出缓冲区可容纳的TS包数 */
+  std::vector<uint8_t> out_;      /**< 输出缓冲区 */
+  std::vector<Buffer> datagrams_; /**< 交给回调的数据报列表 */
+  size_t count_ = 0;              /**< 缓冲中的TS包数 */
+  std::vector<uint8_t> headers_;  /**< 暂存的SPS/PPS */
+  uint8_t pat_[TS_PACKET_SIZE];   /**< PAT包模板 */
+  uint8_t pmt_[TS_PACKET_SIZE];   /**< PMT包模板 */
+  Span spans_[4] = {};            /**< 当前PES的负载片段：PES头、AUD、头信息、帧数据 */
+  size_t span_ = 0;               /**< 正在复制的片段 */
+  size_t spanOffset_ = 0;         /**< 片段内偏移 */
+  uint8_t patCounter_ = 0;        /**< PAT连续计数器 */
+  uint8_t pmtCounter_ = 0;        /**< PMT连续计数器 */
+  uint8_t videoCounter_ = 0;      /**< 视频连续计数器 */
+  bool started_ = false;          /**< 已输出第一帧 */
+  int64_t lastTablesUs_ = 0;      /**< 上次插入PAT/PMT的解码时间戳 */
+  int64_t lastPcrUs_ = 0;         /**< 上次插入PCR的解码时间戳 */
+  TsMuxerStats stats_;            /**< 统计 */
+};
+
+TsMuxer::TsMuxer(const TsMuxerParams& params, Sink sink) : pImpl_(std::make_unique<Impl>(params, std::move(sink))) {}
+
+TsMuxer::~TsMuxer() = default;
+
+void TsMuxer::write(const EncodedFrame& frame) { pImpl_->write(frame); }
+
+TsMuxerStats TsMuxer::getStats() const { return pImpl_->getStats(); }
+
+const TsMuxerParams& TsMuxer::getParams() const { return pImpl_->getParams(); }
+
+}  // namespace camera_toolkit
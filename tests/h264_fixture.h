@@ -0,0 +1,68 @@
+/**
+ * @file h264_fixture.h
+ * @brief 封装和录像测试共用的H.264访问单元生成函数
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace camera_toolkit {
+namespace testing {
+
+const std::vector<uint8_t> SPS = {0x67, 0x64, 0x00, 0x1F, 0xAC, 0xD9, 0x40}; /**< High profile 3.1 SPS */
+const std::vector<uint8_t> PPS = {0x68, 0xEB, 0xE3, 0xCB};                   /**< PPS */
+
+/**
+ * @brief 访问单元中除片以外的可选内容
+ */
+struct AccessUnitOptions {
+  int fill = -1;              /**< 片数据的填充字节(取低8位)，负数为按位置变化的非零图案 */
+  bool parameterSets = false; /**< IDR帧前带SPS、PPS */
+  bool aud = false;           /**< 以AUD开头 */
+};
+
+/**
+ * @brief 追加一个带4字节起始码的NAL单元
+ */
+inline void appendNal(std::vector<uint8_t>& au, const std::vector<uint8_t>& nal) {
+  au.insert(au.end(), {0, 0, 0, 1});
+  au.insert(au.end(), nal.begin(), nal.end());
+}
+
+/**
+ * @brief 生成Annex-B格式的SPS、PPS
+ */
+inline std::vector<uint8_t> parameterSets() {
+  std::vector<uint8_t> au;
+  appendNal(au, SPS);
+  appendNal(au, PPS);
+  return au;
+}
+
+/**
+ * @brief 生成一个Annex-B访问单元
+ * @param idr 是否为IDR帧
+ * @param sliceSize 片的字节数，含4字节起始码和NAL头
+ * @param options 填充方式和片之前的NAL单元
+ * @note 填充字节为0时会形成起始码，需要核对内容的测试应避开
+ */
+inline std::vector<uint8_t> accessUnit(bool idr, size_t sliceSize, const AccessUnitOptions& options = {}) {
+  std::vector<uint8_t> au;
+  if (options.aud) appendNal(au, {0x09, 0xF0});
+  if (idr && options.parameterSets) {
+    appendNal(au, SPS);
+    appendNal(au, PPS);
+  }
+  std::vector<uint8_t> slice(sliceSize > 4 ? sliceSize - 4 : 1);
+  for (size_t i = 0; i < slice.size(); i++) {
+    slice[i] = static_cast<uint8_t>(options.fill >= 0 ? options.fill : (i + 4) * 7 + 1);
+  }
+  slice[0] = idr ? 0x65 : 0x41;
+  appendNal(au, slice);
+  return au;
+}
+
+}  // namespace testing
+}  // namespace camera_toolkit
@@ -0,0 +1,167 @@
+/**
+ * @file network_emulator.h
+ * @brief 用于拥塞控制测试的本地网络仿真器
+ *
+ * 按时间回放链路轨迹(瓶颈带宽、传播延迟、丢包率)，对发送的包建模瓶颈排队，
+ * 并周期性生成逐包反馈和接收者报告
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "camera_toolkit/congestion_control.h"
+
+namespace camera_toolkit {
+namespace testing {
+
+/**
+ * @brief 链路轨迹中的一个时间点
+ */
+struct TracePoint {
+  int64_t timeMs = 0;    /**< 生效时刻 */
+  int capacityKbps = 0;  /**< 瓶颈带宽 */
+  int delayMs = 0;       /**< 单向传播延迟 */
+  double lossRate = 0.0; /**< 随机丢包率 */
+};
+
+/**
+ * @brief 解析文本轨迹，每行 "time_ms capacity_kbps delay_ms loss_rate"，#开头为注释
+ */
+inline std::vector<TracePoint> parseTrace(const std::string& text) {
+  std::vector<TracePoint> trace;
+  std::istringstream in(text);
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream fields(line);
+    TracePoint pt;
+    if (fields >> pt.timeMs >> pt.capacityKbps >> pt.delayMs >> pt.lossRate) {
+      trace.push_back(pt);
+    }
+  }
+  return trace;
+}
+
+/**
+ * @brief 网络仿真器
+ *
+ * 发送端以控制器目标码率按 10ms 节拍发送固定大小的包；包经过 FIFO 瓶颈队列后
+ * 加上传播延迟到达。每 50ms 生成一次逐包反馈，每 1s 生成一次接收者报告
+ */
+class NetworkEmulator {
+ public:
+  NetworkEmulator(std::vector<TracePoint> trace, CongestionController& cc, bool transportFeedback = true)
+      : trace_(std::move(trace)), cc_(cc), transportFeedback_(transportFeedback) {}
+
+  /**
+   * @brief 运行仿真到指定时刻
+   * @param untilMs 结束时刻(毫秒)
+   * @param onTick 每个 10ms 节拍回调(当前毫秒，目标码率)
+   */
+  template <typename F>
+  void run(int64_t untilMs, F&& onTick) {
+    for (; nowMs_ < untilMs; nowMs_ += TICK_MS) {
+      const TracePoint& link = linkAt(nowMs_);
+      sendTick(link);
+      if (transportFeedback_ && nowMs_ % FEEDBACK_MS == 0) deliverFeedback();
+      if (nowMs_ % REPORT_MS == 0 && nowMs_ > 0) deliverReport();
+      onTick(nowMs_, cc_.getTargetBitrate());
+    }
+  }
+
+  void run(int64_t untilMs) {
+    run(untilMs, [](int64_t, int) {});
+  }
+
+  /** @brief 最近一次到达包的排队延迟(毫秒) */
+  double lastQueueDelayMs() const { return lastQueueDelayMs_; }
+
+ private:
+  static constexpr int64_t TICK_MS = 10;
+  static constexpr int64_t FEEDBACK_MS = 50;
+  static constexpr int64_t REPORT_MS = 1000;
+  static constexpr int PACKET_SIZE = 1200;
+
+  struct SentPacket {
+    uint16_t seq;
+    int64_t sendUs;
+    int64_t arrivalUs;  // -1 表示丢失
+  };
+
+  const TracePoint& linkAt(int64_t ms) const {
+    size_t i = 0;
+    while (i + 1 < trace_.size() && trace_[i + 1].timeMs <= ms) i++;
+    return trace_[i];
+  }
+
+  // 确定性伪随机数(线性同余)，保证测试可复现
+  double random() {
+    rng_ = rng_ * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<double>(rng_ >> 11) / static_cast<double>(1ULL << 53);
+  }
+
+  void sendTick(const TracePoint& link) {
+    budgetBytes_ += cc_.getTargetBitrate() * 1000.0 / 8.0 * TICK_MS / 1000.0;
+    int64_t tickStartUs = nowMs_ * 1000;
+    int n = 0;
+    while (budgetBytes_ >= PACKET_SIZE) {
+      budgetBytes_ -= PACKET_SIZE;
+      int64_t sendUs = tickStartUs + n++ * 100;  // 节拍内均匀铺开
+      // 瓶颈 FIFO：服务完成时刻 = max(到达队列时刻, 上个包离开时刻) + 传输时间
+      int64_t serviceUs = static_cast<int64_t>(PACKET_SIZE) * 8 * 1000 / link.capacityKbps;
+      linkFreeUs_ = std::max(linkFreeUs_, sendUs) + serviceUs;
+      int64_t arrivalUs = linkFreeUs_ + link.delayMs * 1000;
+
+      bool lost = random() < link.lossRate;
+      sent_.push_back({seq_++, sendUs, lost ? -1 : arrivalUs});
+      intervalSent_++;
+      if (lost) intervalLost_++;
+    }
+  }
+
+  void deliverFeedback() {
+    int64_t nowUs = nowMs_ * 1000;
+    std::vector<PacketFeedback> feedback;
+    // 按序报告已到达(或已确认丢失)的包
+    while (!sent_.empty()) {
+      const SentPacket& p = sent_.front();
+      bool known = p.arrivalUs >= 0 ? p.arrivalUs <= nowUs : p.sendUs + 200000 <= nowUs;
+      if (!known) break;
+      feedback.push_back({p.seq, p.sendUs, p.arrivalUs, PACKET_SIZE});
+      if (p.arrivalUs >= 0) lastQueueDelayMs_ = (p.arrivalUs - p.sendUs) / 1000.0;
+      sent_.pop_front();
+    }
+    if (!feedback.empty()) cc_.onTransportFeedback(feedback, nowUs);
+  }
+
+  void deliverReport() {
+    ReceiverReport rr;
+    if (intervalSent_ > 0) {
+      rr.fractionLost = static_cast<uint8_t>(std::min(255, intervalLost_ * 256 / intervalSent_));
+    }
+    intervalSent_ = 0;
+    intervalLost_ = 0;
+    cc_.onReceiverReport(rr, nowMs_ * 1000);
+  }
+
+  std::vector<TracePoint> trace_;
+  CongestionController& cc_;
+  bool transportFeedback_;
+  std::deque<SentPacket> sent_;
+  int64_t nowMs_ = 0;
+  int64_t linkFreeUs_ = 0;
+  double budgetBytes_ = 0;
+  double lastQueueDelayMs_ = 0;
+  uint16_t seq_ = 0;
+  int intervalSent_ = 0;
+  int intervalLost_ = 0;
+  uint64_t rng_ = 42;
+};
+
+}  // namespace testing
+}  // namespace camera_toolkit
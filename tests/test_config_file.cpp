@@ -0,0 +1,105 @@
+/**
+ * @file test_config_file.cpp
+ * @brief ConfigFile 单元测试
+ */
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "camera_toolkit/config_file.h"
+
+namespace {
+
+// 解析失败时返回错误消息
+std::string parseError(const std::string& text) {
+  try {
+    camera_toolkit::ConfigFile::parse(text, "cams.ini");
+  } catch (const camera_toolkit::CameraToolkitException& e) {
+    return e.what();
+  }
+  return std::string();
+}
+
+}  // namespace
+
+// ============================================================================
+// 解析测试
+// ============================================================================
+
+TEST(ConfigFileTest, ParsesSectionsAndEntries) {
+  const auto config = camera_toolkit::ConfigFile::parse(
+      "# cameras\n"
+      "[global]\n"
+      "metrics = 0.0.0.0:9100\n"
+      "\n"
+      "[stream front]\r\n"
+      "  device=/dev/video0  \r\n"
+      "mask = 0,0,64,64\n"
+      "; second mask\n"
+      "mask = 100,100,32,32\n"
+      "osd = \"  {camera} #1 \"\n"
+      "[stream back]\n"
+      "direct_io =\n");
+
+  const auto& sections = config.getSections();
+  ASSERT_EQ(sections.size(), 3u);
+  EXPECT_EQ(sections[0].type, "global");
+  EXPECT_EQ(sections[0].name, "");
+  ASSERT_NE(sections[0].find("metrics"), nullptr);
+  EXPECT_EQ(sections[0].find("metrics")->value, "0.0.0.0:9100");
+
+  const auto streams = config.getSections("stream");
+  ASSERT_EQ(streams.size(), 2u);
+  EXPECT_EQ(streams[0]->name, "front");
+  EXPECT_EQ(streams[0]->line, 5);
+  ASSERT_EQ(streams[0]->entries.size(), 4u);
+  EXPECT_EQ(streams[0]->entries[0].key, "device");
+  EXPECT_EQ(streams[0]->entries[0].value, "/dev/video0");
+  EXPECT_EQ(streams[0]->entries[0].line, 6);
+  // 重复的键按顺序保留，find返回最后一个
+  EXPECT_EQ(streams[0]->entries[1].value, "0,0,64,64");
+  EXPECT_EQ(streams[0]->find("mask")->value, "100,100,32,32");
+  EXPECT_EQ(streams[0]->find("osd")->value, "  {camera} #1 ");
+  EXPECT_EQ(streams[0]->find("gop"), nullptr);
+  EXPECT_EQ(streams[1]->name, "back");
+  EXPECT_EQ(streams[1]->find("direct_io")->value, "");
+  EXPECT_TRUE(config.getSections("unknown").empty());
+}
+
+TEST(ConfigFileTest, ErrorsCarryLocation) {
+  EXPECT_EQ(parseError("device = /dev/video0\n"), "cams.ini:1: entry outside of a section: device");
+  EXPECT_EQ(parseError("[stream a]\n\nwidth 640\n"), "cams.ini:3: expected key = value: width 640");
+  EXPECT_EQ(parseError("[stream a\n"), "cams.ini:1: unterminated section header");
+  EXPECT_EQ(parseError("[]\n"), "cams.ini:1: invalid section header: []");
+  EXPECT_EQ(parseError("[stream a b]\n"), "cams.ini:1: invalid section header: [stream a b]");
+  EXPECT_EQ(parseError("[stream a]\n= 1\n"), "cams.ini:2: invalid key: ");
+  EXPECT_EQ(parseError("[stream a]\nosd = \"{time}\n"), "cams.ini:2: unterminated quoted value");
+  EXPECT_EQ(parseError("[stream a]\n[stream b]\n[stream a]\n"),
+            "cams.ini:3: duplicate section [stream a], first defined at line 1");
+  EXPECT_EQ(camera_toolkit::ConfigFile::parse("").describe(7, "bad value"), "<config>:7: bad value");
+}
+
+// ============================================================================
+// 文件测试
+// ============================================================================
+
+TEST(ConfigFileTest, LoadsFromFile) {
+  char pathTemplate[] = "/tmp/ck_cfgXXXXXX";
+  int fd = mkstemp(pathTemplate);
+  close(fd);
+  {
+    std::ofstream file(pathTemplate);
+    file << "[stream lobby]\nwidth = 1280\n";
+  }
+  const auto config = camera_toolkit::ConfigFile::load(pathTemplate);
+  unlink(pathTemplate);
+  EXPECT_EQ(config.getOrigin(), pathTemplate);
+  ASSERT_EQ(config.getSections("stream").size(), 1u);
+  EXPECT_EQ(config.getSections("stream")[0]->find("width")->value, "1280");
+
+  EXPECT_THROW(camera_toolkit::ConfigFile::load("/tmp/ck_cfg_does_not_exist.ini"),
+               camera_toolkit::CameraToolkitException);
+}
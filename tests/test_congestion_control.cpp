@@ -0,0 +1,166 @@
+/**
+ * @file test_congestion_control.cpp
+ * @brief CongestionController 单元测试(基于网络仿真器回放链路轨迹)
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "camera_toolkit/congestion_control.h"
+#include "network_emulator.h"
+
+namespace {
+
+using camera_toolkit::testing::NetworkEmulator;
+using camera_toolkit::testing::parseTrace;
+
+camera_toolkit::CongestionControlParams makeParams(int start) {
+  camera_toolkit::CongestionControlParams params;
+  params.startBitrate = start;
+  params.minBitrate = 100;
+  params.maxBitrate = 10000;
+  return params;
+}
+
+}  // namespace
+
+// ============================================================================
+// 参数与边界测试
+// ============================================================================
+
+TEST(CongestionControlTest, StartBitrateIsClamped) {
+  camera_toolkit::CongestionControlParams params;
+  params.startBitrate = 50000;
+  params.maxBitrate = 4000;
+  camera_toolkit::CongestionController cc(params);
+
+  EXPECT_EQ(cc.getTargetBitrate(), 4000);
+}
+
+TEST(CongestionControlTest, TargetNeverBelowMinimum) {
+  camera_toolkit::CongestionControlParams params;
+  params.startBitrate = 300;
+  params.minBitrate = 200;
+  camera_toolkit::CongestionController cc(params);
+
+  camera_toolkit::ReceiverReport rr;
+  rr.fractionLost = 255;
+  for (int i = 0; i < 50; ++i) {
+    cc.onReceiverReport(rr, i * 1000000LL);
+  }
+  EXPECT_EQ(cc.getTargetBitrate(), 200);
+}
+
+// ============================================================================
+// RTCP 解析测试
+// ============================================================================
+
+TEST(CongestionControlTest, ParseReceiverReport) {
+  // RR: V=2, RC=1, PT=201, length=7 (32位字数-1)
+  std::vector<uint8_t> pkt = {0x81, 201, 0x00, 0x07,  // 头
+                              0x00, 0x00, 0x00, 0x01,  // 发送者 SSRC
+                              0x00, 0x00, 0x04, 0xD2,  // 源 SSRC = 1234
+                              64,   0x00, 0x00, 0x0A,  // 丢包率 64/256，累计丢包 10
+                              0x00, 0x01, 0x00, 0x20,  // 扩展最高序列号
+                              0x00, 0x00, 0x00, 0x30,  // 抖动
+                              0x00, 0x00, 0x00, 0x00,  // LSR
+                              0x00, 0x00, 0x00, 0x00}; // DLSR
+
+  camera_toolkit::ReceiverReport rr;
+  ASSERT_TRUE(camera_toolkit::CongestionController::parseReceiverReport(pkt.data(), pkt.size(), 1234, &rr));
+  EXPECT_EQ(rr.ssrc, 1234u);
+  EXPECT_EQ(rr.fractionLost, 64);
+  EXPECT_EQ(rr.cumulativeLost, 10);
+  EXPECT_EQ(rr.highestSequence, 0x00010020u);
+  EXPECT_EQ(rr.jitter, 0x30u);
+}
+
+TEST(CongestionControlTest, ParseRejectsNonReport) {
+  // SDES 包(PT=202)不含报告块
+  std::vector<uint8_t> pkt = {0x81, 202, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01};
+  camera_toolkit::ReceiverReport rr;
+  EXPECT_FALSE(camera_toolkit::CongestionController::parseReceiverReport(pkt.data(), pkt.size(), 1, &rr));
+}
+
+TEST(CongestionControlTest, ParseIgnoresForeignSsrc) {
+  // RR: RC=2，第一个块报告其他流(SSRC=999，丢包率100%)，第二个块报告本端流
+  std::vector<uint8_t> pkt = {0x82, 201, 0x00, 0x0D,  // 头
+                              0x00, 0x00, 0x00, 0x01,  // 发送者 SSRC
+                              0x00, 0x00, 0x03, 0xE7,  // 源 SSRC = 999
+                              255,  0x00, 0x01, 0x00,  // 丢包率 255/256，累计丢包 256
+                              0x00, 0x00, 0x00, 0x00,  // 扩展最高序列号
+                              0x00, 0x00, 0x00, 0x00,  // 抖动
+                              0x00, 0x00, 0x00, 0x00,  // LSR
+                              0x00, 0x00, 0x00, 0x00,  // DLSR
+                              0x00, 0x00, 0x04, 0xD2,  // 源 SSRC = 1234
+                              8,    0x00, 0x00, 0x02,  // 丢包率 8/256，累计丢包 2
+                              0x00, 0x00, 0x00, 0x40,  // 扩展最高序列号
+                              0x00, 0x00, 0x00, 0x00,  // 抖动
+                              0x00, 0x00, 0x00, 0x00,  // LSR
+                              0x00, 0x00, 0x00, 0x00}; // DLSR
+
+  camera_toolkit::ReceiverReport rr;
+  ASSERT_TRUE(camera_toolkit::CongestionController::parseReceiverReport(pkt.data(), pkt.size(), 1234, &rr));
+  EXPECT_EQ(rr.ssrc, 1234u);
+  EXPECT_EQ(rr.fractionLost, 8);
+  EXPECT_EQ(rr.cumulativeLost, 2);
+  EXPECT_EQ(rr.highestSequence, 0x40u);
+
+  // 只含其他流的报告块时不应返回结果
+  std::vector<uint8_t> foreign(pkt.begin(), pkt.begin() + 32);
+  foreign[0] = 0x81;
+  foreign[3] = 0x07;
+  EXPECT_FALSE(camera_toolkit::CongestionController::parseReceiverReport(foreign.data(), foreign.size(), 1234, &rr));
+}
+
+// ============================================================================
+// 仿真回放测试
+// ============================================================================
+
+TEST(CongestionControlTest, RampsUpTowardsCapacity) {
+  camera_toolkit::CongestionController cc(makeParams(500));
+  NetworkEmulator emu(parseTrace("0 2000 20 0.0\n"), cc);
+
+  emu.run(30000);
+
+  // 应逼近但不长期超过瓶颈带宽
+  EXPECT_GT(cc.getTargetBitrate(), 1200);
+  EXPECT_LT(cc.getTargetBitrate(), 2400);
+}
+
+TEST(CongestionControlTest, BacksOffWhenCapacityDrops) {
+  camera_toolkit::CongestionController cc(makeParams(1500));
+  NetworkEmulator emu(parseTrace("# time capacity delay loss\n"
+                                 "0     3000 20 0.0\n"
+                                 "10000  800 20 0.0\n"),
+                      cc);
+
+  emu.run(10000);
+  int before = cc.getTargetBitrate();
+  emu.run(14000);
+
+  EXPECT_GT(before, 1000);
+  EXPECT_LT(cc.getTargetBitrate(), 900);
+  // 码率降低后队列应排空，排队延迟不会持续增长
+  emu.run(20000);
+  EXPECT_LT(emu.lastQueueDelayMs(), 200.0);
+}
+
+TEST(CongestionControlTest, HeavyLossReducesRateWithoutTransportFeedback) {
+  camera_toolkit::CongestionController cc(makeParams(2000));
+  NetworkEmulator emu(parseTrace("0 10000 20 0.25\n"), cc, /*transportFeedback=*/false);
+
+  emu.run(10000);
+
+  EXPECT_LT(cc.getTargetBitrate(), 1000);
+}
+
+TEST(CongestionControlTest, LowLossAllowsGrowthFromReportsOnly) {
+  camera_toolkit::CongestionController cc(makeParams(1000));
+  NetworkEmulator emu(parseTrace("0 10000 20 0.01\n"), cc, /*transportFeedback=*/false);
+
+  emu.run(10000);
+
+  EXPECT_GT(cc.getTargetBitrate(), 1500);
+}
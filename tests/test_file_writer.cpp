@@ -0,0 +1,250 @@
+/**
+ * @file test_file_writer.cpp
+ * @brief AsyncFileWriter 单元测试
+ */
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "camera_toolkit/file_writer.h"
+
+namespace {
+
+// 在临时目录下分配文件路径，测试结束时删除
+class TempFile {
+ public:
+  TempFile() {
+    char pathTemplate[] = "/tmp/ck_fwXXXXXX";
+    int fd = mkstemp(pathTemplate);
+    close(fd);
+    path_ = pathTemplate;
+  }
+
+  ~TempFile() { unlink(path_.c_str()); }
+
+  const std::string& path() const { return path_; }
+
+  std::vector<uint8_t> read() const {
+    std::ifstream file(path_, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+ private:
+  std::string path_;
+};
+
+// 确定性的测试数据
+std::vector<uint8_t> pattern(size_t size, uint32_t seed) {
+  std::vector<uint8_t> data(size);
+  for (auto& byte : data) {
+    seed = seed * 1103515245u + 12345u;
+    byte = static_cast<uint8_t>(seed >> 16);
+  }
+  return data;
+}
+
+}  // namespace
+
+// ============================================================================
+// 写入测试
+// ============================================================================
+
+TEST(AsyncFileWriterTest, SmallWritesAreBatched) {
+  TempFile file;
+  std::vector<uint8_t> expected;
+  camera_toolkit::FileWriterStats stats;
+  {
+    camera_toolkit::FileWriterParams params;
+    params.path = file.path();
+    params.bufferSize = 64 * 1024;
+    camera_toolkit::AsyncFileWriter writer(params);
+
+    // 大小不一的类RTP包
+    for (int i = 0; i < 5000; ++i) {
+      std::vector<uint8_t> packet = pattern(100 + (i * 37) % 1300, i);
+      ASSERT_TRUE(writer.write(packet.data(), packet.size()));
+      expected.insert(expected.end(), packet.begin(), packet.end());
+    }
+    writer.flush();
+    stats = writer.getStats();
+  }
+
+  EXPECT_EQ(file.read(), expected);
+  EXPECT_EQ(stats.bytesWritten, expected.size());
+  EXPECT_LE(stats.writes, expected.size() / (64 * 1024) + 2);
+  EXPECT_GE(stats.maxQueuedBuffers, 1);
+  EXPECT_EQ(stats.queuedBuffers, 0);
+  EXPECT_EQ(stats.queuedBytes, 0u);
+  EXPECT_EQ(stats.errors, 0u);
+}
+
+TEST(AsyncFileWriterTest, LargeWriteSpansBuffers) {
+  TempFile file;
+  std::vector<uint8_t> frame = pattern(1920 * 1080 * 2 + 123, 7);
+  {
+    camera_toolkit::FileWriterParams params;
+    params.path = file.path();
+    params.bufferSize = 4096;
+    camera_toolkit::AsyncFileWriter writer(params);
+    for (int i = 0; i < 3; ++i) ASSERT_TRUE(writer.write(frame.data(), frame.size()));
+  }
+
+  std::vector<uint8_t> data = file.read();
+  ASSERT_EQ(data.size(), frame.size() * 3);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE(std::equal(frame.begin(), frame.end(), data.begin() + i * frame.size())) << i;
+  }
+}
+
+TEST(AsyncFileWriterTest, DirectIOFlushKeepsUnalignedTail) {
+  TempFile file;
+  std::vector<uint8_t> first = pattern(5000, 1);
+  std::vector<uint8_t> second = pattern(3000, 2);
+  std::vector<uint8_t> expected = first;
+  expected.insert(expected.end(), second.begin(), second.end());
+
+  camera_toolkit::FileWriterParams params;
+  params.path = file.path();
+  params.bufferSize = 8192;
+  params.directIO = true;
+  camera_toolkit::AsyncFileWriter writer(params);
+
+  // 不支持O_DIRECT的文件系统(如tmpfs)退回普通写入，结果应相同
+  writer.write(first.data(), first.size());
+  writer.flush();
+  EXPECT_EQ(file.read(), first);
+
+  writer.write(second.data(), second.size());
+  writer.flush();
+  EXPECT_EQ(file.read(), expected);
+}
+
+TEST(AsyncFileWriterTest, PreallocatedSpaceIsTrimmed) {
+  TempFile file;
+  {
+    camera_toolkit::FileWriterParams params;
+    params.path = file.path();
+    params.preallocate = 8 << 20;
+    camera_toolkit::AsyncFileWriter writer(params);
+    std::vector<uint8_t> data = pattern(1000, 3);
+    writer.write(data.data(), data.size());
+  }
+  struct stat st{};
+  ASSERT_EQ(stat(file.path().c_str(), &st), 0);
+  EXPECT_EQ(st.st_size, 1000);
+  EXPECT_LT(st.st_blocks * 512, 8 << 20);
+}
+
+TEST(AsyncFileWriterTest, DirectIOFlushKeepsPreallocation) {
+  TempFile file;
+  camera_toolkit::FileWriterParams params;
+  params.path = file.path();
+  params.directIO = true;
+  params.preallocate = 8 << 20;
+  camera_toolkit::AsyncFileWriter writer(params);
+  if (!writer.getStats().directIO) GTEST_SKIP() << "O_DIRECT not supported";
+
+  // 补零写出的尾部被截掉后，文件末尾之后的预分配空间仍应保留
+  std::vector<uint8_t> data = pattern(5000, 4);
+  writer.write(data.data(), data.size());
+  writer.flush();
+  struct stat st{};
+  ASSERT_EQ(stat(file.path().c_str(), &st), 0);
+  EXPECT_EQ(st.st_size, 5000);
+  EXPECT_GE(st.st_blocks * 512, 8 << 20);
+}
+
+TEST(AsyncFileWriterTest, ReopenSwitchesFilesInOrder) {
+  TempFile first, second, third;
+  std::vector<uint8_t> a = pattern(5000, 6);
+  std::vector<uint8_t> b = pattern(10000, 7);
+  std::vector<uint8_t> c = pattern(3000, 8);
+
+  camera_toolkit::FileWriterParams params;
+  params.path = first.path();
+  params.bufferSize = 8192;
+  params.directIO = true;
+  params.preallocate = 1 << 20;
+  camera_toolkit::AsyncFileWriter writer(params);
+
+  // 不等待写盘即切换：各文件只含切换前后各自追加的数据，O_DIRECT补零和预分配都不留在文件中
+  writer.write(a.data(), a.size());
+  writer.reopen(second.path());
+  writer.write(b.data(), b.size());
+  writer.reopen(third.path());
+  writer.write(c.data(), c.size());
+  writer.flush();
+  EXPECT_EQ(first.read(), a);
+  EXPECT_EQ(second.read(), b);
+  EXPECT_EQ(third.read(), c);
+
+  struct stat st{};
+  ASSERT_EQ(stat(first.path().c_str(), &st), 0);
+  EXPECT_LT(st.st_blocks * 512, 1 << 20);
+  EXPECT_EQ(writer.getStats().bytesWritten, a.size() + b.size() + c.size());
+}
+
+// ============================================================================
+// 异常情况测试
+// ============================================================================
+
+TEST(AsyncFileWriterTest, DropsWholeWriteWhenBuffersAreShort) {
+  TempFile file;
+  camera_toolkit::FileWriterParams params;
+  params.path = file.path();
+  params.bufferSize = 4096;
+  params.dropWhenFull = true;
+  camera_toolkit::AsyncFileWriter writer(params);
+
+  // 两个缓冲区最多容纳8192字节，超出的写入整块丢弃
+  std::vector<uint8_t> data = pattern(3 * 4096, 4);
+  EXPECT_FALSE(writer.write(data.data(), data.size()));
+  EXPECT_TRUE(writer.write(data.data(), 4096));
+  writer.flush();
+  EXPECT_EQ(writer.getStats().dropped, 1u);
+  EXPECT_EQ(file.read(), std::vector<uint8_t>(data.begin(), data.begin() + 4096));
+}
+
+TEST(AsyncFileWriterTest, WriteErrorsAreCounted) {
+  camera_toolkit::FileWriterParams params;
+  params.path = "/dev/full";
+  params.bufferSize = 4096;
+  camera_toolkit::AsyncFileWriter writer(params);
+  std::vector<uint8_t> data = pattern(10000, 5);
+  writer.write(data.data(), data.size());
+  writer.flush();
+  auto stats = writer.getStats();
+  EXPECT_EQ(stats.errors, 3u);
+  EXPECT_EQ(stats.bytesWritten, 0u);
+}
+
+TEST(AsyncFileWriterTest, ReopenFailureDropsDataUntilNextReopen) {
+  TempFile first, last;
+  camera_toolkit::FileWriterParams params;
+  params.path = first.path();
+  camera_toolkit::AsyncFileWriter writer(params);
+
+  std::vector<uint8_t> data = pattern(1000, 9);
+  writer.reopen("/nonexistent-dir/out.bin");
+  writer.write(data.data(), data.size());
+  writer.reopen(last.path());
+  writer.write(data.data(), data.size());
+  writer.flush();
+  EXPECT_EQ(writer.getStats().errors, 1u);
+  EXPECT_EQ(first.read(), std::vector<uint8_t>());
+  EXPECT_EQ(last.read(), data);
+}
+
+TEST(AsyncFileWriterTest, OpenFailureThrows) {
+  camera_toolkit::FileWriterParams params;
+  params.path = "/nonexistent-dir/out.bin";
+  EXPECT_THROW(camera_toolkit::AsyncFileWriter writer(params), camera_toolkit::CameraToolkitException);
+}
@@ -0,0 +1,134 @@
+/**
+ * @file test_latency.cpp
+ * @brief LatencyHistogram / LatencyTracer 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "camera_toolkit/latency.h"
+
+// ============================================================================
+// 直方图测试
+// ============================================================================
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  camera_toolkit::LatencyHistogram h;
+  EXPECT_EQ(h.getCount(), 0u);
+  EXPECT_EQ(h.getMin(), 0);
+  EXPECT_EQ(h.getMax(), 0);
+  EXPECT_EQ(h.getMean(), 0);
+  EXPECT_EQ(h.getPercentile(99), 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  camera_toolkit::LatencyHistogram h;
+  for (int v = 0; v < 100; ++v) h.record(v);
+  EXPECT_EQ(h.getCount(), 100u);
+  EXPECT_EQ(h.getMin(), 0);
+  EXPECT_EQ(h.getMax(), 99);
+  EXPECT_DOUBLE_EQ(h.getMean(), 49.5);
+  EXPECT_EQ(h.getPercentile(50), 49);
+  EXPECT_EQ(h.getPercentile(100), 99);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinRelativeError) {
+  // 1us 到 100ms 的确定性伪随机值，与排序后的精确百分位比较
+  camera_toolkit::LatencyHistogram h;
+  std::vector<int64_t> values;
+  uint32_t seed = 1;
+  for (int i = 0; i < 10000; ++i) {
+    seed = seed * 1103515245u + 12345u;
+    int64_t v = 1000 + static_cast<int64_t>(seed % 100000) * (seed % 1000 + 1);
+    values.push_back(v);
+    h.record(v);
+  }
+  std::sort(values.begin(), values.end());
+  for (double p : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+    int64_t exact = values[static_cast<size_t>(std::ceil(p / 100.0 * values.size() - 1e-9)) - 1];
+    int64_t approx = h.getPercentile(p);
+    EXPECT_GE(approx, exact) << p;
+    EXPECT_LE(approx, exact + exact / 64 + 1) << p;
+  }
+  EXPECT_EQ(h.getPercentile(100), values.back());
+}
+
+TEST(LatencyHistogramTest, OutOfRangeValuesAreClamped) {
+  camera_toolkit::LatencyHistogram h;
+  h.record(-5);
+  h.record(INT64_MAX);
+  EXPECT_EQ(h.getCount(), 2u);
+  EXPECT_EQ(h.getMin(), 0);
+  EXPECT_GT(h.getMax(), int64_t{1} << 39);
+}
+
+TEST(LatencyHistogramTest, MergeMatchesCombinedRecording) {
+  camera_toolkit::LatencyHistogram a, b, all;
+  for (int i = 0; i < 500; ++i) {
+    int64_t v = i * 7919 % 200000;
+    (i % 2 ? a : b).record(v);
+    all.record(v);
+  }
+  a.merge(b);
+  EXPECT_EQ(a.getCount(), all.getCount());
+  EXPECT_EQ(a.getMin(), all.getMin());
+  EXPECT_EQ(a.getMax(), all.getMax());
+  for (double p : {10.0, 50.0, 99.0}) EXPECT_EQ(a.getPercentile(p), all.getPercentile(p));
+
+  a.reset();
+  EXPECT_EQ(a.getCount(), 0u);
+  EXPECT_EQ(a.getPercentile(50), 0);
+}
+
+// ============================================================================
+// 跟踪汇总测试
+// ============================================================================
+
+TEST(LatencyTracerTest, StagesMeasureFromPreviousMarkedStage) {
+  camera_toolkit::LatencyTracer tracer;
+  camera_toolkit::FrameTrace trace;
+  trace.mark(camera_toolkit::TraceStage::Dequeue, 1000000);
+  trace.mark(camera_toolkit::TraceStage::Convert, 1003000);
+  // 未经过叠加阶段，编码提交直接接在转换之后
+  trace.mark(camera_toolkit::TraceStage::EncodeSubmit, 1003500);
+  trace.mark(camera_toolkit::TraceStage::EncodeReturn, 1010500);
+  tracer.record(trace);
+
+  EXPECT_EQ(tracer.getStage(camera_toolkit::TraceStage::Dequeue).getCount(), 0u);
+  EXPECT_EQ(tracer.getStage(camera_toolkit::TraceStage::Convert).getMax(), 3000);
+  EXPECT_EQ(tracer.getStage(camera_toolkit::TraceStage::Overlay).getCount(), 0u);
+  EXPECT_EQ(tracer.getStage(camera_toolkit::TraceStage::EncodeSubmit).getMax(), 500);
+  EXPECT_EQ(tracer.getStage(camera_toolkit::TraceStage::EncodeReturn).getMax(), 7000);
+  EXPECT_EQ(tracer.getStage(camera_toolkit::TraceStage::Sent).getCount(), 0u);
+  EXPECT_EQ(tracer.getEndToEnd().getMax(), 10500);
+
+  // 只有一个阶段时没有端到端时延
+  trace.clear();
+  trace.mark(camera_toolkit::TraceStage::Dequeue, 2000000);
+  tracer.record(trace);
+  EXPECT_EQ(tracer.getEndToEnd().getCount(), 1u);
+}
+
+TEST(LatencyTracerTest, ReportListsRecordedStages) {
+  camera_toolkit::LatencyTracer tracer;
+  EXPECT_EQ(tracer.report().find("convert"), std::string::npos);
+
+  camera_toolkit::FrameTrace trace;
+  trace.mark(camera_toolkit::TraceStage::Dequeue);
+  trace.mark(camera_toolkit::TraceStage::Convert);
+  trace.mark(camera_toolkit::TraceStage::Sent, trace.stamps[1] + 2000000);
+  tracer.record(trace);
+
+  std::string report = tracer.report();
+  EXPECT_NE(report.find("convert"), std::string::npos);
+  EXPECT_NE(report.find("send"), std::string::npos);
+  EXPECT_NE(report.find("end-to-end"), std::string::npos);
+  EXPECT_EQ(report.find("encode"), std::string::npos);
+
+  tracer.reset();
+  EXPECT_EQ(tracer.getEndToEnd().getCount(), 0u);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_logger.cpp
+ * @brief 异步日志单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "camera_toolkit/logger.h"
+
+namespace {
+
+/**
+ * @brief 收集日志输出的测试夹具，每个测试结束时恢复默认输出
+ */
+class LoggerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    camera_toolkit::flushLog();
+    camera_toolkit::setLogSink([this](camera_toolkit::LogLevel level, const char* message) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      lines_.emplace_back(level, message);
+    });
+  }
+
+  void TearDown() override {
+    camera_toolkit::flushLog();
+    camera_toolkit::setLogSink(nullptr);
+    camera_toolkit::setLogLevel(camera_toolkit::LogLevel::Debug);
+  }
+
+  std::vector<std::pair<camera_toolkit::LogLevel, std::string>> lines() {
+    camera_toolkit::flushLog();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lines_;
+  }
+
+  std::mutex mutex_;
+  std::vector<std::pair<camera_toolkit::LogLevel, std::string>> lines_;
+};
+
+constexpr int kExitMessages = 20000; /**< 退出测试中生产者线程记录的消息数 */
+
+std::atomic<int> exitReceived{0}; /**< 退出测试中输出回调收到的消息数 */
+std::thread exitProducer;         /**< 退出测试中的生产者线程 */
+
+/**
+ * @brief 在日志器停止之后运行: 等生产者结束，所有未丢弃的消息都应已输出
+ */
+void checkNothingLostAtExit() {
+  exitProducer.join();
+  auto stats = camera_toolkit::getLogStats();
+  bool complete = exitReceived + static_cast<int>(stats.dropped) == kExitMessages && stats.suppressed == 0;
+  _Exit(complete ? 0 : 1);
+}
+
+}  // namespace
+
+// ============================================================================
+// 输出测试
+// ============================================================================
+
+TEST_F(LoggerTest, MessagesArriveInOrder) {
+  for (int i = 0; i < 100; ++i) {
+    camera_toolkit::logMessage(i % 2 ? camera_toolkit::LogLevel::Warn : camera_toolkit::LogLevel::Info,
+                               ("message " + std::to_string(i)).c_str());
+  }
+  auto out = lines();
+  ASSERT_EQ(out.size(), 100u);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(out[i].first, i % 2 ? camera_toolkit::LogLevel::Warn : camera_toolkit::LogLevel::Info);
+    EXPECT_EQ(out[i].second, "message " + std::to_string(i));
+  }
+}
+
+TEST_F(LoggerTest, RuntimeLevelFiltersMessages) {
+  camera_toolkit::setLogLevel(camera_toolkit::LogLevel::Warn);
+  EXPECT_EQ(camera_toolkit::getLogLevel(), camera_toolkit::LogLevel::Warn);
+  camera_toolkit::logMessage(camera_toolkit::LogLevel::Info, "filtered info");
+  camera_toolkit::logMessage(camera_toolkit::LogLevel::Error, "kept error");
+  camera_toolkit::logMessage(camera_toolkit::LogLevel::Off, "never logged");
+
+  auto out = lines();
+  ASSERT_EQ(out.size(), 1u);
+  EXPECT_EQ(out[0].second, "kept error");
+}
+
+TEST_F(LoggerTest, LongMessagesAreTruncated) {
+  std::string text(1000, 'x');
+  camera_toolkit::logMessage(camera_toolkit::LogLevel::Info, text.c_str());
+  auto out = lines();
+  ASSERT_EQ(out.size(), 1u);
+  EXPECT_GT(out[0].second.size(), 100u);
+  EXPECT_LT(out[0].second.size(), text.size());
+  EXPECT_EQ(out[0].second, std::string(out[0].second.size(), 'x'));
+}
+
+// ============================================================================
+// 限流与背压测试
+// ============================================================================
+
+TEST_F(LoggerTest, RepeatedMessagesAreRateLimited) {
+  auto before = camera_toolkit::getLogStats();
+  for (int i = 0; i < 100; ++i) {
+    camera_toolkit::logMessage(camera_toolkit::LogLevel::Warn, "Encoded frame delayed");
+  }
+  camera_toolkit::logMessage(camera_toolkit::LogLevel::Warn, "different message");
+
+  auto out = lines();
+  ASSERT_EQ(out.size(), 6u);
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(out[i].second, "Encoded frame delayed");
+  EXPECT_EQ(out[5].second, "different message");
+  EXPECT_EQ(camera_toolkit::getLogStats().suppressed - before.suppressed, 95u);
+}
+
+TEST_F(LoggerTest, FullQueueDropsInsteadOfBlocking) {
+  // 输出回调阻塞住后台线程，队列被填满后记录日志仍立即返回
+  std::atomic<bool> release{false};
+  std::atomic<int> received{0};
+  camera_toolkit::setLogSink([&](camera_toolkit::LogLevel, const char*) {
+    received++;
+    while (!release) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+
+  auto before = camera_toolkit::getLogStats();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 4096; ++i) {
+    camera_toolkit::logMessage(camera_toolkit::LogLevel::Info, ("flood " + std::to_string(i)).c_str());
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::seconds(1));
+
+  release = true;
+  camera_toolkit::flushLog();
+  auto after = camera_toolkit::getLogStats();
+  EXPECT_GT(after.dropped - before.dropped, 0u);
+  EXPECT_EQ(after.written - before.written + after.dropped - before.dropped, 4096u);
+  EXPECT_EQ(static_cast<uint64_t>(received), after.written - before.written);
+}
+
+// ============================================================================
+// 退出测试
+// ============================================================================
+
+TEST(LoggerExitTest, MessagesLoggedDuringShutdownAreNotLost) {
+  // 子进程重新执行，日志器在子进程中首次创建，atexit回调才能排在它的shutdown()之后
+  ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+  EXPECT_EXIT(
+      {
+        std::atexit(checkNothingLostAtExit);
+        camera_toolkit::setLogSink([](camera_toolkit::LogLevel, const char*) { exitReceived++; });
+        std::atomic<int> logged{0};
+        exitProducer = std::thread([&logged] {
+          for (int i = 0; i < kExitMessages; ++i) {
+            camera_toolkit::logMessage(camera_toolkit::LogLevel::Info, ("exit " + std::to_string(i)).c_str());
+            logged++;
+          }
+        });
+        // 生产者仍在记录时退出，消息在shutdown()前后跨越都不能丢
+        while (logged < kExitMessages / 2) std::this_thread::yield();
+        std::exit(0);
+      },
+      ::testing::ExitedWithCode(0), "");
+}
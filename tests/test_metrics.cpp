@@ -0,0 +1,210 @@
+/**
+ * @file test_metrics.cpp
+ * @brief MetricsRegistry / MetricsServer 单元测试
+ */
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/metrics.h"
+
+namespace {
+
+// 连接本机端口，发送原始请求并读取完整响应(服务端响应后关闭连接)
+std::string request(int port, const std::string& raw) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct timeval tv{};
+  tv.tv_sec = 2;
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  struct sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  std::string response;
+  if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+    send(fd, raw.data(), raw.size(), MSG_NOSIGNAL);
+    char data[4096];
+    ssize_t n;
+    while ((n = read(fd, data, sizeof(data))) > 0) response.append(data, static_cast<size_t>(n));
+  }
+  close(fd);
+  return response;
+}
+
+std::string get(int port, const std::string& path) {
+  return request(port, "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n");
+}
+
+camera_toolkit::MetricsServerParams loopbackParams() {
+  camera_toolkit::MetricsServerParams params;
+  params.port = 0;
+  return params;
+}
+
+}  // namespace
+
+// ============================================================================
+// 注册表测试
+// ============================================================================
+
+TEST(MetricsRegistryTest, RendersTextFormat) {
+  camera_toolkit::MetricsRegistry registry;
+  auto& frames = registry.counter("ck_frames_total", "Frames captured");
+  auto& fps = registry.gauge("ck_fps", "Frames per second");
+  auto& encode = registry.counter("ck_encode_seconds_total", "Encode time\nin seconds", 1e-9);
+  frames.add();
+  frames.add(41);
+  fps.set(14.5);
+  encode.add(2500000000ULL);
+
+  EXPECT_EQ(frames.get(), 42u);
+  EXPECT_DOUBLE_EQ(fps.get(), 14.5);
+  EXPECT_EQ(registry.render(),
+            "# HELP ck_frames_total Frames captured\n"
+            "# TYPE ck_frames_total counter\n"
+            "ck_frames_total 42\n"
+            "# HELP ck_fps Frames per second\n"
+            "# TYPE ck_fps gauge\n"
+            "ck_fps 14.5\n"
+            "# HELP ck_encode_seconds_total Encode time\\nin seconds\n"
+            "# TYPE ck_encode_seconds_total counter\n"
+            "ck_encode_seconds_total 2.5\n");
+}
+
+TEST(MetricsRegistryTest, RejectsInvalidAndDuplicateNames) {
+  camera_toolkit::MetricsRegistry registry;
+  registry.counter("ck_total", "");
+  EXPECT_THROW(registry.gauge("ck_total", ""), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(registry.gauge("", ""), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(registry.gauge("1st", ""), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(registry.gauge("ck-fps", ""), camera_toolkit::CameraToolkitException);
+  EXPECT_NO_THROW(registry.gauge("ck:fps_2", ""));
+}
+
+TEST(MetricsRegistryTest, LabeledSeriesShareFamily) {
+  camera_toolkit::MetricsRegistry registry;
+  registry.counter("ck_frames_total", "Frames", 1.0, {{"stream", "front"}}).add(3);
+  registry.gauge("ck_fps", "FPS", {{"stream", "front"}}).set(15);
+  registry.counter("ck_frames_total", "Frames", 1.0, {{"stream", "back \"2\"\\"}}).add(5);
+  EXPECT_EQ(registry.render(),
+            "# HELP ck_frames_total Frames\n"
+            "# TYPE ck_frames_total counter\n"
+            "ck_frames_total{stream=\"front\"} 3\n"
+            "ck_frames_total{stream=\"back \\\"2\\\"\\\\\"} 5\n"
+            "# HELP ck_fps FPS\n"
+            "# TYPE ck_fps gauge\n"
+            "ck_fps{stream=\"front\"} 15\n");
+
+  EXPECT_THROW(registry.counter("ck_frames_total", "", 1.0, {{"stream", "front"}}),
+               camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(registry.gauge("ck_frames_total", "", {{"stream", "side"}}), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(registry.gauge("ck_queue", "", {{"__stream", "x"}}), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(registry.gauge("ck_queue", "", {{"a:b", "x"}}), camera_toolkit::CameraToolkitException);
+}
+
+TEST(MetricsRegistryTest, ConcurrentUpdatesAreNotLost) {
+  camera_toolkit::MetricsRegistry registry;
+  auto& counter = registry.counter("ck_events_total", "");
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&counter] {
+      for (int i = 0; i < 100000; ++i) counter.add();
+    });
+  }
+  // 更新进行中反复抓取
+  for (int i = 0; i < 100; ++i) EXPECT_NE(registry.render().find("ck_events_total "), std::string::npos);
+  for (auto& thread : threads) thread.join();
+  EXPECT_NE(registry.render().find("ck_events_total 400000\n"), std::string::npos);
+}
+
+// ============================================================================
+// HTTP端点测试
+// ============================================================================
+
+TEST(MetricsServerTest, ServesMetricsOnLoopback) {
+  camera_toolkit::MetricsRegistry registry;
+  auto& sent = registry.counter("ck_packets_sent_total", "Packets sent");
+  camera_toolkit::MetricsServer server(loopbackParams(), registry);
+  ASSERT_GT(server.getPort(), 0);
+
+  sent.add(7);
+  std::string response = get(server.getPort(), "/metrics");
+  EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+  EXPECT_NE(response.find("Content-Type: text/plain; version=0.0.4"), std::string::npos);
+  EXPECT_NE(response.find("\r\n\r\n# HELP ck_packets_sent_total"), std::string::npos);
+  EXPECT_NE(response.find("ck_packets_sent_total 7\n"), std::string::npos);
+
+  // 每次抓取读取最新值
+  sent.add();
+  EXPECT_NE(get(server.getPort(), "/metrics?x=1").find("ck_packets_sent_total 8\n"), std::string::npos);
+}
+
+TEST(MetricsServerTest, RejectsOtherRequests) {
+  camera_toolkit::MetricsRegistry registry;
+  registry.gauge("ck_fps", "");
+  camera_toolkit::MetricsServer server(loopbackParams(), registry);
+
+  EXPECT_EQ(get(server.getPort(), "/").rfind("HTTP/1.1 404", 0), 0u);
+  EXPECT_EQ(request(server.getPort(), "POST /metrics HTTP/1.1\r\n\r\n").rfind("HTTP/1.1 405", 0), 0u);
+
+  std::string head = request(server.getPort(), "HEAD /metrics HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(head.rfind("HTTP/1.1 200 OK", 0), 0u);
+  EXPECT_EQ(head.find("ck_fps"), std::string::npos);
+
+  std::string huge = "GET /metrics HTTP/1.1\r\nX-Pad: " + std::string(10000, 'a') + "\r\n\r\n";
+  EXPECT_EQ(request(server.getPort(), huge).rfind("HTTP/1.1 431", 0), 0u);
+}
+
+TEST(MetricsServerTest, SplitRequestIsReassembled) {
+  camera_toolkit::MetricsRegistry registry;
+  registry.gauge("ck_fps", "").set(15);
+  camera_toolkit::MetricsServer server(loopbackParams(), registry);
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(static_cast<uint16_t>(server.getPort()));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+  send(fd, "GET /met", 8, 0);
+  usleep(20000);
+  send(fd, "rics HTTP/1.1\r\n\r\n", 17, 0);
+  std::string response;
+  char data[4096];
+  ssize_t n;
+  while ((n = read(fd, data, sizeof(data))) > 0) response.append(data, static_cast<size_t>(n));
+  close(fd);
+  EXPECT_NE(response.find("ck_fps 15\n"), std::string::npos);
+}
+
+TEST(MetricsServerTest, IdleConnectionsAreClosed) {
+  camera_toolkit::MetricsRegistry registry;
+  camera_toolkit::MetricsServerParams params = loopbackParams();
+  params.idleTimeoutMs = 100;
+  camera_toolkit::MetricsServer server(params, registry);
+
+  // 只发送部分请求，服务端超时后关闭连接
+  EXPECT_EQ(request(server.getPort(), "GET /metrics"), "");
+  EXPECT_EQ(get(server.getPort(), "/metrics").rfind("HTTP/1.1 200 OK", 0), 0u);
+}
+
+TEST(MetricsServerTest, InvalidAddressThrows) {
+  camera_toolkit::MetricsRegistry registry;
+  camera_toolkit::MetricsServerParams params;
+  params.address = "not-an-ip";
+  EXPECT_THROW(camera_toolkit::MetricsServer(params, registry), camera_toolkit::NetworkException);
+
+  camera_toolkit::MetricsServer first(loopbackParams(), registry);
+  params.address = "127.0.0.1";
+  params.port = first.getPort();
+  EXPECT_THROW(camera_toolkit::MetricsServer(params, registry), camera_toolkit::NetworkException);
+}
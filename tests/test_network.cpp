@@ -0,0 +1,536 @@
+/**
+ * @file test_network.cpp
+ * @brief Network 单元测试
+ */
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "camera_toolkit/network.h"
+
+namespace {
+
+// 在临时目录下创建监听中的 Unix SEQPACKET 套接字
+class UnixServer {
+ public:
+  UnixServer() {
+    char dirTemplate[] = "/tmp/ck_netXXXXXX";
+    dir_ = mkdtemp(dirTemplate);
+    path_ = dir_ + "/sock";
+
+    listenFd_ = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path_.c_str(), sizeof(addr.sun_path) - 1);
+    bind(listenFd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    listen(listenFd_, 1);
+  }
+
+  ~UnixServer() {
+    if (connFd_ >= 0) close(connFd_);
+    if (listenFd_ >= 0) close(listenFd_);
+    unlink(path_.c_str());
+    rmdir(dir_.c_str());
+  }
+
+  int accept() {
+    connFd_ = ::accept(listenFd_, nullptr, nullptr);
+    return connFd_;
+  }
+
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string dir_;
+  std::string path_;
+  int listenFd_ = -1;
+  int connFd_ = -1;
+};
+
+// 绑定在 127.0.0.1 随机端口上的 UDP 接收端
+class UdpReceiver {
+ public:
+  UdpReceiver() {
+    fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd_, reinterpret_cast<struct sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+  }
+
+  ~UdpReceiver() { close(fd_); }
+
+  int fd() const { return fd_; }
+  int port() const { return port_; }
+
+ private:
+  int fd_ = -1;
+  int port_ = 0;
+};
+
+// 先由 Network 发一个包，取得其源地址后从 receiver 回送 count 个包
+void replyFrom(const UdpReceiver& receiver, camera_toolkit::Network& net, int count, size_t size) {
+  ASSERT_EQ(net.send("hi", 2), 2);
+  char probe[8];
+  struct sockaddr_in peer{};
+  socklen_t len = sizeof(peer);
+  ASSERT_EQ(recvfrom(receiver.fd(), probe, sizeof(probe), 0, reinterpret_cast<struct sockaddr*>(&peer), &len), 2);
+
+  std::string payload(size, '\0');
+  for (int i = 0; i < count; ++i) {
+    payload[0] = static_cast<char>(i);
+    ASSERT_EQ(sendto(receiver.fd(), payload.data(), payload.size(), 0, reinterpret_cast<struct sockaddr*>(&peer), len),
+              static_cast<ssize_t>(payload.size()));
+  }
+}
+
+// 当前 CLOCK_MONOTONIC 时刻(纳秒)
+int64_t monotonicNs() {
+  struct timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+// 创建写入指定内容的 memfd
+int makeMemfd(const std::string& content) {
+  int fd = memfd_create("ck_test", MFD_CLOEXEC);
+  EXPECT_EQ(write(fd, content.data(), content.size()), static_cast<ssize_t>(content.size()));
+  return fd;
+}
+
+// 读取描述符中的全部内容(从偏移0开始)
+std::string readAll(int fd, size_t size) {
+  std::string out(size, '\0');
+  EXPECT_EQ(pread(fd, out.data(), size, 0), static_cast<ssize_t>(size));
+  return out;
+}
+
+}  // namespace
+
+// ============================================================================
+// UNIX 传输配置测试
+// ============================================================================
+
+TEST(NetworkTest, UnixEmptyPathThrows) {
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+
+  EXPECT_THROW(camera_toolkit::Network net(params), camera_toolkit::NetworkException);
+}
+
+TEST(NetworkTest, UnixMissingServerThrows) {
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+  params.socketPath = "/tmp/ck_net_does_not_exist.sock";
+
+  EXPECT_THROW(camera_toolkit::Network net(params), camera_toolkit::NetworkException);
+}
+
+TEST(NetworkTest, SendFdRequiresUnixTransport) {
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UDP;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = 9;
+
+  camera_toolkit::Network net(params);
+  int fd = -1;
+  char meta[4] = {};
+  EXPECT_THROW(net.sendFd(0, meta, sizeof(meta)), camera_toolkit::NetworkException);
+  EXPECT_THROW(net.receiveFd(meta, sizeof(meta), &fd), camera_toolkit::NetworkException);
+}
+
+// ============================================================================
+// SCM_RIGHTS 描述符传递测试
+// ============================================================================
+
+TEST(NetworkTest, SendFdPassesDescriptorWithMetadata) {
+  UnixServer server;
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+  params.socketPath = server.path();
+  camera_toolkit::Network net(params);
+  int peer = server.accept();
+  ASSERT_GE(peer, 0);
+
+  const std::string content = "raw frame bytes";
+  int memfd = makeMemfd(content);
+
+  camera_toolkit::FrameDescriptor desc;
+  desc.sequence = 42;
+  desc.width = 3840;
+  desc.height = 2160;
+  desc.size = static_cast<uint32_t>(content.size());
+  ASSERT_EQ(net.sendFd(memfd, &desc, sizeof(desc)), static_cast<int>(sizeof(desc)));
+  close(memfd);
+
+  // 服务端用 recvmsg 取出描述符和元数据
+  camera_toolkit::FrameDescriptor got;
+  struct iovec iov{&got, sizeof(got)};
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ASSERT_EQ(recvmsg(peer, &msg, 0), static_cast<ssize_t>(sizeof(got)));
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  ASSERT_NE(cmsg, nullptr);
+  EXPECT_EQ(cmsg->cmsg_type, SCM_RIGHTS);
+  int receivedFd;
+  std::memcpy(&receivedFd, CMSG_DATA(cmsg), sizeof(int));
+
+  EXPECT_EQ(got.sequence, 42u);
+  EXPECT_EQ(got.width, 3840u);
+  EXPECT_EQ(got.height, 2160u);
+  EXPECT_EQ(readAll(receivedFd, got.size), content);
+  close(receivedFd);
+}
+
+TEST(NetworkTest, ReceiveFdGetsDescriptorFromPeer) {
+  UnixServer server;
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+  params.socketPath = server.path();
+  camera_toolkit::Network net(params);
+  int peer = server.accept();
+  ASSERT_GE(peer, 0);
+
+  const std::string content = "dmabuf stand-in";
+  int memfd = makeMemfd(content);
+
+  uint32_t meta = 0xCAFEBABE;
+  struct iovec iov{&meta, sizeof(meta)};
+  alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  struct msghdr msg{};
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  std::memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+  ASSERT_EQ(sendmsg(peer, &msg, 0), static_cast<ssize_t>(sizeof(meta)));
+  close(memfd);
+
+  uint32_t gotMeta = 0;
+  int fd = -1;
+  ASSERT_EQ(net.receiveFd(&gotMeta, sizeof(gotMeta), &fd), static_cast<int>(sizeof(gotMeta)));
+  EXPECT_EQ(gotMeta, 0xCAFEBABEu);
+  ASSERT_GE(fd, 0);
+  EXPECT_EQ(readAll(fd, content.size()), content);
+  close(fd);
+}
+
+TEST(NetworkTest, ReceiveFdWithoutDescriptorReturnsMinusOne) {
+  UnixServer server;
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+  params.socketPath = server.path();
+  camera_toolkit::Network net(params);
+  int peer = server.accept();
+  ASSERT_GE(peer, 0);
+
+  // 普通消息(不带描述符)
+  const char text[] = "meta only";
+  ASSERT_EQ(::send(peer, text, sizeof(text), 0), static_cast<ssize_t>(sizeof(text)));
+
+  char buf[32] = {};
+  int fd = 123;
+  EXPECT_EQ(net.receiveFd(buf, sizeof(buf), &fd), static_cast<int>(sizeof(text)));
+  EXPECT_EQ(fd, -1);
+  EXPECT_STREQ(buf, text);
+}
+
+// ============================================================================
+// SO_TXTIME 定时发送测试
+// ============================================================================
+
+TEST(NetworkTest, SendAtDeliversNoEarlierThanTxTime) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UDP;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.txTime = true;  // 回环口默认无 fq qdisc 时回退为用户态定时
+  camera_toolkit::Network net(params);
+
+  const char payload[] = "paced";
+  int64_t txTime = monotonicNs() + 20 * 1000000;
+  ASSERT_EQ(net.sendAt(payload, sizeof(payload), txTime), static_cast<int>(sizeof(payload)));
+
+  char buf[16] = {};
+  ASSERT_EQ(recv(receiver.fd(), buf, sizeof(buf), 0), static_cast<ssize_t>(sizeof(payload)));
+  EXPECT_GE(monotonicNs(), txTime);
+  EXPECT_STREQ(buf, payload);
+}
+
+TEST(NetworkTest, SendAtPastTimeSendsImmediately) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.txTime = true;
+  camera_toolkit::Network net(params);
+
+  const char payload[] = "late";
+  camera_toolkit::Buffer buf(const_cast<char*>(payload), sizeof(payload));
+  EXPECT_EQ(net.sendAt(buf, monotonicNs() - 1000000), buf.size);
+}
+
+TEST(NetworkTest, TcpTxTimeFallsBackToUserspace) {
+  // 本地 TCP 监听端
+  int listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(bind(listenFd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)), 0);
+  ASSERT_EQ(listen(listenFd, 1), 0);
+  socklen_t len = sizeof(addr);
+  getsockname(listenFd, reinterpret_cast<struct sockaddr*>(&addr), &len);
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::TCP;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = ntohs(addr.sin_port);
+  params.txTime = true;
+
+  {
+    camera_toolkit::Network net(params);
+    // SO_TXTIME 仅用于 UDP，TCP 始终使用用户态定时
+    EXPECT_FALSE(net.isKernelPacing());
+  }
+  close(listenFd);
+}
+
+// ============================================================================
+// recvmmsg 批量接收测试
+// ============================================================================
+
+TEST(NetworkTest, ReceiveBatchDrainsQueuedPackets) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  camera_toolkit::Network net(params);
+  replyFrom(receiver, net, 5, 100);
+
+  camera_toolkit::ReceivedPacket packets[8];
+  ASSERT_EQ(net.receiveBatch(packets, 8), 5);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(packets[i].size, 100);
+    EXPECT_EQ(packets[i].data[0], i);
+    EXPECT_FALSE(packets[i].truncated);
+    EXPECT_EQ(packets[i].timestampNs, 0);
+  }
+}
+
+TEST(NetworkTest, ReceiveBatchRespectsBatchSize) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.batchSize = 2;
+  camera_toolkit::Network net(params);
+  replyFrom(receiver, net, 5, 10);
+
+  camera_toolkit::ReceivedPacket packets[8];
+  EXPECT_EQ(net.receiveBatch(packets, 8), 2);
+  EXPECT_EQ(net.receiveBatch(packets, 1), 1);
+  EXPECT_EQ(packets[0].data[0], 2);
+  EXPECT_EQ(net.receiveBatch(packets, 8), 2);
+  EXPECT_EQ(packets[1].data[0], 4);
+}
+
+TEST(NetworkTest, ReceiveBatchReportsTruncationAndTimestamps) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.batchBufferSize = 64;
+  params.rxTimestamp = true;
+  camera_toolkit::Network net(params);
+
+  struct timespec before{};
+  clock_gettime(CLOCK_REALTIME, &before);
+  replyFrom(receiver, net, 1, 200);
+
+  camera_toolkit::ReceivedPacket packets[4];
+  ASSERT_EQ(net.receiveBatch(packets, 4), 1);
+  struct timespec after{};
+  clock_gettime(CLOCK_REALTIME, &after);
+
+  EXPECT_EQ(packets[0].size, 64);
+  EXPECT_TRUE(packets[0].truncated);
+  EXPECT_GE(packets[0].timestampNs, static_cast<int64_t>(before.tv_sec) * 1000000000 + before.tv_nsec);
+  EXPECT_LE(packets[0].timestampNs, static_cast<int64_t>(after.tv_sec) * 1000000000 + after.tv_nsec);
+}
+
+TEST(NetworkTest, ReceiveBatchTimesOutWhenIdle) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.receiveTimeoutMs = 20;
+  camera_toolkit::Network net(params);
+
+  camera_toolkit::ReceivedPacket packets[4];
+  EXPECT_EQ(net.receiveBatch(packets, 4), -1);
+  EXPECT_TRUE(errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
+// ============================================================================
+// sendmmsg 批量发送测试
+// ============================================================================
+
+TEST(NetworkTest, SendBatchSendsEachBufferAsDatagram) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.batchSize = 4;
+  camera_toolkit::Network net(params);
+
+  // 10个包分3次系统调用发送
+  std::vector<std::vector<uint8_t>> payloads;
+  std::vector<camera_toolkit::Buffer> buffers;
+  for (int i = 0; i < 10; ++i) payloads.emplace_back(100 + i, static_cast<uint8_t>(i));
+  for (auto& payload : payloads) buffers.emplace_back(payload.data(), static_cast<int>(payload.size()));
+  ASSERT_EQ(net.sendBatch(buffers.data(), static_cast<int>(buffers.size())), 10);
+
+  uint8_t data[256];
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_EQ(recv(receiver.fd(), data, sizeof(data), 0), 100 + i);
+    EXPECT_EQ(data[0], i);
+  }
+
+  camera_toolkit::NetworkStats stats = net.getStats();
+  EXPECT_EQ(stats.packetsSent, 10u);
+  EXPECT_EQ(stats.bytesSent, 1045u);
+  uint64_t samples = 0;
+  for (uint64_t bucket : stats.sendLatency) samples += bucket;
+  EXPECT_EQ(samples, 3u);
+}
+
+TEST(NetworkTest, SendBatchWithoutBatchArraysSendsOneByOne) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.batchSize = 0;
+  camera_toolkit::Network net(params);
+
+  uint8_t payload[2][50] = {{1}, {2}};
+  camera_toolkit::Buffer buffers[2] = {{payload[0], 50}, {payload[1], 50}};
+  ASSERT_EQ(net.sendBatch(buffers, 2), 2);
+  EXPECT_EQ(net.getStats().packetsSent, 2u);
+}
+
+// ============================================================================
+// 发送统计与套接字调优测试
+// ============================================================================
+
+TEST(NetworkTest, StatsCountSentPacketsAndLatency) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  camera_toolkit::Network net(params);
+
+  char payload[100] = {};
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(net.send(payload, sizeof(payload)), static_cast<int>(sizeof(payload)));
+  }
+
+  camera_toolkit::NetworkStats stats = net.getStats();
+  EXPECT_EQ(stats.packetsSent, 3u);
+  EXPECT_EQ(stats.bytesSent, 300u);
+  EXPECT_EQ(stats.shortSends, 0u);
+  EXPECT_EQ(stats.errors, 0u);
+  uint64_t samples = 0;
+  for (uint64_t bucket : stats.sendLatency) samples += bucket;
+  EXPECT_EQ(samples, 3u);
+
+  net.resetStats();
+  EXPECT_EQ(net.getStats().packetsSent, 0u);
+}
+
+TEST(NetworkTest, StatsCountErrorsAndDetectDisconnect) {
+  UnixServer server;
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+  params.socketPath = server.path();
+  camera_toolkit::Network net(params);
+  int peer = server.accept();
+  ASSERT_GE(peer, 0);
+  close(peer);
+
+  // 对端已关闭：发送失败(EPIPE)，且不会触发SIGPIPE
+  EXPECT_EQ(net.send("x", 1), -1);
+  EXPECT_EQ(errno, EPIPE);
+  EXPECT_EQ(net.getStats().errors, 1u);
+  EXPECT_FALSE(net.isConnected());
+}
+
+TEST(NetworkTest, StatsReportQueuedBytes) {
+  UnixServer server;
+
+  camera_toolkit::NetworkParams params;
+  params.type = camera_toolkit::NetworkType::UNIX;
+  params.socketPath = server.path();
+  camera_toolkit::Network net(params);
+  ASSERT_GE(server.accept(), 0);
+
+  // 对端不读取，数据留在发送队列中
+  char payload[1000] = {};
+  ASSERT_EQ(net.send(payload, sizeof(payload)), static_cast<int>(sizeof(payload)));
+  EXPECT_GT(net.getStats().queuedBytes, 0);
+}
+
+TEST(NetworkTest, SocketBufferSizesAreApplied) {
+  UdpReceiver receiver;
+
+  camera_toolkit::NetworkParams params;
+  params.serverIP = "127.0.0.1";
+  params.serverPort = receiver.port();
+  params.sendBufferSize = 65536;
+  params.receiveBufferSize = 65536;
+  params.tos = 0xB8;  // DSCP EF
+  params.priority = 5;
+  camera_toolkit::Network net(params);
+
+  // 内核会把设置值翻倍以包含簿记开销
+  camera_toolkit::NetworkStats stats = net.getStats();
+  EXPECT_EQ(stats.sendBufferSize, 2 * 65536);
+  EXPECT_EQ(stats.receiveBufferSize, 2 * 65536);
+}
@@ -0,0 +1,195 @@
+/**
+ * @file test_osd.cpp
+ * @brief Osd 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "camera_toolkit/osd.h"
+#include "camera_toolkit/timestamp.h"
+
+namespace {
+
+constexpr int kWidth = 640;
+constexpr int kHeight = 480;
+// YUV420 Y 平面大小
+constexpr int kYPlaneSize = kWidth * kHeight;
+
+std::vector<uint8_t> makeYPlane(uint8_t fill = 128) {
+  return std::vector<uint8_t>(kYPlaneSize, fill);
+}
+
+camera_toolkit::OsdRegion makeRegion(const char* format, int x, int y, int factor = 0) {
+  camera_toolkit::OsdRegion region;
+  region.format = format;
+  region.x = x;
+  region.y = y;
+  region.factor = factor;
+  return region;
+}
+
+camera_toolkit::OsdParams makeParams(std::vector<camera_toolkit::OsdRegion> regions) {
+  camera_toolkit::OsdParams params;
+  params.videoWidth = kWidth;
+  params.videoHeight = kHeight;
+  params.cameraName = "CAM1";
+  params.regions = std::move(regions);
+  return params;
+}
+
+// 用 Timestamp::drawText 在相同位置绘制参考文字
+void drawReference(uint8_t* image, const camera_toolkit::OsdRegion& region, const char* text) {
+  camera_toolkit::TimestampParams params;
+  params.startX = region.x;
+  params.startY = region.y;
+  params.videoWidth = kWidth;
+  params.factor = region.factor;
+  camera_toolkit::Timestamp(params).drawText(image, text);
+}
+
+}  // namespace
+
+// ============================================================================
+// 参数测试
+// ============================================================================
+
+TEST(OsdTest, DefaultParams) {
+  camera_toolkit::OsdParams params;
+  camera_toolkit::Osd osd(params);
+
+  EXPECT_EQ(osd.getParams().videoWidth, 640);
+  EXPECT_EQ(osd.getParams().videoHeight, 480);
+  EXPECT_TRUE(osd.getParams().regions.empty());
+
+  // 没有区域时不修改图像
+  auto yPlane = makeYPlane(128);
+  osd.draw(yPlane.data());
+  EXPECT_EQ(yPlane, makeYPlane(128));
+}
+
+TEST(OsdTest, InvalidVideoSizeThrows) {
+  camera_toolkit::OsdParams params;
+  params.videoHeight = 0;
+  EXPECT_THROW(camera_toolkit::Osd osd(params), camera_toolkit::CameraToolkitException);
+}
+
+// ============================================================================
+// 模板字段测试
+// ============================================================================
+
+TEST(OsdTest, TemplateFieldsAreSubstituted) {
+  auto region = makeRegion("{camera} {fps}fps {kbps}kbps", 10, 20);
+  camera_toolkit::Osd osd(makeParams({region}));
+  osd.update({25.0, 1200});
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  osd.draw(yPlane1.data());
+  drawReference(yPlane2.data(), region, "CAM1 25.0fps 1200kbps");
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+TEST(OsdTest, UnknownFieldsStayLiteral) {
+  auto region = makeRegion("{foo} {camera", 10, 20);
+  camera_toolkit::Osd osd(makeParams({region}));
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  osd.draw(yPlane1.data());
+  drawReference(yPlane2.data(), region, "{foo} {camera");
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+TEST(OsdTest, TimeFieldMatchesTimestamp) {
+  auto region = makeRegion("{time}", 10, 10);
+  camera_toolkit::Osd osd(makeParams({region}));
+  camera_toolkit::TimestampParams tsParams;
+  tsParams.videoWidth = kWidth;
+  camera_toolkit::Timestamp ts(tsParams);
+
+  for (int64_t t : {1700000000000000LL, 1700000000500000LL, 1700000001000000LL}) {
+    auto yPlane1 = makeYPlane(128);
+    auto yPlane2 = makeYPlane(128);
+    osd.draw(yPlane1.data(), t);
+    ts.draw(yPlane2.data(), t);
+    EXPECT_EQ(yPlane1, yPlane2) << t;
+  }
+}
+
+// ============================================================================
+// 增量更新与合成测试
+// ============================================================================
+
+TEST(OsdTest, StatsUpdateMatchesFreshRender) {
+  auto region = makeRegion("{fps} / {kbps}", 10, 40, 1);
+  camera_toolkit::Osd cached(makeParams({region}));
+  camera_toolkit::Osd fresh(makeParams({region}));
+
+  auto scratch = makeYPlane(128);
+  cached.update({29.9, 980});
+  cached.draw(scratch.data());
+  cached.update({30.0, 1010});
+  fresh.update({30.0, 1010});
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  cached.draw(yPlane1.data());
+  fresh.draw(yPlane2.data());
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+TEST(OsdTest, MultipleRegionsMatchSequentialDraws) {
+  // 左上角两行、右下角右对齐，两个区域的行范围互相重叠
+  auto left = makeRegion("{camera}\\n{fps}", 10, 30);
+  auto right = makeRegion("{kbps} kbps", kWidth - 10, 25, 1);
+  camera_toolkit::Osd osd(makeParams({left, right}));
+  osd.update({15.0, 512});
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  osd.draw(yPlane1.data());
+  drawReference(yPlane2.data(), left, "CAM1\\n15.0");
+  drawReference(yPlane2.data(), right, "512 kbps");
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+TEST(OsdTest, RegionsAreClippedToFrame) {
+  // 第一个区域从左边缘外开始并多行向上展开越过顶边，第二个区域越过底边
+  auto top = makeRegion("A\\nB\\nC", -7, 4);
+  auto bottom = makeRegion("{camera}", 10, kHeight - 4);
+  camera_toolkit::Osd osd(makeParams({top, bottom}));
+
+  std::vector<uint8_t> buffer(kYPlaneSize + 2 * kWidth, 0xAB);
+  uint8_t* image = buffer.data() + kWidth;
+  osd.draw(image);
+
+  for (int i = 0; i < kWidth; ++i) {
+    EXPECT_EQ(buffer[i], 0xAB) << "before frame at " << i;
+    EXPECT_EQ(buffer[kWidth + kYPlaneSize + i], 0xAB) << "after frame at " << i;
+  }
+  // 帧内仍然绘制了可见部分，左边缘外的列被裁掉而不是折回上一行末尾
+  EXPECT_NE(std::vector<uint8_t>(image, image + kYPlaneSize), std::vector<uint8_t>(kYPlaneSize, 0xAB));
+  for (int y = 0; y < 20; ++y) {
+    for (int x = kWidth - 8; x < kWidth; ++x) ASSERT_EQ(image[y * kWidth + x], 0xAB) << "at (" << x << ", " << y << ")";
+  }
+}
+
+TEST(OsdTest, SlicedDrawMatchesWholeFrame) {
+  auto left = makeRegion("{camera}\\n{fps}", 10, 30, 1);
+  auto right = makeRegion("{kbps} kbps", kWidth - 10, 25, 2);
+  camera_toolkit::Osd sliced(makeParams({left, right}));
+  camera_toolkit::Osd whole(makeParams({left, right}));
+  sliced.update({15.0, 512});
+  whole.update({15.0, 512});
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  auto frame1 = camera_toolkit::FrameView::contiguous(yPlane1.data(), kWidth, kHeight);
+  for (int y = 0; y < kHeight; y += 16) {
+    sliced.draw(frame1, 0, y, y + 16);
+  }
+  whole.draw(camera_toolkit::FrameView::contiguous(yPlane2.data(), kWidth, kHeight), 0);
+  EXPECT_EQ(yPlane1, yPlane2);
+}
@@ -0,0 +1,309 @@
+/**
+ * @file test_overlay.cpp
+ * @brief Overlay 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "camera_toolkit/overlay.h"
+#include "yuv_fixture.h"
+
+namespace {
+
+using camera_toolkit::testing::noiseFrame;
+using camera_toolkit::testing::toNv12;
+
+constexpr int kWidth = 64;
+constexpr int kHeight = 48;
+constexpr int kYSize = kWidth * kHeight;
+constexpr int kCSize = (kWidth / 2) * (kHeight / 2);
+
+// 创建 I420 帧，Y/U/V 分别填充
+std::vector<uint8_t> makeFrame(uint8_t y, uint8_t u, uint8_t v) {
+  std::vector<uint8_t> frame(kYSize + 2 * kCSize, y);
+  std::fill(frame.begin() + kYSize, frame.begin() + kYSize + kCSize, u);
+  std::fill(frame.begin() + kYSize + kCSize, frame.end(), v);
+  return frame;
+}
+
+// 纯色 RGBA 位图
+std::vector<uint8_t> makeImage(int w, int h, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  std::vector<uint8_t> rgba;
+  for (int i = 0; i < w * h; ++i) {
+    rgba.insert(rgba.end(), {r, g, b, a});
+  }
+  return rgba;
+}
+
+camera_toolkit::OverlayParams makeParams(camera_toolkit::PixelFormat format = camera_toolkit::PixelFormat::YUV420) {
+  camera_toolkit::OverlayParams params;
+  params.videoWidth = kWidth;
+  params.videoHeight = kHeight;
+  params.pixelFormat = format;
+  return params;
+}
+
+// 浮点参考: dst * (1 - a) + c * a
+int reference(int dst, int color, int alpha) {
+  return static_cast<int>(dst * (255 - alpha) / 255.0 + color * alpha / 255.0 + 0.5);
+}
+
+}  // namespace
+
+// ============================================================================
+// 参数测试
+// ============================================================================
+
+TEST(OverlayTest, RejectsUnsupportedFormat) {
+  EXPECT_THROW(camera_toolkit::Overlay(makeParams(camera_toolkit::PixelFormat::YUYV)),
+               camera_toolkit::CameraToolkitException);
+  EXPECT_NO_THROW(camera_toolkit::Overlay(makeParams(camera_toolkit::PixelFormat::NV12)));
+}
+
+TEST(OverlayTest, InvalidLayerIdThrows) {
+  camera_toolkit::Overlay overlay(makeParams());
+  auto image = makeImage(2, 2, 0, 0, 0, 255);
+  int id = overlay.addImage(image.data(), 2, 2, 8, 0, 0);
+  EXPECT_THROW(overlay.setText(id, "X"), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(overlay.setPosition(id + 1, 0, 0), camera_toolkit::CameraToolkitException);
+  overlay.remove(id);
+  EXPECT_THROW(overlay.setPosition(id, 0, 0), camera_toolkit::CameraToolkitException);
+}
+
+// ============================================================================
+// 位图混合测试
+// ============================================================================
+
+TEST(OverlayTest, OpaqueImageWritesBt601Colour) {
+  camera_toolkit::Overlay overlay(makeParams());
+  auto image = makeImage(4, 4, 255, 0, 0, 255);
+  overlay.addImage(image.data(), 4, 4, 16, 2, 2);
+
+  auto frame = makeFrame(128, 128, 128);
+  overlay.draw(frame.data());
+
+  // 纯红 BT.601 有限范围: Y=82, U=90, V=240
+  EXPECT_EQ(frame[2 * kWidth + 2], 82);
+  EXPECT_EQ(frame[5 * kWidth + 5], 82);
+  EXPECT_EQ(frame[6 * kWidth + 6], 128);
+  EXPECT_EQ(frame[kYSize + 1 * (kWidth / 2) + 1], 90);
+  EXPECT_EQ(frame[kYSize + kCSize + 2 * (kWidth / 2) + 2], 240);
+  EXPECT_EQ(frame[kYSize + 3 * (kWidth / 2) + 3], 128);
+}
+
+TEST(OverlayTest, TransparentImageLeavesFrameUntouched) {
+  camera_toolkit::Overlay overlay(makeParams());
+  auto image = makeImage(16, 16, 255, 255, 0, 0);
+  overlay.addImage(image.data(), 16, 16, 64, 5, 5);
+
+  auto frame = noiseFrame(kWidth, kHeight, 1);
+  auto expected = frame;
+  overlay.draw(frame.data());
+  EXPECT_EQ(frame, expected);
+}
+
+TEST(OverlayTest, BlendMatchesFloatReference) {
+  // 宽度不是 16/32 的整数倍，覆盖 SIMD 主循环和标量尾部
+  constexpr int kW = 45;
+  constexpr int kH = 6;
+  for (int alpha : {1, 77, 128, 200, 254}) {
+    camera_toolkit::Overlay overlay(makeParams());
+    auto image = makeImage(kW, kH, 0, 255, 0, static_cast<uint8_t>(alpha));
+    overlay.addImage(image.data(), kW, kH, kW * 4, 0, 0);
+
+    auto frame = noiseFrame(kWidth, kHeight, alpha);
+    auto original = frame;
+    overlay.draw(frame.data());
+
+    // 纯绿 Y=144，预乘和除以255均为精确舍入，与浮点结果最多相差1
+    for (int y = 0; y < kH; ++y) {
+      for (int x = 0; x < kW; ++x) {
+        int i = y * kWidth + x;
+        EXPECT_NEAR(frame[i], reference(original[i], 144, alpha), 1) << "alpha " << alpha << " at " << x;
+      }
+    }
+  }
+}
+
+TEST(OverlayTest, OddPositionAveragesPremultipliedChroma) {
+  camera_toolkit::Overlay overlay(makeParams());
+  // 单个不透明蓝色像素落在 2x2 色度块的右下角
+  auto image = makeImage(1, 1, 0, 0, 255, 255);
+  overlay.addImage(image.data(), 1, 1, 4, 3, 3);
+
+  auto frame = makeFrame(100, 128, 128);
+  overlay.draw(frame.data());
+
+  // 纯蓝 U=240；色度块 Alpha = 255/4 ≈ 64，预乘 U = 240*255/1020 = 60
+  int u = frame[kYSize + 1 * (kWidth / 2) + 1];
+  EXPECT_EQ(u, 60 + (128 * (255 - 64) + 127) / 255);
+  EXPECT_EQ(frame[kYSize], 128);
+  EXPECT_EQ(frame[3 * kWidth + 3], 41);
+  EXPECT_EQ(frame[3 * kWidth + 2], 100);
+}
+
+TEST(OverlayTest, Nv12MatchesI420) {
+  auto image = makeImage(13, 9, 200, 40, 90, 180);
+  auto i420 = noiseFrame(kWidth, kHeight, 7);
+  auto nv12 = toNv12(i420, kWidth, kHeight);
+
+  camera_toolkit::Overlay a(makeParams(camera_toolkit::PixelFormat::YUV420));
+  camera_toolkit::Overlay b(makeParams(camera_toolkit::PixelFormat::NV12));
+  for (camera_toolkit::Overlay* o : {&a, &b}) {
+    o->addImage(image.data(), 13, 9, 13 * 4, 7, 5);
+    o->addText("NV12", 20, 30, 0, {255, 255, 0}, {0, 0, 255}, 200);
+  }
+  a.draw(i420.data());
+  b.draw(nv12.data());
+
+  EXPECT_EQ(toNv12(i420, kWidth, kHeight), nv12);
+}
+
+TEST(OverlayTest, LayersAreClippedToFrame) {
+  camera_toolkit::Overlay overlay(makeParams());
+  auto image = makeImage(20, 20, 255, 255, 255, 255);
+  overlay.addImage(image.data(), 20, 20, 80, -7, -9);
+  overlay.addImage(image.data(), 20, 20, 80, kWidth - 5, kHeight - 3);
+
+  std::vector<uint8_t> buffer(kYSize + 2 * kCSize + 2 * 64, 0xAB);
+  uint8_t* frame = buffer.data() + 64;
+  std::fill(frame, frame + kYSize + 2 * kCSize, 16);
+  overlay.draw(frame);
+
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ(buffer[i], 0xAB);
+    EXPECT_EQ(buffer[buffer.size() - 1 - i], 0xAB);
+  }
+  // 可见部分已绘制
+  EXPECT_EQ(frame[0], 235);
+  EXPECT_EQ(frame[kYSize - 1], 235);
+  EXPECT_EQ(frame[12 * kWidth], 16);
+}
+
+TEST(OverlayTest, SetPositionWithNewParityRebuildsChroma) {
+  auto image = makeImage(5, 5, 30, 200, 60, 150);
+  camera_toolkit::Overlay moved(makeParams());
+  camera_toolkit::Overlay fresh(makeParams());
+  int id = moved.addImage(image.data(), 5, 5, 20, 4, 4);
+  moved.setPosition(id, 9, 11);
+  fresh.addImage(image.data(), 5, 5, 20, 9, 11);
+
+  auto frame1 = noiseFrame(kWidth, kHeight, 3);
+  auto frame2 = frame1;
+  moved.draw(frame1.data());
+  fresh.draw(frame2.data());
+  EXPECT_EQ(frame1, frame2);
+}
+
+// ============================================================================
+// 彩色文字测试
+// ============================================================================
+
+TEST(OverlayTest, TextUsesFillAndOutlineColours) {
+  camera_toolkit::Overlay overlay(makeParams());
+  overlay.addText("1", 0, 0, 0, {0, 255, 0}, {0, 0, 0});
+
+  auto frame = makeFrame(128, 128, 128);
+  overlay.draw(frame.data());
+
+  // '1' 点阵首行: {0, 0, 0, 1, 0, 0, 0}，第二行: {0, 0, 1, 2, 1, 0, 0}
+  EXPECT_EQ(frame[2], 128);
+  EXPECT_EQ(frame[3], 16);
+  EXPECT_EQ(frame[kWidth + 3], 144);
+  EXPECT_EQ(frame[kWidth + 2], 16);
+}
+
+TEST(OverlayTest, SetTextMatchesFreshLayer) {
+  camera_toolkit::Overlay updated(makeParams());
+  camera_toolkit::Overlay fresh(makeParams());
+  int id = updated.addText("12:00", 3, 5, 1, {255, 0, 0}, {255, 255, 255}, 220);
+  updated.setText(id, "12:01\\nREC");
+  fresh.addText("12:01\\nREC", 3, 5, 1, {255, 0, 0}, {255, 255, 255}, 220);
+
+  auto frame1 = noiseFrame(kWidth, kHeight, 5);
+  auto frame2 = frame1;
+  updated.draw(frame1.data());
+  fresh.draw(frame2.data());
+  EXPECT_EQ(frame1, frame2);
+}
+
+// ============================================================================
+// 帧视图测试
+// ============================================================================
+
+TEST(OverlayTest, StridedFrameMatchesContiguous) {
+  auto image = makeImage(11, 7, 10, 220, 130, 170);
+  auto contiguous = noiseFrame(kWidth, kHeight, 9);
+
+  // 各平面独立分配并带行填充，模拟对齐帧和帧池
+  constexpr int kPad = 24;
+  std::vector<uint8_t> y((kWidth + kPad) * kHeight, 0xAB);
+  std::vector<uint8_t> u((kWidth / 2 + kPad) * (kHeight / 2), 0xAB);
+  std::vector<uint8_t> v((kWidth / 2 + kPad) * (kHeight / 2), 0xAB);
+  camera_toolkit::FrameView frame;
+  frame.planes[0] = y.data();
+  frame.planes[1] = u.data();
+  frame.planes[2] = v.data();
+  frame.strides[0] = kWidth + kPad;
+  frame.strides[1] = frame.strides[2] = kWidth / 2 + kPad;
+  frame.width = kWidth;
+  frame.height = kHeight;
+  for (int r = 0; r < kHeight; ++r) {
+    std::copy_n(&contiguous[r * kWidth], kWidth, &y[r * frame.strides[0]]);
+  }
+  for (int r = 0; r < kHeight / 2; ++r) {
+    std::copy_n(&contiguous[kYSize + r * (kWidth / 2)], kWidth / 2, &u[r * frame.strides[1]]);
+    std::copy_n(&contiguous[kYSize + kCSize + r * (kWidth / 2)], kWidth / 2, &v[r * frame.strides[2]]);
+  }
+
+  camera_toolkit::Overlay a(makeParams());
+  camera_toolkit::Overlay b(makeParams());
+  a.addImage(image.data(), 11, 7, 44, kWidth - 6, 3);
+  b.addImage(image.data(), 11, 7, 44, kWidth - 6, 3);
+  a.draw(contiguous.data());
+  b.draw(frame);
+
+  for (int r = 0; r < kHeight; ++r) {
+    for (int x = 0; x < frame.strides[0]; ++x) {
+      ASSERT_EQ(y[r * frame.strides[0] + x], x < kWidth ? contiguous[r * kWidth + x] : 0xAB);
+    }
+  }
+  for (int r = 0; r < kHeight / 2; ++r) {
+    for (int x = 0; x < frame.strides[1]; ++x) {
+      bool inside = x < kWidth / 2;
+      ASSERT_EQ(u[r * frame.strides[1] + x], inside ? contiguous[kYSize + r * (kWidth / 2) + x] : 0xAB);
+      ASSERT_EQ(v[r * frame.strides[2] + x], inside ? contiguous[kYSize + kCSize + r * (kWidth / 2) + x] : 0xAB);
+    }
+  }
+}
+
+TEST(OverlayTest, MismatchedFrameFormatThrows) {
+  camera_toolkit::Overlay overlay(makeParams());
+  auto frame = noiseFrame(kWidth, kHeight, 11);
+  auto view = camera_toolkit::FrameView::contiguous(frame.data(), kWidth, kHeight, camera_toolkit::PixelFormat::NV12);
+  EXPECT_THROW(overlay.draw(view), camera_toolkit::CameraToolkitException);
+}
+
+TEST(OverlayTest, SlicedDrawMatchesWholeFrame) {
+  auto image = makeImage(21, 17, 250, 120, 30, 140);
+  for (auto format : {camera_toolkit::PixelFormat::YUV420, camera_toolkit::PixelFormat::NV12}) {
+    camera_toolkit::Overlay sliced(makeParams(format));
+    camera_toolkit::Overlay whole(makeParams(format));
+    // 奇数坐标让色度块跨越分条边界
+    sliced.addImage(image.data(), 21, 17, 84, 5, 7);
+    whole.addImage(image.data(), 21, 17, 84, 5, 7);
+
+    auto frame1 = noiseFrame(kWidth, kHeight, 13);
+    if (format == camera_toolkit::PixelFormat::NV12) frame1 = toNv12(frame1, kWidth, kHeight);
+    auto frame2 = frame1;
+    auto view = camera_toolkit::FrameView::contiguous(frame1.data(), kWidth, kHeight, format);
+    for (int y = 0; y < kHeight; y += 6) {
+      sliced.draw(view, y, y + 6);
+    }
+    whole.draw(frame2.data());
+    EXPECT_EQ(frame1, frame2) << static_cast<int>(format);
+  }
+}
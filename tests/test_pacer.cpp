@@ -0,0 +1,93 @@
+/**
+ * @file test_pacer.cpp
+ * @brief Pacer 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "camera_toolkit/pacer.h"
+
+namespace {
+
+constexpr int64_t kMs = 1000000;  // 1毫秒(纳秒)
+
+}  // namespace
+
+// ============================================================================
+// 参数测试
+// ============================================================================
+
+TEST(PacerTest, PacingRateIsBitrateTimesFactor) {
+  camera_toolkit::PacerParams params;
+  params.bitrate = 1000;
+  params.pacingFactor = 2.0;
+  camera_toolkit::Pacer pacer(params);
+
+  EXPECT_EQ(pacer.getPacingRate(), 2000);
+
+  pacer.setBitrate(500);
+  EXPECT_EQ(pacer.getPacingRate(), 1000);
+  EXPECT_EQ(pacer.getParams().bitrate, 500);
+}
+
+// ============================================================================
+// 发送时刻计算测试
+// ============================================================================
+
+TEST(PacerTest, PacketsAreSpacedBySizeOverRate) {
+  camera_toolkit::PacerParams params;
+  params.bitrate = 1000;  // 发送速率 1 Mbps
+  params.pacingFactor = 1.0;
+  params.fps = 1;
+  camera_toolkit::Pacer pacer(params);
+
+  int64_t now = 100 * kMs;
+  pacer.onFrame(now);
+
+  // 1250 字节 @ 1 Mbps = 10 ms
+  EXPECT_EQ(pacer.next(1250, now), now);
+  EXPECT_EQ(pacer.next(1250, now), now + 10 * kMs);
+  EXPECT_EQ(pacer.next(1250, now), now + 20 * kMs);
+}
+
+TEST(PacerTest, IdleTimeDoesNotAccumulateBurstCredit) {
+  camera_toolkit::PacerParams params;
+  params.bitrate = 1000;
+  params.pacingFactor = 1.0;
+  params.fps = 1;
+  camera_toolkit::Pacer pacer(params);
+
+  pacer.onFrame(0);
+  pacer.next(1250, 0);
+
+  // 很久之后的新帧，第一个包从帧时刻开始，之后仍按速率间隔
+  int64_t later = 5000 * kMs;
+  pacer.onFrame(later);
+  EXPECT_EQ(pacer.next(1250, later), later);
+  EXPECT_EQ(pacer.next(1250, later), later + 10 * kMs);
+}
+
+TEST(PacerTest, FrameIsSentWithinOneFrameInterval) {
+  camera_toolkit::PacerParams params;
+  params.bitrate = 100;  // 很低的速率，单帧发不完
+  params.pacingFactor = 1.0;
+  params.fps = 25;  // 40 ms 窗口
+  camera_toolkit::Pacer pacer(params);
+
+  pacer.onFrame(0);
+  int64_t last = 0;
+  for (int i = 0; i < 50; ++i) {
+    last = pacer.next(1400, 0);
+  }
+  EXPECT_LE(last, 40 * kMs);
+}
+
+TEST(PacerTest, SendTimeNeverInThePast) {
+  camera_toolkit::PacerParams params;
+  camera_toolkit::Pacer pacer(params);
+
+  pacer.onFrame(0);
+  int64_t now = 1000 * kMs;
+  EXPECT_GE(pacer.next(1000, now), now);
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_packet_pool.cpp
+ * @brief PacketPool 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/packet_pool.h"
+
+using camera_toolkit::Packet;
+using camera_toolkit::PacketPool;
+
+// ============================================================================
+// 分配与引用计数测试
+// ============================================================================
+
+TEST(PacketPoolTest, AllocateCopiesDataAndMetadata) {
+  PacketPool pool(4096);
+  const uint8_t data[5] = {0, 0, 1, 0x65, 0x88};
+  Packet packet = pool.allocate(data, sizeof(data), 1000, 900, true);
+
+  ASSERT_FALSE(packet.empty());
+  EXPECT_EQ(packet.size(), sizeof(data));
+  EXPECT_EQ(std::memcmp(packet.data(), data, sizeof(data)), 0);
+  EXPECT_EQ(packet.ptsUs(), 1000);
+  EXPECT_EQ(packet.dtsUs(), 900);
+  EXPECT_TRUE(packet.keyframe());
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(packet.data()) % 64, 0u);
+
+  camera_toolkit::EncodedFrame frame = packet.frame();
+  EXPECT_EQ(frame.buffer.data, packet.data());
+  EXPECT_EQ(frame.buffer.size, 5);
+  EXPECT_EQ(frame.ptsUs, 1000);
+}
+
+TEST(PacketPoolTest, LastReferenceReturnsMemory) {
+  PacketPool pool(4096);
+  std::vector<uint8_t> data(100, 0x5A);
+  Packet first = pool.allocate(data.data(), data.size(), 0, 0, false);
+  Packet copy = first;
+  Packet moved = std::move(first);
+  EXPECT_TRUE(first.empty());
+  EXPECT_EQ(pool.getStats().livePackets, 1u);
+
+  copy.reset();
+  EXPECT_EQ(pool.getStats().livePackets, 1u);
+  EXPECT_GT(pool.getStats().used, 0u);
+
+  moved = Packet();
+  EXPECT_EQ(pool.getStats().livePackets, 0u);
+  EXPECT_EQ(pool.getStats().used, 0u);
+}
+
+// ============================================================================
+// 容量测试
+// ============================================================================
+
+TEST(PacketPoolTest, FailsWhenFullAndRecoversInFifoOrder) {
+  PacketPool pool(4096);
+  std::vector<uint8_t> data(960, 1);  // 槽位头64字节 + 960字节数据 = 1024
+  std::vector<Packet> packets;
+  for (int i = 0; i < 4; i++) {
+    packets.push_back(pool.allocate(data.data(), data.size(), i, i, false));
+    ASSERT_FALSE(packets.back().empty()) << i;
+  }
+  EXPECT_TRUE(pool.allocate(data.data(), data.size(), 4, 4, false).empty());
+  EXPECT_EQ(pool.getStats().failures, 1u);
+
+  // 释放较新的包不回收空间，释放最早的包后才能分配
+  packets[2].reset();
+  EXPECT_TRUE(pool.allocate(data.data(), data.size(), 4, 4, false).empty());
+  packets[0].reset();
+  Packet next = pool.allocate(data.data(), data.size(), 4, 4, false);
+  ASSERT_FALSE(next.empty());
+  EXPECT_EQ(next.data(), packets[1].data() - 1024);
+}
+
+TEST(PacketPoolTest, WrapsAroundWithPadding) {
+  PacketPool pool(4096);
+  std::vector<uint8_t> big(1500, 2);  // 1600字节槽位
+  Packet a = pool.allocate(big.data(), big.size(), 0, 0, false);
+  Packet b = pool.allocate(big.data(), big.size(), 1, 1, false);
+  a.reset();
+
+  // 尾部只剩896字节，新槽位回绕到开头
+  Packet c = pool.allocate(big.data(), big.size(), 2, 2, false);
+  ASSERT_FALSE(c.empty());
+  EXPECT_LT(c.data(), b.data());
+  EXPECT_EQ(pool.getStats().used, 4096u);
+
+  // 释放b后回收b和尾部填充，只剩c
+  b.reset();
+  EXPECT_EQ(pool.getStats().used, 1600u);
+  c.reset();
+  EXPECT_EQ(pool.getStats().used, 0u);
+}
+
+TEST(PacketPoolTest, OversizedPacketFails) {
+  PacketPool pool(4096);
+  std::vector<uint8_t> data(4096, 0);
+  EXPECT_TRUE(pool.allocate(data.data(), data.size(), 0, 0, false).empty());
+  EXPECT_EQ(pool.getStats().used, 0u);
+}
+
+TEST(PacketPoolTest, ReleaseFromAnotherThread) {
+  PacketPool pool(64 * 1024);
+  std::vector<uint8_t> data(200, 3);
+  for (int round = 0; round < 100; round++) {
+    std::vector<Packet> packets;
+    for (int i = 0; i < 50; i++) packets.push_back(pool.allocate(data.data(), data.size(), i, i, false));
+    std::thread releaser([batch = std::move(packets)]() mutable { batch.clear(); });
+    releaser.join();
+  }
+  EXPECT_EQ(pool.getStats().livePackets, 0u);
+  EXPECT_EQ(pool.getStats().used, 0u);
+  EXPECT_EQ(pool.getStats().failures, 0u);
+}
+
+TEST(PacketPoolTest, ConcurrentAllocateAndRelease) {
+  // 每个包分配后立即交给释放线程：释放最新的包时从tail_遍历到head_，会遇到另一线程刚预留的槽位
+  PacketPool pool(8 * 1024);
+  std::mutex mutex;
+  std::vector<Packet> shared;
+  bool finished = false;
+  size_t corrupted = 0;
+
+  std::thread releaser([&] {
+    std::vector<Packet> batch;
+    while (true) {
+      bool last;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        batch.swap(shared);
+        last = finished;
+      }
+      for (const Packet& packet : batch) {
+        if (packet.data()[0] != static_cast<uint8_t>(packet.ptsUs()) ||
+            packet.data()[packet.size() - 1] != static_cast<uint8_t>(packet.ptsUs())) {
+          corrupted++;
+        }
+      }
+      batch.clear();
+      if (last) return;
+    }
+  });
+
+  std::vector<uint8_t> data;
+  for (int i = 0; i < 50000; i++) {
+    data.assign(static_cast<size_t>(1 + i % 300), static_cast<uint8_t>(i));
+    Packet packet;
+    while ((packet = pool.allocate(data.data(), data.size(), i, i, false)).empty()) std::this_thread::yield();
+    std::lock_guard<std::mutex> lock(mutex);
+    shared.push_back(std::move(packet));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    finished = true;
+  }
+  releaser.join();
+
+  EXPECT_EQ(corrupted, 0u);
+  EXPECT_EQ(pool.getStats().livePackets, 0u);
+  EXPECT_EQ(pool.getStats().used, 0u);
+  EXPECT_EQ(pool.getStats().allocations, 50000u);
+}
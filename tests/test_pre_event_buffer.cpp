@@ -0,0 +1,249 @@
+/**
+ * @file test_pre_event_buffer.cpp
+ * @brief PreEventBuffer 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/pre_event_buffer.h"
+#include "h264_fixture.h"
+
+namespace {
+
+using camera_toolkit::testing::accessUnit;
+
+// 以15fps写入帧，每gop帧一个IDR，片数据填充帧序号加1(跳过0，全零片会形成起始码)便于核对
+void pushFrames(camera_toolkit::PreEventBuffer& buffer, int first, int count, int gop, size_t size = 100) {
+  for (int i = first; i < first + count; i++) {
+    std::vector<uint8_t> au = accessUnit(i % gop == 0, size, {i % 255 + 1});
+    camera_toolkit::EncodedFrame frame;
+    frame.buffer = camera_toolkit::Buffer(au.data(), static_cast<int>(au.size()));
+    frame.ptsUs = frame.dtsUs = i * 1000000LL / 15;
+    buffer.push(frame);
+  }
+}
+
+// 收集输出的帧序号(头信息记为-1)
+class Collector {
+ public:
+  camera_toolkit::PreEventBuffer::Sink sink() {
+    return [this](const camera_toolkit::EncodedFrame& frame) {
+      const uint8_t* data = static_cast<const uint8_t*>(frame.buffer.data);
+      std::lock_guard<std::mutex> lock(mutex_);
+      indices_.push_back((data[4] & 0x1F) == 7 ? -1 : data[5] - 1);
+    };
+  }
+
+  std::vector<int> indices() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return indices_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<int> indices_;
+};
+
+std::vector<int> range(int first, int last) {
+  std::vector<int> result;
+  for (int i = first; i <= last; i++) result.push_back(i);
+  return result;
+}
+
+}  // namespace
+
+// ============================================================================
+// 缓冲测试
+// ============================================================================
+
+TEST(PreEventBufferTest, StartsOnIdr) {
+  camera_toolkit::PreEventBuffer buffer(camera_toolkit::PreEventBufferParams{});
+  pushFrames(buffer, 1, 14, 15);
+  EXPECT_EQ(buffer.getStats().frames, 0);
+  EXPECT_EQ(buffer.getStats().dropped, 14u);
+
+  pushFrames(buffer, 15, 5, 15);
+  auto stats = buffer.getStats();
+  EXPECT_EQ(stats.frames, 5);
+  EXPECT_EQ(stats.gops, 1);
+  EXPECT_EQ(stats.bytes, 500u);
+}
+
+TEST(PreEventBufferTest, EvictsWholeGopsByDuration) {
+  camera_toolkit::PreEventBufferParams params;
+  params.durationMs = 2000;
+  camera_toolkit::PreEventBuffer buffer(params);
+  // GOP为1秒，写入5.6秒
+  pushFrames(buffer, 0, 85, 15);
+
+  auto stats = buffer.getStats();
+  // 最早的GOP从第3秒开始：再淘汰它只剩1.6秒，不足2秒
+  EXPECT_EQ(stats.gops, 3);
+  EXPECT_EQ(stats.frames, 85 - 45);
+  EXPECT_EQ(stats.evictedGops, 3u);
+  EXPECT_GE(stats.durationUs, 2000000);
+}
+
+TEST(PreEventBufferTest, PoolLimitEvictsOldestGop) {
+  camera_toolkit::PreEventBufferParams params;
+  params.poolBytes = 64 * 1024;
+  params.durationMs = 60000;
+  camera_toolkit::PreEventBuffer buffer(params);
+  // 每帧占1024字节槽位，池最多64帧
+  pushFrames(buffer, 0, 100, 10, 900);
+
+  auto stats = buffer.getStats();
+  EXPECT_EQ(stats.dropped, 0u);
+  EXPECT_LE(stats.pool.used, stats.pool.capacity);
+  EXPECT_EQ(stats.frames % 10, 0);
+  EXPECT_GT(stats.evictedGops, 0u);
+  EXPECT_EQ(stats.frames + 10 * static_cast<int>(stats.evictedGops), 100);
+}
+
+TEST(PreEventBufferTest, GopLargerThanPoolDropsUntilNextIdr) {
+  camera_toolkit::PreEventBufferParams params;
+  params.poolBytes = 16 * 1024;
+  camera_toolkit::PreEventBuffer buffer(params);
+  // 一个GOP 30帧放不下
+  pushFrames(buffer, 0, 30, 30, 900);
+  auto stats = buffer.getStats();
+  EXPECT_EQ(stats.frames, 16);
+  EXPECT_EQ(stats.dropped, 14u);
+
+  // 下一个IDR淘汰残缺的GOP后重新开始
+  pushFrames(buffer, 30, 5, 30, 900);
+  stats = buffer.getStats();
+  EXPECT_EQ(stats.frames, 5);
+  EXPECT_EQ(stats.gops, 1);
+}
+
+TEST(PreEventBufferTest, FrameLimitEvictsOldestGop) {
+  camera_toolkit::PreEventBufferParams params;
+  params.maxFrames = 25;
+  params.durationMs = 60000;
+  camera_toolkit::PreEventBuffer buffer(params);
+  pushFrames(buffer, 0, 40, 10);
+  EXPECT_EQ(buffer.getStats().frames, 20);
+  EXPECT_EQ(buffer.getStats().dropped, 0u);
+}
+
+// ============================================================================
+// 输出测试
+// ============================================================================
+
+TEST(PreEventBufferTest, DumpSendsHeadersBufferAndLiveFrames) {
+  camera_toolkit::PreEventBufferParams params;
+  params.durationMs = 1000;
+  camera_toolkit::PreEventBuffer buffer(params);
+
+  const std::vector<uint8_t> header = camera_toolkit::testing::parameterSets();
+  camera_toolkit::EncodedFrame headerFrame;
+  headerFrame.buffer = camera_toolkit::Buffer(const_cast<uint8_t*>(header.data()), static_cast<int>(header.size()));
+  EXPECT_TRUE(buffer.push(headerFrame));
+  pushFrames(buffer, 0, 40, 15);  // 保留第15帧起的GOP
+
+  Collector collector;
+  buffer.startDump(collector.sink());
+  EXPECT_TRUE(buffer.isDumping());
+  EXPECT_THROW(buffer.startDump(collector.sink()), camera_toolkit::CameraToolkitException);
+  pushFrames(buffer, 40, 5, 15);
+  buffer.stopDump();
+  EXPECT_FALSE(buffer.isDumping());
+
+  std::vector<int> expected = range(15, 44);
+  expected.insert(expected.begin(), -1);
+  EXPECT_EQ(collector.indices(), expected);
+  EXPECT_EQ(buffer.getStats().dumped, 30u);
+  EXPECT_EQ(buffer.getStats().lost, 0u);
+}
+
+TEST(PreEventBufferTest, SecondDumpSkipsFramesAlreadyDumped) {
+  camera_toolkit::PreEventBufferParams params;
+  params.durationMs = 10000;
+  camera_toolkit::PreEventBuffer buffer(params);
+  pushFrames(buffer, 0, 20, 10);
+
+  Collector first;
+  buffer.startDump(first.sink());
+  buffer.stopDump();
+  EXPECT_EQ(first.indices(), range(0, 19));
+
+  // 第二次从已输出部分之后的第一个IDR开始
+  pushFrames(buffer, 20, 15, 10);
+  Collector second;
+  buffer.startDump(second.sink());
+  buffer.stopDump();
+  EXPECT_EQ(second.indices(), range(20, 34));
+
+  // 中途开始的GOP被跳过
+  pushFrames(buffer, 35, 10, 10);
+  Collector third;
+  buffer.startDump(third.sink());
+  buffer.stopDump();
+  EXPECT_EQ(third.indices(), range(40, 44));
+}
+
+TEST(PreEventBufferTest, SlowSinkDoesNotBlockPush) {
+  camera_toolkit::PreEventBufferParams params;
+  params.durationMs = 500;
+  params.maxFrames = 64;
+  camera_toolkit::PreEventBuffer buffer(params);
+  pushFrames(buffer, 0, 15, 5);
+
+  std::vector<int> seen;
+  buffer.startDump([&seen](const camera_toolkit::EncodedFrame& frame) {
+    seen.push_back(static_cast<const uint8_t*>(frame.buffer.data)[5] - 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  pushFrames(buffer, 15, 200, 5);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+  buffer.stopDump();
+
+  auto stats = buffer.getStats();
+  EXPECT_GT(stats.lost, 0u);
+  EXPECT_EQ(stats.dumped, seen.size());
+  // 丢失后总是从IDR帧(序号为5的倍数)恢复，每段内连续
+  for (size_t i = 1; i < seen.size(); i++) {
+    if (seen[i] != static_cast<uint8_t>(seen[i - 1] + 1)) {
+      EXPECT_EQ(seen[i] % 5, 0) << i;
+    }
+  }
+}
+
+TEST(PreEventBufferTest, DumpThreadReleasesWhilePushAllocates) {
+  // GOP比内存池大：每个IDR帧淘汰全部缓冲后重新分配，此时只剩输出线程手中的包，
+  // 它们被释放时从最早的槽位一直回收到写入线程刚分配的槽位
+  camera_toolkit::PreEventBufferParams params;
+  params.poolBytes = 8 * 1024;
+  camera_toolkit::PreEventBuffer buffer(params);
+
+  int corrupted = 0;
+  size_t seen = 0;
+  buffer.startDump([&](const camera_toolkit::EncodedFrame& frame) {
+    const uint8_t* data = static_cast<const uint8_t*>(frame.buffer.data);
+    for (int i = 5; i < frame.buffer.size; i++) {
+      if (data[i] != data[5]) {
+        corrupted++;
+        break;
+      }
+    }
+    seen++;
+    if (seen % 16 == 0) std::this_thread::yield();  // 让一批包在写入线程淘汰缓冲时仍在输出线程手中
+  });
+  for (int i = 0; i < 20000; i++) pushFrames(buffer, i, 1, 40, 300);
+  buffer.stopDump();
+
+  auto stats = buffer.getStats();
+  EXPECT_EQ(corrupted, 0);
+  EXPECT_EQ(stats.dumped, seen);
+  EXPECT_GT(stats.evictedGops, 0u);
+  EXPECT_EQ(stats.pool.livePackets, static_cast<size_t>(stats.frames));
+}
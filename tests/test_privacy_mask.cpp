@@ -0,0 +1,214 @@
+/**
+ * @file test_privacy_mask.cpp
+ * @brief PrivacyMask 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "camera_toolkit/privacy_mask.h"
+#include "yuv_fixture.h"
+
+namespace {
+
+using camera_toolkit::testing::noiseFrame;
+using camera_toolkit::testing::toNv12;
+
+constexpr int kWidth = 96;
+constexpr int kHeight = 64;
+constexpr int kYSize = kWidth * kHeight;
+constexpr int kCWidth = kWidth / 2;
+constexpr int kCSize = kCWidth * (kHeight / 2);
+
+camera_toolkit::PrivacyMaskParams makeParams(std::vector<camera_toolkit::MaskRegion> regions,
+                                             camera_toolkit::MaskMode mode = camera_toolkit::MaskMode::Fill) {
+  camera_toolkit::PrivacyMaskParams params;
+  params.videoWidth = kWidth;
+  params.videoHeight = kHeight;
+  params.mode = mode;
+  params.regions = std::move(regions);
+  return params;
+}
+
+// 参考实现: 像素中心是否在多边形内(奇偶规则)
+bool inside(const std::vector<camera_toolkit::MaskPoint>& poly, double x, double y) {
+  bool in = false;
+  for (size_t i = 0, j = poly.size() - 1; i < poly.size(); j = i++) {
+    const auto& p = poly[i];
+    const auto& q = poly[j];
+    if ((p.y <= y) != (q.y <= y) && x < p.x + (y - p.y) * (q.x - p.x) / static_cast<double>(q.y - p.y)) in = !in;
+  }
+  return in;
+}
+
+}  // namespace
+
+// ============================================================================
+// 参数测试
+// ============================================================================
+
+TEST(PrivacyMaskTest, InvalidParamsThrow) {
+  auto params = makeParams({camera_toolkit::MaskRegion::rectangle(0, 0, 4, 4)});
+  params.blockSize = 7;
+  EXPECT_THROW(camera_toolkit::PrivacyMask{params}, camera_toolkit::CameraToolkitException);
+
+  params = makeParams({camera_toolkit::MaskRegion{{{0, 0}, {4, 4}}}});
+  EXPECT_THROW(camera_toolkit::PrivacyMask{params}, camera_toolkit::CameraToolkitException);
+
+  params = makeParams({});
+  params.pixelFormat = camera_toolkit::PixelFormat::YUYV;
+  EXPECT_THROW(camera_toolkit::PrivacyMask{params}, camera_toolkit::CameraToolkitException);
+}
+
+// ============================================================================
+// 纯色填充测试
+// ============================================================================
+
+TEST(PrivacyMaskTest, RectangleFillCoversExactPixels) {
+  camera_toolkit::PrivacyMask mask(makeParams({camera_toolkit::MaskRegion::rectangle(5, 7, 20, 9)}));
+  auto frame = noiseFrame(kWidth, kHeight, 1);
+  auto original = frame;
+  mask.apply(frame.data());
+
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      bool masked = x >= 5 && x < 25 && y >= 7 && y < 16;
+      ASSERT_EQ(frame[y * kWidth + x], masked ? 16 : original[y * kWidth + x]) << x << "," << y;
+    }
+  }
+  // 色度覆盖所有接触遮挡像素的样本: 亮度[5, 25) x [7, 16) -> 色度[2, 13) x [3, 8)
+  for (int y = 0; y < kHeight / 2; ++y) {
+    for (int x = 0; x < kCWidth; ++x) {
+      bool masked = x >= 2 && x < 13 && y >= 3 && y < 8;
+      int i = kYSize + y * kCWidth + x;
+      ASSERT_EQ(frame[i], masked ? 128 : original[i]) << x << "," << y;
+      ASSERT_EQ(frame[i + kCSize], masked ? 128 : original[i + kCSize]) << x << "," << y;
+    }
+  }
+}
+
+TEST(PrivacyMaskTest, PolygonMatchesPointInPolygon) {
+  // 凹多边形，部分超出帧
+  camera_toolkit::MaskRegion region;
+  region.polygon = {{-10, 5}, {60, 0}, {40, 30}, {90, 70}, {10, 50}};
+  camera_toolkit::PrivacyMask mask(makeParams({region}));
+
+  std::vector<uint8_t> frame(kYSize + 2 * kCSize, 200);
+  mask.apply(frame.data());
+
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      bool masked = inside(region.polygon, x + 0.5, y + 0.5);
+      ASSERT_EQ(frame[y * kWidth + x], masked ? 16 : 200) << x << "," << y;
+    }
+  }
+}
+
+TEST(PrivacyMaskTest, RegionsOutsideFrameAreClipped) {
+  camera_toolkit::PrivacyMask mask(makeParams({camera_toolkit::MaskRegion::rectangle(-20, -20, 30, 30),
+                                               camera_toolkit::MaskRegion::rectangle(kWidth - 3, kHeight - 3, 50, 50)},
+                                              camera_toolkit::MaskMode::Pixelate));
+
+  std::vector<uint8_t> buffer(kYSize + 2 * kCSize + 128, 0xAB);
+  uint8_t* frame = buffer.data() + 64;
+  auto noise = noiseFrame(kWidth, kHeight, 3);
+  std::copy(noise.begin(), noise.end(), frame);
+  mask.apply(frame);
+
+  for (int i = 0; i < 64; ++i) {
+    EXPECT_EQ(buffer[i], 0xAB);
+    EXPECT_EQ(buffer[buffer.size() - 1 - i], 0xAB);
+  }
+}
+
+// ============================================================================
+// 马赛克测试
+// ============================================================================
+
+TEST(PrivacyMaskTest, PixelateFillsBlockAverage) {
+  auto params = makeParams({camera_toolkit::MaskRegion::rectangle(20, 10, 30, 20)}, camera_toolkit::MaskMode::Pixelate);
+  params.blockSize = 8;
+  camera_toolkit::PrivacyMask mask(params);
+
+  auto frame = noiseFrame(kWidth, kHeight, 5);
+  auto original = frame;
+  mask.apply(frame.data());
+
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      bool masked = x >= 20 && x < 50 && y >= 10 && y < 30;
+      if (!masked) {
+        ASSERT_EQ(frame[y * kWidth + x], original[y * kWidth + x]);
+        continue;
+      }
+      // 平均值取整块(包括块内未遮挡的像素)
+      int bx = x / 8 * 8;
+      int by = y / 8 * 8;
+      int sum = 0;
+      for (int j = by; j < by + 8; ++j) {
+        for (int i = bx; i < bx + 8; ++i) sum += original[j * kWidth + i];
+      }
+      ASSERT_EQ(frame[y * kWidth + x], (sum + 32) / 64) << x << "," << y;
+    }
+  }
+}
+
+TEST(PrivacyMaskTest, Nv12MatchesI420) {
+  std::vector<camera_toolkit::MaskRegion> regions = {camera_toolkit::MaskRegion::rectangle(3, 3, 41, 17),
+                                                     {{{50, 10}, {90, 20}, {70, 60}}}};
+  for (auto mode : {camera_toolkit::MaskMode::Fill, camera_toolkit::MaskMode::Pixelate}) {
+    auto params = makeParams(regions, mode);
+    params.fillU = 90;
+    params.fillV = 240;
+    camera_toolkit::PrivacyMask a(params);
+    params.pixelFormat = camera_toolkit::PixelFormat::NV12;
+    camera_toolkit::PrivacyMask b(params);
+
+    auto i420 = noiseFrame(kWidth, kHeight, 7);
+    auto nv12 = toNv12(i420, kWidth, kHeight);
+    a.apply(i420.data());
+    b.apply(nv12.data());
+    EXPECT_EQ(toNv12(i420, kWidth, kHeight), nv12) << static_cast<int>(mode);
+  }
+}
+
+TEST(PrivacyMaskTest, StridedFrameMatchesContiguous) {
+  auto params = makeParams({camera_toolkit::MaskRegion::rectangle(30, 20, 40, 30)}, camera_toolkit::MaskMode::Pixelate);
+  camera_toolkit::PrivacyMask mask(params);
+
+  auto contiguous = noiseFrame(kWidth, kHeight, 9);
+  constexpr int kPad = 16;
+  std::vector<uint8_t> y((kWidth + kPad) * kHeight, 0xAB);
+  std::vector<uint8_t> uv((kCWidth + kPad) * kHeight, 0xAB);
+  camera_toolkit::FrameView frame;
+  frame.planes[0] = y.data();
+  frame.planes[1] = uv.data();
+  frame.planes[2] = uv.data() + (kCWidth + kPad) * (kHeight / 2);
+  frame.strides[0] = kWidth + kPad;
+  frame.strides[1] = frame.strides[2] = kCWidth + kPad;
+  frame.width = kWidth;
+  frame.height = kHeight;
+  for (int r = 0; r < kHeight; ++r) {
+    std::copy_n(&contiguous[r * kWidth], kWidth, &y[r * frame.strides[0]]);
+  }
+  for (int r = 0; r < kHeight / 2; ++r) {
+    std::copy_n(&contiguous[kYSize + r * kCWidth], kCWidth, frame.planes[1] + r * frame.strides[1]);
+    std::copy_n(&contiguous[kYSize + kCSize + r * kCWidth], kCWidth, frame.planes[2] + r * frame.strides[2]);
+  }
+
+  mask.apply(frame);
+  camera_toolkit::PrivacyMask(params).apply(contiguous.data());
+
+  for (int r = 0; r < kHeight; ++r) {
+    for (int x = 0; x < frame.strides[0]; ++x) {
+      ASSERT_EQ(y[r * frame.strides[0] + x], x < kWidth ? contiguous[r * kWidth + x] : 0xAB);
+    }
+  }
+  for (int r = 0; r < kHeight / 2; ++r) {
+    for (int x = 0; x < kCWidth; ++x) {
+      ASSERT_EQ(frame.planes[1][r * frame.strides[1] + x], contiguous[kYSize + r * kCWidth + x]);
+      ASSERT_EQ(frame.planes[2][r * frame.strides[2] + x], contiguous[kYSize + kCSize + r * kCWidth + x]);
+    }
+  }
+}
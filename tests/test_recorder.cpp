@@ -0,0 +1,284 @@
+/**
+ * @file test_recorder.cpp
+ * @brief Recorder 单元测试
+ */
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "camera_toolkit/recorder.h"
+#include "h264_fixture.h"
+
+namespace {
+
+using camera_toolkit::testing::accessUnit;
+using camera_toolkit::testing::SPS;
+
+// 与编码器输出一致：每帧以AUD开头，IDR帧前带SPS、PPS
+const camera_toolkit::testing::AccessUnitOptions ENCODER_OUTPUT = {0x5A, true, true};
+
+// 在临时目录下录像，测试结束时删除
+class TempDir {
+ public:
+  TempDir() {
+    char dirTemplate[] = "/tmp/ck_recXXXXXX";
+    dir_ = mkdtemp(dirTemplate);
+  }
+
+  ~TempDir() { std::system(("rm -rf " + dir_).c_str()); }
+
+  const std::string& path() const { return dir_; }
+
+  std::string segment(int index) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/rec-%06d.mp4", index);
+    return dir_ + name;
+  }
+
+ private:
+  std::string dir_;
+};
+
+std::vector<uint8_t> readFile(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+uint32_t be32(const std::vector<uint8_t>& data, size_t pos) {
+  return static_cast<uint32_t>(data[pos]) << 24 | data[pos + 1] << 16 | data[pos + 2] << 8 | data[pos + 3];
+}
+
+uint64_t be64(const std::vector<uint8_t>& data, size_t pos) {
+  return static_cast<uint64_t>(be32(data, pos)) << 32 | be32(data, pos + 4);
+}
+
+struct Box {
+  std::string type;
+  size_t offset;
+  size_t size;
+};
+
+// 列出[begin, end)范围内的box
+std::vector<Box> boxes(const std::vector<uint8_t>& data, size_t begin, size_t end) {
+  std::vector<Box> result;
+  while (begin + 8 <= end) {
+    Box box{std::string(data.begin() + begin + 4, data.begin() + begin + 8), begin, be32(data, begin)};
+    if (box.size < 8 || begin + box.size > end) break;
+    result.push_back(box);
+    begin += box.size;
+  }
+  return result;
+}
+
+// 按路径查找子box(容器box的子box从头部之后开始)
+Box find(const std::vector<uint8_t>& data, const Box& parent, const std::string& type) {
+  for (const Box& box : boxes(data, parent.offset + 8, parent.offset + parent.size)) {
+    if (box.type == type) return box;
+  }
+  return Box{"", 0, 0};
+}
+
+std::string topLevel(const std::vector<uint8_t>& data) {
+  std::string types;
+  for (const Box& box : boxes(data, 0, data.size())) types += box.type + " ";
+  return types;
+}
+
+camera_toolkit::RecorderParams params(const TempDir& dir) {
+  camera_toolkit::RecorderParams p;
+  p.directory = dir.path();
+  p.prefix = "rec";
+  p.segmentDurationMs = 0;
+  return p;
+}
+
+// 以15fps写入帧，每gop帧一个IDR
+void writeFrames(camera_toolkit::Recorder& recorder, int first, int count, int gop) {
+  for (int i = first; i < first + count; ++i) {
+    std::vector<uint8_t> au = accessUnit(i % gop == 0, 204 + i, ENCODER_OUTPUT);
+    camera_toolkit::EncodedFrame frame;
+    frame.buffer = camera_toolkit::Buffer(au.data(), static_cast<int>(au.size()));
+    frame.ptsUs = frame.dtsUs = i * 1000000LL / 15;
+    recorder.write(frame);
+  }
+}
+
+}  // namespace
+
+// ============================================================================
+// 封装测试
+// ============================================================================
+
+TEST(RecorderTest, WritesInitSegmentAndFragments) {
+  TempDir dir;
+  camera_toolkit::Recorder recorder(params(dir));
+  writeFrames(recorder, 0, 30, 1000);
+  EXPECT_EQ(recorder.getSegmentPath(), dir.segment(1));
+  recorder.close();
+  EXPECT_EQ(recorder.getSegmentPath(), "");
+
+  std::vector<uint8_t> data = readFile(dir.segment(1));
+  ASSERT_EQ(topLevel(data), "ftyp moov moof mdat moof mdat ");
+  std::vector<Box> top = boxes(data, 0, data.size());
+
+  // avcC中的参数集
+  Box stsd = find(data, find(data, find(data, find(data, find(data, top[1], "trak"), "mdia"), "minf"), "stbl"), "stsd");
+  ASSERT_GT(stsd.size, 0u);
+  Box avc1 = boxes(data, stsd.offset + 16, stsd.offset + stsd.size)[0];
+  EXPECT_EQ(avc1.type, "avc1");
+  Box avcC = boxes(data, avc1.offset + 86, avc1.offset + avc1.size)[0];
+  EXPECT_EQ(avcC.type, "avcC");
+  EXPECT_EQ(data[avcC.offset + 9], 0x64);
+  EXPECT_EQ(std::vector<uint8_t>(data.begin() + avcC.offset + 16, data.begin() + avcC.offset + 16 + SPS.size()), SPS);
+
+  // 第一个片段为1秒内的15帧，首帧为同步样本
+  Box traf = find(data, top[2], "traf");
+  Box tfdt = find(data, traf, "tfdt");
+  EXPECT_EQ(be64(data, tfdt.offset + 12), 0u);
+  Box trun = find(data, traf, "trun");
+  EXPECT_EQ(be32(data, trun.offset + 12), 15u);
+  EXPECT_EQ(be32(data, trun.offset + 16), top[2].size + 8);  // data_offset指向mdat数据
+  EXPECT_EQ(be32(data, trun.offset + 20), 6000u);            // 时长
+  EXPECT_EQ(be32(data, trun.offset + 28), 0x02000000u);      // 同步样本
+  EXPECT_EQ(be32(data, trun.offset + 20 + 16 + 8), 0x01010000u);
+
+  // mdat中为长度前缀的切片，不含AUD和参数集
+  size_t mdat = top[3].offset + 8;
+  EXPECT_EQ(be32(data, mdat), 200u);
+  EXPECT_EQ(data[mdat + 4], 0x65);
+  EXPECT_EQ(be32(data, trun.offset + 24), 204u);
+
+  Box tfdt2 = find(data, find(data, top[4], "traf"), "tfdt");
+  EXPECT_EQ(be64(data, tfdt2.offset + 12), 90000u);
+
+  auto stats = recorder.getStats();
+  EXPECT_EQ(stats.segments, 1u);
+  EXPECT_EQ(stats.fragments, 2u);
+  EXPECT_EQ(stats.frames, 30u);
+  EXPECT_EQ(stats.bytes, data.size());
+}
+
+TEST(RecorderTest, SkipsFramesBeforeFirstIdr) {
+  TempDir dir;
+  camera_toolkit::Recorder recorder(params(dir));
+  writeFrames(recorder, 1, 14, 15);  // 全部为P帧
+  EXPECT_EQ(recorder.getSegmentPath(), "");
+  writeFrames(recorder, 15, 5, 15);
+  recorder.close();
+
+  EXPECT_EQ(recorder.getStats().skipped, 14u);
+  std::vector<uint8_t> data = readFile(dir.segment(1));
+  std::vector<Box> top = boxes(data, 0, data.size());
+  ASSERT_EQ(top.size(), 4u);
+  // 文件内时间从首个IDR开始
+  EXPECT_EQ(be64(data, find(data, find(data, top[2], "traf"), "tfdt").offset + 12), 0u);
+}
+
+TEST(RecorderTest, CompositionOffsetsForReorderedFrames) {
+  TempDir dir;
+  camera_toolkit::Recorder recorder(params(dir));
+  // 解码顺序 I P B，显示顺序 I B P
+  const int64_t pts[3] = {66666, 200000, 133333};
+  const int64_t dts[3] = {0, 66666, 133333};
+  for (int i = 0; i < 3; ++i) {
+    std::vector<uint8_t> au = accessUnit(i == 0, 104, ENCODER_OUTPUT);
+    camera_toolkit::EncodedFrame frame;
+    frame.buffer = camera_toolkit::Buffer(au.data(), static_cast<int>(au.size()));
+    frame.ptsUs = pts[i];
+    frame.dtsUs = dts[i];
+    recorder.write(frame);
+  }
+  recorder.close();
+
+  std::vector<uint8_t> data = readFile(dir.segment(1));
+  Box trun = find(data, find(data, boxes(data, 0, data.size())[2], "traf"), "trun");
+  EXPECT_EQ(be32(data, trun.offset + 12), 3u);
+  EXPECT_EQ(be32(data, trun.offset + 20 + 12), 6000u);   // I
+  EXPECT_EQ(be32(data, trun.offset + 36 + 12), 12000u);  // P
+  EXPECT_EQ(be32(data, trun.offset + 52 + 12), 0u);      // B
+}
+
+// ============================================================================
+// 分段测试
+// ============================================================================
+
+TEST(RecorderTest, RotatesOnIdrAfterDuration) {
+  TempDir dir;
+  camera_toolkit::RecorderParams p = params(dir);
+  p.segmentDurationMs = 1000;
+  camera_toolkit::Recorder recorder(p);
+  // IDR在第0、10、20、30帧，第20帧(1.33秒)处已超过1秒
+  writeFrames(recorder, 0, 40, 10);
+  recorder.close();
+
+  EXPECT_EQ(recorder.getStats().segments, 2u);
+  for (int i = 1; i <= 2; ++i) {
+    std::vector<uint8_t> data = readFile(dir.segment(i));
+    std::vector<Box> top = boxes(data, 0, data.size());
+    ASSERT_GE(top.size(), 4u) << i;
+    EXPECT_EQ(top[0].type, "ftyp");
+    EXPECT_EQ(top[1].type, "moov");
+    Box traf = find(data, top[2], "traf");
+    EXPECT_EQ(be64(data, find(data, traf, "tfdt").offset + 12), 0u);
+    EXPECT_EQ(be32(data, find(data, traf, "trun").offset + 28), 0x02000000u);
+  }
+  // 第一个文件有两个GOP，第二个文件有两个GOP
+  EXPECT_EQ(topLevel(readFile(dir.segment(1))), "ftyp moov moof mdat moof mdat ");
+  EXPECT_EQ(topLevel(readFile(dir.segment(2))), "ftyp moov moof mdat moof mdat ");
+}
+
+TEST(RecorderTest, RotatesOnIdrAfterSize) {
+  TempDir dir;
+  camera_toolkit::RecorderParams p = params(dir);
+  p.segmentBytes = 1;
+  camera_toolkit::Recorder recorder(p);
+  writeFrames(recorder, 0, 40, 10);
+  recorder.close();
+
+  EXPECT_EQ(recorder.getStats().segments, 4u);
+  EXPECT_EQ(access(dir.segment(4).c_str(), F_OK), 0);
+  EXPECT_NE(access(dir.segment(5).c_str(), F_OK), 0);
+}
+
+TEST(RecorderTest, IndexPointsAtFragments) {
+  TempDir dir;
+  camera_toolkit::RecorderParams p = params(dir);
+  p.fragmentDurationMs = 500;
+  camera_toolkit::Recorder recorder(p);
+  writeFrames(recorder, 0, 45, 15);
+  recorder.close();
+
+  std::vector<uint8_t> data = readFile(dir.segment(1));
+  std::ifstream index(dir.segment(1) + ".idx");
+  std::string line;
+  std::getline(index, line);
+  EXPECT_EQ(line[0], '#');
+
+  int fragments = 0;
+  int syncs = 0;
+  uint64_t end = 0;
+  while (std::getline(index, line)) {
+    std::istringstream fields(line);
+    int64_t ptsUs;
+    uint64_t offset, size;
+    int sync;
+    fields >> ptsUs >> offset >> size >> sync;
+    ASSERT_LT(offset + 8, data.size());
+    EXPECT_EQ(std::string(data.begin() + offset + 4, data.begin() + offset + 8), "moof");
+    EXPECT_EQ(ptsUs % 1000000 == 0, sync == 1) << line;
+    end = offset + size;
+    fragments++;
+    syncs += sync;
+  }
+  // 每个GOP(1秒)分为0.5秒的两个片段
+  EXPECT_EQ(fragments, 6);
+  EXPECT_EQ(syncs, 3);
+  EXPECT_EQ(end, data.size());
+}
@@ -0,0 +1,342 @@
+/**
+ * @file test_stream_server.cpp
+ * @brief StreamServer 单元测试
+ */
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/stream_server.h"
+#include "h264_fixture.h"
+
+namespace {
+
+using camera_toolkit::testing::accessUnit;
+
+// 以15fps写入帧，每gop帧一个IDR(前带SPS/PPS)，片数据填充帧序号
+void writeFrames(camera_toolkit::StreamServer& server, int first, int count, int gop, size_t size = 200) {
+  for (int i = first; i < first + count; i++) {
+    std::vector<uint8_t> au = accessUnit(i % gop == 0, size, {i, true});
+    camera_toolkit::EncodedFrame frame;
+    frame.buffer = camera_toolkit::Buffer(au.data(), static_cast<int>(au.size()));
+    frame.ptsUs = frame.dtsUs = i * 1000000LL / 15;
+    server.write(frame);
+  }
+}
+
+uint32_t read32(const std::vector<uint8_t>& data, size_t offset) {
+  return static_cast<uint32_t>(data[offset]) << 24 | data[offset + 1] << 16 | data[offset + 2] << 8 | data[offset + 3];
+}
+
+std::string boxType(const std::vector<uint8_t>& data, size_t offset) {
+  return std::string(data.begin() + static_cast<std::ptrdiff_t>(offset + 4),
+                     data.begin() + static_cast<std::ptrdiff_t>(offset + 8));
+}
+
+// HTTP客户端：发送请求，解析响应头和分块
+class Client {
+ public:
+  Client(int port, const std::string& request, int receiveBuffer = 0) {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    struct timeval tv{};
+    tv.tv_sec = 2;
+    setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (receiveBuffer > 0) setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0) {
+      send(fd_, request.data(), request.size(), MSG_NOSIGNAL);
+    }
+  }
+
+  ~Client() { close(fd_); }
+
+  // 读取响应头
+  std::string header() {
+    size_t end;
+    while ((end = data_.find("\r\n\r\n")) == std::string::npos) {
+      if (!fill()) return std::string();
+    }
+    std::string result = data_.substr(0, end + 4);
+    data_.erase(0, end + 4);
+    return result;
+  }
+
+  // 读取一个分块的内容，超时或连接关闭返回空
+  std::vector<uint8_t> chunk() {
+    size_t line;
+    while ((line = data_.find("\r\n")) == std::string::npos) {
+      if (!fill()) return {};
+    }
+    const size_t size = std::stoul(data_.substr(0, line), nullptr, 16);
+    while (data_.size() < line + 2 + size + 2) {
+      if (!fill()) return {};
+    }
+    EXPECT_EQ(data_.substr(line + 2 + size, 2), "\r\n");
+    std::vector<uint8_t> body(data_.begin() + static_cast<std::ptrdiff_t>(line + 2),
+                              data_.begin() + static_cast<std::ptrdiff_t>(line + 2 + size));
+    data_.erase(0, line + 2 + size + 2);
+    return body;
+  }
+
+  // 读取到连接关闭为止
+  std::string rest() {
+    while (fill()) {
+    }
+    return data_;
+  }
+
+ private:
+  bool fill() {
+    char buffer[65536];
+    const ssize_t n = read(fd_, buffer, sizeof(buffer));
+    if (n <= 0) return false;
+    data_.append(buffer, static_cast<size_t>(n));
+    return true;
+  }
+
+  int fd_ = -1;
+  std::string data_;
+};
+
+std::string get(const std::string& path) { return "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n"; }
+
+camera_toolkit::StreamServerParams loopbackParams() {
+  camera_toolkit::StreamServerParams params;
+  params.address = "127.0.0.1";
+  params.port = 0;
+  return params;
+}
+
+// 等待服务线程处理完连接请求
+void waitViewers(const camera_toolkit::StreamServer& server, int count) {
+  for (int i = 0; i < 200 && server.getStats().viewers < count; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_EQ(server.getStats().viewers, count);
+}
+
+}  // namespace
+
+// ============================================================================
+// 请求测试
+// ============================================================================
+
+TEST(StreamServerTest, InvalidParamsThrow) {
+  camera_toolkit::StreamServerParams params = loopbackParams();
+  params.path = "live.mp4";
+  EXPECT_THROW(camera_toolkit::StreamServer server(params), camera_toolkit::CameraToolkitException);
+  params = loopbackParams();
+  params.address = "not-an-address";
+  EXPECT_THROW(camera_toolkit::StreamServer server(params), camera_toolkit::NetworkException);
+}
+
+TEST(StreamServerTest, RejectsOtherPathsAndMethods) {
+  camera_toolkit::StreamServer server(loopbackParams());
+  Client notFound(server.getPort(), get("/other.mp4"));
+  EXPECT_EQ(notFound.rest().rfind("HTTP/1.1 404 Not Found\r\n", 0), 0u);
+  Client notAllowed(server.getPort(), "POST /live.mp4 HTTP/1.1\r\n\r\n");
+  EXPECT_EQ(notAllowed.rest().rfind("HTTP/1.1 405 Method Not Allowed\r\n", 0), 0u);
+  Client head(server.getPort(), "HEAD /live.mp4 HTTP/1.1\r\n\r\n");
+  const std::string response = head.rest();
+  EXPECT_NE(response.find("Content-Type: video/mp4\r\n"), std::string::npos);
+  EXPECT_EQ(response.size(), response.find("\r\n\r\n") + 4);
+  EXPECT_EQ(server.getStats().viewers, 0);
+}
+
+// ============================================================================
+// 推流测试
+// ============================================================================
+
+TEST(StreamServerTest, StreamsInitSegmentAndOneFragmentPerFrame) {
+  camera_toolkit::StreamServer server(loopbackParams());
+  Client client(server.getPort(), get("/live.mp4?t=1"));
+  const std::string header = client.header();
+  EXPECT_EQ(header.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+  EXPECT_NE(header.find("Transfer-Encoding: chunked\r\n"), std::string::npos);
+  waitViewers(server, 1);
+
+  // IDR之前的帧被跳过
+  writeFrames(server, 1, 2, 15);
+  writeFrames(server, 15, 3, 15);
+
+  const std::vector<uint8_t> init = client.chunk();
+  ASSERT_GE(init.size(), 16u);
+  EXPECT_EQ(boxType(init, 0), "ftyp");
+  EXPECT_EQ(boxType(init, read32(init, 0)), "moov");
+
+  for (int i = 15; i < 18; i++) {
+    const std::vector<uint8_t> fragment = client.chunk();
+    ASSERT_GT(fragment.size(), 100u) << i;
+    EXPECT_EQ(boxType(fragment, 0), "moof");
+    EXPECT_EQ(read32(fragment, 20), static_cast<uint32_t>(i - 14));  // mfhd序号
+    const uint32_t moof = read32(fragment, 0);
+    EXPECT_EQ(boxType(fragment, moof), "mdat");
+
+    // mdat为4字节长度前缀的NAL，参数集不在样本中
+    std::vector<uint8_t> expected = {0, 0, 0, 196, static_cast<uint8_t>(i == 15 ? 0x65 : 0x41)};
+    expected.resize(200, static_cast<uint8_t>(i));
+    EXPECT_EQ(std::vector<uint8_t>(fragment.begin() + moof + 8, fragment.end()), expected);
+  }
+  EXPECT_EQ(server.getStats().frames, 3u);
+}
+
+TEST(StreamServerTest, LateViewerStartsAtCurrentGop) {
+  camera_toolkit::StreamServer server(loopbackParams());
+  writeFrames(server, 0, 25, 10);
+
+  Client client(server.getPort(), get("/live.mp4"));
+  client.header();
+  EXPECT_EQ(boxType(client.chunk(), 0), "ftyp");
+  // 当前GOP从第20帧开始
+  for (uint32_t sequence = 21; sequence <= 25; sequence++) {
+    const std::vector<uint8_t> fragment = client.chunk();
+    ASSERT_FALSE(fragment.empty());
+    EXPECT_EQ(read32(fragment, 20), sequence);
+  }
+  waitViewers(server, 1);
+  writeFrames(server, 25, 1, 10);
+  EXPECT_EQ(read32(client.chunk(), 20), 26u);
+}
+
+TEST(StreamServerTest, ViewersShareFragments) {
+  camera_toolkit::StreamServer server(loopbackParams());
+  std::vector<std::unique_ptr<Client>> clients;
+  for (int i = 0; i < 50; i++) clients.push_back(std::make_unique<Client>(server.getPort(), get("/live.mp4")));
+  waitViewers(server, 50);
+  writeFrames(server, 0, 30, 15, 1000);
+
+  for (auto& client : clients) {
+    client->header();
+    client->chunk();
+    for (int i = 0; i < 30; i++) ASSERT_EQ(read32(client->chunk(), 20), static_cast<uint32_t>(i + 1));
+  }
+
+  // 每帧只在内存池中保存一份：剩下的只有当前GOP
+  auto stats = server.getStats();
+  EXPECT_EQ(stats.pool.livePackets, 15u);
+  EXPECT_EQ(stats.pool.allocations, 30u);
+  EXPECT_GT(stats.bytesSent, 50u * 30u * 1000u);
+  clients.clear();
+  for (int i = 0; i < 200 && server.getStats().viewers > 0; i++) {
+    writeFrames(server, 30, 1, 15);  // 写入失败后才能发现对端关闭
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(server.getStats().viewers, 0);
+}
+
+TEST(StreamServerTest, SlowViewerSkipsToNextIdr) {
+  camera_toolkit::StreamServerParams params = loopbackParams();
+  params.maxQueueBytes = 64 * 1024;
+  params.sendBufferSize = 16 * 1024;
+  camera_toolkit::StreamServer server(params);
+  Client slow(server.getPort(), get("/live.mp4"), 4096);
+  waitViewers(server, 1);
+
+  // 不读取时积压超限，丢弃到下一个IDR帧
+  writeFrames(server, 0, 300, 30, 8000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_GT(server.getStats().overflows, 0u);
+
+  // 开始读取，积压的片段读完后再写入一个GOP，应完整收到
+  uint32_t previous = 0;
+  int gaps = 0;
+  std::thread reader([&]() {
+    slow.header();
+    slow.chunk();
+    while (true) {
+      const std::vector<uint8_t> fragment = slow.chunk();
+      if (fragment.empty()) break;
+      const uint32_t sequence = read32(fragment, 20);
+      if (previous != 0 && sequence != previous + 1) {
+        // 跳过后总是从IDR帧(序号减1为30的倍数)继续
+        EXPECT_EQ((sequence - 1) % 30, 0u) << sequence;
+        gaps++;
+      }
+      previous = sequence;
+      if (sequence == 330) break;
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  writeFrames(server, 300, 30, 30, 1000);
+  reader.join();
+  EXPECT_GT(gaps, 0);
+  EXPECT_EQ(previous, 330u);
+}
+
+TEST(StreamServerTest, StalledViewerDoesNotPinPool) {
+  camera_toolkit::StreamServerParams params = loopbackParams();
+  params.poolBytes = 256 * 1024;
+  params.maxQueueBytes = 32 * 1024;
+  params.sendBufferSize = 4096;
+  camera_toolkit::StreamServer server(params);
+  Client stalled(server.getPort(), get("/live.mp4"), 4096);
+  waitViewers(server, 1);
+
+  // 观看者不读取，发送到一半的队首片段不能一直占住先进先出的内存池
+  for (int i = 0; i < 300; i++) {
+    writeFrames(server, i, 1, 30, 8000);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto stats = server.getStats();
+  EXPECT_GT(stats.overflows, 0u);
+  EXPECT_EQ(stats.dropped, 0u);
+  EXPECT_EQ(stats.pool.failures, 0u);
+}
+
+TEST(StreamServerTest, ConcurrentWriteAndRelease) {
+  // 服务线程发送后释放片段的同时写入线程在小内存池中不断分配，池多次回绕
+  camera_toolkit::StreamServerParams params = loopbackParams();
+  params.poolBytes = 128 * 1024;
+  params.maxQueueBytes = 32 * 1024;
+  camera_toolkit::StreamServer server(params);
+  Client client(server.getPort(), get("/live.mp4"));
+  waitViewers(server, 1);
+
+  std::atomic<uint32_t> last{UINT32_MAX};
+  uint32_t previous = 0;
+  int corrupted = 0;
+  std::thread reader([&]() {
+    client.header();
+    client.chunk();
+    while (previous < last.load()) {
+      const std::vector<uint8_t> fragment = client.chunk();
+      if (fragment.empty()) break;
+      previous = read32(fragment, 20);
+      // 访问单元末尾填充的都是帧序号
+      for (size_t i = fragment.size() - 100; i < fragment.size(); i++) {
+        if (fragment[i] != fragment.back()) {
+          corrupted++;
+          break;
+        }
+      }
+    }
+  });
+  for (int i = 0; i < 2000; i++) {
+    if (i % 256 == 0) continue;  // 全零的填充会被当作起始码
+    writeFrames(server, i, 1, 10, 1000);
+    if (i % 10 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+  // 读取方收到最后写入的IDR帧后结束
+  last = static_cast<uint32_t>(server.getStats().frames) + 1;
+  writeFrames(server, 2000, 1, 10, 1000);
+  reader.join();
+
+  EXPECT_EQ(corrupted, 0);
+  EXPECT_EQ(previous, last.load());
+  EXPECT_GT(server.getStats().pool.allocations * 1000, 10 * params.poolBytes);
+}
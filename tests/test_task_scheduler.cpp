@@ -0,0 +1,251 @@
+/**
+ * @file test_task_scheduler.cpp
+ * @brief TaskScheduler 单元测试
+ */
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/task_scheduler.h"
+
+namespace {
+
+// 一次性闸门：在open()之前阻塞wait()
+class Gate {
+ public:
+  void open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    open_ = true;
+    cv_.notify_all();
+  }
+
+  void wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return open_; });
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool open_ = false;
+};
+
+camera_toolkit::TaskSchedulerParams withThreads(int threads) {
+  camera_toolkit::TaskSchedulerParams params;
+  params.threads = threads;
+  return params;
+}
+
+}  // namespace
+
+// ============================================================================
+// 执行测试
+// ============================================================================
+
+TEST(TaskSchedulerTest, RunsEveryTaskOnce) {
+  camera_toolkit::TaskScheduler scheduler(withThreads(4));
+  EXPECT_EQ(scheduler.getThreadCount(), 4);
+
+  std::vector<std::atomic<int>> hits(1000);
+  camera_toolkit::TaskGroup group;
+  for (size_t i = 0; i < hits.size(); i++) {
+    scheduler.submit(group, [&hits, i] { hits[i]++; });
+  }
+  scheduler.wait(group);
+  EXPECT_TRUE(group.done());
+  for (const auto& hit : hits) ASSERT_EQ(hit.load(), 1);
+
+  std::vector<int> squares(64, 0);
+  auto square = [&squares](int i) { squares[static_cast<size_t>(i)] = i * i; };
+  scheduler.parallelFor(static_cast<int>(squares.size()), square, camera_toolkit::TaskPriority::High);
+  for (int i = 0; i < 64; i++) EXPECT_EQ(squares[static_cast<size_t>(i)], i * i);
+
+  auto stats = scheduler.getStats();
+  EXPECT_EQ(stats.submitted, 1064u);
+  EXPECT_EQ(stats.executed, 1064u);
+  EXPECT_EQ(stats.failed, 0u);
+}
+
+TEST(TaskSchedulerTest, HigherPriorityRunsFirst) {
+  camera_toolkit::TaskScheduler scheduler(withThreads(1));
+  Gate started, release, finished;
+  scheduler.submit([&] {
+    started.open();
+    release.wait();
+  });
+  started.wait();
+
+  // 唯一的工作线程被占住时排队，放行后按优先级、同优先级按提交顺序执行
+  std::string order;
+  auto record = [&order](char c) { return [&order, c] { order += c; }; };
+  scheduler.submit(record('s'), camera_toolkit::TaskPriority::Low);
+  scheduler.submit(record('e'), camera_toolkit::TaskPriority::Normal);
+  scheduler.submit(record('c'), camera_toolkit::TaskPriority::High);
+  scheduler.submit(record('C'), camera_toolkit::TaskPriority::High);
+  scheduler.submit(record('E'), camera_toolkit::TaskPriority::Normal);
+  scheduler.submit([&finished] { finished.open(); }, camera_toolkit::TaskPriority::Low);
+  release.open();
+  finished.wait();
+  EXPECT_EQ(order, "cCeEs");
+}
+
+TEST(TaskSchedulerTest, WaiterOnlyHelpsItsOwnGroup) {
+  camera_toolkit::TaskScheduler scheduler(withThreads(1));
+  Gate started, release;
+  scheduler.submit([&] {
+    started.open();
+    release.wait();
+  });
+  started.wait();
+
+  // 工作线程被占住，等待方只执行自己组的任务，排在前面的无关任务留给工作线程
+  std::atomic<bool> unrelated{false};
+  scheduler.submit([&unrelated] { unrelated = true; }, camera_toolkit::TaskPriority::High);
+  std::thread::id runner;
+  scheduler.parallelFor(1, [&runner](int) { runner = std::this_thread::get_id(); }, camera_toolkit::TaskPriority::Low);
+  EXPECT_EQ(runner, std::this_thread::get_id());
+  EXPECT_FALSE(unrelated.load());
+  release.open();
+}
+
+TEST(TaskSchedulerTest, IdleWorkersStealQueuedTasks) {
+  camera_toolkit::TaskScheduler scheduler(withThreads(4));
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+
+  // 工作线程提交的子任务进入自己的队列，其他空闲线程把它们偷走
+  Gate finished;
+  scheduler.submit([&] {
+    scheduler.parallelFor(16, [&](int) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      std::lock_guard<std::mutex> lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    });
+    finished.open();
+  });
+  finished.wait();
+  EXPECT_GT(threads.size(), 1u);
+  EXPECT_GT(scheduler.getStats().stolen, 0u);
+}
+
+TEST(TaskSchedulerTest, UngroupedTaskWakesIdleWorkerWhileGroupWaits) {
+  camera_toolkit::TaskScheduler scheduler(withThreads(2));
+  Gate otherStarted, releaseOther, groupStarted;
+  std::atomic<bool> ran{false};
+  bool sawTask = false;
+
+  // 两个工作线程分别被无关任务和组任务占住
+  scheduler.submit([&] {
+    otherStarted.open();
+    releaseOther.wait();
+  });
+  otherStarted.wait();
+  std::thread waiter([&] {
+    camera_toolkit::TaskGroup group;
+    scheduler.submit(group, [&] {
+      groupStarted.open();
+      auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+      while (!ran && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+      sawTask = ran;
+    });
+    groupStarted.wait();
+    scheduler.wait(group);
+  });
+  groupStarted.wait();
+
+  // 等待方先睡下，空闲的工作线程后睡下；无关任务必须唤醒工作线程而不是等待方
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  releaseOther.open();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  scheduler.submit([&ran] { ran = true; });
+  waiter.join();
+  EXPECT_TRUE(sawTask);
+}
+
+TEST(TaskSchedulerTest, NestedWaitsDoNotDeadlock) {
+  // 每层都有线程在等待子任务，等待的线程自己执行队列中的任务
+  camera_toolkit::TaskScheduler scheduler(withThreads(2));
+  std::atomic<int> leaves{0};
+  scheduler.parallelFor(8, [&](int) {
+    scheduler.parallelFor(8, [&](int) { scheduler.parallelFor(8, [&](int) { leaves++; }); });
+  });
+  EXPECT_EQ(leaves.load(), 512);
+}
+
+// ============================================================================
+// 异常与生命周期测试
+// ============================================================================
+
+TEST(TaskSchedulerTest, GroupExceptionsReachTheWaiter) {
+  camera_toolkit::TaskScheduler scheduler(withThreads(2));
+  std::atomic<int> completed{0};
+  EXPECT_THROW(scheduler.parallelFor(32,
+                                     [&](int i) {
+                                       if (i == 7) throw std::runtime_error("slice failed");
+                                       completed++;
+                                     }),
+               std::runtime_error);
+  // 抛出前其余调用都已完成
+  EXPECT_EQ(completed.load(), 31);
+
+  // 不属于任务组的任务异常只计数，调度器继续工作
+  scheduler.submit([] { throw std::runtime_error("snapshot failed"); }, camera_toolkit::TaskPriority::Low);
+  std::atomic<int> after{0};
+  scheduler.parallelFor(4, [&](int) { after++; });
+  EXPECT_EQ(after.load(), 4);
+  for (int i = 0; i < 200 && scheduler.getStats().failed < 2; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  EXPECT_EQ(scheduler.getStats().failed, 2u);
+}
+
+TEST(TaskSchedulerTest, DestructorDrainsQueuedTasks) {
+  std::atomic<int> count{0};
+  {
+    camera_toolkit::TaskScheduler scheduler(withThreads(2));
+    for (int i = 0; i < 100; i++) {
+      scheduler.submit([&count] {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        count++;
+      });
+    }
+  }
+  EXPECT_EQ(count.load(), 100);
+  EXPECT_THROW(camera_toolkit::TaskScheduler scheduler(withThreads(-1)), camera_toolkit::CameraToolkitException);
+}
+
+TEST(TaskSchedulerTest, PinsWorkersToCores) {
+  // 只在允许运行于0号核时检查(容器可能限制了CPU集合)
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  ASSERT_EQ(pthread_getaffinity_np(pthread_self(), sizeof(allowed), &allowed), 0);
+  if (!CPU_ISSET(0, &allowed)) GTEST_SKIP() << "core 0 not available";
+
+  camera_toolkit::TaskSchedulerParams params = withThreads(1);
+  params.pinThreads = true;
+  camera_toolkit::TaskScheduler scheduler(params);
+  int cpus = 0;
+  bool onCore0 = false;
+  Gate finished;
+  scheduler.submit([&] {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+    cpus = CPU_COUNT(&set);
+    onCore0 = CPU_ISSET(0, &set);
+    finished.open();
+  });
+  finished.wait();
+  EXPECT_EQ(cpus, 1);
+  EXPECT_TRUE(onCore0);
+}
@@ -4,8 +4,13 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <ctime>
+#include <string>
 #include <vector>
 
 #include "camera_toolkit/timestamp.h"
@@ -22,6 +27,47 @@ std::vector<uint8_t> makeYPlane(uint8_t fill = 128) {
   return std::vector<uint8_t>(kYPlaneSize, fill);
 }
 
+// 用 localtime_r/strftime 生成参考时间戳文本
+std::string referenceText(int64_t timeUs, bool milliseconds) {
+  time_t sec = static_cast<time_t>(timeUs / 1000000);
+  struct tm tm{};
+  localtime_r(&sec, &tm);
+  char buf[64];
+  strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", &tm);
+  std::string text = buf;
+  if (milliseconds) {
+    char ms[8];
+    snprintf(ms, sizeof(ms), ".%03d", static_cast<int>(timeUs / 1000 % 1000));
+    text += ms;
+  }
+  strftime(buf, sizeof(buf), " (%Z)", &tm);
+  return text + buf;
+}
+
+// 临时切换 TZ 环境变量
+class ScopedTz {
+ public:
+  explicit ScopedTz(const char* tz) {
+    const char* old = getenv("TZ");
+    hadOld_ = old != nullptr;
+    if (hadOld_) old_ = old;
+    setenv("TZ", tz, 1);
+    tzset();
+  }
+  ~ScopedTz() {
+    if (hadOld_) {
+      setenv("TZ", old_.c_str(), 1);
+    } else {
+      unsetenv("TZ");
+    }
+    tzset();
+  }
+
+ private:
+  bool hadOld_ = false;
+  std::string old_;
+};
+
 }  // namespace
 
 // ============================================================================
@@ -173,3 +219,285 @@ TEST(TimestampTest, DrawTextSameContentProducesSameResult) {
 
   EXPECT_EQ(yPlane1, yPlane2);
 }
+
+// ============================================================================
+// 增量重绘测试
+// ============================================================================
+
+TEST(TimestampTest, IncrementalUpdateMatchesFreshRender) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  camera_toolkit::Timestamp cached(params);
+  camera_toolkit::Timestamp fresh(params);
+
+  // 先绘制旧文字，再只改变末尾几个字符
+  auto scratch = makeYPlane(128);
+  cached.drawText(scratch.data(), "2024-01-01 12:00:09");
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  cached.drawText(yPlane1.data(), "2024-01-01 12:00:10");
+  fresh.drawText(yPlane2.data(), "2024-01-01 12:00:10");
+
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+TEST(TimestampTest, LengthAndLineChangesRelayout) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  params.startY = 100;
+  camera_toolkit::Timestamp cached(params);
+  camera_toolkit::Timestamp fresh(params);
+
+  auto scratch = makeYPlane(128);
+  cached.drawText(scratch.data(), "A");
+  cached.drawText(scratch.data(), "LINE1\\nLONGER LINE2");
+
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  cached.drawText(yPlane1.data(), "SHORT");
+  fresh.drawText(yPlane2.data(), "SHORT");
+
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+TEST(TimestampTest, RightAlignedTextIsClippedToWidth) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  params.startX = kWidth - 1;
+  params.factor = 1;
+  camera_toolkit::Timestamp ts(params);
+
+  // 每行之后放置 sentinel，检测是否越过行尾写入下一行
+  std::vector<uint8_t> buffer(kYPlaneSize, 128);
+  ts.drawText(buffer.data(), "0123456789");
+  for (int y = 0; y < 32; ++y) {
+    EXPECT_EQ(buffer[static_cast<size_t>(y + 10) * kWidth], 128) << "row " << y;
+  }
+}
+
+// ============================================================================
+// 字符掩码测试
+// ============================================================================
+
+TEST(TimestampTest, GlyphMaskPixelsAreBlackOrWhite) {
+  camera_toolkit::TimestampParams params;
+  params.startX = 0;
+  params.startY = 0;
+  params.videoWidth = kWidth;
+  camera_toolkit::Timestamp ts(params);
+
+  auto yPlane = makeYPlane(128);
+  ts.drawText(yPlane.data(), "1");
+
+  // '1' 点阵首行: {0, 0, 0, 1, 0, 0, 0}，第二行: {0, 0, 1, 2, 1, 0, 0}
+  EXPECT_EQ(yPlane[2], 128);
+  EXPECT_EQ(yPlane[3], 0);
+  EXPECT_EQ(yPlane[kWidth + 2], 0);
+  EXPECT_EQ(yPlane[kWidth + 3], 255);
+  EXPECT_EQ(yPlane[kWidth + 4], 0);
+  EXPECT_EQ(yPlane[kWidth + 5], 128);
+}
+
+TEST(TimestampTest, ScaledGlyphsMatchNearestNeighbour) {
+  camera_toolkit::TimestampParams params;
+  params.startX = 0;
+  params.startY = 0;
+  params.videoWidth = kWidth;
+
+  auto base = makeYPlane(128);
+  camera_toolkit::Timestamp(params).drawText(base.data(), "8");
+
+  // factor 2 使用编译期掩码表，factor 5 超出表范围走运行时展开
+  for (int factor : {2, 5}) {
+    params.factor = factor;
+    const int scale = factor + 1;
+    auto scaled = makeYPlane(128);
+    camera_toolkit::Timestamp(params).drawText(scaled.data(), "8");
+
+    for (int y = 0; y < 8 * scale; ++y) {
+      for (int x = 0; x < 7 * scale; ++x) {
+        ASSERT_EQ(scaled[y * kWidth + x], base[(y / scale) * kWidth + x / scale])
+            << "factor " << factor << " at (" << x << ", " << y << ")";
+      }
+    }
+  }
+}
+
+// ============================================================================
+// 缓存时间格式化测试
+// ============================================================================
+
+TEST(TimestampTest, CachedClockMatchesStrftime) {
+  // 覆盖半小时偏移时区和夏令时切换(美东 2024-03-10 02:00 跳到 03:00)
+  for (const char* tz : {"UTC0", "IST-5:30", "EST5EDT,M3.2.0,M11.1.0"}) {
+    ScopedTz scoped(tz);
+    for (bool ms : {false, true}) {
+      camera_toolkit::TimestampParams params;
+      params.videoWidth = kWidth;
+      params.milliseconds = ms;
+      camera_toolkit::Timestamp cached(params);
+      camera_toolkit::Timestamp reference(params);
+
+      // 同一实例连续绘制，覆盖跨秒、跨日、跨年和时区切换
+      const int64_t times[] = {1710053999999000LL, 1710054000000000LL, 1710054000123000LL, 1710057601000000LL,
+                               1735689599999999LL, 1735689600000000LL, 1719791999500000LL, 946684800001000LL};
+      for (int64_t t : times) {
+        auto yPlane1 = makeYPlane(128);
+        auto yPlane2 = makeYPlane(128);
+        cached.draw(yPlane1.data(), t);
+        reference.drawText(yPlane2.data(), referenceText(t, ms).c_str());
+        EXPECT_EQ(yPlane1, yPlane2) << tz << " " << referenceText(t, ms);
+      }
+    }
+  }
+}
+
+TEST(TimestampTest, CachedClockFollowsHalfHourDstTransition) {
+  // 纽芬兰(America/St_Johns)本地02:00切换，对应UTC 05:30/04:30，不在UTC整点
+  ScopedTz scoped("NST3:30NDT,M3.2.0,M11.1.0");
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  camera_toolkit::Timestamp cached(params);
+  camera_toolkit::Timestamp reference(params);
+
+  // 先在切换前的同一UTC小时内绘制，再跨过切换时刻
+  const int64_t times[] = {1710046800000000LL, 1710048599000000LL, 1710048600000000LL, 1710049000000000LL,
+                           1730606400000000LL, 1730608199000000LL, 1730608200000000LL, 1730609000000000LL};
+  for (int64_t t : times) {
+    auto yPlane1 = makeYPlane(128);
+    auto yPlane2 = makeYPlane(128);
+    cached.draw(yPlane1.data(), t);
+    reference.drawText(yPlane2.data(), referenceText(t, false).c_str());
+    EXPECT_EQ(yPlane1, yPlane2) << referenceText(t, false);
+  }
+}
+
+TEST(TimestampTest, DrawAfterDrawTextRestoresClock) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  camera_toolkit::Timestamp ts(params);
+  camera_toolkit::Timestamp reference(params);
+  const int64_t t = 1700000000000000LL;
+
+  auto scratch = makeYPlane(128);
+  ts.draw(scratch.data(), t);
+  ts.drawText(scratch.data(), "OVERLAY");
+
+  // 时间未变化，但布局已被 drawText 替换，必须重新布局
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  ts.draw(yPlane1.data(), t);
+  reference.draw(yPlane2.data(), t);
+  EXPECT_EQ(yPlane1, yPlane2);
+}
+
+// ============================================================================
+// 帧视图测试
+// ============================================================================
+
+TEST(TimestampTest, PaddedFrameMatchesContiguous) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  params.startX = kWidth - 10;
+  params.factor = 1;
+  camera_toolkit::Timestamp padded(params);
+  camera_toolkit::Timestamp contiguous(params);
+
+  // 行跨度对齐到 64 字节之外再留 32 字节填充
+  constexpr int kStride = kWidth + 32;
+  std::vector<uint8_t> buffer(static_cast<size_t>(kStride) * kHeight, 0xAB);
+  camera_toolkit::FrameView frame;
+  frame.planes[0] = buffer.data();
+  frame.strides[0] = kStride;
+  frame.width = kWidth;
+  frame.height = kHeight;
+  padded.drawText(frame, "PADDED\\nFRAME");
+
+  auto yPlane = makeYPlane(0xAB);
+  contiguous.drawText(yPlane.data(), "PADDED\\nFRAME");
+
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kStride; ++x) {
+      uint8_t expected = x < kWidth ? yPlane[y * kWidth + x] : 0xAB;
+      ASSERT_EQ(buffer[y * kStride + x], expected) << "at (" << x << ", " << y << ")";
+    }
+  }
+}
+
+TEST(TimestampTest, LinesOutsideFrameAreClipped) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  params.startY = 2;
+  camera_toolkit::Timestamp top(params);
+  params.startY = kHeight - 3;
+  camera_toolkit::Timestamp bottom(params);
+
+  // 多行文字向上展开越过顶边，最后一行越过底边；帧前后放置 sentinel
+  std::vector<uint8_t> buffer(kYPlaneSize + 2 * kWidth * 32, 0xAB);
+  camera_toolkit::FrameView frame =
+      camera_toolkit::FrameView::contiguous(buffer.data() + kWidth * 32, kWidth, kHeight);
+  std::fill(frame.planes[0], frame.planes[0] + kYPlaneSize, 128);
+  top.drawText(frame, "A\\nB\\nC");
+  bottom.drawText(frame, "D");
+
+  for (int i = 0; i < kWidth * 32; ++i) {
+    ASSERT_EQ(buffer[i], 0xAB) << "before frame at " << i;
+    ASSERT_EQ(buffer[buffer.size() - 1 - i], 0xAB) << "after frame at " << i;
+  }
+  bool anyModified = false;
+  for (int i = 0; i < kYPlaneSize; ++i) anyModified = anyModified || frame.planes[0][i] != 128;
+  EXPECT_TRUE(anyModified);
+}
+
+TEST(TimestampTest, NegativeXIsClippedAtLeftEdge) {
+  constexpr int kShift = 13;
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  params.startY = 0;
+  params.startX = 0;
+  camera_toolkit::Timestamp reference(params);
+  params.startX = -kShift;
+  camera_toolkit::Timestamp shifted(params);
+
+  std::vector<uint8_t> expected = makeYPlane();
+  reference.drawText(expected.data(), "TEST");
+
+  // 文字从左边缘外开始：首行之前的 sentinel 不变，可见部分与左移后的参考图一致
+  std::vector<uint8_t> buffer(kYPlaneSize + 2 * kWidth * 32, 0xAB);
+  camera_toolkit::FrameView frame =
+      camera_toolkit::FrameView::contiguous(buffer.data() + kWidth * 32, kWidth, kHeight);
+  std::fill(frame.planes[0], frame.planes[0] + kYPlaneSize, 128);
+  shifted.drawText(frame, "TEST");
+
+  for (int i = 0; i < kWidth * 32; ++i) {
+    ASSERT_EQ(buffer[i], 0xAB) << "before frame at " << i;
+    ASSERT_EQ(buffer[buffer.size() - 1 - i], 0xAB) << "after frame at " << i;
+  }
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      uint8_t want = x + kShift < kWidth ? expected[y * kWidth + x + kShift] : 128;
+      ASSERT_EQ(frame.planes[0][y * kWidth + x], want) << "at (" << x << ", " << y << ")";
+    }
+  }
+}
+
+TEST(TimestampTest, SlicedDrawMatchesWholeFrame) {
+  camera_toolkit::TimestampParams params;
+  params.videoWidth = kWidth;
+  params.startY = 40;
+  params.factor = 2;
+  camera_toolkit::Timestamp sliced(params);
+  camera_toolkit::Timestamp whole(params);
+  const int64_t t = 1700000000LL * 1000000;
+
+  // 分条边界落在文字行中间
+  auto yPlane1 = makeYPlane(128);
+  auto yPlane2 = makeYPlane(128);
+  auto frame1 = camera_toolkit::FrameView::contiguous(yPlane1.data(), kWidth, kHeight);
+  for (int y = 0; y < kHeight; y += 14) {
+    sliced.draw(frame1, t, y, std::min(y + 14, kHeight));
+  }
+  whole.draw(camera_toolkit::FrameView::contiguous(yPlane2.data(), kWidth, kHeight), t);
+  EXPECT_EQ(yPlane1, yPlane2);
+}
@@ -0,0 +1,135 @@
+/**
+ * @file test_trace.cpp
+ * @brief 时间线跟踪单元测试
+ */
+#include <gtest/gtest.h>
+#include <pthread.h>
+
+#include <cstdint>
+#include <regex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera_toolkit/common.h"
+#include "camera_toolkit/timestamp.h"
+#include "camera_toolkit/trace.h"
+
+namespace {
+
+// 统计子串出现次数
+size_t countOf(const std::string& text, const std::string& needle) {
+  size_t n = 0;
+  for (size_t pos = text.find(needle); pos != std::string::npos; pos = text.find(needle, pos + 1)) n++;
+  return n;
+}
+
+}  // namespace
+
+// ============================================================================
+// 记录测试
+// ============================================================================
+
+TEST(TraceTest, NothingIsRecordedWhileStopped) {
+  camera_toolkit::startTracing();
+  camera_toolkit::stopTracing();
+  { CK_TRACE_SCOPE("ignored"); }
+  EXPECT_EQ(camera_toolkit::getTraceStats().events, 0u);
+  EXPECT_EQ(camera_toolkit::getTraceJson().find("ignored"), std::string::npos);
+}
+
+TEST(TraceTest, NestedScopesAreRecorded) {
+  camera_toolkit::startTracing();
+  {
+    CK_TRACE_SCOPE("outer");
+    { CK_TRACE_SCOPE("inner"); }
+  }
+  camera_toolkit::stopTracing();
+
+  EXPECT_EQ(camera_toolkit::getTraceStats().events, 2u);
+  std::string json = camera_toolkit::getTraceJson();
+  EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+
+  // 内层事件先结束，因而先写入；其时间区间应落在外层之内
+  std::regex event("\"name\":\"(\\w+)\",\"pid\":\\d+,\"tid\":\\d+,\"ts\":([0-9.]+),\"dur\":([0-9.]+)");
+  std::vector<std::smatch> matches;
+  for (auto it = std::sregex_iterator(json.begin(), json.end(), event); it != std::sregex_iterator(); ++it) {
+    matches.push_back(*it);
+  }
+  ASSERT_EQ(matches.size(), 2u);
+  EXPECT_EQ(matches[0][1], "inner");
+  EXPECT_EQ(matches[1][1], "outer");
+  double innerTs = std::stod(matches[0][2]), innerDur = std::stod(matches[0][3]);
+  double outerTs = std::stod(matches[1][2]), outerDur = std::stod(matches[1][3]);
+  EXPECT_GE(innerTs, outerTs);
+  EXPECT_LE(innerTs + innerDur, outerTs + outerDur + 0.001);
+}
+
+TEST(TraceTest, ThreadsGetSeparateTracks) {
+  camera_toolkit::startTracing();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([t] {
+      std::string name = "worker" + std::to_string(t);
+      pthread_setname_np(pthread_self(), name.c_str());
+      for (int i = 0; i < 100; ++i) {
+        CK_TRACE_SCOPE("work");
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+  camera_toolkit::stopTracing();
+
+  EXPECT_EQ(camera_toolkit::getTraceStats().events, 400u);
+  std::string json = camera_toolkit::getTraceJson();
+  EXPECT_EQ(countOf(json, "\"name\":\"work\""), 400u);
+  for (int t = 0; t < 4; ++t) EXPECT_NE(json.find("\"worker" + std::to_string(t) + "\""), std::string::npos);
+
+  std::regex tid("\"tid\":(\\d+)");
+  std::set<std::string> tids;
+  for (auto it = std::sregex_iterator(json.begin(), json.end(), tid); it != std::sregex_iterator(); ++it) {
+    tids.insert((*it)[1]);
+  }
+  EXPECT_EQ(tids.size(), 4u);
+}
+
+TEST(TraceTest, FullBufferDropsEvents) {
+  camera_toolkit::startTracing(8);
+  for (int i = 0; i < 20; ++i) {
+    CK_TRACE_SCOPE("burst");
+  }
+  camera_toolkit::stopTracing();
+
+  auto stats = camera_toolkit::getTraceStats();
+  EXPECT_EQ(stats.events, 8u);
+  EXPECT_EQ(stats.dropped, 12u);
+
+  // 新会话清空上一次的事件
+  camera_toolkit::startTracing();
+  camera_toolkit::stopTracing();
+  EXPECT_EQ(camera_toolkit::getTraceStats().events, 0u);
+  EXPECT_EQ(camera_toolkit::getTraceJson().find("burst"), std::string::npos);
+}
+
+// ============================================================================
+// 模块与导出测试
+// ============================================================================
+
+TEST(TraceTest, TimestampDrawIsTraced) {
+#ifdef CK_LIBRARY_TRACING_DISABLED
+  GTEST_SKIP() << "library built with TRACING=OFF";
+#endif
+  camera_toolkit::TimestampParams params;
+  camera_toolkit::Timestamp timestamp(params);
+  std::vector<uint8_t> frame(params.videoWidth * 480, 128);
+
+  camera_toolkit::startTracing();
+  timestamp.draw(frame.data(), 1700000000LL * 1000000);
+  camera_toolkit::stopTracing();
+  EXPECT_NE(camera_toolkit::getTraceJson().find("\"timestamp.draw\""), std::string::npos);
+}
+
+TEST(TraceTest, SaveToInvalidPathThrows) {
+  EXPECT_THROW(camera_toolkit::saveTrace("/nonexistent-dir/trace.json"), camera_toolkit::CameraToolkitException);
+}
@@ -0,0 +1,281 @@
+/**
+ * @file test_ts_muxer.cpp
+ * @brief TsMuxer 单元测试
+ */
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "camera_toolkit/ts_muxer.h"
+#include "h264_fixture.h"
+
+namespace {
+
+using camera_toolkit::testing::accessUnit;
+
+constexpr int TS = 188;
+
+// 解析后的TS包
+struct TsPacket {
+  int pid;
+  bool start;
+  int counter;
+  bool randomAccess;
+  bool hasPcr;
+  uint64_t pcrBase;
+  std::vector<uint8_t> payload;
+};
+
+TsPacket parse(const uint8_t* p) {
+  TsPacket packet{};
+  EXPECT_EQ(p[0], 0x47);
+  packet.pid = (p[1] & 0x1F) << 8 | p[2];
+  packet.start = (p[1] & 0x40) != 0;
+  packet.counter = p[3] & 0x0F;
+  size_t offset = 4;
+  if (p[3] & 0x20) {
+    const int length = p[4];
+    if (length > 0) {
+      packet.randomAccess = (p[5] & 0x40) != 0;
+      packet.hasPcr = (p[5] & 0x10) != 0;
+      if (packet.hasPcr) {
+        packet.pcrBase = static_cast<uint64_t>(p[6]) << 25 | p[7] << 17 | p[8] << 9 | p[9] << 1 | p[10] >> 7;
+      }
+    }
+    offset += 1 + length;
+  }
+  EXPECT_LE(offset, static_cast<size_t>(TS));
+  packet.payload.assign(p + offset, p + TS);
+  return packet;
+}
+
+uint32_t crc32Mpeg(const uint8_t* data, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < size; i++) {
+    crc ^= static_cast<uint32_t>(data[i]) << 24;
+    for (int bit = 0; bit < 8; bit++) crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+  }
+  return crc;
+}
+
+uint64_t readTimestamp(const uint8_t* p) {
+  return static_cast<uint64_t>(p[0] & 0x0E) << 29 | p[1] << 22 | (p[2] & 0xFE) << 14 | p[3] << 7 | p[4] >> 1;
+}
+
+// 收集输出的数据报
+class Capture {
+ public:
+  camera_toolkit::TsMuxer::Sink sink() {
+    return [this](const camera_toolkit::Buffer* datagrams, int count) {
+      calls.push_back(count);
+      for (int i = 0; i < count; i++) {
+        const uint8_t* data = static_cast<const uint8_t*>(datagrams[i].data);
+        sizes.push_back(datagrams[i].size);
+        EXPECT_EQ(datagrams[i].size % TS, 0);
+        if (i > 0) {
+          EXPECT_EQ(datagrams[i - 1].data, data - datagrams[i - 1].size);
+        }
+        for (int offset = 0; offset < datagrams[i].size; offset += TS) packets.push_back(parse(data + offset));
+      }
+    };
+  }
+
+  std::vector<TsPacket> pid(int value) const {
+    std::vector<TsPacket> result;
+    for (const auto& packet : packets) {
+      if (packet.pid == value) result.push_back(packet);
+    }
+    return result;
+  }
+
+  std::vector<int> calls;
+  std::vector<int> sizes;
+  std::vector<TsPacket> packets;
+};
+
+void write(camera_toolkit::TsMuxer& muxer, const std::vector<uint8_t>& au, int64_t ptsUs, int64_t dtsUs) {
+  camera_toolkit::EncodedFrame frame;
+  frame.buffer = camera_toolkit::Buffer(const_cast<uint8_t*>(au.data()), static_cast<int>(au.size()));
+  frame.ptsUs = ptsUs;
+  frame.dtsUs = dtsUs;
+  muxer.write(frame);
+}
+
+// 把视频PID上的负载按PES拆分
+std::vector<std::vector<uint8_t>> reassemble(const std::vector<TsPacket>& packets) {
+  std::vector<std::vector<uint8_t>> pes;
+  for (const auto& packet : packets) {
+    if (packet.start) pes.emplace_back();
+    pes.back().insert(pes.back().end(), packet.payload.begin(), packet.payload.end());
+  }
+  return pes;
+}
+
+}  // namespace
+
+// ============================================================================
+// 参数测试
+// ============================================================================
+
+TEST(TsMuxerTest, InvalidParamsThrow) {
+  Capture capture;
+  camera_toolkit::TsMuxerParams params;
+  params.videoPid = 0x0F;
+  EXPECT_THROW(camera_toolkit::TsMuxer(params, capture.sink()), camera_toolkit::CameraToolkitException);
+  params = camera_toolkit::TsMuxerParams{};
+  params.pmtPid = params.videoPid;
+  EXPECT_THROW(camera_toolkit::TsMuxer(params, capture.sink()), camera_toolkit::CameraToolkitException);
+  params = camera_toolkit::TsMuxerParams{};
+  params.packetsPerDatagram = 0;
+  EXPECT_THROW(camera_toolkit::TsMuxer(params, capture.sink()), camera_toolkit::CameraToolkitException);
+  EXPECT_THROW(camera_toolkit::TsMuxer(camera_toolkit::TsMuxerParams{}, nullptr),
+               camera_toolkit::CameraToolkitException);
+}
+
+// ============================================================================
+// 节目表测试
+// ============================================================================
+
+TEST(TsMuxerTest, WritesPatAndPmtWithValidCrc) {
+  Capture capture;
+  camera_toolkit::TsMuxer muxer(camera_toolkit::TsMuxerParams{}, capture.sink());
+  write(muxer, accessUnit(true, 1000), 0, 0);
+
+  ASSERT_GE(capture.packets.size(), 3u);
+  const TsPacket& pat = capture.packets[0];
+  EXPECT_EQ(pat.pid, 0);
+  EXPECT_TRUE(pat.start);
+  const uint8_t* section = pat.payload.data() + 1;
+  const size_t patLength = 3 + ((section[1] & 0x0F) << 8 | section[2]);
+  EXPECT_EQ(crc32Mpeg(section, patLength), 0u);  // 含CRC的整段CRC为0
+  EXPECT_EQ((section[10] & 0x1F) << 8 | section[11], 0x1000);
+
+  const TsPacket& pmt = capture.packets[1];
+  EXPECT_EQ(pmt.pid, 0x1000);
+  section = pmt.payload.data() + 1;
+  EXPECT_EQ(section[0], 0x02);
+  const size_t pmtLength = 3 + ((section[1] & 0x0F) << 8 | section[2]);
+  EXPECT_EQ(crc32Mpeg(section, pmtLength), 0u);
+  EXPECT_EQ((section[8] & 0x1F) << 8 | section[9], 0x100);  // PCR PID
+  EXPECT_EQ(section[12], 0x1B);
+  EXPECT_EQ((section[13] & 0x1F) << 8 | section[14], 0x100);
+}
+
+TEST(TsMuxerTest, RepeatsTablesOnIdrAndInterval) {
+  Capture capture;
+  camera_toolkit::TsMuxer muxer(camera_toolkit::TsMuxerParams{}, capture.sink());
+  // 30fps，每15帧一个IDR：第0、4、8、12帧按间隔插入，第15帧IDR重新计时
+  for (int i = 0; i < 30; i++) write(muxer, accessUnit(i % 15 == 0, 500), i * 33333LL, i * 33333LL);
+
+  const auto pat = capture.pid(0);
+  EXPECT_EQ(muxer.getStats().tables, pat.size());
+  EXPECT_EQ(pat.size(), 8u);
+  EXPECT_EQ(capture.pid(0x1000).size(), 8u);
+  for (size_t i = 0; i < pat.size(); i++) EXPECT_EQ(pat[i].counter, static_cast<int>(i % 16));
+}
+
+// ============================================================================
+// PES测试
+// ============================================================================
+
+TEST(TsMuxerTest, PesCarriesTimestampsAndAudPrefixedPayload) {
+  Capture capture;
+  camera_toolkit::TsMuxerParams params;
+  params.muxDelayMs = 100;
+  camera_toolkit::TsMuxer muxer(params, capture.sink());
+
+  const std::vector<uint8_t> header = camera_toolkit::testing::parameterSets();
+  write(muxer, header, 0, 0);
+  EXPECT_TRUE(capture.calls.empty());
+  EXPECT_EQ(muxer.getStats().frames, 0u);
+
+  const auto idr = accessUnit(true, 3000);
+  const auto p = accessUnit(false, 20);
+  write(muxer, idr, 1000000, 1000000);
+  write(muxer, p, 1100000, 1033333);
+
+  const auto pes = reassemble(capture.pid(0x100));
+  ASSERT_EQ(pes.size(), 2u);
+
+  // 第一帧：只有PTS
+  const std::vector<uint8_t>& first = pes[0];
+  EXPECT_EQ(first[0], 0x00);
+  EXPECT_EQ(first[2], 0x01);
+  EXPECT_EQ(first[3], 0xE0);
+  EXPECT_EQ(first[7], 0x80);
+  EXPECT_EQ(first[8], 5);
+  EXPECT_EQ(readTimestamp(first.data() + 9), 99000u);  // (1s + 100ms) x 90kHz
+  std::vector<uint8_t> expected = {0, 0, 0, 1, 0x09, 0xF0};
+  expected.insert(expected.end(), header.begin(), header.end());
+  expected.insert(expected.end(), idr.begin(), idr.end());
+  EXPECT_EQ(std::vector<uint8_t>(first.begin() + 14, first.end()), expected);
+
+  // 第二帧：PTS和DTS不同，头信息不再重复
+  const std::vector<uint8_t>& second = pes[1];
+  EXPECT_EQ(second[7], 0xC0);
+  EXPECT_EQ(second[8], 10);
+  EXPECT_EQ(second[9] >> 4, 3);
+  EXPECT_EQ(second[14] >> 4, 1);
+  EXPECT_EQ(readTimestamp(second.data() + 9), 108000u);
+  EXPECT_EQ(readTimestamp(second.data() + 14), 101999u);
+  expected = {0, 0, 0, 1, 0x09, 0xF0};
+  expected.insert(expected.end(), p.begin(), p.end());
+  EXPECT_EQ(std::vector<uint8_t>(second.begin() + 19, second.end()), expected);
+}
+
+TEST(TsMuxerTest, ContinuityCountersAndPcr) {
+  Capture capture;
+  camera_toolkit::TsMuxerParams params;
+  params.pcrIntervalMs = 40;
+  camera_toolkit::TsMuxer muxer(params, capture.sink());
+  for (int i = 0; i < 10; i++) write(muxer, accessUnit(i == 0, 700), i * 20000LL, i * 20000LL);
+
+  const auto video = capture.pid(0x100);
+  for (size_t i = 0; i < video.size(); i++) EXPECT_EQ(video[i].counter, static_cast<int>(i % 16));
+
+  std::vector<uint64_t> pcrs;
+  for (const auto& packet : video) {
+    if (packet.hasPcr) {
+      EXPECT_TRUE(packet.start);
+      pcrs.push_back(packet.pcrBase);
+    }
+  }
+  // 20ms一帧，每40ms一个PCR，取自解码时间戳
+  ASSERT_EQ(pcrs.size(), 5u);
+  for (size_t i = 0; i < pcrs.size(); i++) EXPECT_EQ(pcrs[i], i * 3600);
+  EXPECT_EQ(muxer.getStats().pcrs, 5u);
+  EXPECT_TRUE(video[0].randomAccess);
+}
+
+// ============================================================================
+// 数据报测试
+// ============================================================================
+
+TEST(TsMuxerTest, GroupsPacketsIntoDatagramsPerFrame) {
+  Capture capture;
+  camera_toolkit::TsMuxerParams params;
+  params.packetsPerDatagram = 7;
+  params.maxDatagrams = 4;
+  camera_toolkit::TsMuxer muxer(params, capture.sink());
+
+  // PAT + PMT + 10个视频包 = 12个TS包，一次输出两个数据报
+  write(muxer, accessUnit(true, 1800), 0, 0);
+  ASSERT_EQ(capture.calls, std::vector<int>({2}));
+  EXPECT_EQ(capture.sizes, std::vector<int>({7 * TS, 5 * TS}));
+
+  // 超过输出缓冲区的大帧分多次输出
+  capture.calls.clear();
+  capture.sizes.clear();
+  write(muxer, accessUnit(false, 40 * 184), 33333, 33333);
+  ASSERT_EQ(capture.calls.size(), 2u);
+  EXPECT_EQ(capture.calls[0], 4);
+  for (size_t i = 0; i < 4; i++) EXPECT_EQ(capture.sizes[i], 7 * TS);
+
+  auto stats = muxer.getStats();
+  EXPECT_EQ(stats.frames, 2u);
+  EXPECT_EQ(stats.batches, 3u);
+  EXPECT_EQ(stats.packets, capture.packets.size());
+  EXPECT_EQ(stats.datagrams, 2u + capture.sizes.size());
+}
@@ -0,0 +1,47 @@
+/**
+ * @file yuv_fixture.h
+ * @brief 叠加和遮挡测试共用的YUV测试帧生成函数
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace camera_toolkit {
+namespace testing {
+
+/**
+ * @brief 生成确定性伪随机I420帧，覆盖所有像素值
+ * @param width 宽度(偶数)
+ * @param height 高度(偶数)
+ * @param seed 随机种子
+ */
+inline std::vector<uint8_t> noiseFrame(int width, int height, uint32_t seed) {
+  std::vector<uint8_t> frame(static_cast<size_t>(width * height * 3 / 2));
+  for (auto& b : frame) {
+    seed = seed * 1103515245u + 12345u;
+    b = static_cast<uint8_t>(seed >> 16);
+  }
+  return frame;
+}
+
+/**
+ * @brief 把I420帧转为NV12帧
+ * @param i420 I420帧
+ * @param width 宽度(偶数)
+ * @param height 高度(偶数)
+ */
+inline std::vector<uint8_t> toNv12(const std::vector<uint8_t>& i420, int width, int height) {
+  const int ySize = width * height;
+  const int cSize = ySize / 4;
+  std::vector<uint8_t> nv12(i420.begin(), i420.begin() + ySize);
+  for (int i = 0; i < cSize; ++i) {
+    nv12.push_back(i420[ySize + i]);
+    nv12.push_back(i420[ySize + cSize + i]);
+  }
+  return nv12;
+}
+
+}  // namespace testing
+}  // namespace camera_toolkit